@@ -4,6 +4,8 @@
 #include "Game/Actor.hpp"
 #include "Game/Weapon.hpp"
 
+#include <cstdlib>
+
 void AI::Update()
 {
 	Actor* possessedActor = m_map->GetActorByUID(m_actorUID);
@@ -19,7 +21,7 @@ void AI::Update()
 		if (target)
 		{
 			m_targetUID = target->m_UID;
-			g_audio->StartSoundAt(possessedActor->m_definition.m_seeSound, possessedActor->m_position);
+			g_voiceManager->PlaySoundAt(possessedActor->m_definition.m_seeSound, possessedActor->m_position, VoicePriority::NORMAL, possessedActor->m_UID);
 		}
 	}
 
@@ -50,6 +52,36 @@ void AI::Update()
 		bool isTargetWithinLOS = m_map->HasLineOfSight(possessedActor, target);
 		bool isTargetWithinFiringAngle = fabsf(GetAngleDegreesBetweenVectors2D(displacementFirePositionToTarget, possessedActor->GetForwardNormal().GetXY())) < 15.f;
 
+		// Without line of sight, distant targets are chased along a hierarchical path and near ones down the shared flow field
+		// Agents fall back to the flow field whenever the path can't be planned or walked
+		Vec2 moveDirection = displacement2DTowardsTarget;
+		if (!isTargetWithinLOS)
+		{
+			Vec2 navigationDirection = Vec2::ZERO;
+			if (displacement2DTowardsTarget.GetLengthSquared() > AI_PATH_MIN_DISTANCE * AI_PATH_MIN_DISTANCE)
+			{
+				navigationDirection = GetPathDirection(possessedActor, target);
+			}
+			else
+			{
+				ClearPath();
+			}
+
+			if (navigationDirection == Vec2::ZERO)
+			{
+				FlowField const* flowField = m_map->GetFlowFieldToActor(target);
+				navigationDirection = flowField ? flowField->GetDirectionAtPosition(possessedActor->m_position.GetXY()) : Vec2::ZERO;
+			}
+			if (navigationDirection != Vec2::ZERO)
+			{
+				moveDirection = navigationDirection;
+			}
+		}
+		else
+		{
+			ClearPath();
+		}
+
 		if (isTargetWithinFiringRange && isTargetWithinLOS && isTargetWithinFiringAngle)
 		{
 			possessedActor->Attack();
@@ -58,10 +90,72 @@ void AI::Update()
 		{
 			possessedActor->MoveInDirection(possessedActor->GetForwardNormal(), movementSpeed);
 		}
-		possessedActor->TurnInDirection(displacement2DTowardsTarget.GetOrientationDegrees(), possessedActor->m_definition.m_turnSpeed);
+		possessedActor->TurnInDirection(moveDirection.GetOrientationDegrees(), possessedActor->m_definition.m_turnSpeed);
 	}
 }
 
+Vec2 const AI::GetPathDirection(Actor const* possessedActor, Actor const* target)
+{
+	Vec2 position = possessedActor->m_position.GetXY();
+	IntVec2 targetTileCoords(RoundDownToInt(target->m_position.x), RoundDownToInt(target->m_position.y));
+	int targetTileDrift = abs(targetTileCoords.x - m_pathGoalTileCoords.x) + abs(targetTileCoords.y - m_pathGoalTileCoords.y);
+	if (m_pathWaypoints.empty() || m_pathNavigationVersion != m_map->m_navigationVersion || targetTileDrift > AI_PATH_REPLAN_TILE_DISTANCE)
+	{
+		ClearPath();
+		if (!m_map->FindPath(possessedActor->m_position, target->m_position, m_pathWaypoints))
+		{
+			ClearPath();
+			return Vec2::ZERO;
+		}
+		m_pathGoalTileCoords = targetTileCoords;
+		m_pathNavigationVersion = m_map->m_navigationVersion;
+	}
+
+	IntVec2 tileCoords(RoundDownToInt(position.x), RoundDownToInt(position.y));
+	while (true)
+	{
+		// Skip ahead to just past the furthest step already reached, so an agent that cuts a corner doesn't turn back
+		for (int stepIndex = (int)m_pathSteps.size() - 1; stepIndex >= m_nextPathStepIndex; stepIndex--)
+		{
+			if (RoundDownToInt(m_pathSteps[stepIndex].x) == tileCoords.x && RoundDownToInt(m_pathSteps[stepIndex].y) == tileCoords.y)
+			{
+				m_nextPathStepIndex = stepIndex + 1;
+				break;
+			}
+		}
+		if (m_nextPathStepIndex < (int)m_pathSteps.size())
+		{
+			return (m_pathSteps[m_nextPathStepIndex] - position).GetNormalized();
+		}
+
+		// The last leg ends at the tile the path was planned to, from there the flow field takes over until the next replan
+		if (m_nextPathWaypointIndex >= (int)m_pathWaypoints.size())
+		{
+			m_pathWaypoints.clear();
+			return Vec2::ZERO;
+		}
+
+		m_pathSteps.clear();
+		m_nextPathStepIndex = 0;
+		if (!m_map->FindLocalPath(position, m_pathWaypoints[m_nextPathWaypointIndex], m_pathSteps))
+		{
+			// Pushed off the path into another cluster, plan again next frame
+			ClearPath();
+			return Vec2::ZERO;
+		}
+		m_nextPathWaypointIndex++;
+	}
+}
+
+void AI::ClearPath()
+{
+	m_pathWaypoints.clear();
+	m_nextPathWaypointIndex = 0;
+	m_pathSteps.clear();
+	m_nextPathStepIndex = 0;
+	m_pathGoalTileCoords = IntVec2(-1, -1);
+}
+
 void AI::DamagedBy(Actor* actor)
 {
 	m_targetUID = actor->m_UID;
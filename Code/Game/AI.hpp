@@ -2,6 +2,13 @@
 
 #include "Game/Controller.hpp"
 
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <vector>
+
+class Actor;
+
 class AI : public Controller
 {
 public:
@@ -11,10 +18,24 @@ public:
 	virtual void Update() override;
 
 	virtual bool IsPlayer() const override { return false; }
+	virtual bool HasTarget() const override { return m_targetUID != ActorUID::INVALID; }
 	virtual void DamagedBy(Actor * actor) override;
 	virtual void KilledBy(Actor * actor) override;
 	virtual void Killed(Actor * actor) override;
 
+private:
+	Vec2 const GetPathDirection(Actor const* possessedActor, Actor const* target);
+	void ClearPath();
+
 public:
 	ActorUID m_targetUID = ActorUID::INVALID;
+
+private:
+	// Hierarchical waypoints to the target, each leg is expanded into tile steps only when the agent starts walking it
+	std::vector<Vec2> m_pathWaypoints;
+	int m_nextPathWaypointIndex = 0;
+	std::vector<Vec2> m_pathSteps;
+	int m_nextPathStepIndex = 0;
+	IntVec2 m_pathGoalTileCoords = IntVec2(-1, -1);
+	int m_pathNavigationVersion = -1;
 };
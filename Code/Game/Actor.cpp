@@ -1,12 +1,16 @@
 #include "Game/Actor.hpp"
 
+#include "Game/AllocationTracker.hpp"
 #include "Game/App.hpp"
 #include "Game/Controller.hpp"
+#include "Game/CounterRNG.hpp"
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Map.hpp"
 #include "Game/MapDefinition.hpp"
 #include "Game/Player.hpp"
+#include "Game/RenderList.hpp"
 #include "Game/Weapon.hpp"
 #include "Game/Gold/Particle.hpp"
 
@@ -25,6 +29,22 @@
 Actor::~Actor()
 {
 	m_map->m_game->m_gameClock.RemoveChild(&m_animationClock);
+
+	for (int weaponIndex = 0; weaponIndex < (int)m_weapons.size(); weaponIndex++)
+	{
+		delete m_weapons[weaponIndex];
+	}
+	m_weapons.clear();
+	for (int weaponIndex = 0; weaponIndex < (int)m_leftWeapons.size(); weaponIndex++)
+	{
+		delete m_leftWeapons[weaponIndex];
+	}
+	m_leftWeapons.clear();
+	for (int weaponIndex = 0; weaponIndex < (int)m_rightWeapons.size(); weaponIndex++)
+	{
+		delete m_rightWeapons[weaponIndex];
+	}
+	m_rightWeapons.clear();
 }
 
 Actor::Actor(Map* map, SpawnInfo const& spawnInfo, ActorUID uid)
@@ -60,6 +80,7 @@ Actor::Actor(Map* map, SpawnInfo const& spawnInfo, ActorUID uid)
 	if (!m_definition.m_is3DActor && m_definition.m_visible)
 	{
 		m_currentAnimation = m_definition.m_animations[0];
+		m_currentSpriteTable = m_definition.m_spriteTables[0];
 		if (m_currentAnimation.m_scaleBySpeed)
 		{
 			m_animationClock.SetTimeScale(m_velocity.GetLength() / m_definition.m_runSpeed);
@@ -71,6 +92,18 @@ Actor::Actor(Map* map, SpawnInfo const& spawnInfo, ActorUID uid)
 	}
 }
 
+void* Actor::operator new(size_t numBytes)
+{
+	TrackAllocation(AllocationCategory::ACTORS, numBytes);
+	return ::operator new(numBytes);
+}
+
+void Actor::operator delete(void* pointer, size_t numBytes)
+{
+	TrackFree(AllocationCategory::ACTORS, numBytes);
+	::operator delete(pointer);
+}
+
 void Actor::Update()
 {
 	if (m_isDestroyed)
@@ -78,6 +111,10 @@ void Actor::Update()
 		return;
 	}
 
+	// Frames skipped while on a reduced tick are simulated in this update
+	m_updateDeltaSeconds = m_pendingUpdateSeconds + m_map->m_game->m_gameClock.GetDeltaSeconds();
+	m_pendingUpdateSeconds = 0.f;
+
 	if (m_controller && !m_controller->IsPlayer())
 	{
 		m_controller->Update();
@@ -93,15 +130,6 @@ void Actor::Update()
 		}
 	}
 
-	if (m_equippedWeaponIndex != -1 && g_audio->IsPlaying(m_weapons[m_equippedWeaponIndex]->m_fireSoundPlayback))
-	{
-		g_audio->SetSoundPosition(m_weapons[m_equippedWeaponIndex]->m_fireSoundPlayback, m_position);
-	}
-	if (g_audio->IsPlaying(m_hurtSoundPlayback))
-	{
-		g_audio->SetSoundPosition(m_hurtSoundPlayback, m_position);
-	}
-
 	if (m_isDead)
 	{
 		return;
@@ -112,6 +140,7 @@ void Actor::Update()
 		// Current Animation has ended
 		// Reset to default "Walk" animation
 		m_currentAnimation = m_definition.m_animations[0];
+		m_currentSpriteTable = m_definition.m_spriteTables[0];
 
 		if (m_currentAnimation.m_scaleBySpeed)
 		{
@@ -136,11 +165,12 @@ void Actor::Update()
 
 	if (m_definition.m_showVisualParticles)
 	{
+		CounterRNG particleRNG = g_randomStreams->GetRNG(RandomStream::PARTICLES, m_UID.GetData(), m_map->m_frameIndex, RANDOM_CHANNEL_ACTOR_UPDATE);
 		for (int particleIndex = 0; particleIndex < m_definition.m_visualParticles; particleIndex++)
 		{
-			float particleSize = g_RNG->RollRandomFloatInRange(m_definition.m_visualParticleSize);
+			float particleSize = particleRNG.RollRandomFloatInRange(m_definition.m_visualParticleSize);
 			Particle* particle = m_map->SpawnParticle(m_position - GetForwardNormal() * m_definition.m_physicsRadius, particleSize, m_definition.m_visualParticleColor, m_definition.m_visualParticleLifetime);
-			Vec3 randomDirection = Vec3(g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f));
+			Vec3 randomDirection = Vec3(particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f));
 			randomDirection = randomDirection.GetNormalized() * m_definition.m_visualParticleSpeed;
 			particle->AddImpulse(randomDirection);
 		}
@@ -149,7 +179,7 @@ void Actor::Update()
 
 void Actor::UpdatePhysics()
 {
-	float deltaSeconds = m_map->m_game->m_gameClock.GetDeltaSeconds();
+	float deltaSeconds = m_updateDeltaSeconds;
 
 	AddForce(-m_velocity * m_definition.m_drag);
 	AddForce(Vec3::GROUNDWARD * GRAVITY * m_definition.m_gravityScale);
@@ -165,7 +195,7 @@ void Actor::UpdatePhysics()
 
 }
 
-void Actor::Render() const
+void Actor::AddDrawItems(RenderList& renderList) const
 {
 
 	if (g_openXR && g_openXR->IsInitialized())
@@ -180,15 +210,14 @@ void Actor::Render() const
 			transform.Append(player->m_leftControllerOrientation.GetAsMatrix_iFwd_jLeft_kUp());
 			transform.AppendScaleUniform3D(leftWeapon->m_definition.m_modelScale);
 
-			g_renderer->SetBlendMode(BlendMode::OPAQUE);
-			g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-			g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-			g_renderer->SetDepthMode(DepthMode::ENABLED);
-			g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-			g_renderer->SetModelConstants(transform);
-			g_renderer->BindTexture(leftWeapon->m_definition.m_texture);
-			//g_theRenderer->BindShader(m_definition.m_shader);
-			g_renderer->DrawIndexBuffer(leftWeapon->m_definition.m_model->GetVertexBuffer(), leftWeapon->m_definition.m_model->GetIndexBuffer(), leftWeapon->m_definition.m_model->GetIndexCount());
+			DrawItem leftWeaponItem;
+			leftWeaponItem.m_vertexBuffer = leftWeapon->m_definition.m_model->GetVertexBuffer();
+			leftWeaponItem.m_indexBuffer = leftWeapon->m_definition.m_model->GetIndexBuffer();
+			leftWeaponItem.m_indexCount = leftWeapon->m_definition.m_model->GetIndexCount();
+			leftWeaponItem.m_modelMatrix = transform;
+			leftWeaponItem.m_texture = leftWeapon->m_definition.m_texture;
+			leftWeaponItem.m_lateLatchSlot = LateLatchSlot::LEFT_HAND;
+			renderList.AddDrawItem(leftWeaponItem);
 
 			// Render Right Hand Weapon
 			Weapon* const& rightWeapon = m_weapons[player->m_rightWeaponIndex];
@@ -196,15 +225,14 @@ void Actor::Render() const
 			transform.Append(player->m_rightControllerOrientation.GetAsMatrix_iFwd_jLeft_kUp());
 			transform.AppendScaleUniform3D(rightWeapon->m_definition.m_modelScale);
 
-			g_renderer->SetBlendMode(BlendMode::OPAQUE);
-			g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-			g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-			g_renderer->SetDepthMode(DepthMode::ENABLED);
-			g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-			g_renderer->SetModelConstants(transform);
-			g_renderer->BindTexture(rightWeapon->m_definition.m_texture);
-			//g_theRenderer->BindShader(m_definition.m_shader);
-			g_renderer->DrawIndexBuffer(rightWeapon->m_definition.m_model->GetVertexBuffer(), rightWeapon->m_definition.m_model->GetIndexBuffer(), rightWeapon->m_definition.m_model->GetIndexCount());
+			DrawItem rightWeaponItem;
+			rightWeaponItem.m_vertexBuffer = rightWeapon->m_definition.m_model->GetVertexBuffer();
+			rightWeaponItem.m_indexBuffer = rightWeapon->m_definition.m_model->GetIndexBuffer();
+			rightWeaponItem.m_indexCount = rightWeapon->m_definition.m_model->GetIndexCount();
+			rightWeaponItem.m_modelMatrix = transform;
+			rightWeaponItem.m_texture = rightWeapon->m_definition.m_texture;
+			rightWeaponItem.m_lateLatchSlot = LateLatchSlot::RIGHT_HAND;
+			renderList.AddDrawItem(rightWeaponItem);
 
 			return;
 		}
@@ -214,21 +242,13 @@ void Actor::Render() const
 	{
 		if (m_equippedWeaponIndex > -1)
 		{
-			m_weapons[m_equippedWeaponIndex]->Render();
+			m_weapons[m_equippedWeaponIndex]->AddDrawItems(renderList);
 		}
 
 		Mat44 transform = Mat44::CreateTranslation3D(m_position);
 		transform.Append(m_orientation.GetAsMatrix_iFwd_jLeft_kUp());
 
-		g_renderer->SetBlendMode(m_definition.m_blendMode);
-		g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-		g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-		g_renderer->SetDepthMode(DepthMode::ENABLED);
-		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_renderer->SetModelConstants(transform);
-		g_renderer->BindTexture(m_definition.m_texture);
-		//g_theRenderer->BindShader(m_definition.m_shader);
-		g_renderer->DrawIndexBuffer(m_definition.m_model->GetVertexBuffer(), m_definition.m_model->GetIndexBuffer(), m_definition.m_model->GetIndexCount());
+		renderList.AddIndexedDraw(m_definition.m_model->GetVertexBuffer(), m_definition.m_model->GetIndexBuffer(), m_definition.m_model->GetIndexCount(), transform, Rgba8::WHITE, m_definition.m_texture, m_definition.m_blendMode, RenderList::GetLayerForBlendMode(m_definition.m_blendMode));
 
 		return;
 	}
@@ -240,36 +260,36 @@ void Actor::Render() const
 
 	Mat44 billboardMatrix = GetBillboardMatrix(m_definition.m_billboardType, g_app->m_worldCamera.GetModelMatrix(), m_position);
 
-	Vec3 viewingDirection = m_position - g_app->m_worldCamera.GetPosition();
-	viewingDirection = viewingDirection.GetXY().GetNormalized().ToVec3();
-	Mat44 worldToLocal = GetRenderModelMatrix().GetOrthonormalInverse();
-	viewingDirection = worldToLocal.TransformVectorQuantity3D(viewingDirection);
-	SpriteAnimDefinition animation = m_currentAnimation.GetAnimationForDirection(viewingDirection);
-	SpriteDefinition sprite = animation.GetSpriteDefAtTime(m_animationClock.GetTotalSeconds());
+	if (!m_currentSpriteTable || m_currentSpriteTable->IsEmpty())
+	{
+		return;
+	}
+
+	// Sprite directions only vary around the up axis, so the actor's yaw is all that is needed to bring the view into its space
+	float localViewingDegrees = (m_position - g_app->m_worldCamera.GetPosition()).GetXY().GetOrientationDegrees() - m_orientation.m_yawDegrees;
+	AABB2 const& spriteUVs = m_currentSpriteTable->GetUVs(localViewingDegrees, m_animationClock.GetTotalSeconds());
 
-	std::vector<Vertex_PCU> unlitVertexes;
-	std::vector<Vertex_PCUTBN> litVertexes;
+	// The render list copies the vertexes, so frame scratch arrays are enough
+	std::vector<Vertex_PCU>& unlitVertexes = g_frameArena->AcquireScratchVertexesPCU();
+	std::vector<Vertex_PCUTBN>& litVertexes = g_frameArena->AcquireScratchVertexesPCUTBN();
 
 	if (m_definition.m_isLit)
 	{
-		AddVertsForRoundedQuad3D(litVertexes, Vec3::ZERO, Vec3::NORTH * m_definition.m_size.x, Vec3::NORTH * m_definition.m_size.x + Vec3::SKYWARD * m_definition.m_size.y, Vec3::SKYWARD * m_definition.m_size.y, Rgba8::WHITE, sprite.GetUVs());
+		AddVertsForRoundedQuad3D(litVertexes, Vec3::ZERO, Vec3::NORTH * m_definition.m_size.x, Vec3::NORTH * m_definition.m_size.x + Vec3::SKYWARD * m_definition.m_size.y, Vec3::SKYWARD * m_definition.m_size.y, Rgba8::WHITE, spriteUVs);
 		TransformVertexArray3D(litVertexes, Mat44::CreateTranslation3D(-Vec3(0.f, m_definition.m_size.x, m_definition.m_size.y) * Vec3(0.f, m_definition.m_pivot.x, m_definition.m_pivot.y)));
 	}
 	else
 	{
-		AddVertsForQuad3D(unlitVertexes, Vec3::ZERO, Vec3::NORTH * m_definition.m_size.x, Vec3::NORTH * m_definition.m_size.x + Vec3::SKYWARD * m_definition.m_size.y, Vec3::SKYWARD * m_definition.m_size.y, Rgba8::WHITE, sprite.GetUVs());
+		AddVertsForQuad3D(unlitVertexes, Vec3::ZERO, Vec3::NORTH * m_definition.m_size.x, Vec3::NORTH * m_definition.m_size.x + Vec3::SKYWARD * m_definition.m_size.y, Vec3::SKYWARD * m_definition.m_size.y, Rgba8::WHITE, spriteUVs);
 		TransformVertexArray3D(unlitVertexes, Mat44::CreateTranslation3D(-Vec3(0.f, m_definition.m_size.x, m_definition.m_size.y) * Vec3(0.f, m_definition.m_pivot.x, m_definition.m_pivot.y)));
 	}
 
-	g_renderer->SetBlendMode(BlendMode::OPAQUE);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->SetModelConstants(billboardMatrix, m_definition.m_texture ? Rgba8::WHITE : Rgba8::MAGENTA);
-	g_renderer->BindTexture(m_definition.m_texture);
-	g_renderer->BindShader(m_definition.m_shader);
-	m_definition.m_isLit ? g_renderer->DrawVertexArray(litVertexes) : g_renderer->DrawVertexArray(unlitVertexes);
+	DrawItem billboardItem;
+	billboardItem.m_modelMatrix = billboardMatrix;
+	billboardItem.m_tint = m_definition.m_texture ? Rgba8::WHITE : Rgba8::MAGENTA;
+	billboardItem.m_texture = m_definition.m_texture;
+	billboardItem.m_shader = m_definition.m_shader;
+	m_definition.m_isLit ? renderList.AddVertexArray(litVertexes, billboardItem) : renderList.AddVertexArray(unlitVertexes, billboardItem);
 }
 
 void Actor::RenderDebug() const
@@ -284,6 +304,7 @@ void Actor::TakeDamage(float damage)
 		return;
 	}
 
+	WakeUp();
 	m_health -= damage;
 	if (m_health <= 0.f)
 	{
@@ -291,12 +312,13 @@ void Actor::TakeDamage(float damage)
 	}
 	else
 	{
-		m_hurtSoundPlayback = g_audio->StartSoundAt(m_definition.m_hurtSound, m_position);
+		m_hurtSoundPlayback = g_voiceManager->PlaySoundAt(m_definition.m_hurtSound, m_position, GetSoundPriority(), m_UID);
 	}
 
 	if (!m_definition.m_is3DActor)
 	{
 		m_currentAnimation = m_definition.GetAnimationGroupByName("Hurt");
+		m_currentSpriteTable = m_definition.GetSpriteTableByName("Hurt");
 		if (m_currentAnimation.m_scaleBySpeed)
 		{
 			m_animationClock.SetTimeScale(m_velocity.GetLength() / m_definition.m_runSpeed);
@@ -323,49 +345,45 @@ void Actor::Die()
 
 	if (m_definition.m_deathSound != MISSING_SOUND_ID)
 	{
-		g_audio->StartSoundAt(m_definition.m_deathSound, m_position);
+		g_voiceManager->PlaySoundAt(m_definition.m_deathSound, m_position, VoicePriority::HIGH, m_UID);
 	}
 
 	if (m_definition.m_explodeOnDie)
 	{
+		CounterRNG particleRNG = g_randomStreams->GetRNG(RandomStream::PARTICLES, m_UID.GetData(), m_map->m_frameIndex, RANDOM_CHANNEL_ACTOR_DEATH);
 		for (int particleIndex = 0; particleIndex < m_definition.m_explosionParticles; particleIndex++)
 		{
-			float particleSize = g_RNG->RollRandomFloatInRange(m_definition.m_explosionParticleSize);
+			float particleSize = particleRNG.RollRandomFloatInRange(m_definition.m_explosionParticleSize);
 			Particle* particle = m_map->SpawnParticle(m_position, particleSize, m_definition.m_explosionParticleColor, m_definition.m_explosionParticleLifetime);
-			Vec3 randomDirection = Vec3(g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f));
+			Vec3 randomDirection = Vec3(particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f));
 			randomDirection = randomDirection.GetNormalized() * m_definition.m_explosionParticleSpeed;
 			particle->AddImpulse(randomDirection);
-			
-			for (int actorIndex = 0; actorIndex < (int)m_map->m_actors.size(); actorIndex++)
-			{
-				Actor* actor = m_map->m_actors[actorIndex];
-				if (!actor)
-				{
-					continue;
-				}
+		}
 
-				if (!IsPointInsideDisc2D(actor->m_position.GetXY(), m_position.GetXY(), m_definition.m_explosionRadius))
-				{
-					continue;
-				}
+		// Damage and impulse are resolved once per actor in range, independent of the particle count
+		std::vector<Actor*> actorsInRadius;
+		m_map->GetActorsInRadius(m_position, m_definition.m_explosionRadius, actorsInRadius);
+		Actor* owner = m_map->GetActorByUID(m_ownerUID);
+		CounterRNG combatRNG = g_randomStreams->GetRNG(RandomStream::COMBAT, m_UID.GetData(), m_map->m_frameIndex, RANDOM_CHANNEL_ACTOR_DEATH);
+		for (int actorIndex = 0; actorIndex < (int)actorsInRadius.size(); actorIndex++)
+		{
+			Actor* actor = actorsInRadius[actorIndex];
 
-				if (actor->m_UID != m_ownerUID || actor->m_definition.m_faction == Faction::MARINE)
-				{
-					Vec3 directionToActor = (actor->m_position - m_position).GetNormalized();
-					actor->AddImpulse(m_definition.m_impulseOnExplode * directionToActor);
-				}
+			if (actor->m_UID != m_ownerUID || actor->m_definition.m_faction == Faction::MARINE)
+			{
+				Vec3 directionToActor = (actor->m_position - m_position).GetNormalized();
+				actor->AddImpulse(m_definition.m_impulseOnExplode * directionToActor);
+			}
 
-				if (actor->m_UID != m_ownerUID)
+			if (actor->m_UID != m_ownerUID)
+			{
+				float damage = combatRNG.RollRandomFloatInRange(m_definition.m_explosionDamage);
+				actor->TakeDamage(damage);
+				if (actor->m_controller)
 				{
-					float damage = g_RNG->RollRandomFloatInRange(m_definition.m_explosionDamage);
-					actor->TakeDamage(damage);
-					if (actor->m_controller)
-					{
-						actor->m_controller->DamagedBy(m_map->GetActorByUID(m_ownerUID));
-					}
+					actor->m_controller->DamagedBy(owner);
 				}
 			}
-
 		}
 	}
 
@@ -375,6 +393,7 @@ void Actor::Die()
 	}
 
 	m_currentAnimation = m_definition.GetAnimationGroupByName("Death");
+	m_currentSpriteTable = m_definition.GetSpriteTableByName("Death");
 	if (m_currentAnimation.m_scaleBySpeed)
 	{
 		m_animationClock.SetTimeScale(m_velocity.GetLength() / m_definition.m_runSpeed);
@@ -393,9 +412,39 @@ void Actor::AddForce(Vec3 const& force)
 
 void Actor::AddImpulse(Vec3 const& impulse)
 {
+	WakeUp();
 	m_velocity += impulse;
 }
 
+void Actor::WakeUp()
+{
+	if (m_activityTier == ActivityTier::SLEEPING && !m_isDead)
+	{
+		m_map->m_activityStats.m_numWoken++;
+		m_activityTier = ActivityTier::ACTIVE;
+	}
+	m_secondsAtRest = 0.f;
+}
+
+bool Actor::IsAtRest() const
+{
+	if (m_velocity.GetLengthSquared() > ACTOR_SLEEP_SPEED * ACTOR_SLEEP_SPEED)
+	{
+		return false;
+	}
+	if (m_controller && m_controller->HasTarget())
+	{
+		return false;
+	}
+
+	// A hurt or attack animation still has to play out and hand back to the default animation
+	if (!m_definition.m_is3DActor && !m_definition.m_animations.empty() && m_currentAnimation.m_name != m_definition.m_animations[0].m_name)
+	{
+		return false;
+	}
+	return true;
+}
+
 void Actor::OnCollide(Actor* other)
 {
 	if (other && !other->m_isDead)
@@ -421,7 +470,9 @@ void Actor::OnCollide(Actor* other)
 
 		if (m_definition.m_damageOnCollide != FloatRange::ZERO)
 		{
-			other->TakeDamage(g_RNG->RollRandomFloatInRange(m_definition.m_damageOnCollide));
+			// Keyed by the pair, so touching several actors in one frame rolls independently for each
+			CounterRNG combatRNG = g_randomStreams->GetRNG(RandomStream::COMBAT, m_UID.GetData(), m_map->m_frameIndex, RANDOM_CHANNEL_COLLISION + other->m_UID.GetIndex());
+			other->TakeDamage(combatRNG.RollRandomFloatInRange(m_definition.m_damageOnCollide));
 			Actor* owner = m_map->GetActorByUID(m_ownerUID);
 			if (owner)
 			{
@@ -451,6 +502,7 @@ void Actor::OnCollideWithStatic(StaticActor* staticActor)
 
 void Actor::OnPossessed(Controller* controller)
 {
+	WakeUp();
 	m_controller = controller;
 	if (!controller->IsPlayer())
 	{
@@ -483,7 +535,7 @@ void Actor::MoveInDirection(Vec3 const& direction, float speed)
 
 void Actor::TurnInDirection(float targetOrientation, float maxTurnRate)
 {
-	float deltaSeconds = m_map->m_game->m_gameClock.GetDeltaSeconds();
+	float deltaSeconds = m_updateDeltaSeconds;
 
 	m_orientation.m_yawDegrees = GetTurnedTowardDegrees(m_orientation.m_yawDegrees, targetOrientation, maxTurnRate * deltaSeconds);
 }
@@ -573,3 +625,12 @@ Vec3 const Actor::GetWeaponPosition() const
 {
 	return m_pivotPosition + GetForwardNormal() * 0.2f + GetLeftNormal() * 0.02f;
 }
+
+VoicePriority Actor::GetSoundPriority() const
+{
+	if (m_controller && m_controller->IsPlayer())
+	{
+		return VoicePriority::HIGH;
+	}
+	return VoicePriority::NORMAL;
+}
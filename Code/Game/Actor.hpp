@@ -2,6 +2,7 @@
 
 #include "Game/ActorDefinition.hpp"
 #include "Game/ActorUID.hpp"
+#include "Game/VoiceManager.hpp"
 
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/Clock.hpp"
@@ -12,10 +13,18 @@
 
 
 class Map;
+class RenderList;
 struct SpawnInfo;
 class Controller;
 class StaticActor;
 
+enum class ActivityTier
+{
+	ACTIVE,
+	REDUCED,
+	SLEEPING
+};
+
 class Actor
 {
 public:
@@ -23,9 +32,13 @@ public:
 	Actor() = default;
 	Actor(Map* map, SpawnInfo const& spawnInfo, ActorUID uid);
 
+	// Routed through the allocation tracker, subclasses with their own category override these
+	static void*				operator new(size_t numBytes);
+	static void					operator delete(void* pointer, size_t numBytes);
+
 	virtual void				Update();
 	virtual void				UpdatePhysics();
-	virtual void				Render() const;
+	virtual void				AddDrawItems(RenderList& renderList) const;
 	void						RenderDebug() const;
 
 	virtual void				TakeDamage(float damage);
@@ -36,6 +49,9 @@ public:
 	virtual void				OnCollide(Actor* other);
 	virtual void				OnCollideWithStatic(StaticActor* other);
 	
+	void						WakeUp();
+	bool						IsAtRest() const;
+
 	virtual void				OnPossessed(Controller* controller);
 	virtual void				OnUnpossessed();
 	virtual void				MoveInDirection(Vec3 const& direction, float speed);
@@ -54,6 +70,11 @@ public:
 	virtual Vec3 const			GetUpNormal() const;
 	virtual Vec3 const			GetEyePosition() const;
 	Vec3 const					GetWeaponPosition() const;
+	// Sounds the player makes always outrank everyone else's
+	VoicePriority				GetSoundPriority() const;
+	// Actors spawned since the last collision pass have not moved yet as far as swept tests are concerned
+	Vec3 const					GetSweepStartPosition() const { return m_hasSweepStartPosition ? m_sweepStartPosition : m_position; }
+	Vec3 const					GetSweepDisplacement() const { return m_position - GetSweepStartPosition(); }
 
 public:
 	ActorUID					m_UID = ActorUID::INVALID;
@@ -86,8 +107,21 @@ public:
 
 	Clock						m_animationClock;
 	AnimationGroupDefinition	m_currentAnimation;
+	DirectionalSpriteTable const* m_currentSpriteTable = nullptr;
 
 	SoundPlaybackID				m_hurtSoundPlayback;
 	bool						m_isGrounded = false;
+	// Where the previous collision pass left the actor, swept tests cover the motion from here to m_position
+	Vec3						m_sweepStartPosition = Vec3::ZERO;
+	bool						m_hasSweepStartPosition = false;
+
+	ActivityTier				m_activityTier = ActivityTier::ACTIVE;
+	float						m_secondsAtRest = 0.f;
+	// Map frame a waker last came within reach, resting actors only fall asleep on frames nothing did
+	unsigned int				m_nearWakerFrameIndex = 0;
+	// Game time covered by the current update, several frames' worth for actors on a reduced tick
+	float						m_updateDeltaSeconds = 0.f;
+	// Game time from frames the map skipped this actor on, folded into its next update
+	float						m_pendingUpdateSeconds = 0.f;
 
 };
\ No newline at end of file
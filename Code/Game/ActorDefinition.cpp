@@ -2,6 +2,7 @@
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
+#include "Game/AllocationTracker.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Weapon.hpp"
 #include "Game/WeaponDefinition.hpp"
@@ -212,6 +213,7 @@ ActorDefinition::ActorDefinition(XmlElement const* element)
 			if (m_texture)
 			{
 				m_spriteSheet = new SpriteSheet(m_texture, m_spriteSheetCellCount);
+				TrackAllocation(AllocationCategory::DEFINITIONS, sizeof(SpriteSheet));
 			}
 
 			XmlElement const* animationGroupElement = visualsElement->FirstChildElement("AnimationGroup");
@@ -219,6 +221,8 @@ ActorDefinition::ActorDefinition(XmlElement const* element)
 			{
 				AnimationGroupDefinition animationGroup = AnimationGroupDefinition(animationGroupElement, m_spriteSheet);
 				m_animations.push_back(animationGroup);
+				m_spriteTables.push_back(new DirectionalSpriteTable(animationGroupElement, m_spriteSheet));
+				TrackAllocation(AllocationCategory::DEFINITIONS, sizeof(DirectionalSpriteTable));
 				animationGroupElement = animationGroupElement->NextSiblingElement();
 			}
 		}
@@ -273,3 +277,21 @@ AnimationGroupDefinition ActorDefinition::GetAnimationGroupByName(std::string an
 
 	return m_animations[0];
 }
+
+DirectionalSpriteTable const* ActorDefinition::GetSpriteTableByName(std::string const& animationGroupName) const
+{
+	if (m_spriteTables.empty())
+	{
+		return nullptr;
+	}
+
+	for (int tableIndex = 0; tableIndex < (int)m_spriteTables.size(); tableIndex++)
+	{
+		if (!strcmp(animationGroupName.c_str(), m_spriteTables[tableIndex]->m_name.c_str()))
+		{
+			return m_spriteTables[tableIndex];
+		}
+	}
+
+	return m_spriteTables[0];
+}
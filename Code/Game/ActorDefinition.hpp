@@ -10,6 +10,8 @@
 #include "Engine/Renderer/Spritesheet.hpp"
 #include "Engine/Renderer/Texture.hpp"
 
+#include "Game/DirectionalSpriteTable.hpp"
+
 #include <map>
 #include <string>
 #include <vector>
@@ -72,6 +74,8 @@ public:
 	SpriteSheet*				m_spriteSheet = nullptr;
 	IntVec2						m_spriteSheetCellCount = IntVec2::ZERO;
 	std::vector<AnimationGroupDefinition> m_animations;
+	// Parallel to m_animations, shared by every actor copying this definition
+	std::vector<DirectionalSpriteTable*> m_spriteTables;
 	SoundID						m_hurtSound = MISSING_SOUND_ID;
 	SoundID						m_deathSound = MISSING_SOUND_ID;
 	SoundID						m_seeSound = MISSING_SOUND_ID;
@@ -105,6 +109,7 @@ public:
 	ActorDefinition() = default;
 	ActorDefinition(XmlElement const* element);
 	AnimationGroupDefinition GetAnimationGroupByName(std::string animationGroupName) const;
+	DirectionalSpriteTable const* GetSpriteTableByName(std::string const& animationGroupName) const;
 
 	static void					InitializeActorDefinitions();
 
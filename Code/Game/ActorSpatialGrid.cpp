@@ -0,0 +1,83 @@
+#include "Game/ActorSpatialGrid.hpp"
+
+#include "Game/Actor.hpp"
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+
+
+void ActorSpatialGrid::Rebuild(std::vector<Actor*> const& actors, IntVec2 const& mapDimensions, float cellSize)
+{
+	m_cellSize = cellSize;
+	m_gridDimensions = IntVec2(std::max(1, RoundDownToInt((float)mapDimensions.x / cellSize) + 1), std::max(1, RoundDownToInt((float)mapDimensions.y / cellSize) + 1));
+	m_numIndexedActors = (int)actors.size();
+
+	int numCells = m_gridDimensions.x * m_gridDimensions.y;
+	m_cellStartIndexes.assign(numCells + 1, 0);
+	m_actorCellIndexes.assign(m_numIndexedActors, -1);
+
+	// Count actors per cell, then prefix sum the counts into start offsets
+	for (int actorIndex = 0; actorIndex < m_numIndexedActors; actorIndex++)
+	{
+		Actor const* actor = actors[actorIndex];
+		if (!actor)
+		{
+			continue;
+		}
+
+		IntVec2 cellCoords = GetCellCoordsForPosition(actor->m_position.GetXY());
+		int cellIndex = cellCoords.x + cellCoords.y * m_gridDimensions.x;
+		m_actorCellIndexes[actorIndex] = cellIndex;
+		m_cellStartIndexes[cellIndex + 1]++;
+	}
+	for (int cellIndex = 0; cellIndex < numCells; cellIndex++)
+	{
+		m_cellStartIndexes[cellIndex + 1] += m_cellStartIndexes[cellIndex];
+	}
+
+	m_cellActorIndexes.resize(m_cellStartIndexes[numCells]);
+	// Kept as a member rather than taken from the frame arena, the grid is rebuilt on the simulation thread
+	m_cellWriteIndexes.assign(m_cellStartIndexes.begin(), m_cellStartIndexes.end() - 1);
+	for (int actorIndex = 0; actorIndex < m_numIndexedActors; actorIndex++)
+	{
+		int cellIndex = m_actorCellIndexes[actorIndex];
+		if (cellIndex < 0)
+		{
+			continue;
+		}
+		m_cellActorIndexes[m_cellWriteIndexes[cellIndex]] = actorIndex;
+		m_cellWriteIndexes[cellIndex]++;
+	}
+}
+
+void ActorSpatialGrid::GetActorIndexesNearDisc(Vec2 const& discCenter, float discRadius, std::vector<int>& out_actorIndexes) const
+{
+	if (m_gridDimensions.x <= 0 || m_gridDimensions.y <= 0)
+	{
+		return;
+	}
+
+	IntVec2 minCellCoords = GetCellCoordsForPosition(discCenter - Vec2(discRadius, discRadius));
+	IntVec2 maxCellCoords = GetCellCoordsForPosition(discCenter + Vec2(discRadius, discRadius));
+	for (int cellY = minCellCoords.y; cellY <= maxCellCoords.y; cellY++)
+	{
+		for (int cellX = minCellCoords.x; cellX <= maxCellCoords.x; cellX++)
+		{
+			int cellIndex = cellX + cellY * m_gridDimensions.x;
+			for (int cellActorIndex = m_cellStartIndexes[cellIndex]; cellActorIndex < m_cellStartIndexes[cellIndex + 1]; cellActorIndex++)
+			{
+				out_actorIndexes.push_back(m_cellActorIndexes[cellActorIndex]);
+			}
+		}
+	}
+}
+
+IntVec2 const ActorSpatialGrid::GetCellCoordsForPosition(Vec2 const& position) const
+{
+	// Positions outside the map are clamped into the border cells so nothing is ever dropped from the grid
+	int cellX = std::min(std::max(RoundDownToInt(position.x / m_cellSize), 0), m_gridDimensions.x - 1);
+	int cellY = std::min(std::max(RoundDownToInt(position.y / m_cellSize), 0), m_gridDimensions.y - 1);
+	return IntVec2(cellX, cellY);
+}
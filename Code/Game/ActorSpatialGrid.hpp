@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <vector>
+
+class Actor;
+
+// Uniform grid over the map's tiles holding indexes into the map's actor list
+// Rebuilt once per frame with a counting sort, so each cell's actors are contiguous in a single array
+class ActorSpatialGrid
+{
+public:
+	~ActorSpatialGrid() = default;
+	ActorSpatialGrid() = default;
+
+	void				Rebuild(std::vector<Actor*> const& actors, IntVec2 const& mapDimensions, float cellSize);
+	// Appends the indexes of actors in every cell overlapping the disc's bounds, exact overlap tests are left to the caller
+	void				GetActorIndexesNearDisc(Vec2 const& discCenter, float discRadius, std::vector<int>& out_actorIndexes) const;
+
+	int					GetNumIndexedActors() const { return m_numIndexedActors; }
+	IntVec2 const		GetCellCoordsForPosition(Vec2 const& position) const;
+
+private:
+	float				m_cellSize = 1.f;
+	IntVec2				m_gridDimensions = IntVec2(0, 0);
+	int					m_numIndexedActors = 0;
+	std::vector<int>	m_cellStartIndexes;
+	std::vector<int>	m_cellActorIndexes;
+	std::vector<int>	m_actorCellIndexes;
+	std::vector<int>	m_cellWriteIndexes;
+};
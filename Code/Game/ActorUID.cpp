@@ -18,6 +18,11 @@ unsigned int ActorUID::GetIndex() const
 	return m_data & INDEX_BITFIELD;
 }
 
+unsigned int ActorUID::GetData() const
+{
+	return m_data;
+}
+
 bool ActorUID::operator==(ActorUID const& otherUID) const
 {
 	return m_data == otherUID.m_data;
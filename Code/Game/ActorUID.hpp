@@ -9,6 +9,8 @@ public:
 
 	bool IsValid() const;
 	unsigned int GetIndex() const;
+	// Salt and index together, unique among live actors
+	unsigned int GetData() const;
 	bool operator==(ActorUID const& otherUID) const;
 	bool operator!=(ActorUID const& otherUID) const;
 
@@ -0,0 +1,73 @@
+#include "Game/AllocationTracker.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+
+static AllocationCategoryStats s_allocationStats[(int)AllocationCategory::COUNT];
+
+static char const* const s_allocationCategoryNames[(int)AllocationCategory::COUNT] =
+{
+	"Actors",
+	"Particles",
+	"Weapons",
+	"Controllers",
+	"Definitions",
+	"GPU buffers"
+};
+
+void TrackAllocation(AllocationCategory category, size_t numBytes)
+{
+	AllocationCategoryStats& stats = s_allocationStats[(int)category];
+	stats.m_numLiveAllocations++;
+	stats.m_numAllocations++;
+	stats.m_liveBytes += numBytes;
+	stats.m_peakBytes = stats.m_liveBytes > stats.m_peakBytes ? stats.m_liveBytes : stats.m_peakBytes;
+}
+
+void TrackFree(AllocationCategory category, size_t numBytes)
+{
+	AllocationCategoryStats& stats = s_allocationStats[(int)category];
+	stats.m_numLiveAllocations--;
+	stats.m_numFrees++;
+	stats.m_liveBytes = numBytes < stats.m_liveBytes ? stats.m_liveBytes - numBytes : 0;
+}
+
+AllocationCategoryStats const& GetAllocationStats(AllocationCategory category)
+{
+	return s_allocationStats[(int)category];
+}
+
+char const* GetAllocationCategoryName(AllocationCategory category)
+{
+	return s_allocationCategoryNames[(int)category];
+}
+
+AllocationSnapshot TakeAllocationSnapshot()
+{
+	AllocationSnapshot snapshot;
+	for (int categoryIndex = 0; categoryIndex < (int)AllocationCategory::COUNT; categoryIndex++)
+	{
+		snapshot.m_numLiveAllocations[categoryIndex] = s_allocationStats[categoryIndex].m_numLiveAllocations;
+		snapshot.m_liveBytes[categoryIndex] = s_allocationStats[categoryIndex].m_liveBytes;
+	}
+	return snapshot;
+}
+
+int ReportAllocationLeaks(AllocationSnapshot const& snapshot, char const* label)
+{
+	int numLeaked = 0;
+	for (int categoryIndex = 0; categoryIndex < (int)AllocationCategory::COUNT; categoryIndex++)
+	{
+		AllocationCategoryStats const& stats = s_allocationStats[categoryIndex];
+		int numCategoryLeaked = stats.m_numLiveAllocations - snapshot.m_numLiveAllocations[categoryIndex];
+		if (numCategoryLeaked <= 0)
+		{
+			continue;
+		}
+
+		size_t leakedBytes = stats.m_liveBytes > snapshot.m_liveBytes[categoryIndex] ? stats.m_liveBytes - snapshot.m_liveBytes[categoryIndex] : 0;
+		DebuggerPrintf("%s: %d %s allocations (%d bytes) still live\n", label, numCategoryLeaked, s_allocationCategoryNames[categoryIndex], (int)leakedBytes);
+		numLeaked += numCategoryLeaked;
+	}
+	return numLeaked;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+enum class AllocationCategory
+{
+	ACTORS,
+	PARTICLES,
+	WEAPONS,
+	CONTROLLERS,
+	DEFINITIONS,
+	GPU_BUFFERS,
+	COUNT
+};
+
+struct AllocationCategoryStats
+{
+public:
+	int			m_numLiveAllocations = 0;
+	size_t		m_liveBytes = 0;
+	size_t		m_peakBytes = 0;
+	int			m_numAllocations = 0;
+	int			m_numFrees = 0;
+};
+
+struct AllocationSnapshot
+{
+public:
+	int			m_numLiveAllocations[(int)AllocationCategory::COUNT] = {};
+	size_t		m_liveBytes[(int)AllocationCategory::COUNT] = {};
+};
+
+// Counts game object allocations per subsystem, so ownership leaks show up as live counts that never come back down
+// Game classes route their operator new and delete through here, and engine objects the game owns (GPU buffers, sprite sheets) are tracked where they are created and freed
+void								TrackAllocation(AllocationCategory category, size_t numBytes);
+void								TrackFree(AllocationCategory category, size_t numBytes);
+
+AllocationCategoryStats const&		GetAllocationStats(AllocationCategory category);
+char const*							GetAllocationCategoryName(AllocationCategory category);
+
+AllocationSnapshot					TakeAllocationSnapshot();
+// Prints every category holding more live allocations than it did at the snapshot and returns the total number leaked
+int									ReportAllocationLeaks(AllocationSnapshot const& snapshot, char const* label);
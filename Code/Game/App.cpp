@@ -1,6 +1,12 @@
 #include "Game/App.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/AudioBackend.hpp"
+#include "Game/CounterRNG.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/FramePacer.hpp"
+#include "Game/GeometryCache.hpp"
+#include "Game/VoiceManager.hpp"
 
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Clock.hpp"
@@ -8,7 +14,6 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Window.hpp"
@@ -17,11 +22,15 @@
 
 App* g_app = nullptr;
 AudioSystem* g_audio = nullptr;
-RandomNumberGenerator* g_RNG = nullptr;
+RandomStreams* g_randomStreams = nullptr;
 Renderer* g_renderer = nullptr;
 Window* g_window = nullptr;
 BitmapFont* g_squirrelFont = nullptr;
 ModelLoader* g_modelLoader = nullptr;
+GeometryCache* g_geometryCache = nullptr;
+VoiceManager* g_voiceManager = nullptr;
+FrameArena* g_frameArena = nullptr;
+FramePacer* g_framePacer = nullptr;
 
 bool App::HandleQuitRequested(EventArgs& args)
 {
@@ -92,7 +101,7 @@ Camera const App::GetCurrentCamera() const
 void App::InitializeCameras()
 {
 	m_worldCamera.SetRenderBasis(Vec3::SKYWARD, Vec3::WEST, Vec3::NORTH);
-	m_worldCamera.SetPerspectiveView(g_window->GetAspect(), 60.f, 0.1f, 1000.f);
+	m_worldCamera.SetPerspectiveView(g_window->GetAspect(), WORLD_CAMERA_FOV_DEGREES, WORLD_CAMERA_NEAR, WORLD_CAMERA_FAR);
 	m_worldCamera.SetTransform(Vec3::ZERO, EulerAngles::ZERO);
 
 	m_screenCamera.SetOrthoView(Vec2::ZERO, Vec2(g_screenSizeY * g_window->GetAspect(), g_screenSizeY));
@@ -110,6 +119,15 @@ App::App()
 
 App::~App()
 {
+	delete g_voiceManager;
+	g_voiceManager = nullptr;
+
+	delete g_frameArena;
+	g_frameArena = nullptr;
+
+	delete g_framePacer;
+	g_framePacer = nullptr;
+
 	delete g_renderer;
 	g_renderer = nullptr;
 
@@ -119,11 +137,8 @@ App::~App()
 	delete g_audio;
 	g_audio = nullptr;
 
-	delete g_RNG;
-	g_RNG = nullptr;
-
-	delete m_game;
-	m_game = nullptr;
+	delete g_randomStreams;
+	g_randomStreams = nullptr;
 }
 
 void App::Startup()
@@ -178,17 +193,84 @@ void App::Startup()
 	g_modelLoader->Startup();
 	g_openXR->Startup();
 
+	g_randomStreams = new RandomStreams((unsigned int)g_gameConfigBlackboard.GetValue("worldSeed", 0));
+	g_geometryCache = new GeometryCache();
+	g_voiceManager = new VoiceManager(new EngineAudioBackend(), g_gameConfigBlackboard.GetValue("maxAudioVoices", 32), g_gameConfigBlackboard.GetValue("maxAudioInstancesPerSound", 4), g_gameConfigBlackboard.GetValue("maxAudibleDistance", 40.f));
+	g_frameArena = new FrameArena((size_t)g_gameConfigBlackboard.GetValue("frameArenaBytes", 256 * 1024));
+	// The OpenXR runtime already paces frames to the headset, so the pacer only runs for the desktop
+	float targetFrameRate = g_openXR->IsInitialized() ? 0.f : g_gameConfigBlackboard.GetValue("targetFrameRate", 0.f);
+	g_framePacer = new FramePacer(targetFrameRate, g_gameConfigBlackboard.GetValue("adaptiveFramePacing", false));
+
 	InitializeCameras();
 
 	m_game = new Game();
 
 	SubscribeEventCallbackFunction("Quit", HandleQuitRequested, "Exits the application");
 	SubscribeEventCallbackFunction("Controls", ShowControls, "Shows game controls");
+	SubscribeEventCallbackFunction("FramePacer", Event_FramePacer, "Sets the frame rate limit and prints frame time statistics");
 
 	EventArgs emptyArgs;
 	ShowControls(emptyArgs);
 }
 
+bool App::Event_FramePacer(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Sets the frame rate limit and prints frame time statistics", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float] target frames per second, 0 runs unpaced", "rate"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [bool] drop to a fraction of the rate while deadlines are missed", "adaptive"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [bool] clears the statistics after printing them", "reset"), false);
+		return true;
+	}
+
+	float targetFrameRate = args.GetValue("rate", -1.f);
+	if (targetFrameRate >= 0.f)
+	{
+		g_framePacer->SetTargetFrameRate(targetFrameRate);
+	}
+	bool isAdaptive = args.GetValue("adaptive", g_framePacer->IsAdaptive());
+	if (isAdaptive != g_framePacer->IsAdaptive())
+	{
+		g_framePacer->SetAdaptive(isAdaptive);
+	}
+
+	FramePacerStats const& stats = g_framePacer->GetStats();
+	int numFrames = stats.m_numFrames > 0 ? stats.m_numFrames : 1;
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Frame Pacer (target %.1f fps, running %.1f fps%s)", g_framePacer->GetTargetFrameRate(), g_framePacer->GetEffectiveFrameRate(), g_framePacer->IsAdaptive() ? ", adaptive" : ""), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d missed deadlines)", "Frames", stats.m_numFrames, stats.m_numMissedDeadlines), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f / %.3f / %.3f ms", "Frame time min/avg/max", stats.m_minFrameSeconds * 1000.0, stats.m_totalFrameSeconds / numFrames * 1000.0, stats.m_maxFrameSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.0f / %.0f / %.0f ms", "Frame time p50/p95/p99", stats.GetFrameTimePercentile(0.5f) * 1000.0, stats.GetFrameTimePercentile(0.95f) * 1000.0, stats.GetFrameTimePercentile(0.99f) * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms sleeping, %.3f ms spinning", "Wait per frame", stats.m_totalSleepSeconds / numFrames * 1000.0, stats.m_totalSpinSeconds / numFrames * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Sleep margin", g_framePacer->GetSleepMarginSeconds() * 1000.0), false);
+
+	// Histogram rows only for buckets that saw frames, with a bar scaled to the fullest bucket
+	int maxBucketCount = 1;
+	for (int bucketIndex = 0; bucketIndex < FRAME_HISTOGRAM_BUCKETS; bucketIndex++)
+	{
+		maxBucketCount = stats.m_frameTimeHistogram[bucketIndex] > maxBucketCount ? stats.m_frameTimeHistogram[bucketIndex] : maxBucketCount;
+	}
+	for (int bucketIndex = 0; bucketIndex < FRAME_HISTOGRAM_BUCKETS; bucketIndex++)
+	{
+		int bucketCount = stats.m_frameTimeHistogram[bucketIndex];
+		if (bucketCount == 0)
+		{
+			continue;
+		}
+		std::string bar(1 + bucketCount * 40 / maxBucketCount, '#');
+		std::string bucketLabel = bucketIndex == FRAME_HISTOGRAM_BUCKETS - 1 ? Stringf("%d+ ms", bucketIndex) : Stringf("%d-%d ms", bucketIndex, bucketIndex + 1);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %6d %s", bucketLabel.c_str(), bucketCount, bar.c_str()), false);
+	}
+
+	if (args.GetValue("reset", false))
+	{
+		g_framePacer->ResetStats();
+	}
+	return true;
+}
+
 void App::LoadGameConfigXml()
 {
 	g_gameConfigBlackboard = NamedStrings();
@@ -214,6 +296,7 @@ void App::Run()
 	while (!IsQuitting())
 	{
 		RunFrame();
+		g_framePacer->WaitForNextFrame();
 	}
 }
 
@@ -223,6 +306,10 @@ void App::RunFrame()
 
 	Update();
 
+	// The next simulation step overlaps rendering of the snapshot the last frame published
+	m_game->StartSimulation();
+	m_game->AcquireRenderSnapshot();
+
 	m_currentEye = XREye::NONE;
 	g_renderer->BeginRenderForEye(XREye::NONE);
 
@@ -240,6 +327,7 @@ void App::RunFrame()
 	if (g_openXR->IsInitialized())
 	{
 		m_currentEye = XREye::LEFT;
+		m_game->LateLatchPoses();
 		g_renderer->BeginRenderForEye(XREye::LEFT);
 		g_renderer->BeginRenderEvent("HMD Left Eye");
 		g_renderer->ClearScreen(Rgba8::BLACK);
@@ -247,6 +335,7 @@ void App::RunFrame()
 		g_renderer->EndRenderEvent("HMD Left Eye");
 
 		m_currentEye = XREye::RIGHT;
+		m_game->LateLatchPoses();
 		g_renderer->BeginRenderForEye(XREye::RIGHT);
 		g_renderer->BeginRenderEvent("HMD Right Eye");
 		g_renderer->ClearScreen(Rgba8::BLACK);
@@ -254,6 +343,10 @@ void App::RunFrame()
 		g_renderer->EndRenderEvent("HMD Right Eye");
 	}
 
+	m_game->FinishSimulation();
+	// Scene is traversed once per step and the render list is replayed for every view of the next frame
+	m_game->BuildRenderList();
+
 	EndFrame();
 
 }
@@ -280,6 +373,8 @@ void App::BeginFrame()
 	DebugRenderBeginFrame();
 	g_modelLoader->BeginFrame();
 	g_openXR->BeginFrame();
+	g_geometryCache->BeginFrame();
+	g_frameArena->Reset();
 }
 
 void App::Update()
@@ -313,7 +408,7 @@ void App::Update()
 		g_input->SetCursorMode(true, true);
 	}
 
-	DebugAddScreenText(Stringf("[System Clock]\t\tTime: %.2f, Frames per Seconds: %.2f, Scale: %.2f", Clock::GetSystemClock().GetTotalSeconds(), m_frameRate, Clock::GetSystemClock().GetTimeScale()), Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX) - 16.f, g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY) - 16.f), 16.f, Vec2(1.f, 1.f), 0.f);
+	g_geometryCache->AddScreenText("App::SystemClock", g_frameArena->Format("[System Clock]\t\tTime: %.2f, Frames per Seconds: %.2f, Scale: %.2f", Clock::GetSystemClock().GetTotalSeconds(), m_frameRate, Clock::GetSystemClock().GetTimeScale()), Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX) - 16.f, g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY) - 16.f), 16.f, Vec2(1.f, 1.f));
 }
 
 void App::Render() const
@@ -365,6 +460,7 @@ void App::RenderScreen() const
 
 	g_renderer->BeginCamera(m_screenCamera);
 	m_game->RenderScreen();
+	g_geometryCache->RenderScreenText(g_squirrelFont, AABB2(Vec2::ZERO, Vec2(g_screenSizeX, g_screenSizeY)));
 	g_renderer->EndCamera(m_screenCamera);
 
 	DebugRenderScreen(m_screenCamera);
@@ -398,6 +494,14 @@ void App::EndFrame()
 
 void App::Shutdown()
 {
+	// The game owns maps full of GPU buffers and clocks, so it goes before the systems they belong to
+	delete m_game;
+	m_game = nullptr;
+
+	// Cached meshes and screen text hold vertex and index buffers, which must be released while the device is still alive
+	delete g_geometryCache;
+	g_geometryCache = nullptr;
+
 	g_openXR->Shutdown();
 	g_modelLoader->Shutdown();
 	DebugRenderSystemShutdown();
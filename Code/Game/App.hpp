@@ -19,6 +19,7 @@ public:
 	bool				HandleQuitRequested			();
 	static bool			HandleQuitRequested			(EventArgs& args);
 	static bool			ShowControls				(EventArgs& args);
+	static bool			Event_FramePacer			(EventArgs& args);
 
 	// VR Integration
 	XREye				GetCurrentEye() const;
@@ -0,0 +1,91 @@
+#include "Game/AudioBackend.hpp"
+
+#include "Game/GameCommon.hpp"
+
+
+SoundPlaybackID EngineAudioBackend::StartSoundAt(SoundID soundID, Vec3 const& position)
+{
+	return g_audio->StartSoundAt(soundID, position);
+}
+
+bool EngineAudioBackend::IsPlaying(SoundPlaybackID playbackID)
+{
+	return g_audio->IsPlaying(playbackID);
+}
+
+void EngineAudioBackend::SetSoundPosition(SoundPlaybackID playbackID, Vec3 const& position)
+{
+	g_audio->SetSoundPosition(playbackID, position);
+}
+
+void EngineAudioBackend::StopSound(SoundPlaybackID playbackID)
+{
+	g_audio->StopSound(playbackID);
+}
+
+StubAudioBackend::StubAudioBackend(float voiceDurationSeconds)
+	: m_voiceDurationSeconds(voiceDurationSeconds)
+{
+}
+
+SoundPlaybackID StubAudioBackend::StartSoundAt(SoundID soundID, Vec3 const& position)
+{
+	UNUSED(soundID);
+	UNUSED(position);
+
+	StubVoice voice;
+	voice.m_playbackID = m_nextPlaybackID;
+	voice.m_endSeconds = m_currentSeconds + m_voiceDurationSeconds;
+	m_playingVoices.push_back(voice);
+	m_nextPlaybackID++;
+
+	m_numStarts++;
+	m_numPeakPlayingVoices = (int)m_playingVoices.size() > m_numPeakPlayingVoices ? (int)m_playingVoices.size() : m_numPeakPlayingVoices;
+	return voice.m_playbackID;
+}
+
+bool StubAudioBackend::IsPlaying(SoundPlaybackID playbackID)
+{
+	for (int voiceIndex = 0; voiceIndex < (int)m_playingVoices.size(); voiceIndex++)
+	{
+		if (m_playingVoices[voiceIndex].m_playbackID == playbackID)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void StubAudioBackend::SetSoundPosition(SoundPlaybackID playbackID, Vec3 const& position)
+{
+	UNUSED(playbackID);
+	UNUSED(position);
+
+	m_numPositionUpdates++;
+}
+
+void StubAudioBackend::StopSound(SoundPlaybackID playbackID)
+{
+	for (int voiceIndex = 0; voiceIndex < (int)m_playingVoices.size(); voiceIndex++)
+	{
+		if (m_playingVoices[voiceIndex].m_playbackID == playbackID)
+		{
+			m_playingVoices.erase(m_playingVoices.begin() + voiceIndex);
+			m_numStops++;
+			return;
+		}
+	}
+}
+
+void StubAudioBackend::AdvanceTime(float deltaSeconds)
+{
+	m_currentSeconds += deltaSeconds;
+	for (int voiceIndex = 0; voiceIndex < (int)m_playingVoices.size(); voiceIndex++)
+	{
+		if (m_playingVoices[voiceIndex].m_endSeconds <= m_currentSeconds)
+		{
+			m_playingVoices.erase(m_playingVoices.begin() + voiceIndex);
+			voiceIndex--;
+		}
+	}
+}
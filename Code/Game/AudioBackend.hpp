@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <vector>
+
+// The handful of audio calls the voice manager makes, so it can run against the engine or a stub with no device
+class AudioBackend
+{
+public:
+	virtual ~AudioBackend() = default;
+
+	virtual SoundPlaybackID		StartSoundAt(SoundID soundID, Vec3 const& position) = 0;
+	virtual bool				IsPlaying(SoundPlaybackID playbackID) = 0;
+	virtual void				SetSoundPosition(SoundPlaybackID playbackID, Vec3 const& position) = 0;
+	virtual void				StopSound(SoundPlaybackID playbackID) = 0;
+};
+
+class EngineAudioBackend : public AudioBackend
+{
+public:
+	virtual SoundPlaybackID		StartSoundAt(SoundID soundID, Vec3 const& position) override;
+	virtual bool				IsPlaying(SoundPlaybackID playbackID) override;
+	virtual void				SetSoundPosition(SoundPlaybackID playbackID, Vec3 const& position) override;
+	virtual void				StopSound(SoundPlaybackID playbackID) override;
+};
+
+// Plays nothing, every sound simply lasts a fixed time which is advanced by hand, and every call is counted
+class StubAudioBackend : public AudioBackend
+{
+public:
+	explicit StubAudioBackend(float voiceDurationSeconds);
+
+	virtual SoundPlaybackID		StartSoundAt(SoundID soundID, Vec3 const& position) override;
+	virtual bool				IsPlaying(SoundPlaybackID playbackID) override;
+	virtual void				SetSoundPosition(SoundPlaybackID playbackID, Vec3 const& position) override;
+	virtual void				StopSound(SoundPlaybackID playbackID) override;
+
+	void						AdvanceTime(float deltaSeconds);
+	int							GetNumPlayingVoices() const { return (int)m_playingVoices.size(); }
+
+public:
+	int							m_numStarts = 0;
+	int							m_numStops = 0;
+	int							m_numPositionUpdates = 0;
+	int							m_numPeakPlayingVoices = 0;
+
+private:
+	struct StubVoice
+	{
+		SoundPlaybackID			m_playbackID = MISSING_SOUND_ID;
+		float					m_endSeconds = 0.f;
+	};
+
+	float						m_voiceDurationSeconds = 1.f;
+	float						m_currentSeconds = 0.f;
+	SoundPlaybackID				m_nextPlaybackID = 0;
+	std::vector<StubVoice>		m_playingVoices;
+};
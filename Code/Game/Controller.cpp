@@ -1,9 +1,22 @@
 #include "Game/Controller.hpp"
 
 #include "Game/Actor.hpp"
+#include "Game/AllocationTracker.hpp"
 #include "Game/Map.hpp"
 
 
+void* Controller::operator new(size_t numBytes)
+{
+	TrackAllocation(AllocationCategory::CONTROLLERS, numBytes);
+	return ::operator new(numBytes);
+}
+
+void Controller::operator delete(void* pointer, size_t numBytes)
+{
+	TrackFree(AllocationCategory::CONTROLLERS, numBytes);
+	::operator delete(pointer);
+}
+
 void Controller::Possess(Actor* actor)
 {
 	m_actorUID = actor->m_UID;
@@ -12,6 +12,9 @@ public:
 	virtual ~Controller() = default;
 	Controller() = default;
 
+	static void* operator new(size_t numBytes);
+	static void operator delete(void* pointer, size_t numBytes);
+
 	virtual void Update() = 0;
 	
 	Actor* GetActor() const;
@@ -19,6 +22,7 @@ public:
 	virtual void Unpossess(Actor* actor);
 
 	virtual bool IsPlayer() const = 0;
+	virtual bool HasTarget() const { return false; }
 	virtual void DamagedBy(Actor* actor) = 0;
 	virtual void KilledBy(Actor* actor) = 0;
 	virtual void Killed(Actor* actor) = 0;
@@ -0,0 +1,209 @@
+#include "Game/CounterRNG.hpp"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+
+#include <math.h>
+#include <thread>
+#include <vector>
+
+
+// SplitMix64 finalizer, spreads every input bit over the whole key
+static uint64_t MixKeyBits(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+unsigned int SquaresRandom32(uint64_t counter, uint64_t key)
+{
+	uint64_t x = counter * key;
+	uint64_t y = x;
+	uint64_t z = y + key;
+	x = x * x + y;
+	x = (x >> 32) | (x << 32);
+	x = x * x + z;
+	x = (x >> 32) | (x << 32);
+	x = x * x + y;
+	x = (x >> 32) | (x << 32);
+	return (unsigned int)((x * x + z) >> 32);
+}
+
+CounterRNG::CounterRNG(uint64_t key, uint64_t counter)
+	: m_key(key)
+	, m_counter(counter)
+{
+}
+
+unsigned int CounterRNG::RollRandomUnsignedInt()
+{
+	unsigned int result = SquaresRandom32(m_counter, m_key);
+	m_counter++;
+	return result;
+}
+
+float CounterRNG::RollRandomFloatZeroToOne()
+{
+	// The top 24 bits fill a float mantissa exactly
+	return (float)(RollRandomUnsignedInt() >> 8) * (1.f / 16777215.f);
+}
+
+float CounterRNG::RollRandomFloatInRange(float minInclusive, float maxInclusive)
+{
+	return minInclusive + (maxInclusive - minInclusive) * RollRandomFloatZeroToOne();
+}
+
+float CounterRNG::RollRandomFloatInRange(FloatRange const& range)
+{
+	return RollRandomFloatInRange(range.m_min, range.m_max);
+}
+
+int CounterRNG::RollRandomIntInRange(int minInclusive, int maxInclusive)
+{
+	// Multiply and shift instead of a modulo, the bias is below one part in four billion for any range used here
+	uint64_t rangeSize = (uint64_t)((int64_t)maxInclusive - (int64_t)minInclusive + 1);
+	return minInclusive + (int)(((uint64_t)RollRandomUnsignedInt() * rangeSize) >> 32);
+}
+
+bool CounterRNG::RollRandomChance(float probabilityOfReturningTrue)
+{
+	return RollRandomFloatZeroToOne() < probabilityOfReturningTrue;
+}
+
+Vec2 CounterRNG::RollRandomVec2InRadius(Vec2 const& center, float radius)
+{
+	float angleDegrees = RollRandomFloatInRange(0.f, 360.f);
+	float distance = radius * sqrtf(RollRandomFloatZeroToOne());
+	return center + Vec2::MakeFromPolarDegrees(angleDegrees, distance);
+}
+
+Vec3 CounterRNG::RollRandomVec3InRadius(Vec3 const& center, float radius)
+{
+	Vec3 offset;
+	do
+	{
+		offset = Vec3(RollRandomFloatInRange(-1.f, 1.f), RollRandomFloatInRange(-1.f, 1.f), RollRandomFloatInRange(-1.f, 1.f));
+	}
+	while (offset.GetLengthSquared() > 1.f);
+
+	return center + offset * radius;
+}
+
+Vec3 CounterRNG::RollRandomVec3InAABB3(AABB3 const& box)
+{
+	float x = RollRandomFloatInRange(box.m_mins.x, box.m_maxs.x);
+	float y = RollRandomFloatInRange(box.m_mins.y, box.m_maxs.y);
+	float z = RollRandomFloatInRange(box.m_mins.z, box.m_maxs.z);
+	return Vec3(x, y, z);
+}
+
+RandomStreams::RandomStreams(unsigned int worldSeed)
+	: m_worldSeed(worldSeed)
+{
+}
+
+void RandomStreams::SetWorldSeed(unsigned int worldSeed)
+{
+	m_worldSeed = worldSeed;
+}
+
+CounterRNG RandomStreams::GetRNG(RandomStream stream, unsigned int subject, unsigned int frameIndex, unsigned int channel) const
+{
+	uint64_t key = MixKeyBits(((uint64_t)m_worldSeed << 32) | (uint64_t)stream);
+	key = MixKeyBits(key ^ (((uint64_t)subject << 32) | (uint64_t)channel));
+	// Squares needs an odd key, the mixing already leaves the bits irregular
+	key |= 1;
+
+	// Each frame gets its own block of counters, so a subject can roll up to 2^32 times per frame without overlapping the next
+	return CounterRNG(key, (uint64_t)frameIndex << 32);
+}
+
+unsigned int GetRandomSubjectForName(char const* name)
+{
+	// FNV-1a
+	unsigned int hash = 2166136261u;
+	for (char const* character = name; *character != '\0'; character++)
+	{
+		hash = (hash ^ (unsigned char)*character) * 16777619u;
+	}
+	return hash;
+}
+
+RandomBenchmarkResults RunRandomBenchmark(int numRolls, int numSubjects, int rollsPerSubject, int numThreads)
+{
+	RandomBenchmarkResults results;
+	results.m_numRolls = numRolls;
+	results.m_numSubjects = numSubjects;
+	results.m_numThreads = numThreads;
+
+	RandomNumberGenerator engineRNG;
+	double engineSum = 0.0;
+	double startTime = GetCurrentTimeSeconds();
+	for (int rollIndex = 0; rollIndex < numRolls; rollIndex++)
+	{
+		engineSum += engineRNG.RollRandomFloatInRange(0.f, 1.f);
+	}
+	results.m_engineSeconds = GetCurrentTimeSeconds() - startTime;
+	results.m_engineMean = (float)(engineSum / (double)numRolls);
+
+	RandomStreams streams(0);
+	CounterRNG counterRNG = streams.GetRNG(RandomStream::BENCHMARK, 0);
+	double counterSum = 0.0;
+	startTime = GetCurrentTimeSeconds();
+	for (int rollIndex = 0; rollIndex < numRolls; rollIndex++)
+	{
+		counterSum += counterRNG.RollRandomFloatZeroToOne();
+	}
+	results.m_counterSeconds = GetCurrentTimeSeconds() - startTime;
+	results.m_counterMean = (float)(counterSum / (double)numRolls);
+
+	// Serial pass, each subject rolls from its own keyed generator for frame 1
+	std::vector<float> serialRolls((size_t)numSubjects * (size_t)rollsPerSubject);
+	startTime = GetCurrentTimeSeconds();
+	for (int subjectIndex = 0; subjectIndex < numSubjects; subjectIndex++)
+	{
+		CounterRNG subjectRNG = streams.GetRNG(RandomStream::BENCHMARK, subjectIndex, 1);
+		for (int rollIndex = 0; rollIndex < rollsPerSubject; rollIndex++)
+		{
+			serialRolls[(size_t)subjectIndex * rollsPerSubject + rollIndex] = subjectRNG.RollRandomFloatZeroToOne();
+		}
+	}
+	results.m_keyedSeconds = GetCurrentTimeSeconds() - startTime;
+
+	// Parallel pass over interleaved subjects, the order subjects are visited in must not matter
+	std::vector<float> parallelRolls(serialRolls.size());
+	std::vector<std::thread> threads;
+	startTime = GetCurrentTimeSeconds();
+	for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+	{
+		threads.emplace_back([&, threadIndex]()
+		{
+			for (int subjectIndex = numSubjects - 1 - threadIndex; subjectIndex >= 0; subjectIndex -= numThreads)
+			{
+				CounterRNG subjectRNG = streams.GetRNG(RandomStream::BENCHMARK, subjectIndex, 1);
+				for (int rollIndex = 0; rollIndex < rollsPerSubject; rollIndex++)
+				{
+					parallelRolls[(size_t)subjectIndex * rollsPerSubject + rollIndex] = subjectRNG.RollRandomFloatZeroToOne();
+				}
+			}
+		});
+	}
+	for (int threadIndex = 0; threadIndex < (int)threads.size(); threadIndex++)
+	{
+		threads[threadIndex].join();
+	}
+	results.m_parallelSeconds = GetCurrentTimeSeconds() - startTime;
+
+	for (int rollIndex = 0; rollIndex < (int)serialRolls.size(); rollIndex++)
+	{
+		if (serialRolls[rollIndex] != parallelRolls[rollIndex])
+		{
+			results.m_numParallelMismatches++;
+		}
+	}
+
+	return results;
+}
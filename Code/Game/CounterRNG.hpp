@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/FloatRange.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <stdint.h>
+
+// Independent sources of randomness, so rolls in one never shift the results of another (cosmetic particles cannot change a damage roll)
+enum class RandomStream
+{
+	MAP_GENERATION,
+	SPAWNING,
+	COMBAT,
+	PARTICLES,
+	BENCHMARK,
+	COUNT
+};
+
+// Squares counter-based generator (Widynski): the result is a pure function of the counter and key, four rounds of middle-square mixing
+unsigned int SquaresRandom32(uint64_t counter, uint64_t key);
+
+// A cheap value type holding a key and a counter, each roll hashes the counter and advances it
+// Nothing is shared between instances, so separate actors can roll on separate threads and still get the same results as a serial update
+class CounterRNG
+{
+public:
+	~CounterRNG() = default;
+	CounterRNG() = default;
+	explicit CounterRNG(uint64_t key, uint64_t counter = 0);
+
+	unsigned int	RollRandomUnsignedInt();
+	float			RollRandomFloatZeroToOne();
+	float			RollRandomFloatInRange(float minInclusive, float maxInclusive);
+	float			RollRandomFloatInRange(FloatRange const& range);
+	int				RollRandomIntInRange(int minInclusive, int maxInclusive);
+	bool			RollRandomChance(float probabilityOfReturningTrue);
+	Vec2			RollRandomVec2InRadius(Vec2 const& center, float radius);
+	Vec3			RollRandomVec3InRadius(Vec3 const& center, float radius);
+	Vec3			RollRandomVec3InAABB3(AABB3 const& box);
+
+public:
+	uint64_t		m_key = 0;
+	uint64_t		m_counter = 0;
+};
+
+// Hands out generators keyed by stream, subject (an actor UID, a map, a wave) and simulation frame
+// The same world seed and the same keys always produce the same rolls, regardless of update order or thread
+class RandomStreams
+{
+public:
+	~RandomStreams() = default;
+	explicit RandomStreams(unsigned int worldSeed);
+
+	void			SetWorldSeed(unsigned int worldSeed);
+	unsigned int	GetWorldSeed() const { return m_worldSeed; }
+
+	// The channel separates several rolls a subject makes in the same frame that must not repeat each other (two hands firing, one collision per other actor)
+	CounterRNG		GetRNG(RandomStream stream, unsigned int subject, unsigned int frameIndex = 0, unsigned int channel = 0) const;
+
+private:
+	unsigned int	m_worldSeed = 0;
+};
+
+// Stable subject for things identified by name, such as map definitions
+unsigned int GetRandomSubjectForName(char const* name);
+
+struct RandomBenchmarkResults
+{
+public:
+	int		m_numRolls = 0;
+	double	m_engineSeconds = 0.0;
+	double	m_counterSeconds = 0.0;
+	// A fresh keyed generator per subject, the way actors roll during an update
+	int		m_numSubjects = 0;
+	double	m_keyedSeconds = 0.0;
+	int		m_numThreads = 0;
+	double	m_parallelSeconds = 0.0;
+	int		m_numParallelMismatches = 0;
+	float	m_engineMean = 0.f;
+	float	m_counterMean = 0.f;
+};
+
+// Times float rolls from the engine generator against the counter generator, then repeats the keyed per-subject rolls across threads
+// and checks every thread produced exactly what the serial pass did
+RandomBenchmarkResults RunRandomBenchmark(int numRolls, int numSubjects, int rollsPerSubject, int numThreads);
@@ -0,0 +1,79 @@
+#include "Game/DirectionalSpriteTable.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Renderer/Spritesheet.hpp"
+
+#include <math.h>
+
+
+DirectionalSpriteTable::DirectionalSpriteTable(XmlElement const* animationGroupElement, SpriteSheet const* spriteSheet)
+{
+	m_name = ParseXmlAttribute(*animationGroupElement, "name", m_name);
+	m_secondsPerFrame = ParseXmlAttribute(*animationGroupElement, "secondsPerFrame", m_secondsPerFrame);
+	std::string playbackMode = ParseXmlAttribute(*animationGroupElement, "playbackMode", "Loop");
+	m_isLooping = !strcmp(playbackMode.c_str(), "Loop");
+
+	if (!spriteSheet)
+	{
+		return;
+	}
+
+	std::vector<Vec3> directions;
+	XmlElement const* directionElement = animationGroupElement->FirstChildElement("Direction");
+	while (directionElement)
+	{
+		XmlElement const* animationElement = directionElement->FirstChildElement("Animation");
+		if (animationElement)
+		{
+			int startFrame = ParseXmlAttribute(*animationElement, "startFrame", 0);
+			int endFrame = ParseXmlAttribute(*animationElement, "endFrame", startFrame);
+			directions.push_back(ParseXmlAttribute(*directionElement, "vector", Vec3::EAST).GetNormalized());
+			m_firstFrameIndexes.push_back((int)m_frameUVs.size());
+			m_numFrames.push_back(endFrame - startFrame + 1);
+			for (int frameIndex = startFrame; frameIndex <= endFrame; frameIndex++)
+			{
+				m_frameUVs.push_back(spriteSheet->GetSpriteUVs(frameIndex));
+			}
+		}
+		directionElement = directionElement->NextSiblingElement("Direction");
+	}
+
+	if ((int)directions.size() > 256)
+	{
+		ERROR_AND_DIE(Stringf("Animation group \"%s\" has more than 256 directions", m_name.c_str()));
+	}
+
+	// Each bin gets the direction closest to its center angle, the same choice GetAnimationForDirection makes
+	for (int binIndex = 0; binIndex < SPRITE_TABLE_ANGLE_BINS && !directions.empty(); binIndex++)
+	{
+		float binCenterDegrees = ((float)binIndex + 0.5f) * 360.f / (float)SPRITE_TABLE_ANGLE_BINS;
+		Vec3 binDirection = Vec3(CosDegrees(binCenterDegrees), SinDegrees(binCenterDegrees), 0.f);
+		int closestDirectionIndex = 0;
+		float closestDot = -FLT_MAX;
+		for (int directionIndex = 0; directionIndex < (int)directions.size(); directionIndex++)
+		{
+			float dot = DotProduct3D(binDirection, directions[directionIndex]);
+			if (dot > closestDot)
+			{
+				closestDot = dot;
+				closestDirectionIndex = directionIndex;
+			}
+		}
+		m_directionIndexByAngleBin[binIndex] = (unsigned char)closestDirectionIndex;
+	}
+}
+
+AABB2 const& DirectionalSpriteTable::GetUVs(float localViewingDegrees, float seconds) const
+{
+	int binIndex = (int)floorf(localViewingDegrees * (float)SPRITE_TABLE_ANGLE_BINS / 360.f) & (SPRITE_TABLE_ANGLE_BINS - 1);
+	int directionIndex = m_directionIndexByAngleBin[binIndex];
+
+	int numFrames = m_numFrames[directionIndex];
+	int frameIndex = seconds > 0.f ? (int)(seconds / m_secondsPerFrame) : 0;
+	frameIndex = m_isLooping ? frameIndex % numFrames : (frameIndex < numFrames ? frameIndex : numFrames - 1);
+
+	return m_frameUVs[m_firstFrameIndexes[directionIndex] + frameIndex];
+}
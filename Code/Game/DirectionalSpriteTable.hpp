@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Engine/Core/XMLUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
+
+#include <string>
+#include <vector>
+
+class SpriteSheet;
+
+// Resolution of the view angle lookup, a power of two so wrapped angles map to bins with a mask
+constexpr int SPRITE_TABLE_ANGLE_BINS = 256;
+
+// Sprite UVs for one animation group, built from the same XML as its AnimationGroupDefinition
+// The direction facing the viewer is baked per quantized view angle and every frame's UVs are stored up front,
+// so picking a billboard sprite is an angle bin lookup and a frame index instead of matching directions and copying sprite definitions
+class DirectionalSpriteTable
+{
+public:
+	~DirectionalSpriteTable() = default;
+	DirectionalSpriteTable() = default;
+	DirectionalSpriteTable(XmlElement const* animationGroupElement, SpriteSheet const* spriteSheet);
+
+	// View angle is the yaw of the camera-to-sprite direction relative to the sprite's own yaw
+	AABB2 const&		GetUVs(float localViewingDegrees, float seconds) const;
+	bool				IsEmpty() const { return m_frameUVs.empty(); }
+
+public:
+	std::string			m_name = "";
+
+private:
+	float				m_secondsPerFrame = 1.f;
+	bool				m_isLooping = false;
+	unsigned char		m_directionIndexByAngleBin[SPRITE_TABLE_ANGLE_BINS] = {};
+	std::vector<int>	m_firstFrameIndexes;
+	std::vector<int>	m_numFrames;
+	std::vector<AABB2>	m_frameUVs;
+};
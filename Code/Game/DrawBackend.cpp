@@ -0,0 +1,185 @@
+#include "Game/DrawBackend.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/GeometryCache.hpp"
+
+
+RendererDrawBackend RendererDrawBackend::s_instance;
+
+void RendererDrawBackend::SetBlendMode(BlendMode blendMode)
+{
+	g_renderer->SetBlendMode(blendMode);
+}
+
+void RendererDrawBackend::SetDepthMode(DepthMode depthMode)
+{
+	g_renderer->SetDepthMode(depthMode);
+}
+
+void RendererDrawBackend::SetRasterizerCullMode(RasterizerCullMode cullMode)
+{
+	g_renderer->SetRasterizerCullMode(cullMode);
+}
+
+void RendererDrawBackend::SetRasterizerFillMode(RasterizerFillMode fillMode)
+{
+	g_renderer->SetRasterizerFillMode(fillMode);
+}
+
+void RendererDrawBackend::SetSamplerMode(SamplerMode samplerMode)
+{
+	g_renderer->SetSamplerMode(samplerMode);
+}
+
+void RendererDrawBackend::BindShader(Shader* shader)
+{
+	g_renderer->BindShader(shader);
+}
+
+void RendererDrawBackend::BindTexture(Texture* texture)
+{
+	g_renderer->BindTexture(texture);
+}
+
+void RendererDrawBackend::SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& tint)
+{
+	g_renderer->SetModelConstants(modelMatrix, tint);
+}
+
+void RendererDrawBackend::DrawIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount)
+{
+	g_renderer->DrawIndexBuffer(vertexBuffer, indexBuffer, indexCount);
+}
+
+void RendererDrawBackend::DrawVertexArray(std::vector<Vertex_PCU> const& vertexes)
+{
+	g_geometryCache->DrawDynamicVertexArray(vertexes);
+}
+
+void RendererDrawBackend::DrawVertexArray(std::vector<Vertex_PCUTBN> const& vertexes)
+{
+	g_renderer->DrawVertexArray(vertexes);
+	g_geometryCache->RecordDynamicUpload(vertexes.size() * sizeof(Vertex_PCUTBN));
+}
+
+void RecordingDrawBackend::SetBlendMode(BlendMode blendMode)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::SET_BLEND_MODE;
+	command.m_value = (int)blendMode;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::SetDepthMode(DepthMode depthMode)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::SET_DEPTH_MODE;
+	command.m_value = (int)depthMode;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::SetRasterizerCullMode(RasterizerCullMode cullMode)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::SET_CULL_MODE;
+	command.m_value = (int)cullMode;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::SetRasterizerFillMode(RasterizerFillMode fillMode)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::SET_FILL_MODE;
+	command.m_value = (int)fillMode;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::SetSamplerMode(SamplerMode samplerMode)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::SET_SAMPLER_MODE;
+	command.m_value = (int)samplerMode;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::BindShader(Shader* shader)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::BIND_SHADER;
+	command.m_pointer = shader;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::BindTexture(Texture* texture)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::BIND_TEXTURE;
+	command.m_pointer = texture;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& tint)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::SET_MODEL_CONSTANTS;
+	command.m_modelMatrix = modelMatrix;
+	command.m_tint = tint;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::DrawIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount)
+{
+	UNUSED(indexBuffer);
+
+	DrawCommand command;
+	command.m_type = DrawCommandType::DRAW_INDEXED;
+	command.m_pointer = vertexBuffer;
+	command.m_count = indexCount;
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::DrawVertexArray(std::vector<Vertex_PCU> const& vertexes)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::DRAW_VERTEX_ARRAY;
+	command.m_pointer = vertexes.data();
+	command.m_count = (int)vertexes.size();
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::DrawVertexArray(std::vector<Vertex_PCUTBN> const& vertexes)
+{
+	DrawCommand command;
+	command.m_type = DrawCommandType::DRAW_VERTEX_ARRAY;
+	command.m_pointer = vertexes.data();
+	command.m_count = (int)vertexes.size();
+	m_commands.push_back(command);
+}
+
+void RecordingDrawBackend::Clear()
+{
+	m_commands.clear();
+}
+
+int RecordingDrawBackend::GetNumCommandsOfType(DrawCommandType type) const
+{
+	int numCommands = 0;
+	for (int commandIndex = 0; commandIndex < (int)m_commands.size(); commandIndex++)
+	{
+		if (m_commands[commandIndex].m_type == type)
+		{
+			numCommands++;
+		}
+	}
+	return numCommands;
+}
+
+int RecordingDrawBackend::GetNumStateCommands() const
+{
+	return (int)m_commands.size() - GetNumDrawCommands() - GetNumCommandsOfType(DrawCommandType::SET_MODEL_CONSTANTS);
+}
+
+int RecordingDrawBackend::GetNumDrawCommands() const
+{
+	return GetNumCommandsOfType(DrawCommandType::DRAW_INDEXED) + GetNumCommandsOfType(DrawCommandType::DRAW_VERTEX_ARRAY);
+}
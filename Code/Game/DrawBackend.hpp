@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <vector>
+
+class IndexBuffer;
+class Shader;
+class Texture;
+class VertexBuffer;
+
+// Everything a RenderList needs from a renderer, so the same list can be replayed into the real renderer or recorded for inspection
+class DrawBackend
+{
+public:
+	virtual ~DrawBackend() = default;
+
+	virtual void SetBlendMode(BlendMode blendMode) = 0;
+	virtual void SetDepthMode(DepthMode depthMode) = 0;
+	virtual void SetRasterizerCullMode(RasterizerCullMode cullMode) = 0;
+	virtual void SetRasterizerFillMode(RasterizerFillMode fillMode) = 0;
+	virtual void SetSamplerMode(SamplerMode samplerMode) = 0;
+	virtual void BindShader(Shader* shader) = 0;
+	virtual void BindTexture(Texture* texture) = 0;
+	virtual void SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& tint) = 0;
+	virtual void DrawIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount) = 0;
+	virtual void DrawVertexArray(std::vector<Vertex_PCU> const& vertexes) = 0;
+	virtual void DrawVertexArray(std::vector<Vertex_PCUTBN> const& vertexes) = 0;
+};
+
+class RendererDrawBackend : public DrawBackend
+{
+public:
+	virtual void SetBlendMode(BlendMode blendMode) override;
+	virtual void SetDepthMode(DepthMode depthMode) override;
+	virtual void SetRasterizerCullMode(RasterizerCullMode cullMode) override;
+	virtual void SetRasterizerFillMode(RasterizerFillMode fillMode) override;
+	virtual void SetSamplerMode(SamplerMode samplerMode) override;
+	virtual void BindShader(Shader* shader) override;
+	virtual void BindTexture(Texture* texture) override;
+	virtual void SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& tint) override;
+	virtual void DrawIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount) override;
+	virtual void DrawVertexArray(std::vector<Vertex_PCU> const& vertexes) override;
+	virtual void DrawVertexArray(std::vector<Vertex_PCUTBN> const& vertexes) override;
+
+public:
+	static RendererDrawBackend s_instance;
+};
+
+enum class DrawCommandType
+{
+	SET_BLEND_MODE,
+	SET_DEPTH_MODE,
+	SET_CULL_MODE,
+	SET_FILL_MODE,
+	SET_SAMPLER_MODE,
+	BIND_SHADER,
+	BIND_TEXTURE,
+	SET_MODEL_CONSTANTS,
+	DRAW_INDEXED,
+	DRAW_VERTEX_ARRAY
+};
+
+struct DrawCommand
+{
+public:
+	DrawCommandType		m_type = DrawCommandType::DRAW_INDEXED;
+	int					m_value = 0;
+	void const*			m_pointer = nullptr;
+	int					m_count = 0;
+	// Only set by SET_MODEL_CONSTANTS
+	Mat44				m_modelMatrix = Mat44::IDENTITY;
+	Rgba8				m_tint = Rgba8::WHITE;
+};
+
+// Records the command stream instead of drawing it, for checking sort order and state filtering without a device
+class RecordingDrawBackend : public DrawBackend
+{
+public:
+	virtual void SetBlendMode(BlendMode blendMode) override;
+	virtual void SetDepthMode(DepthMode depthMode) override;
+	virtual void SetRasterizerCullMode(RasterizerCullMode cullMode) override;
+	virtual void SetRasterizerFillMode(RasterizerFillMode fillMode) override;
+	virtual void SetSamplerMode(SamplerMode samplerMode) override;
+	virtual void BindShader(Shader* shader) override;
+	virtual void BindTexture(Texture* texture) override;
+	virtual void SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& tint) override;
+	virtual void DrawIndexBuffer(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount) override;
+	virtual void DrawVertexArray(std::vector<Vertex_PCU> const& vertexes) override;
+	virtual void DrawVertexArray(std::vector<Vertex_PCUTBN> const& vertexes) override;
+
+	void Clear();
+	int GetNumCommandsOfType(DrawCommandType type) const;
+	int GetNumStateCommands() const;
+	int GetNumDrawCommands() const;
+
+public:
+	std::vector<DrawCommand> m_commands;
+};
@@ -0,0 +1,187 @@
+#include "Game/FlowField.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+
+constexpr int NUM_NEIGHBORS = 8;
+constexpr int NEIGHBOR_OFFSETS_X[NUM_NEIGHBORS] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+constexpr int NEIGHBOR_OFFSETS_Y[NUM_NEIGHBORS] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+constexpr float NEIGHBOR_COSTS[NUM_NEIGHBORS] = { 1.f, 1.f, 1.f, 1.f, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+void FlowField::Compute(std::vector<unsigned char> const& blockedTiles, IntVec2 const& dimensions, IntVec2 const& goalTileCoords)
+{
+	BeginCompute(dimensions, goalTileCoords);
+	while (m_isComputePending)
+	{
+		ContinueCompute(blockedTiles, INT_MAX);
+	}
+}
+
+void FlowField::BeginCompute(IntVec2 const& dimensions, IntVec2 const& goalTileCoords)
+{
+	m_isComputePending = true;
+	m_pendingDimensions = dimensions;
+	m_pendingGoalTileCoords = goalTileCoords;
+	m_pendingBakeTileIndex = -1;
+
+	int numTiles = m_pendingDimensions.x * m_pendingDimensions.y;
+	m_pendingDistances.assign(numTiles, UNREACHABLE_DISTANCE);
+	m_pendingDirections.assign(numTiles, Vec2::ZERO);
+	m_openList.clear();
+
+	// The goal is seeded even if it is blocked so a target standing against a wall still attracts agents
+	if (goalTileCoords.x >= 0 && goalTileCoords.y >= 0 && goalTileCoords.x < m_pendingDimensions.x && goalTileCoords.y < m_pendingDimensions.y)
+	{
+		int goalTileIndex = goalTileCoords.x + goalTileCoords.y * m_pendingDimensions.x;
+		m_pendingDistances[goalTileIndex] = 0.f;
+		m_openList.push_back(std::make_pair(0.f, goalTileIndex));
+	}
+}
+
+int FlowField::ContinueCompute(std::vector<unsigned char> const& blockedTiles, int maxTileVisits)
+{
+	if (!m_isComputePending)
+	{
+		return 0;
+	}
+
+	int numTileVisits = 0;
+	while (!m_openList.empty() && numTileVisits < maxTileVisits)
+	{
+		std::pop_heap(m_openList.begin(), m_openList.end(), std::greater<std::pair<float, int>>());
+		std::pair<float, int> current = m_openList.back();
+		m_openList.pop_back();
+
+		int tileIndex = current.second;
+		if (current.first > m_pendingDistances[tileIndex])
+		{
+			continue;
+		}
+		numTileVisits++;
+
+		int tileX = tileIndex % m_pendingDimensions.x;
+		int tileY = tileIndex / m_pendingDimensions.x;
+		for (int neighborIndex = 0; neighborIndex < NUM_NEIGHBORS; neighborIndex++)
+		{
+			int neighborX = tileX + NEIGHBOR_OFFSETS_X[neighborIndex];
+			int neighborY = tileY + NEIGHBOR_OFFSETS_Y[neighborIndex];
+			if (!IsTileWalkable(blockedTiles, neighborX, neighborY))
+			{
+				continue;
+			}
+			if (neighborX != tileX && neighborY != tileY && (!IsTileWalkable(blockedTiles, neighborX, tileY) || !IsTileWalkable(blockedTiles, tileX, neighborY)))
+			{
+				continue;
+			}
+
+			int neighborTileIndex = neighborX + neighborY * m_pendingDimensions.x;
+			float neighborDistance = current.first + NEIGHBOR_COSTS[neighborIndex];
+			if (neighborDistance < m_pendingDistances[neighborTileIndex])
+			{
+				m_pendingDistances[neighborTileIndex] = neighborDistance;
+				m_openList.push_back(std::make_pair(neighborDistance, neighborTileIndex));
+				std::push_heap(m_openList.begin(), m_openList.end(), std::greater<std::pair<float, int>>());
+			}
+		}
+	}
+	if (!m_openList.empty())
+	{
+		return numTileVisits;
+	}
+
+	// Bake the steepest descent direction per tile so agents never search neighbors while moving
+	int numTiles = m_pendingDimensions.x * m_pendingDimensions.y;
+	if (m_pendingBakeTileIndex < 0)
+	{
+		m_pendingBakeTileIndex = 0;
+	}
+	while (m_pendingBakeTileIndex < numTiles && numTileVisits < maxTileVisits)
+	{
+		BakeDirectionAtTile(blockedTiles, m_pendingBakeTileIndex);
+		m_pendingBakeTileIndex++;
+		numTileVisits++;
+	}
+	if (m_pendingBakeTileIndex < numTiles)
+	{
+		return numTileVisits;
+	}
+
+	m_dimensions = m_pendingDimensions;
+	m_goalTileCoords = m_pendingGoalTileCoords;
+	m_distances.swap(m_pendingDistances);
+	m_directions.swap(m_pendingDirections);
+	m_isComputePending = false;
+	m_numComputes++;
+	return numTileVisits;
+}
+
+bool FlowField::IsTileWalkable(std::vector<unsigned char> const& blockedTiles, int tileX, int tileY) const
+{
+	return tileX >= 0 && tileY >= 0 && tileX < m_pendingDimensions.x && tileY < m_pendingDimensions.y && blockedTiles[tileX + tileY * m_pendingDimensions.x] == 0;
+}
+
+void FlowField::BakeDirectionAtTile(std::vector<unsigned char> const& blockedTiles, int tileIndex)
+{
+	float tileDistance = m_pendingDistances[tileIndex];
+	if (tileDistance <= 0.f || tileDistance >= UNREACHABLE_DISTANCE)
+	{
+		return;
+	}
+
+	int tileX = tileIndex % m_pendingDimensions.x;
+	int tileY = tileIndex / m_pendingDimensions.x;
+	float lowestDistance = tileDistance;
+	Vec2 bestDirection = Vec2::ZERO;
+	for (int neighborIndex = 0; neighborIndex < NUM_NEIGHBORS; neighborIndex++)
+	{
+		int neighborX = tileX + NEIGHBOR_OFFSETS_X[neighborIndex];
+		int neighborY = tileY + NEIGHBOR_OFFSETS_Y[neighborIndex];
+		if (neighborX < 0 || neighborY < 0 || neighborX >= m_pendingDimensions.x || neighborY >= m_pendingDimensions.y)
+		{
+			continue;
+		}
+		if (neighborX != tileX && neighborY != tileY && (!IsTileWalkable(blockedTiles, neighborX, tileY) || !IsTileWalkable(blockedTiles, tileX, neighborY)))
+		{
+			continue;
+		}
+
+		float neighborDistance = m_pendingDistances[neighborX + neighborY * m_pendingDimensions.x];
+		if (neighborDistance < lowestDistance)
+		{
+			lowestDistance = neighborDistance;
+			bestDirection = Vec2((float)NEIGHBOR_OFFSETS_X[neighborIndex], (float)NEIGHBOR_OFFSETS_Y[neighborIndex]);
+		}
+	}
+	if (lowestDistance < tileDistance)
+	{
+		m_pendingDirections[tileIndex] = bestDirection.GetNormalized();
+	}
+}
+
+Vec2 const FlowField::GetDirectionAtPosition(Vec2 const& position) const
+{
+	IntVec2 tileCoords(RoundDownToInt(position.x), RoundDownToInt(position.y));
+	if (!IsTileInBounds(tileCoords))
+	{
+		return Vec2::ZERO;
+	}
+	return m_directions[tileCoords.x + tileCoords.y * m_dimensions.x];
+}
+
+float FlowField::GetDistanceAtTile(IntVec2 const& tileCoords) const
+{
+	if (!IsTileInBounds(tileCoords))
+	{
+		return UNREACHABLE_DISTANCE;
+	}
+	return m_distances[tileCoords.x + tileCoords.y * m_dimensions.x];
+}
+
+bool FlowField::IsTileInBounds(IntVec2 const& tileCoords) const
+{
+	return tileCoords.x >= 0 && tileCoords.y >= 0 && tileCoords.x < m_dimensions.x && tileCoords.y < m_dimensions.y;
+}
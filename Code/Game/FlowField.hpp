@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Game/ActorUID.hpp"
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <utility>
+#include <vector>
+
+// Dijkstra distance map from every walkable tile to a single goal tile, with the downhill direction baked per tile
+// Computed once per goal tile and shared by every agent chasing that goal, so sampling a direction is a single lookup
+// A compute can be spread over several frames, the last completed field keeps being sampled until the new one is done
+class FlowField
+{
+public:
+	~FlowField() = default;
+	FlowField() = default;
+
+	// Blocked tiles hold a non-zero value, and diagonal steps may not cut the corners of blocked tiles
+	void				Compute(std::vector<unsigned char> const& blockedTiles, IntVec2 const& dimensions, IntVec2 const& goalTileCoords);
+	void				BeginCompute(IntVec2 const& dimensions, IntVec2 const& goalTileCoords);
+	// Visits at most maxTileVisits tiles (searched plus baked) and returns how many were visited, blockedTiles must match the ones the compute began with
+	int					ContinueCompute(std::vector<unsigned char> const& blockedTiles, int maxTileVisits);
+
+	Vec2 const			GetDirectionAtPosition(Vec2 const& position) const;
+	float				GetDistanceAtTile(IntVec2 const& tileCoords) const;
+	IntVec2 const		GetGoalTileCoords() const { return m_goalTileCoords; }
+	IntVec2 const		GetPendingGoalTileCoords() const { return m_pendingGoalTileCoords; }
+	bool				IsComputePending() const { return m_isComputePending; }
+	bool				HasCompletedCompute() const { return m_numComputes > 0; }
+	bool				IsTileInBounds(IntVec2 const& tileCoords) const;
+
+private:
+	bool				IsTileWalkable(std::vector<unsigned char> const& blockedTiles, int tileX, int tileY) const;
+	void				BakeDirectionAtTile(std::vector<unsigned char> const& blockedTiles, int tileIndex);
+
+public:
+	static constexpr float UNREACHABLE_DISTANCE = 999999.f;
+
+	ActorUID			m_targetUID = ActorUID::INVALID;
+	int					m_navigationVersion = -1;
+	int					m_pendingNavigationVersion = -1;
+	int					m_numComputes = 0;
+
+private:
+	IntVec2				m_dimensions = IntVec2(0, 0);
+	IntVec2				m_goalTileCoords = IntVec2(-1, -1);
+	std::vector<float>	m_distances;
+	std::vector<Vec2>	m_directions;
+
+	// The compute in progress fills these and swaps them in once every tile is baked
+	bool				m_isComputePending = false;
+	IntVec2				m_pendingDimensions = IntVec2(0, 0);
+	IntVec2				m_pendingGoalTileCoords = IntVec2(-1, -1);
+	std::vector<float>	m_pendingDistances;
+	std::vector<Vec2>	m_pendingDirections;
+	// -1 while the search is running, then the next tile to bake a direction for
+	int					m_pendingBakeTileIndex = -1;
+	// Open list is kept as a heap across computes so recomputing does not reallocate
+	std::vector<std::pair<float, int>>	m_openList;
+};
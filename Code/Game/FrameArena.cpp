@@ -0,0 +1,179 @@
+#include "Game/FrameArena.hpp"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+
+static unsigned char* AlignPointer(unsigned char* pointer, size_t alignment)
+{
+	uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+	uintptr_t alignedAddress = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	return reinterpret_cast<unsigned char*>(alignedAddress);
+}
+
+template <typename VertexType>
+static std::vector<VertexType>& AcquireScratchArray(std::vector<std::vector<VertexType>*>& scratchArrays, std::vector<size_t>& capacities, int& numScratchArrays)
+{
+	if (numScratchArrays == (int)scratchArrays.size())
+	{
+		scratchArrays.push_back(new std::vector<VertexType>());
+		capacities.push_back(0);
+	}
+	std::vector<VertexType>& scratchArray = *scratchArrays[numScratchArrays];
+	capacities[numScratchArrays] = scratchArray.capacity();
+	numScratchArrays++;
+	return scratchArray;
+}
+
+template <typename VertexType>
+static int ResetScratchArrays(std::vector<std::vector<VertexType>*>& scratchArrays, std::vector<size_t> const& capacities, int& numScratchArrays)
+{
+	int numGrowths = 0;
+	for (int arrayIndex = 0; arrayIndex < numScratchArrays; arrayIndex++)
+	{
+		if (scratchArrays[arrayIndex]->capacity() > capacities[arrayIndex])
+		{
+			numGrowths++;
+		}
+		scratchArrays[arrayIndex]->clear();
+	}
+	numScratchArrays = 0;
+	return numGrowths;
+}
+
+FrameArena::~FrameArena()
+{
+	for (int blockIndex = 0; blockIndex < (int)m_overflowBlocks.size(); blockIndex++)
+	{
+		delete[] m_overflowBlocks[blockIndex];
+	}
+	m_overflowBlocks.clear();
+
+	delete[] m_block;
+	m_block = nullptr;
+
+	for (int arrayIndex = 0; arrayIndex < (int)m_scratchVertexesPCU.size(); arrayIndex++)
+	{
+		delete m_scratchVertexesPCU[arrayIndex];
+	}
+	m_scratchVertexesPCU.clear();
+	for (int arrayIndex = 0; arrayIndex < (int)m_scratchVertexesPCUTBN.size(); arrayIndex++)
+	{
+		delete m_scratchVertexesPCUTBN[arrayIndex];
+	}
+	m_scratchVertexesPCUTBN.clear();
+}
+
+FrameArena::FrameArena(size_t blockSize)
+	: m_blockSize(blockSize)
+{
+	m_block = new unsigned char[m_blockSize];
+}
+
+void FrameArena::Reset()
+{
+	size_t usedBytes = m_blockOffset + m_overflowBytesUsed;
+	m_peakBytes = usedBytes > m_peakBytes ? usedBytes : m_peakBytes;
+
+	// Merge the overflow into one block big enough for this frame, so the next frame like it fits without chaining
+	if (!m_overflowBlocks.empty())
+	{
+		for (int blockIndex = 0; blockIndex < (int)m_overflowBlocks.size(); blockIndex++)
+		{
+			delete[] m_overflowBlocks[blockIndex];
+		}
+		m_overflowBlocks.clear();
+
+		delete[] m_block;
+		m_blockSize += m_overflowCapacity;
+		m_block = new unsigned char[m_blockSize];
+		m_currentFrameStats.m_numBlockAllocations++;
+
+		m_overflowBlockSize = 0;
+		m_overflowBlockOffset = 0;
+		m_overflowCapacity = 0;
+		m_overflowBytesUsed = 0;
+	}
+	m_blockOffset = 0;
+
+	m_currentFrameStats.m_numBytes = usedBytes;
+	m_currentFrameStats.m_numScratchArrayGrowths += ResetScratchArrays(m_scratchVertexesPCU, m_scratchCapacitiesPCU, m_numScratchVertexesPCU);
+	m_currentFrameStats.m_numScratchArrayGrowths += ResetScratchArrays(m_scratchVertexesPCUTBN, m_scratchCapacitiesPCUTBN, m_numScratchVertexesPCUTBN);
+
+	m_lastFrameStats = m_currentFrameStats;
+	m_currentFrameStats = FrameArenaStats();
+}
+
+void* FrameArena::Allocate(size_t numBytes, size_t alignment)
+{
+	m_currentFrameStats.m_numAllocations++;
+
+	unsigned char* alignedPointer = AlignPointer(m_block + m_blockOffset, alignment);
+	size_t alignedOffset = alignedPointer - m_block;
+	if (alignedOffset + numBytes <= m_blockSize)
+	{
+		m_blockOffset = alignedOffset + numBytes;
+		return alignedPointer;
+	}
+
+	if (!m_overflowBlocks.empty())
+	{
+		unsigned char* overflowBlock = m_overflowBlocks.back();
+		alignedPointer = AlignPointer(overflowBlock + m_overflowBlockOffset, alignment);
+		alignedOffset = alignedPointer - overflowBlock;
+		if (alignedOffset + numBytes <= m_overflowBlockSize)
+		{
+			m_overflowBytesUsed += alignedOffset + numBytes - m_overflowBlockOffset;
+			m_overflowBlockOffset = alignedOffset + numBytes;
+			return alignedPointer;
+		}
+	}
+
+	AllocateOverflowBlock(numBytes + alignment);
+	unsigned char* overflowBlock = m_overflowBlocks.back();
+	alignedPointer = AlignPointer(overflowBlock, alignment);
+	m_overflowBlockOffset = (alignedPointer - overflowBlock) + numBytes;
+	m_overflowBytesUsed += m_overflowBlockOffset;
+	return alignedPointer;
+}
+
+char const* FrameArena::Format(char const* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(nullptr, 0, format, args);
+	va_end(args);
+
+	if (length < 0)
+	{
+		return "";
+	}
+
+	char* text = static_cast<char*>(Allocate((size_t)length + 1, 1));
+	va_start(args, format);
+	vsnprintf(text, (size_t)length + 1, format, args);
+	va_end(args);
+	return text;
+}
+
+std::vector<Vertex_PCU>& FrameArena::AcquireScratchVertexesPCU()
+{
+	m_currentFrameStats.m_numScratchArrays++;
+	return AcquireScratchArray(m_scratchVertexesPCU, m_scratchCapacitiesPCU, m_numScratchVertexesPCU);
+}
+
+std::vector<Vertex_PCUTBN>& FrameArena::AcquireScratchVertexesPCUTBN()
+{
+	m_currentFrameStats.m_numScratchArrays++;
+	return AcquireScratchArray(m_scratchVertexesPCUTBN, m_scratchCapacitiesPCUTBN, m_numScratchVertexesPCUTBN);
+}
+
+void FrameArena::AllocateOverflowBlock(size_t minBytes)
+{
+	m_overflowBlockSize = minBytes > m_blockSize ? minBytes : m_blockSize;
+	m_overflowBlocks.push_back(new unsigned char[m_overflowBlockSize]);
+	m_overflowBlockOffset = 0;
+	m_overflowCapacity += m_overflowBlockSize;
+	m_currentFrameStats.m_numBlockAllocations++;
+}
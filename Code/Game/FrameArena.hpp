@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+
+#include <cstddef>
+#include <vector>
+
+struct FrameArenaStats
+{
+public:
+	int			m_numAllocations = 0;
+	size_t		m_numBytes = 0;
+	int			m_numBlockAllocations = 0;
+	int			m_numScratchArrays = 0;
+	int			m_numScratchArrayGrowths = 0;
+};
+
+// Linear allocator for memory that only lives until the end of the frame, reset once per frame in App::BeginFrame
+// Allocation bumps an offset into one block, and an overflowing frame chains extra blocks that are merged into one larger block on the next reset, so a steady frame never touches the heap
+// Engine functions that fill vertexes take plain std::vectors, so the arena also hands out scratch vertex arrays that are cleared on reset but keep their capacity
+class FrameArena
+{
+public:
+	~FrameArena();
+	explicit FrameArena(size_t blockSize);
+
+	void						Reset();
+
+	void*						Allocate(size_t numBytes, size_t alignment = alignof(std::max_align_t));
+	// Formats into arena memory, for names and labels that are only needed this frame
+	char const*					Format(char const* format, ...);
+
+	std::vector<Vertex_PCU>&	AcquireScratchVertexesPCU();
+	std::vector<Vertex_PCUTBN>&	AcquireScratchVertexesPCUTBN();
+
+	FrameArenaStats const&		GetLastFrameStats() const { return m_lastFrameStats; }
+	size_t						GetPeakBytes() const { return m_peakBytes; }
+	size_t						GetCapacity() const { return m_blockSize; }
+
+private:
+	void						AllocateOverflowBlock(size_t minBytes);
+
+private:
+	unsigned char*				m_block = nullptr;
+	size_t						m_blockSize = 0;
+	size_t						m_blockOffset = 0;
+	std::vector<unsigned char*>	m_overflowBlocks;
+	size_t						m_overflowBlockSize = 0;
+	size_t						m_overflowBlockOffset = 0;
+	size_t						m_overflowCapacity = 0;
+	size_t						m_overflowBytesUsed = 0;
+
+	// Scratch arrays are heap allocated individually so references handed out stay valid while more are added
+	std::vector<std::vector<Vertex_PCU>*>		m_scratchVertexesPCU;
+	std::vector<std::vector<Vertex_PCUTBN>*>	m_scratchVertexesPCUTBN;
+	std::vector<size_t>			m_scratchCapacitiesPCU;
+	std::vector<size_t>			m_scratchCapacitiesPCUTBN;
+	int							m_numScratchVertexesPCU = 0;
+	int							m_numScratchVertexesPCUTBN = 0;
+
+	size_t						m_peakBytes = 0;
+	FrameArenaStats				m_currentFrameStats;
+	FrameArenaStats				m_lastFrameStats;
+};
+
+// STL allocator over a FrameArena, for containers that are thrown away before the arena is reset
+// Deallocation does nothing, the memory comes back when the arena is reset
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+	explicit FrameAllocator(FrameArena* arena) : m_arena(arena) {}
+	template <typename U>
+	FrameAllocator(FrameAllocator<U> const& other) : m_arena(other.m_arena) {}
+
+	T*				allocate(size_t count) { return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T))); }
+	void			deallocate(T* pointer, size_t count) { (void)pointer; (void)count; }
+
+	template <typename U>
+	bool			operator==(FrameAllocator<U> const& other) const { return m_arena == other.m_arena; }
+	template <typename U>
+	bool			operator!=(FrameAllocator<U> const& other) const { return m_arena != other.m_arena; }
+
+public:
+	FrameArena*		m_arena = nullptr;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,197 @@
+#include "Game/FramePacer.hpp"
+
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+
+
+constexpr int ADAPTIVE_WINDOW_FRAMES = 60;
+constexpr int MAX_ADAPTIVE_RATE_DIVISOR = 4;
+constexpr double MIN_SLEEP_MARGIN_SECONDS = 0.0005;
+constexpr double MAX_SLEEP_MARGIN_SECONDS = 0.02;
+// Blend factors for the oversleep average per sleep and for easing the margin toward it per frame
+constexpr double OVERSLEEP_AVERAGE_BLEND = 0.1;
+constexpr double SLEEP_MARGIN_DECAY_BLEND = 0.05;
+
+
+double FramePacerStats::GetFrameTimePercentile(float percentile) const
+{
+	int numFramesBelow = (int)((float)m_numFrames * percentile);
+	int numFramesCounted = 0;
+	for (int bucketIndex = 0; bucketIndex < FRAME_HISTOGRAM_BUCKETS; bucketIndex++)
+	{
+		numFramesCounted += m_frameTimeHistogram[bucketIndex];
+		if (numFramesCounted > numFramesBelow)
+		{
+			return (double)(bucketIndex + 1) * FRAME_HISTOGRAM_BUCKET_SECONDS;
+		}
+	}
+	return m_maxFrameSeconds;
+}
+
+FramePacer::~FramePacer()
+{
+	timeEndPeriod(1);
+}
+
+FramePacer::FramePacer(float targetFrameRate, bool isAdaptive)
+	: m_targetFrameRate(targetFrameRate)
+	, m_isAdaptive(isAdaptive)
+{
+	// The default scheduler tick is about 15.6ms, longer than a whole frame at the usual targets, so a 1ms sleep could never be trusted
+	timeBeginPeriod(1);
+
+	m_frameStartSeconds = GetCurrentTimeSeconds();
+	m_deadlineSeconds = m_frameStartSeconds;
+}
+
+void FramePacer::WaitForNextFrame()
+{
+	double workEndSeconds = GetCurrentTimeSeconds();
+	double workSeconds = workEndSeconds - m_frameStartSeconds;
+
+	float effectiveFrameRate = GetEffectiveFrameRate();
+	if (effectiveFrameRate <= 0.f)
+	{
+		RecordFrame(workSeconds);
+		m_frameStartSeconds = workEndSeconds;
+		return;
+	}
+
+	double frameSeconds = 1.0 / (double)effectiveFrameRate;
+	m_deadlineSeconds += frameSeconds;
+
+	// A late frame starts the next one right away and the schedule restarts from now instead of rushing frames to catch up
+	bool missedDeadline = workEndSeconds > m_deadlineSeconds;
+	if (missedDeadline)
+	{
+		m_stats.m_numMissedDeadlines++;
+		m_deadlineSeconds = workEndSeconds;
+	}
+
+	double sleepStartSeconds = GetCurrentTimeSeconds();
+	bool didSleep = false;
+	while (m_deadlineSeconds - GetCurrentTimeSeconds() > m_sleepMarginSeconds)
+	{
+		didSleep = true;
+		double requestedSleepSeconds = 0.001;
+		double sleepCallStartSeconds = GetCurrentTimeSeconds();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		double oversleepSeconds = std::max(GetCurrentTimeSeconds() - sleepCallStartSeconds - requestedSleepSeconds, 0.0);
+		m_averageOversleepSeconds += (oversleepSeconds - m_averageOversleepSeconds) * OVERSLEEP_AVERAGE_BLEND;
+		if (oversleepSeconds > m_sleepMarginSeconds)
+		{
+			m_sleepMarginSeconds = std::min(oversleepSeconds, MAX_SLEEP_MARGIN_SECONDS);
+		}
+	}
+
+	// One preempted sleep must not leave every later frame spinning, so the margin settles back once sleeps are accurate again
+	// A frame too short to sleep at all has nothing to measure, the average decays so a margin wider than the frame cannot lock itself in
+	if (!didSleep)
+	{
+		m_averageOversleepSeconds *= 1.0 - OVERSLEEP_AVERAGE_BLEND;
+	}
+	double settledMarginSeconds = std::max(2.0 * m_averageOversleepSeconds, MIN_SLEEP_MARGIN_SECONDS);
+	m_sleepMarginSeconds += (settledMarginSeconds - m_sleepMarginSeconds) * SLEEP_MARGIN_DECAY_BLEND;
+
+	double spinStartSeconds = GetCurrentTimeSeconds();
+	while (GetCurrentTimeSeconds() < m_deadlineSeconds)
+	{
+		std::this_thread::yield();
+	}
+	double frameEndSeconds = GetCurrentTimeSeconds();
+
+	m_stats.m_totalSleepSeconds += spinStartSeconds - sleepStartSeconds;
+	m_stats.m_totalSpinSeconds += frameEndSeconds - spinStartSeconds;
+	RecordFrame(frameEndSeconds - m_frameStartSeconds);
+	m_frameStartSeconds = frameEndSeconds;
+
+	if (m_isAdaptive)
+	{
+		UpdateAdaptiveDivisor(missedDeadline, workSeconds);
+	}
+}
+
+void FramePacer::SetTargetFrameRate(float targetFrameRate)
+{
+	m_targetFrameRate = targetFrameRate;
+	m_rateDivisor = 1;
+	m_deadlineSeconds = GetCurrentTimeSeconds();
+	ResetStats();
+}
+
+void FramePacer::SetAdaptive(bool isAdaptive)
+{
+	m_isAdaptive = isAdaptive;
+	m_rateDivisor = 1;
+	m_numWindowFrames = 0;
+	m_numWindowMisses = 0;
+	m_maxWindowWorkSeconds = 0.0;
+}
+
+void FramePacer::ResetStats()
+{
+	m_stats = FramePacerStats();
+}
+
+float FramePacer::GetEffectiveFrameRate() const
+{
+	return m_targetFrameRate / (float)m_rateDivisor;
+}
+
+void FramePacer::RecordFrame(double frameSeconds)
+{
+	if (m_stats.m_numFrames == 0)
+	{
+		m_stats.m_minFrameSeconds = frameSeconds;
+		m_stats.m_maxFrameSeconds = frameSeconds;
+	}
+	m_stats.m_numFrames++;
+	m_stats.m_totalFrameSeconds += frameSeconds;
+	m_stats.m_minFrameSeconds = std::min(m_stats.m_minFrameSeconds, frameSeconds);
+	m_stats.m_maxFrameSeconds = std::max(m_stats.m_maxFrameSeconds, frameSeconds);
+
+	int bucketIndex = std::min((int)(frameSeconds / FRAME_HISTOGRAM_BUCKET_SECONDS), FRAME_HISTOGRAM_BUCKETS - 1);
+	m_stats.m_frameTimeHistogram[bucketIndex]++;
+}
+
+void FramePacer::UpdateAdaptiveDivisor(bool missedDeadline, double workSeconds)
+{
+	m_numWindowFrames++;
+	m_numWindowMisses += missedDeadline ? 1 : 0;
+	m_maxWindowWorkSeconds = std::max(m_maxWindowWorkSeconds, workSeconds);
+	if (m_numWindowFrames < ADAPTIVE_WINDOW_FRAMES)
+	{
+		return;
+	}
+
+	// Dropping a whole fraction keeps frame times even, which reads better than a rate that keeps slipping
+	int previousDivisor = m_rateDivisor;
+	if (m_numWindowMisses * 4 > m_numWindowFrames && m_rateDivisor < MAX_ADAPTIVE_RATE_DIVISOR)
+	{
+		m_rateDivisor++;
+	}
+	else if (m_numWindowMisses == 0 && m_rateDivisor > 1 && m_maxWindowWorkSeconds < 0.8 / (double)(m_targetFrameRate / (float)(m_rateDivisor - 1)))
+	{
+		m_rateDivisor--;
+	}
+
+	if (m_rateDivisor != previousDivisor)
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("Frame pacer: %d of %d deadlines missed, now targeting %.1f fps", m_numWindowMisses, m_numWindowFrames, GetEffectiveFrameRate()), false);
+	}
+
+	m_numWindowFrames = 0;
+	m_numWindowMisses = 0;
+	m_maxWindowWorkSeconds = 0.0;
+}
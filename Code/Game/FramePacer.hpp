@@ -0,0 +1,66 @@
+#pragma once
+
+constexpr int FRAME_HISTOGRAM_BUCKETS = 50;
+constexpr double FRAME_HISTOGRAM_BUCKET_SECONDS = 0.001;
+
+struct FramePacerStats
+{
+public:
+	int			m_numFrames = 0;
+	int			m_numMissedDeadlines = 0;
+	double		m_totalFrameSeconds = 0.0;
+	double		m_minFrameSeconds = 0.0;
+	double		m_maxFrameSeconds = 0.0;
+	double		m_totalSleepSeconds = 0.0;
+	double		m_totalSpinSeconds = 0.0;
+	// Frame times in 1ms buckets, the last bucket holds everything longer
+	int			m_frameTimeHistogram[FRAME_HISTOGRAM_BUCKETS] = {};
+
+	double		GetFrameTimePercentile(float percentile) const;
+};
+
+// Holds each frame to a fixed period so frame times are even and the CPU idles instead of spinning through extra frames
+// Waiting sleeps while the deadline is far enough away to absorb the OS scheduler's oversleep, then spins for the rest
+// Adaptive mode drops to a whole fraction of the target rate while deadlines keep being missed, and climbs back once frames fit again
+class FramePacer
+{
+public:
+	~FramePacer();
+	FramePacer(float targetFrameRate, bool isAdaptive);
+
+	// Called once per frame after it is presented, returns when the next frame should start
+	void						WaitForNextFrame();
+
+	// Zero or less runs unpaced
+	void						SetTargetFrameRate(float targetFrameRate);
+	void						SetAdaptive(bool isAdaptive);
+	void						ResetStats();
+
+	float						GetTargetFrameRate() const { return m_targetFrameRate; }
+	float						GetEffectiveFrameRate() const;
+	bool						IsAdaptive() const { return m_isAdaptive; }
+	double						GetSleepMarginSeconds() const { return m_sleepMarginSeconds; }
+	FramePacerStats const&		GetStats() const { return m_stats; }
+
+private:
+	void						RecordFrame(double frameSeconds);
+	void						UpdateAdaptiveDivisor(bool missedDeadline, double workSeconds);
+
+private:
+	float						m_targetFrameRate = 0.f;
+	bool						m_isAdaptive = false;
+	// Adaptive mode runs at the target rate divided by this
+	int							m_rateDivisor = 1;
+	double						m_frameStartSeconds = 0.0;
+	double						m_deadlineSeconds = 0.0;
+	// Time left before the deadline at which sleeping stops, raised at once when a sleep overshoots it and eased back toward twice the average oversleep
+	double						m_sleepMarginSeconds = 0.002;
+	double						m_averageOversleepSeconds = 0.001;
+
+	// Missed deadlines and work time over the current adaptive window
+	int							m_numWindowFrames = 0;
+	int							m_numWindowMisses = 0;
+	double						m_maxWindowWorkSeconds = 0.0;
+
+	FramePacerStats				m_stats;
+};
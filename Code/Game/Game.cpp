@@ -10,7 +10,20 @@
 #include "Game/Map.hpp"
 #include "Game/Gold/GoldMap.hpp"
 #include "Game/Actor.hpp"
-
+#include "Game/DrawBackend.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/GeometryCache.hpp"
+#include "Game/NavigationBenchmark.hpp"
+#include "Game/RenderListBenchmark.hpp"
+#include "Game/VoiceManager.hpp"
+#include "Game/AudioBackend.hpp"
+#include "Game/CounterRNG.hpp"
+#include "Game/PoissonDiskPlacement.hpp"
+#include "Game/SimulationThread.hpp"
+#include "Game/SnapshotExchange.hpp"
+
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
@@ -18,6 +31,9 @@
 #include "Engine/Renderer/Spritesheet.hpp"
 #include "Engine/VirtualReality/OpenXR.hpp"
 
+#include <algorithm>
+#include <string.h>
+
 Game::Game()
 {
 	LoadAssets();
@@ -27,10 +43,43 @@ Game::Game()
 	ActorDefinition::InitializeActorDefinitions();
 
 	m_player = new Player(this, 0, -1);
+	m_poseProvider = new OpenXRPoseProvider();
+	m_simulationThread = new SimulationThread([this]() { UpdateSimulation(); });
+
+	SubscribeEventCallbackFunction("RenderStats", Event_RenderStats, "Prints render list statistics for the last frame");
+	SubscribeEventCallbackFunction("RenderListBenchmark", Event_RenderListBenchmark, "Times building and sorting a synthetic render list and checks its sort order and state filtering without a map");
+	SubscribeEventCallbackFunction("NavBenchmark", Event_NavBenchmark, "Times hierarchical pathfinding against full-grid search on a generated maze");
+	SubscribeEventCallbackFunction("VoiceStats", Event_VoiceStats, "Prints voice manager counters");
+	SubscribeEventCallbackFunction("VoiceStress", Event_VoiceStress, "Simulates a wave of soldiers against a stub audio backend and prints voice manager counters");
+	SubscribeEventCallbackFunction("AllocationStats", Event_AllocationStats, "Prints live and peak allocations per subsystem");
+	SubscribeEventCallbackFunction("AllocationSoak", Event_AllocationSoak, "Repeatedly builds and tears down a map and reports anything it leaves behind");
+	SubscribeEventCallbackFunction("ProjectileStats", Event_ProjectileStats, "Prints projectile system counters for the last update");
+	SubscribeEventCallbackFunction("ProjectileBenchmark", Event_ProjectileBenchmark, "Times a burst of projectiles simulated as actors against the projectile system");
+	SubscribeEventCallbackFunction("ActivityStats", Event_ActivityStats, "Prints how many actors are active, on a reduced tick or asleep");
+	SubscribeEventCallbackFunction("SnapshotStress", Event_SnapshotStress, "Hammers the render snapshot handoff from two threads and checks every snapshot read is whole and in order");
+	SubscribeEventCallbackFunction("SimulationStress", Event_SimulationStress, "Steps a map on the simulation thread while replaying its last snapshot, and checks the snapshot never changes under the replay");
+	SubscribeEventCallbackFunction("LateLatchStats", Event_LateLatchStats, "Prints how stale the update pose was when it was late latched for the last eye");
+	SubscribeEventCallbackFunction("LateLatchTest", Event_LateLatchTest, "Late latches a test render list against a mock pose source and checks the hand matrices it submits");
+	SubscribeEventCallbackFunction("RandomBenchmark", Event_RandomBenchmark, "Times the engine random generator against the keyed counter generator and checks threaded rolls match serial ones");
+	SubscribeEventCallbackFunction("LoadTileMap", Event_LoadTileMap, "Replaces the current map with a tile map built from a map definition");
+	SubscribeEventCallbackFunction("PlacementBenchmark", Event_PlacementBenchmark, "Times Poisson-disk tree and rock placement over a large world against the old per-tile placement");
 }
 
 Game::~Game()
 {
+	delete m_simulationThread;
+	m_simulationThread = nullptr;
+
+	UnloadCurrentMap();
+
+	delete m_player;
+	m_player = nullptr;
+
+	delete m_poseProvider;
+	m_poseProvider = nullptr;
+
+	delete m_logoSpriteSheet;
+	m_logoSpriteSheet = nullptr;
 }
 
 void Game::LoadAssets()
@@ -45,6 +94,7 @@ void Game::LoadAssets()
 	if (m_gameState == GameState::INTRO)
 	{
 		m_logoTexture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Logo.png");
+		m_logoSpriteSheet = new SpriteSheet(m_logoTexture, IntVec2(15, 19));
 		SoundID logoBackgroundMusic = g_audio->CreateOrGetSound("Data/Audio//Music/LogoMusic.mp3");
 		m_introMusicPlayback = g_audio->StartSound(logoBackgroundMusic);
 	}
@@ -58,7 +108,13 @@ void Game::Update()
 {
 	float deltaSeconds = m_gameClock.GetDeltaSeconds();
 	float gameFPS = deltaSeconds == 0.f ? 0.f : 1.f / deltaSeconds;
-	DebugAddScreenText(Stringf("[Game Clock]\t\tTime: %.2f, Frames per Seconds: %.2f, Scale: %.2f", m_gameClock.GetTotalSeconds(), gameFPS, m_gameClock.GetTimeScale()), Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX) - 16.f, g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY) - 32.f), 16.f, Vec2(1.f, 1.f), 0.f);
+	g_geometryCache->AddScreenText("Game::GameClock", g_frameArena->Format("[Game Clock]\t\tTime: %.2f, Frames per Seconds: %.2f, Scale: %.2f", m_gameClock.GetTotalSeconds(), gameFPS, m_gameClock.GetTimeScale()), Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX) - 16.f, g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY) - 32.f), 16.f, Vec2(1.f, 1.f));
+
+	if (m_poseProvider->IsActive())
+	{
+		m_poseProvider->SamplePose(m_updatePose);
+		ApplyHeadPose(m_updatePose);
+	}
 
 	switch (m_gameState)
 	{
@@ -69,17 +125,6 @@ void Game::Update()
 	}
 
 
-	if (g_openXR && g_openXR->IsInitialized())
-	{
-		EulerAngles leftEyeOrientation;
-		g_openXR->GetTransformForEye_iFwd_jLeft_kUp(XREye::LEFT, m_player->m_leftEyeLocalPosition, leftEyeOrientation);
-
-		EulerAngles rightEyeOrientation;
-		g_openXR->GetTransformForEye_iFwd_jLeft_kUp(XREye::RIGHT, m_player->m_rightEyeLocalPosition, rightEyeOrientation);
-
-		m_player->m_hmdOrientation = rightEyeOrientation;
-	}
-
 	Mat44 billboardTargetMatrix = Mat44::CreateTranslation3D(m_player->m_position);
 	billboardTargetMatrix.Append((m_player->m_orientation + m_player->m_hmdOrientation).GetAsMatrix_iFwd_jLeft_kUp());
 
@@ -96,8 +141,7 @@ void Game::UpdateGame(float deltaSeconds)
 		UpdatePlayers(deltaSeconds);
 		if (m_currentMap)
 		{
-			m_currentMap->Update();
-			UpdateCameras();
+			m_currentMap->UpdateMainThread();
 		}
 	}
 
@@ -111,6 +155,13 @@ void Game::UpdatePlayers(float deltaSeconds)
 	m_player->Update();
 }
 
+// Runs on the simulation thread, the main thread renders meanwhile and only reads published snapshots
+void Game::UpdateSimulation()
+{
+	m_currentMap->Update();
+	g_voiceManager->Update(m_currentMap);
+}
+
 void Game::UpdateCameras()
 {
 	if (m_currentMap)
@@ -123,36 +174,65 @@ void Game::UpdateCameras()
 		}
 	}
 	g_app->m_worldCamera.SetTransform(m_player->m_position, m_player->m_orientation);
-	
+	UpdateEyeCameras();
+
+	//g_app->m_screenCamera.SetOrthoView(Vec2(0.f, 0.f), Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX), g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY)));
+}
+
+void Game::ApplyHeadPose(PoseSample const& pose)
+{
+	m_player->m_leftEyeLocalPosition = pose.m_leftEye.m_position;
+	m_player->m_rightEyeLocalPosition = pose.m_rightEye.m_position;
+	m_player->m_hmdOrientation = pose.m_rightEye.m_orientation;
+}
+
+void Game::UpdateEyeCameras()
+{
+	SetEyeCameraTransforms(m_player->m_position, m_player->m_orientation, m_player->m_leftEyeLocalPosition, m_player->m_rightEyeLocalPosition, m_player->m_hmdOrientation);
+}
+
+void Game::SetEyeCameraTransforms(Vec3 const& playerPosition, EulerAngles const& playerOrientation, Vec3 const& leftEyeLocalPosition, Vec3 const& rightEyeLocalPosition, EulerAngles const& hmdOrientation)
+{
 	if (g_openXR && g_openXR->IsInitialized())
 	{
-		Mat44 playerModelMatrix = Mat44::CreateTranslation3D(m_player->m_position);
-		playerModelMatrix.Append(m_player->m_orientation.GetAsMatrix_iFwd_jLeft_kUp());
+		Mat44 playerModelMatrix = Mat44::CreateTranslation3D(playerPosition);
+		playerModelMatrix.Append(playerOrientation.GetAsMatrix_iFwd_jLeft_kUp());
 
-		constexpr float XR_NEAR = 0.1f;
-		constexpr float XR_FAR = 1000.f;
 		float lFovLeft, lFovRight, lFovUp, lFovDown;
 		float rFovLeft, rFovRight, rFovUp, rFovDown;
 		Vec3 leftEyePosition, rightEyePosition;
 		EulerAngles leftEyeOrientation, rightEyeOrientation;
 
 		g_openXR->GetFovsForEye(XREye::LEFT, lFovLeft, lFovRight, lFovUp, lFovDown);
-		g_app->m_leftEyeCamera.SetXRView(lFovLeft, lFovRight, lFovUp, lFovDown, XR_NEAR, XR_FAR);
+		g_app->m_leftEyeCamera.SetXRView(lFovLeft, lFovRight, lFovUp, lFovDown, XR_CAMERA_NEAR, XR_CAMERA_FAR);
 		Mat44 leftEyeTransform = playerModelMatrix;
-		leftEyeTransform.AppendTranslation3D(m_player->m_leftEyeLocalPosition);
-		leftEyeTransform.Append(m_player->m_hmdOrientation.GetAsMatrix_iFwd_jLeft_kUp());
+		leftEyeTransform.AppendTranslation3D(leftEyeLocalPosition);
+		leftEyeTransform.Append(hmdOrientation.GetAsMatrix_iFwd_jLeft_kUp());
 		g_app->m_leftEyeCamera.SetTransform(leftEyeTransform);
 
 		g_openXR->GetFovsForEye(XREye::RIGHT, rFovLeft, rFovRight, rFovUp, rFovDown);
-		g_app->m_rightEyeCamera.SetXRView(rFovLeft, rFovRight, rFovUp, rFovDown, XR_NEAR, XR_FAR);
+		g_app->m_rightEyeCamera.SetXRView(rFovLeft, rFovRight, rFovUp, rFovDown, XR_CAMERA_NEAR, XR_CAMERA_FAR);
 		Mat44 rightEyeTransform = playerModelMatrix;
-		rightEyeTransform.AppendTranslation3D(m_player->m_rightEyeLocalPosition);
-		rightEyeTransform.Append(m_player->m_hmdOrientation.GetAsMatrix_iFwd_jLeft_kUp());
+		rightEyeTransform.AppendTranslation3D(rightEyeLocalPosition);
+		rightEyeTransform.Append(hmdOrientation.GetAsMatrix_iFwd_jLeft_kUp());
 		g_app->m_rightEyeCamera.SetTransform(rightEyeTransform);
 	}
+}
 
+void Game::UpdateViewFrustums()
+{
+	m_viewFrustums.clear();
+	m_viewFrustums.push_back(ViewFrustum::CreatePerspective(g_app->m_worldCamera.GetModelMatrix(), g_window->GetAspect(), WORLD_CAMERA_FOV_DEGREES, WORLD_CAMERA_NEAR, WORLD_CAMERA_FAR));
 
-	//g_app->m_screenCamera.SetOrthoView(Vec2(0.f, 0.f), Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX), g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY)));
+	if (g_openXR && g_openXR->IsInitialized())
+	{
+		// OpenXR reports eye fovs in radians
+		float fovLeft, fovRight, fovUp, fovDown;
+		g_openXR->GetFovsForEye(XREye::LEFT, fovLeft, fovRight, fovUp, fovDown);
+		m_viewFrustums.push_back(ViewFrustum::CreatePerspective(g_app->m_leftEyeCamera.GetModelMatrix(), ConvertRadiansToDegrees(fovLeft), ConvertRadiansToDegrees(fovRight), ConvertRadiansToDegrees(fovUp), ConvertRadiansToDegrees(fovDown), XR_CAMERA_NEAR, XR_CAMERA_FAR));
+		g_openXR->GetFovsForEye(XREye::RIGHT, fovLeft, fovRight, fovUp, fovDown);
+		m_viewFrustums.push_back(ViewFrustum::CreatePerspective(g_app->m_rightEyeCamera.GetModelMatrix(), ConvertRadiansToDegrees(fovLeft), ConvertRadiansToDegrees(fovRight), ConvertRadiansToDegrees(fovUp), ConvertRadiansToDegrees(fovDown), XR_CAMERA_NEAR, XR_CAMERA_FAR));
+	}
 }
 
 void Game::HandleDeveloperCheats()
@@ -178,6 +258,1048 @@ void Game::HandleDeveloperCheats()
 	}
 }
 
+bool Game::Event_RenderStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	GeometryCacheStats const& cacheStats = g_geometryCache->GetLastFrameStats();
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Geometry Cache (last frame)", false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Cached meshes", g_geometryCache->GetNumCachedMeshes()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Cached draws", cacheStats.m_numCachedDraws), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d bytes)", "Cache uploads", cacheStats.m_numCacheUploads, (int)cacheStats.m_cacheUploadBytes), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d bytes)", "Dynamic uploads", cacheStats.m_numDynamicDraws, (int)cacheStats.m_dynamicUploadBytes), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d rebuilt, %d reused", "Text blocks", cacheStats.m_numTextBlocksRebuilt, cacheStats.m_numTextBlocksReused), false);
+
+	FrameArenaStats const& arenaStats = g_frameArena->GetLastFrameStats();
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Frame Arena (last frame)", false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d bytes)", "Allocations", arenaStats.m_numAllocations, (int)arenaStats.m_numBytes), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d of %d bytes", "Peak bytes", (int)g_frameArena->GetPeakBytes(), (int)g_frameArena->GetCapacity()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Block allocations", arenaStats.m_numBlockAllocations), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d grew)", "Scratch vertex arrays", arenaStats.m_numScratchArrays, arenaStats.m_numScratchArrayGrowths), false);
+
+	Map* map = g_app->m_game->m_currentMap;
+	if (!map)
+	{
+		g_console->AddLine(Rgba8::RED, "No map is loaded", false);
+		return true;
+	}
+
+	RenderListStats const& stats = map->m_renderSnapshots.GetReadBuffer().GetStats();
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Render List", false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Draw items", stats.m_numDrawItems), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Vertex arrays", stats.m_numVertexArrays), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Views submitted", stats.m_numSubmits), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Draw calls", stats.m_numDrawCalls), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "State changes", stats.m_numStateChanges), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Build", stats.m_buildSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Sort", stats.m_sortSeconds * 1000.0), false);
+
+	GoldMap const* goldMap = dynamic_cast<GoldMap const*>(map);
+	if (!goldMap)
+	{
+		g_console->AddLine(Rgba8::STEEL_BLUE, "Tile Mesh", false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d without culling or merging)", "Vertexes", map->m_numTileVertexes, map->m_numUnculledTileVertexes), false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d without culling or merging)", "Indexes", map->m_numTileIndexes, map->m_numUnculledTileIndexes), false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d drawn, %d culled", "Chunks", map->m_numTileChunksDrawn, map->m_numTileChunksCulled), false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Chunk rebuilds", map->m_numTileChunkRebuilds), false);
+	}
+	if (goldMap)
+	{
+		g_console->AddLine(Rgba8::STEEL_BLUE, "Static Geometry", false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d in 1 draw (%d vertexes)", "Static instances", goldMap->m_staticBatches.GetNumInstances(), goldMap->m_staticBatches.GetNumVertexes()), false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d rebuilds)", "Static casters drawn", goldMap->m_shadowCasterBatches.GetNumInstances(), goldMap->m_shadowCasterBatches.GetNumBuilds()), false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Static casters culled", goldMap->m_numShadowCastersCulled), false);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Static shadow map renders", goldMap->m_numStaticShadowMapRenders), false);
+	}
+
+	// Replayed with and without state filtering into recorders, which leaves the list's own stats alone and copies nothing
+	RenderList const& renderList = map->m_renderSnapshots.GetReadBuffer();
+	RecordingDrawBackend filteredRecorder;
+	RecordingDrawBackend unfilteredRecorder;
+	RenderListStats filteredStats;
+	RenderListStats unfilteredStats;
+	renderList.Replay(filteredRecorder, filteredStats);
+	renderList.Replay(unfilteredRecorder, unfilteredStats, false);
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Single View Replay", false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Draw commands", filteredRecorder.GetNumDrawCommands()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "State commands", filteredRecorder.GetNumStateCommands()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Unfiltered state commands", unfilteredRecorder.GetNumStateCommands()), false);
+
+	return true;
+}
+
+bool Game::Event_RenderListBenchmark(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Times building and sorting a synthetic render list and checks its sort order and state filtering without a map", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of draw items in the list", "items"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of times the list is rebuilt", "iterations"), false);
+		return true;
+	}
+
+	int numDrawItems = args.GetValue("items", 5000);
+	int numIterations = args.GetValue("iterations", 100);
+	if (numDrawItems <= 0 || numIterations <= 0)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run RenderListBenchmark help=true for usage", false);
+		return true;
+	}
+
+	RenderListBenchmarkResults results = RunRenderListBenchmark(numDrawItems, numIterations);
+	bool didPass = results.m_numSortOrderErrors == 0 && results.m_numStateMismatches == 0;
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Render List Benchmark (%d items, %d iterations)", numDrawItems, numIterations), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Build", results.m_averageBuildSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Sort", results.m_averageSortSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Draw commands", results.m_numDrawCommands), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d unfiltered)", "State commands", results.m_numStateCommands, results.m_numUnfilteredStateCommands), false);
+	g_console->AddLine(didPass ? Rgba8::MAGENTA : Rgba8::RED, Stringf("%-30s : %d out of order, %d state mismatches", "Errors", results.m_numSortOrderErrors, results.m_numStateMismatches), false);
+
+	return true;
+}
+
+bool Game::Event_NavBenchmark(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Times hierarchical pathfinding against full-grid search on a generated maze", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int >= 8] width and height of the maze in tiles", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of random path queries", "queries"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int >= 4] width and height of each cluster in tiles", "cluster"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 512);
+	int numQueries = args.GetValue("queries", 1000);
+	int clusterSize = args.GetValue("cluster", 16);
+	if (size < 8 || numQueries <= 0 || clusterSize < 4)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run NavBenchmark help=true for usage", false);
+		return true;
+	}
+
+	NavigationBenchmarkResults results = RunNavigationBenchmark(IntVec2(size, size), clusterSize, numQueries, 200, 10);
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Navigation Benchmark (%dx%d maze, %d tile clusters)", size, size, clusterSize), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Graph build", results.m_buildSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d portals in %d clusters", "Graph size", results.m_numPortals, results.m_numClusters), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.1f us", "Local tile update", results.m_averageTileUpdateSeconds * 1000000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.1f us (%d of %d found)", "Hierarchical query", results.m_averageQuerySeconds * 1000000.0, results.m_numPathsFound, results.m_numQueries), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.1f", "Nodes expanded per query", results.m_averageNodesExpanded), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Full-grid search", results.m_averageFullGridSearchSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f", "Worst path cost ratio", results.m_worstPathCostRatio), false);
+
+	return true;
+}
+
+static void PrintVoiceManagerStats(VoiceManager const& voiceManager)
+{
+	VoiceManagerStats const& stats = voiceManager.GetStats();
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d of %d", "Active voices", voiceManager.GetNumActiveVoices(), voiceManager.GetMaxVoices()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Peak active voices", stats.m_numPeakActiveVoices), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Requests", stats.m_numRequests), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Started", stats.m_numStarted), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Culled by distance", stats.m_numCulledByDistance), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d stolen, %d rejected", "Per-sound cap", stats.m_numStolenBySoundCap, stats.m_numRejectedBySoundCap), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d stolen, %d rejected", "Voice budget", stats.m_numStolenByBudget, stats.m_numRejectedByBudget), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Finished", stats.m_numFinished), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Position updates", stats.m_numPositionUpdates), false);
+}
+
+bool Game::Event_VoiceStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Voice Manager", false);
+	PrintVoiceManagerStats(*g_voiceManager);
+	return true;
+}
+
+bool Game::Event_VoiceStress(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Simulates a wave of soldiers firing, spotting, getting hurt and dying, against a stub audio backend", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of soldiers in the wave", "soldiers"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float > 0.f] simulated duration in seconds", "seconds"), false);
+		return true;
+	}
+
+	int numSoldiers = args.GetValue("soldiers", 20);
+	float durationSeconds = args.GetValue("seconds", 10.f);
+	if (numSoldiers <= 0 || durationSeconds <= 0.f)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run VoiceStress help=true for usage", false);
+		return true;
+	}
+
+	// Sound ids only need to be distinct for the stub, so fire, see, hurt and death use the first four
+	SoundID const fireSound = 0;
+	SoundID const seeSound = 1;
+	SoundID const hurtSound = 2;
+	SoundID const deathSound = 3;
+	float const voiceDurationSeconds = 1.5f;
+	float const deltaSeconds = 1.f / 60.f;
+
+	VoiceManager voiceManager(new StubAudioBackend(voiceDurationSeconds), g_gameConfigBlackboard.GetValue("maxAudioVoices", 32), g_gameConfigBlackboard.GetValue("maxAudioInstancesPerSound", 4), g_gameConfigBlackboard.GetValue("maxAudibleDistance", 40.f));
+	StubAudioBackend* managedBackend = dynamic_cast<StubAudioBackend*>(voiceManager.GetBackend());
+	StubAudioBackend unmanagedBackend(voiceDurationSeconds);
+	voiceManager.SetListenerPosition(0, Vec3::ZERO);
+
+	CounterRNG stressRNG = g_randomStreams->GetRNG(RandomStream::BENCHMARK, GetRandomSubjectForName("VoiceStress"));
+	std::vector<Vec3> soldierPositions;
+	std::vector<float> soldierNextFireSeconds;
+	std::vector<float> soldierDeathSeconds;
+	for (int soldierIndex = 0; soldierIndex < numSoldiers; soldierIndex++)
+	{
+		float distance = stressRNG.RollRandomFloatInRange(5.f, 60.f);
+		float angleDegrees = stressRNG.RollRandomFloatInRange(0.f, 360.f);
+		Vec2 positionXY = Vec2::MakeFromPolarDegrees(angleDegrees, distance);
+		soldierPositions.push_back(Vec3(positionXY.x, positionXY.y, 0.f));
+		soldierNextFireSeconds.push_back(stressRNG.RollRandomFloatInRange(0.f, 0.5f));
+		soldierDeathSeconds.push_back(stressRNG.RollRandomFloatInRange(durationSeconds * 0.5f, durationSeconds * 2.f));
+	}
+
+	for (float currentSeconds = 0.f; currentSeconds < durationSeconds; currentSeconds += deltaSeconds)
+	{
+		for (int soldierIndex = 0; soldierIndex < numSoldiers; soldierIndex++)
+		{
+			if (soldierDeathSeconds[soldierIndex] < 0.f)
+			{
+				continue;
+			}
+
+			Vec3 const& position = soldierPositions[soldierIndex];
+			if (currentSeconds == 0.f)
+			{
+				voiceManager.PlaySoundAt(seeSound, position);
+				unmanagedBackend.StartSoundAt(seeSound, position);
+			}
+			if (currentSeconds >= soldierNextFireSeconds[soldierIndex])
+			{
+				voiceManager.PlaySoundAt(fireSound, position);
+				unmanagedBackend.StartSoundAt(fireSound, position);
+				soldierNextFireSeconds[soldierIndex] += 0.25f;
+			}
+			if (stressRNG.RollRandomFloatInRange(0.f, 1.f) < deltaSeconds * 0.5f)
+			{
+				voiceManager.PlaySoundAt(hurtSound, position);
+				unmanagedBackend.StartSoundAt(hurtSound, position);
+			}
+			if (currentSeconds >= soldierDeathSeconds[soldierIndex])
+			{
+				voiceManager.PlaySoundAt(deathSound, position, VoicePriority::HIGH);
+				unmanagedBackend.StartSoundAt(deathSound, position);
+				soldierDeathSeconds[soldierIndex] = -1.f;
+			}
+		}
+
+		voiceManager.Update(nullptr);
+		managedBackend->AdvanceTime(deltaSeconds);
+		unmanagedBackend.AdvanceTime(deltaSeconds);
+	}
+
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Voice Stress (%d soldiers, %.1f seconds)", numSoldiers, durationSeconds), false);
+	PrintVoiceManagerStats(voiceManager);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Peak voices without manager", unmanagedBackend.m_numPeakPlayingVoices), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Backend starts", managedBackend->m_numStarts), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Backend stops", managedBackend->m_numStops), false);
+
+	return true;
+}
+
+static void PrintAllocationStats()
+{
+	for (int categoryIndex = 0; categoryIndex < (int)AllocationCategory::COUNT; categoryIndex++)
+	{
+		AllocationCategory category = (AllocationCategory)categoryIndex;
+		AllocationCategoryStats const& stats = GetAllocationStats(category);
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d live (%d bytes), %d peak bytes, %d allocated, %d freed", GetAllocationCategoryName(category), stats.m_numLiveAllocations, (int)stats.m_liveBytes, (int)stats.m_peakBytes, stats.m_numAllocations, stats.m_numFrees), false);
+	}
+}
+
+bool Game::Event_AllocationStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Allocations", false);
+	PrintAllocationStats();
+	return true;
+}
+
+// Soaks and benchmarks build their own tile map from a definition, separate from the map being played
+static Map* CreateBenchmarkMap(MapDefinition const& mapDef)
+{
+	return new Map(g_app->m_game, mapDef);
+}
+
+bool Game::Event_AllocationSoak(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Builds a map, spawns its actors, cycles their weapons and spawns particles, then deletes it and checks nothing was left behind", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map definition to load, defaults to the defaultMap config value", "map"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of build and teardown cycles", "cycles"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int >= 0] particles spawned per cycle", "particles"), false);
+		return true;
+	}
+
+	std::string mapName = args.GetValue("map", g_gameConfigBlackboard.GetValue("defaultMap", ""));
+	int numCycles = args.GetValue("cycles", 10);
+	int numParticles = args.GetValue("particles", 50);
+	auto mapDefIter = MapDefinition::s_mapDefs.find(mapName);
+	if (mapDefIter == MapDefinition::s_mapDefs.end() || numCycles <= 0 || numParticles < 0)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run AllocationSoak help=true for usage", false);
+		return true;
+	}
+
+	int numLeaked = 0;
+	int numLeakingCycles = 0;
+	for (int cycleIndex = 0; cycleIndex < numCycles; cycleIndex++)
+	{
+		AllocationSnapshot snapshot = TakeAllocationSnapshot();
+		Map* map = CreateBenchmarkMap(mapDefIter->second);
+
+		// Every equip used to allocate a new animation clock, so cycle through the whole inventory a few times
+		for (int actorIndex = 0; actorIndex < (int)map->m_actors.size(); actorIndex++)
+		{
+			Actor* actor = map->m_actors[actorIndex];
+			if (!actor)
+			{
+				continue;
+			}
+			for (int equipIndex = 0; equipIndex < 3 * (int)actor->m_weapons.size(); equipIndex++)
+			{
+				actor->EquipWeapon(equipIndex % (int)actor->m_weapons.size());
+			}
+		}
+
+	CounterRNG soakRNG = g_randomStreams->GetRNG(RandomStream::BENCHMARK, GetRandomSubjectForName("AllocationSoak"));
+		for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+		{
+			Vec3 position(soakRNG.RollRandomFloatInRange(0.f, 10.f), soakRNG.RollRandomFloatInRange(0.f, 10.f), 0.5f);
+			map->SpawnParticle(position, 0.05f, Rgba8::WHITE, 1.f);
+		}
+
+		delete map;
+
+		int numCycleLeaked = ReportAllocationLeaks(snapshot, "AllocationSoak");
+		if (numCycleLeaked > 0)
+		{
+			numLeaked += numCycleLeaked;
+			numLeakingCycles++;
+		}
+	}
+
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Allocation Soak (%s, %d cycles)", mapName.c_str(), numCycles), false);
+	g_console->AddLine(numLeaked > 0 ? Rgba8::RED : Rgba8::MAGENTA, Stringf("%-30s : %d in %d cycles", "Leaked allocations", numLeaked, numLeakingCycles), false);
+	PrintAllocationStats();
+	return true;
+}
+
+bool Game::Event_ProjectileStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_app->m_game->m_currentMap;
+	if (!map)
+	{
+		g_console->AddLine(Rgba8::RED, "No map is loaded", false);
+		return true;
+	}
+
+	ProjectileStats const& stats = map->m_projectiles.GetLastUpdateStats();
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Projectiles (last update)", false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Live", map->m_projectiles.GetNumProjectiles()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Spawned", stats.m_numSpawned), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Simulated", stats.m_numSimulated), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d actor, %d static", "Cylinder tests", stats.m_numActorTests, stats.m_numStaticActorTests), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d explosions)", "Impacts", stats.m_numImpacts, stats.m_numExplosions), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Update", stats.m_updateSeconds * 1000.0), false);
+	return true;
+}
+
+// Builds a fresh map, fires the projectiles from random open tiles and returns the average time of a map update
+static double TimeProjectileMapUpdates(MapDefinition const& mapDef, std::string const& projectileName, int numProjectiles, int numFrames, bool useProjectileSystem)
+{
+	Map* map = CreateBenchmarkMap(mapDef);
+
+	ActorUID ownerUID = ActorUID::INVALID;
+	for (int actorIndex = 0; actorIndex < (int)map->m_actors.size(); actorIndex++)
+	{
+		if (map->m_actors[actorIndex])
+		{
+			ownerUID = map->m_actors[actorIndex]->m_UID;
+			break;
+		}
+	}
+
+	CounterRNG spawnRNG = g_randomStreams->GetRNG(RandomStream::BENCHMARK, GetRandomSubjectForName("ProjectileStats"));
+	IntVec2 dimensions = map->GetDimensions();
+	int numSpawned = 0;
+	for (int attemptIndex = 0; attemptIndex < numProjectiles * 10 && numSpawned < numProjectiles; attemptIndex++)
+	{
+		Vec3 position(spawnRNG.RollRandomFloatInRange(0.f, (float)dimensions.x), spawnRNG.RollRandomFloatInRange(0.f, (float)dimensions.y), 0.5f);
+		if (map->m_solidGrid.IsTileSolid(RoundDownToInt(position.x), RoundDownToInt(position.y)))
+		{
+			continue;
+		}
+
+		EulerAngles orientation(spawnRNG.RollRandomFloatInRange(0.f, 360.f), 0.f, 0.f);
+		Vec3 velocity = orientation.GetAsMatrix_iFwd_jLeft_kUp().GetIBasis3D() * 4.f;
+		if (useProjectileSystem)
+		{
+			map->m_projectiles.Spawn(projectileName, position, orientation, velocity, ownerUID);
+		}
+		else
+		{
+			SpawnInfo spawnInfo;
+			spawnInfo.m_actor = projectileName;
+			spawnInfo.m_position = position;
+			spawnInfo.m_orientation = orientation;
+			Actor* projectileActor = map->SpawnActor(spawnInfo);
+			projectileActor->m_ownerUID = ownerUID;
+			projectileActor->AddImpulse(velocity);
+		}
+		numSpawned++;
+	}
+
+	double startTime = GetCurrentTimeSeconds();
+	for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		map->Update();
+	}
+	double averageSeconds = (GetCurrentTimeSeconds() - startTime) / (double)numFrames;
+
+	delete map;
+	return averageSeconds;
+}
+
+bool Game::Event_ProjectileBenchmark(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Times map updates with a burst of projectiles spawned as actors, and again with the same burst in the projectile system", false);
+		g_console->AddLine("Projectiles move by the game clock's current delta, so run it unpaused", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map definition to load, defaults to the defaultMap config value", "map"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] projectile actor definition, defaults to PlasmaProjectile", "projectile"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of projectiles", "projectiles"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of map updates timed", "frames"), false);
+		return true;
+	}
+
+	std::string mapName = args.GetValue("map", g_gameConfigBlackboard.GetValue("defaultMap", ""));
+	std::string projectileName = args.GetValue("projectile", "PlasmaProjectile");
+	int numProjectiles = args.GetValue("projectiles", 500);
+	int numFrames = args.GetValue("frames", 60);
+	auto mapDefIter = MapDefinition::s_mapDefs.find(mapName);
+	if (mapDefIter == MapDefinition::s_mapDefs.end() || ActorDefinition::s_actorDefs.find(projectileName) == ActorDefinition::s_actorDefs.end() || numProjectiles <= 0 || numFrames <= 0)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run ProjectileBenchmark help=true for usage", false);
+		return true;
+	}
+
+	// The map's own actors cost the same in every run, so the empty run is subtracted out
+	double baselineSeconds = TimeProjectileMapUpdates(mapDefIter->second, projectileName, 0, numFrames, true);
+	double actorSeconds = TimeProjectileMapUpdates(mapDefIter->second, projectileName, numProjectiles, numFrames, false) - baselineSeconds;
+	double systemSeconds = TimeProjectileMapUpdates(mapDefIter->second, projectileName, numProjectiles, numFrames, true) - baselineSeconds;
+
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Projectile Benchmark (%s, %d x %s, %d frames at %.4f s)", mapName.c_str(), numProjectiles, projectileName.c_str(), numFrames, g_app->m_game->m_gameClock.GetDeltaSeconds()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Map update without projectiles", baselineSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Projectiles as actors", actorSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Projectile system", systemSeconds * 1000.0), false);
+	if (systemSeconds > 0.0)
+	{
+		g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.1fx", "Speedup", actorSeconds / systemSeconds), false);
+	}
+	return true;
+}
+
+bool Game::Event_ActivityStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	Map* map = g_app->m_game->m_currentMap;
+	if (!map)
+	{
+		g_console->AddLine(Rgba8::RED, "No map is loaded", false);
+		return true;
+	}
+
+	ActivityTierStats const& stats = map->m_activityStats;
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Actor Activity (last update)", false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Active", stats.m_numActive), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (every %d frames)", "Reduced tick", stats.m_numReduced, ACTOR_REDUCED_TICK_INTERVAL), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Sleeping", stats.m_numSleeping), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d of %d", "Updated", stats.m_numUpdated, (int)map->m_actors.size()), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d woken, %d fell asleep", "Transitions (total)", stats.m_numWoken, stats.m_numFellAsleep), false);
+	return true;
+}
+
+bool Game::Event_SnapshotStress(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Hammers the render snapshot handoff from two threads and checks every snapshot read is whole and in order", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of snapshots the producer publishes", "snapshots"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] values written to each snapshot", "payload"), false);
+		return true;
+	}
+
+	int numSnapshots = args.GetValue("snapshots", 1000000);
+	int payloadSize = args.GetValue("payload", 256);
+	if (numSnapshots <= 0 || payloadSize <= 0)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run SnapshotStress help=true for usage", false);
+		return true;
+	}
+
+	SnapshotStressResults results = RunSnapshotExchangeStress(numSnapshots, payloadSize);
+	bool didPass = results.m_numTornReads == 0 && results.m_numOutOfOrderReads == 0;
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Snapshot Stress (%d snapshots, %d values each)", numSnapshots, payloadSize), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Published", results.m_numPublished), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d (%d skipped)", "Acquired", results.m_numAcquired, results.m_numSkipped), false);
+	g_console->AddLine(didPass ? Rgba8::MAGENTA : Rgba8::RED, Stringf("%-30s : %d torn, %d out of order", "Bad reads", results.m_numTornReads, results.m_numOutOfOrderReads), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Elapsed", results.m_elapsedSeconds * 1000.0), false);
+	return true;
+}
+
+// Order sensitive hash of a recorded command stream, vertex arrays are told apart by where their vertexes live and how many there are
+static uint64_t HashDrawCommands(std::vector<DrawCommand> const& commands)
+{
+	uint64_t hash = GeometryCache::HashValue(commands.size());
+	for (int commandIndex = 0; commandIndex < (int)commands.size(); commandIndex++)
+	{
+		DrawCommand const& command = commands[commandIndex];
+		hash = GeometryCache::HashValue(command.m_type, hash);
+		hash = GeometryCache::HashValue(command.m_value, hash);
+		hash = GeometryCache::HashValue(command.m_pointer, hash);
+		hash = GeometryCache::HashValue(command.m_count, hash);
+		hash = GeometryCache::HashValue(command.m_modelMatrix, hash);
+		hash = GeometryCache::HashValue(command.m_tint, hash);
+	}
+	return hash;
+}
+
+bool Game::Event_SimulationStress(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Steps a map on the simulation thread while this thread replays the snapshot published before the step, as the frame loop does", false);
+		g_console->AddLine("Every replay during the step has to record exactly what was recorded before it started, otherwise the step wrote into a published snapshot", false);
+		g_console->AddLine("Replays go to a recording backend, so nothing is drawn and the map being played is left alone", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map definition to load, defaults to the defaultMap config value", "map"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of simulation steps", "frames"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] replays per step, one for each view a frame renders", "views"), false);
+		return true;
+	}
+
+	std::string mapName = args.GetValue("map", g_gameConfigBlackboard.GetValue("defaultMap", ""));
+	int numFrames = args.GetValue("frames", 600);
+	int numViews = args.GetValue("views", 3);
+	auto mapDefIter = MapDefinition::s_mapDefs.find(mapName);
+	if (mapDefIter == MapDefinition::s_mapDefs.end() || numFrames <= 0 || numViews <= 0)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run SimulationStress help=true for usage", false);
+		return true;
+	}
+
+	Map* map = CreateBenchmarkMap(mapDefIter->second);
+
+	// One view looking straight down over the whole map, so culling keeps every tile chunk in the list
+	IntVec2 dimensions = map->GetDimensions();
+	float viewHeight = (float)std::max(dimensions.x, dimensions.y);
+	Mat44 overheadTransform = Mat44::CreateTranslation3D(Vec3((float)dimensions.x * 0.5f, (float)dimensions.y * 0.5f, viewHeight));
+	overheadTransform.Append(EulerAngles(0.f, 90.f, 0.f).GetAsMatrix_iFwd_jLeft_kUp());
+	std::vector<ViewFrustum> viewFrustums;
+	viewFrustums.push_back(ViewFrustum::CreatePerspective(overheadTransform, 1.f, 90.f, WORLD_CAMERA_NEAR, viewHeight * 2.f));
+
+	map->BuildRenderList(viewFrustums);
+	map->m_renderSnapshots.AcquireLatest();
+
+	int numMutatedFrames = 0;
+	int numUnpublishedFrames = 0;
+	double totalStepSeconds = 0.0;
+	double totalReplaySeconds = 0.0;
+	double startTime = GetCurrentTimeSeconds();
+	{
+		SimulationThread simulationThread([map]() { map->Update(); });
+		RecordingDrawBackend recorder;
+		RenderListStats replayStats;
+		for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+		{
+			RenderList const& snapshot = map->m_renderSnapshots.GetReadBuffer();
+			recorder.Clear();
+			snapshot.Replay(recorder, replayStats);
+			uint64_t publishedHash = HashDrawCommands(recorder.m_commands);
+
+			simulationThread.StartStep();
+
+			double replayStartTime = GetCurrentTimeSeconds();
+			bool wasMutated = false;
+			for (int viewIndex = 0; viewIndex < numViews; viewIndex++)
+			{
+				recorder.Clear();
+				snapshot.Replay(recorder, replayStats);
+				wasMutated = wasMutated || HashDrawCommands(recorder.m_commands) != publishedHash;
+			}
+			totalReplaySeconds += GetCurrentTimeSeconds() - replayStartTime;
+
+			simulationThread.WaitForStep();
+			totalStepSeconds += simulationThread.GetLastStepSeconds();
+			if (wasMutated)
+			{
+				numMutatedFrames++;
+			}
+
+			map->BuildRenderList(viewFrustums);
+			if (!map->m_renderSnapshots.AcquireLatest())
+			{
+				numUnpublishedFrames++;
+			}
+		}
+	}
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+	delete map;
+
+	bool didPass = numMutatedFrames == 0 && numUnpublishedFrames == 0;
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Simulation Stress (%s, %d frames, %d views)", mapName.c_str(), numFrames, numViews), false);
+	g_console->AddLine(didPass ? Rgba8::MAGENTA : Rgba8::RED, Stringf("%-30s : %d changed during the step, %d not published", "Bad snapshots", numMutatedFrames, numUnpublishedFrames), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Simulation step", totalStepSeconds / numFrames * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Replays during the step", totalReplaySeconds / numFrames * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Frame", elapsedSeconds / numFrames * 1000.0), false);
+	return true;
+}
+
+bool Game::Event_LateLatchStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	LateLatchStats const& stats = g_app->m_game->m_lateLatchStats;
+	g_console->AddLine(Rgba8::STEEL_BLUE, "Late Latch (last eye)", false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d", "Latches", stats.m_numLatches), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Update pose age", stats.m_lastUpdatePoseAgeSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f ms", "Latched pose age", stats.m_lastLatchedPoseAgeSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.3f degrees", "Head yaw correction", stats.m_lastHeadCorrectionDegrees), false);
+	return true;
+}
+
+// World pose of a tracked hand, the same way the player places its controllers
+static TrackedPose GetWorldHandPose(Vec3 const& playerPosition, EulerAngles const& playerOrientation, TrackedPose const& localPose)
+{
+	Mat44 playerModelMatrix = Mat44::CreateTranslation3D(playerPosition);
+	playerModelMatrix.Append(playerOrientation.GetAsMatrix_iFwd_jLeft_kUp());
+
+	TrackedPose worldPose;
+	worldPose.m_position = playerModelMatrix.TransformPosition3D(localPose.m_position);
+	worldPose.m_orientation = playerOrientation + localPose.m_orientation;
+	return worldPose;
+}
+
+static Mat44 GetTrackedPoseTransform(TrackedPose const& pose, Mat44 const& localTransform)
+{
+	Mat44 transform = Mat44::CreateTranslation3D(pose.m_position);
+	transform.Append(pose.m_orientation.GetAsMatrix_iFwd_jLeft_kUp());
+	transform.Append(localTransform);
+	return transform;
+}
+
+static bool AreTintsEqual(Rgba8 const& tintA, Rgba8 const& tintB)
+{
+	return tintA.r == tintB.r && tintA.g == tintB.g && tintA.b == tintB.b && tintA.a == tintB.a;
+}
+
+static Mat44 GetPlayerHeadTransform(Player const* player)
+{
+	Mat44 headTransform = Mat44::CreateTranslation3D(player->m_position);
+	headTransform.Append((player->m_orientation + player->m_hmdOrientation).GetAsMatrix_iFwd_jLeft_kUp());
+	return headTransform;
+}
+
+static float GetMatrixDifference(Mat44 const& matrixA, Mat44 const& matrixB)
+{
+	float difference = (matrixA.GetIBasis3D() - matrixB.GetIBasis3D()).GetLength();
+	difference = std::max(difference, (matrixA.GetJBasis3D() - matrixB.GetJBasis3D()).GetLength());
+	difference = std::max(difference, (matrixA.GetKBasis3D() - matrixB.GetKBasis3D()).GetLength());
+	return std::max(difference, (matrixA.GetTranslation3D() - matrixB.GetTranslation3D()).GetLength());
+}
+
+bool Game::Event_LateLatchTest(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Runs late latching on a test render list with a mock pose source injected, and checks the hand matrices recorded at submit", false);
+		g_console->AddLine("Hand errors compare where the weapons are drawn with where the hands are at display time, with and without the correction", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of frames", "frames"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float >= 0] milliseconds from the update pose to the latch", "simMs"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float >= 0] milliseconds from the latch to display", "renderMs"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float] head sway amplitude in degrees", "amplitude"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float] head sway frequency in hertz", "frequency"), false);
+		return true;
+	}
+
+	int numFrames = args.GetValue("frames", 900);
+	float simMilliseconds = args.GetValue("simMs", 11.f);
+	float renderMilliseconds = args.GetValue("renderMs", 3.f);
+	float amplitudeDegrees = args.GetValue("amplitude", 45.f);
+	float frequency = args.GetValue("frequency", 0.5f);
+	if (numFrames <= 0 || simMilliseconds < 0.f || renderMilliseconds < 0.f)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run LateLatchTest help=true for usage", false);
+		return true;
+	}
+
+	// Everything the latch touches on the live game is put back afterwards
+	Game* game = g_app->m_game;
+	MockPoseProvider* mockProvider = new MockPoseProvider(amplitudeDegrees, frequency);
+	PoseProvider* previousPoseProvider = game->SetPoseProvider(mockProvider);
+	LateLatchStats previousLateLatchStats = game->m_lateLatchStats;
+	Mat44 playerHeadTransform = GetPlayerHeadTransform(game->m_player);
+	Vec3 playerPosition = game->m_player->m_position;
+	EulerAngles playerOrientation = game->m_player->m_orientation;
+
+	// Weapons sit ahead of the hand, so the correction has to carry the item's own offset as well as the pose
+	// Items are told apart in the recording by tint, since sorting may reorder them
+	Mat44 const weaponOffset = Mat44::CreateTranslation3D(Vec3(0.15f, 0.f, -0.05f));
+	Mat44 const sceneModelMatrix = Mat44::CreateTranslation3D(Vec3(3.f, 2.f, 0.f));
+	Rgba8 const leftHandTint = Rgba8::RED;
+	Rgba8 const rightHandTint = Rgba8::GREEN;
+	Rgba8 const sceneTint = Rgba8::BLUE;
+	float const matrixTolerance = 0.001f;
+
+	RenderList renderList;
+	GameRenderState renderState;
+	renderState.m_playerPosition = playerPosition;
+	renderState.m_playerOrientation = playerOrientation;
+	RecordingDrawBackend recorder;
+	double const frameSeconds = 1.0 / 90.0;
+	int numMismatchedFrames = 0;
+	float maxMatrixError = 0.f;
+	double totalHandErrorWithout = 0.0;
+	double totalHandErrorWith = 0.0;
+	float maxHandErrorWithout = 0.f;
+	float maxHandErrorWith = 0.f;
+	for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		double updateTime = (double)frameIndex * frameSeconds;
+		double latchTime = updateTime + (double)simMilliseconds * 0.001;
+		double displayTime = latchTime + (double)renderMilliseconds * 0.001;
+
+		// Build the list as the map would, with the hands at their update pose
+		PoseSample updatePose;
+		mockProvider->SetManualTime(updateTime);
+		mockProvider->SamplePose(updatePose);
+		renderState.m_leftHandPose = GetWorldHandPose(playerPosition, playerOrientation, updatePose.m_leftController);
+		renderState.m_rightHandPose = GetWorldHandPose(playerPosition, playerOrientation, updatePose.m_rightController);
+
+		renderList.BeginBuild();
+		DrawItem leftHandItem;
+		leftHandItem.m_modelMatrix = GetTrackedPoseTransform(renderState.m_leftHandPose, weaponOffset);
+		leftHandItem.m_tint = leftHandTint;
+		leftHandItem.m_lateLatchSlot = LateLatchSlot::LEFT_HAND;
+		renderList.AddDrawItem(leftHandItem);
+		DrawItem rightHandItem;
+		rightHandItem.m_modelMatrix = GetTrackedPoseTransform(renderState.m_rightHandPose, weaponOffset);
+		rightHandItem.m_tint = rightHandTint;
+		rightHandItem.m_lateLatchSlot = LateLatchSlot::RIGHT_HAND;
+		renderList.AddDrawItem(rightHandItem);
+		DrawItem sceneItem;
+		sceneItem.m_modelMatrix = sceneModelMatrix;
+		sceneItem.m_tint = sceneTint;
+		renderList.AddDrawItem(sceneItem);
+		renderList.EndBuild();
+
+		mockProvider->SetManualTime(latchTime);
+		game->LateLatchPoses(renderList, renderState);
+
+		recorder.Clear();
+		RenderListStats replayStats;
+		renderList.Replay(recorder, replayStats);
+
+		PoseSample latchedPose;
+		mockProvider->SamplePose(latchedPose);
+		Mat44 expectedLeftHandMatrix = GetTrackedPoseTransform(GetWorldHandPose(playerPosition, playerOrientation, latchedPose.m_leftController), weaponOffset);
+		Mat44 expectedRightHandMatrix = GetTrackedPoseTransform(GetWorldHandPose(playerPosition, playerOrientation, latchedPose.m_rightController), weaponOffset);
+
+		int numMatchedItems = 0;
+		bool isFrameMismatched = false;
+		Mat44 drawnLeftHandMatrix = leftHandItem.m_modelMatrix;
+		for (int commandIndex = 0; commandIndex < (int)recorder.m_commands.size(); commandIndex++)
+		{
+			DrawCommand const& command = recorder.m_commands[commandIndex];
+			if (command.m_type != DrawCommandType::SET_MODEL_CONSTANTS)
+			{
+				continue;
+			}
+
+			Mat44 expectedMatrix = sceneModelMatrix;
+			if (AreTintsEqual(command.m_tint, leftHandTint))
+			{
+				expectedMatrix = expectedLeftHandMatrix;
+				drawnLeftHandMatrix = command.m_modelMatrix;
+			}
+			else if (AreTintsEqual(command.m_tint, rightHandTint))
+			{
+				expectedMatrix = expectedRightHandMatrix;
+			}
+			else if (!AreTintsEqual(command.m_tint, sceneTint))
+			{
+				isFrameMismatched = true;
+				continue;
+			}
+
+			float matrixError = GetMatrixDifference(command.m_modelMatrix, expectedMatrix);
+			maxMatrixError = std::max(maxMatrixError, matrixError);
+			isFrameMismatched = isFrameMismatched || matrixError > matrixTolerance;
+			numMatchedItems++;
+		}
+		if (isFrameMismatched || numMatchedItems != 3)
+		{
+			numMismatchedFrames++;
+		}
+
+		PoseSample displayPose;
+		mockProvider->SetManualTime(displayTime);
+		mockProvider->SamplePose(displayPose);
+		Vec3 displayedWeaponPosition = GetTrackedPoseTransform(GetWorldHandPose(playerPosition, playerOrientation, displayPose.m_leftController), weaponOffset).GetTranslation3D();
+		float handErrorWithout = (leftHandItem.m_modelMatrix.GetTranslation3D() - displayedWeaponPosition).GetLength();
+		float handErrorWith = (drawnLeftHandMatrix.GetTranslation3D() - displayedWeaponPosition).GetLength();
+		totalHandErrorWithout += handErrorWithout;
+		totalHandErrorWith += handErrorWith;
+		maxHandErrorWithout = std::max(maxHandErrorWithout, handErrorWithout);
+		maxHandErrorWith = std::max(maxHandErrorWith, handErrorWith);
+	}
+
+	bool didLatchWritePlayer = GetMatrixDifference(GetPlayerHeadTransform(game->m_player), playerHeadTransform) > 0.f;
+
+	delete game->SetPoseProvider(previousPoseProvider);
+	game->m_lateLatchStats = previousLateLatchStats;
+	game->UpdateEyeCameras();
+
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Late Latch Test (%d frames, %.1f ms sim, %.1f ms render)", numFrames, simMilliseconds, renderMilliseconds), false);
+	g_console->AddLine(numMismatchedFrames == 0 ? Rgba8::MAGENTA : Rgba8::RED, Stringf("%-30s : %d (largest matrix error %.5f)", "Frames with wrong matrices", numMismatchedFrames, maxMatrixError), false);
+	g_console->AddLine(didLatchWritePlayer ? Rgba8::RED : Rgba8::MAGENTA, Stringf("%-30s : %s", "Player pose written", didLatchWritePlayer ? "yes" : "no"), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f mm without, %.2f mm with", "Average hand error", totalHandErrorWithout / numFrames * 1000.0, totalHandErrorWith / numFrames * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f mm without, %.2f mm with", "Max hand error", maxHandErrorWithout * 1000.f, maxHandErrorWith * 1000.f), false);
+	return true;
+}
+
+bool Game::Event_RandomBenchmark(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Times the engine random generator against the keyed counter generator and checks threaded rolls match serial ones", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] float rolls timed on each generator", "rolls"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] keyed subjects, one generator each", "subjects"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] rolls made by each subject", "perSubject"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] threads sharing the subjects in the parallel pass", "threads"), false);
+		return true;
+	}
+
+	int numRolls = args.GetValue("rolls", 10000000);
+	int numSubjects = args.GetValue("subjects", 100000);
+	int rollsPerSubject = args.GetValue("perSubject", 16);
+	int numThreads = args.GetValue("threads", 4);
+	if (numRolls <= 0 || numSubjects <= 0 || rollsPerSubject <= 0 || numThreads <= 0)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run RandomBenchmark help=true for usage", false);
+		return true;
+	}
+
+	RandomBenchmarkResults results = RunRandomBenchmark(numRolls, numSubjects, rollsPerSubject, numThreads);
+	int numKeyedRolls = numSubjects * rollsPerSubject;
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Random Benchmark (%d rolls, %d subjects x %d rolls, %d threads)", numRolls, numSubjects, rollsPerSubject, numThreads), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f M/s (mean %.4f)", "Engine generator", (double)numRolls / results.m_engineSeconds * 0.000001, results.m_engineMean), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f M/s (mean %.4f)", "Counter generator", (double)numRolls / results.m_counterSeconds * 0.000001, results.m_counterMean), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f M/s", "Keyed, serial", (double)numKeyedRolls / results.m_keyedSeconds * 0.000001), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f M/s", "Keyed, parallel", (double)numKeyedRolls / results.m_parallelSeconds * 0.000001), false);
+	g_console->AddLine(results.m_numParallelMismatches == 0 ? Rgba8::MAGENTA : Rgba8::RED, Stringf("%-30s : %d", "Parallel mismatches", results.m_numParallelMismatches), false);
+	return true;
+}
+
+bool Game::Event_PlacementBenchmark(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Times Poisson-disk tree and rock placement over a large world against the old per-tile placement", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float > 0] side length of the square world scattered with the placer", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float > 0] side length for the per-tile placement, which is quadratic in the number of placements", "naiveSize"), false);
+		return true;
+	}
+
+	float worldSize = args.GetValue("size", 1000.f);
+	float naiveWorldSize = args.GetValue("naiveSize", 200.f);
+	if (worldSize <= 0.f || naiveWorldSize <= 0.f)
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run PlacementBenchmark help=true for usage", false);
+		return true;
+	}
+
+	PlacementBenchmarkResults results = RunPlacementBenchmark(worldSize, naiveWorldSize);
+	g_console->AddLine(Rgba8::STEEL_BLUE, Stringf("Placement Benchmark (%.0f x %.0f world, per-tile %.0f x %.0f)", worldSize, worldSize, naiveWorldSize, naiveWorldSize), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d in %.2f ms (%d candidates)", "Poisson-disk placements", results.m_numPlacements, results.m_poissonSeconds * 1000.0, results.m_numCandidates), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f k/s", "Poisson-disk rate", (double)results.m_numPlacements / results.m_poissonSeconds * 0.001), false);
+	g_console->AddLine(results.m_numSpacingViolations == 0 ? Rgba8::MAGENTA : Rgba8::RED, Stringf("%-30s : %d", "Spacing violations", results.m_numSpacingViolations), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %d in %.2f ms", "Per-tile placements", results.m_numNaivePlacements, results.m_naiveSeconds * 1000.0), false);
+	g_console->AddLine(Rgba8::MAGENTA, Stringf("%-30s : %.2f k/s", "Per-tile rate", (double)results.m_numNaivePlacements / results.m_naiveSeconds * 0.001), false);
+	return true;
+}
+
+bool Game::Event_LoadTileMap(EventArgs& args)
+{
+	bool help = args.GetValue("help", false);
+	if (help)
+	{
+		g_console->AddLine("Replaces the current map with a tile map built from a map definition, the game otherwise only starts the outdoor map", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map definition to load, defaults to the defaultMap config value", "map"), false);
+		return true;
+	}
+
+	std::string mapName = args.GetValue("map", g_gameConfigBlackboard.GetValue("defaultMap", ""));
+	auto mapDefIter = MapDefinition::s_mapDefs.find(mapName);
+	if (mapDefIter == MapDefinition::s_mapDefs.end())
+	{
+		g_console->AddLine(Rgba8::RED, "Invalid parameters, run LoadTileMap help=true for usage", false);
+		return true;
+	}
+
+	g_app->m_game->StartTileMap(mapDefIter->second);
+	return true;
+}
+
+void Game::StartSimulation()
+{
+	if (m_gameState != GameState::GAME || !m_currentMap)
+	{
+		return;
+	}
+
+	// A map loaded this frame has nothing published yet, so its first snapshot is built before the step moves anything
+	if (m_renderStateMap != m_currentMap)
+	{
+		BuildRenderList();
+	}
+
+	m_simulationThread->StartStep();
+}
+
+void Game::FinishSimulation()
+{
+	m_simulationThread->WaitForStep();
+}
+
+void Game::BuildRenderList()
+{
+	if (m_gameState != GameState::GAME || !m_currentMap)
+	{
+		return;
+	}
+
+	UpdateCameras();
+	UpdateViewFrustums();
+	m_currentMap->BuildRenderList(m_viewFrustums);
+
+	GameRenderState& renderState = m_renderStates.GetWriteBuffer();
+	renderState.m_playerPosition = m_player->m_position;
+	renderState.m_playerOrientation = m_player->m_orientation;
+	renderState.m_leftHandPose.m_position = m_player->m_leftControllerWorldPosition;
+	renderState.m_leftHandPose.m_orientation = m_player->m_leftControllerOrientation;
+	renderState.m_rightHandPose.m_position = m_player->m_rightControllerWorldPosition;
+	renderState.m_rightHandPose.m_orientation = m_player->m_rightControllerOrientation;
+	m_player->BuildHudState(renderState.m_hud);
+	m_renderStates.Publish();
+	m_renderStateMap = m_currentMap;
+}
+
+void Game::AcquireRenderSnapshot()
+{
+	if (m_gameState != GameState::GAME || !m_currentMap)
+	{
+		return;
+	}
+
+	// Every view this frame draws the newest published snapshot, even though the simulation has already moved past it
+	m_currentMap->m_renderSnapshots.AcquireLatest();
+	m_renderStates.AcquireLatest();
+}
+
+// Transform taking a hand drawn at its built world pose to where the late-latched local pose puts it
+static Mat44 GetHandLateLatchCorrection(TrackedPose const& builtWorldPose, Vec3 const& playerPosition, EulerAngles const& playerOrientation, TrackedPose const& latchedLocalPose)
+{
+	Mat44 playerModelMatrix = Mat44::CreateTranslation3D(playerPosition);
+	playerModelMatrix.Append(playerOrientation.GetAsMatrix_iFwd_jLeft_kUp());
+
+	Mat44 builtTransform = Mat44::CreateTranslation3D(builtWorldPose.m_position);
+	builtTransform.Append(builtWorldPose.m_orientation.GetAsMatrix_iFwd_jLeft_kUp());
+
+	Mat44 correction = Mat44::CreateTranslation3D(playerModelMatrix.TransformPosition3D(latchedLocalPose.m_position));
+	correction.Append((playerOrientation + latchedLocalPose.m_orientation).GetAsMatrix_iFwd_jLeft_kUp());
+	correction.Append(builtTransform.GetOrthonormalInverse());
+	return correction;
+}
+
+void Game::LateLatchPoses()
+{
+	if (m_gameState != GameState::GAME || !m_currentMap)
+	{
+		return;
+	}
+
+	LateLatchPoses(m_currentMap->m_renderSnapshots.GetReadBuffer(), m_renderStates.GetReadBuffer());
+}
+
+void Game::LateLatchPoses(RenderList const& renderList, GameRenderState const& renderState)
+{
+	if (!m_poseProvider->IsActive())
+	{
+		return;
+	}
+
+	// The eye cameras are render-side, so they take the latched head pose directly instead of going through the player
+	PoseSample latchedPose;
+	m_poseProvider->SamplePose(latchedPose);
+	SetEyeCameraTransforms(renderState.m_playerPosition, renderState.m_playerOrientation, latchedPose.m_leftEye.m_position, latchedPose.m_rightEye.m_position, latchedPose.m_rightEye.m_orientation);
+
+	// Hand weapons were baked into the render list with the update pose, so the list is given the difference instead of rebuilt
+	renderList.SetLateLatchCorrection(LateLatchSlot::LEFT_HAND, GetHandLateLatchCorrection(renderState.m_leftHandPose, renderState.m_playerPosition, renderState.m_playerOrientation, latchedPose.m_leftController));
+	renderList.SetLateLatchCorrection(LateLatchSlot::RIGHT_HAND, GetHandLateLatchCorrection(renderState.m_rightHandPose, renderState.m_playerPosition, renderState.m_playerOrientation, latchedPose.m_rightController));
+
+	double latchTime = GetCurrentTimeSeconds();
+	m_lateLatchStats.m_numLatches++;
+	m_lateLatchStats.m_lastUpdatePoseAgeSeconds = latchTime - m_updatePose.m_sampleTimeSeconds;
+	m_lateLatchStats.m_lastLatchedPoseAgeSeconds = latchTime - latchedPose.m_sampleTimeSeconds;
+	m_lateLatchStats.m_lastHeadCorrectionDegrees = GetShortestAngularDispDegrees(m_updatePose.m_rightEye.m_orientation.m_yawDegrees, latchedPose.m_rightEye.m_orientation.m_yawDegrees);
+}
+
+PoseProvider* Game::SetPoseProvider(PoseProvider* poseProvider)
+{
+	PoseProvider* previousPoseProvider = m_poseProvider;
+	m_poseProvider = poseProvider;
+	return previousPoseProvider;
+}
+
 void Game::Render() const
 {
 	switch (m_gameState)
@@ -233,9 +1355,16 @@ void Game::RenderWorldScreenQuad() const
 		float quadHeight = SCREEN_QUAD_DISTANCE * TanDegrees(30.f) * (currentEye == XREye::NONE ? 1.f : 0.5f);
 		float quadWidth = quadHeight * g_window->GetAspect();
 
-		// Render screen quad
-		std::vector<Vertex_PCU> screenVerts;
-		AddVertsForQuad3D(screenVerts, Vec3(0.f, quadWidth, -quadHeight), Vec3(0.f, -quadWidth, -quadHeight), Vec3(0.f, -quadWidth, quadHeight), Vec3(0.f, quadWidth, quadHeight), Rgba8::WHITE, AABB2(Vec2(1.f, 1.f), Vec2(0.f, 0.f)));
+		// Render screen quad, rebuilt only when its size changes
+		char const* screenQuadName = (currentEye == XREye::NONE ? "Game::WorldScreenQuad::Desktop" : "Game::WorldScreenQuad::Eye");
+		uint64_t screenQuadKey = GeometryCache::HashValue(quadHeight, GeometryCache::HashValue(quadWidth));
+		CachedMesh const* screenQuadMesh = g_geometryCache->FindMesh(screenQuadName, screenQuadKey);
+		if (!screenQuadMesh)
+		{
+			std::vector<Vertex_PCU> screenVerts;
+			AddVertsForQuad3D(screenVerts, Vec3(0.f, quadWidth, -quadHeight), Vec3(0.f, -quadWidth, -quadHeight), Vec3(0.f, -quadWidth, quadHeight), Vec3(0.f, quadWidth, quadHeight), Rgba8::WHITE, AABB2(Vec2(1.f, 1.f), Vec2(0.f, 0.f)));
+			screenQuadMesh = g_geometryCache->UpdateMesh(screenQuadName, screenQuadKey, screenVerts);
+		}
 		g_renderer->SetBlendMode(BlendMode::ALPHA);
 		g_renderer->SetDepthMode(DepthMode::DISABLED);
 		g_renderer->SetModelConstants(m_screenBillboardMatrix);
@@ -244,7 +1373,7 @@ void Game::RenderWorldScreenQuad() const
 		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 		g_renderer->BindTexture(g_app->m_screenRTVTexture);
 		g_renderer->BindShader(nullptr);
-		g_renderer->DrawVertexArray(screenVerts);
+		g_geometryCache->DrawMesh(screenQuadMesh);
 	}
 	g_renderer->EndRenderEvent("World Screen Quad");
 }
@@ -258,8 +1387,7 @@ void Game::GoToLobby()
 void Game::QuitToLobby()
 {
 	DebugRenderClear();
-	delete m_currentMap;
-	m_currentMap = nullptr;
+	UnloadCurrentMap();
 
 
 	g_audio->StopSound(m_gameMusicPlayback);
@@ -283,6 +1411,7 @@ void Game::StartGame()
 	//	}
 	//}
 
+	m_mapAllocationSnapshot = TakeAllocationSnapshot();
 	m_currentMap = new GoldMap(this);
 
 	g_audio->StopSound(m_attractMusicPlayback);
@@ -294,12 +1423,7 @@ void Game::StartGame()
 void Game::QuitToAttractScreen()
 {
 	DebugRenderClear();
-
-	if (m_currentMap)
-	{
-		delete m_currentMap;
-		m_currentMap = nullptr;
-	}
+	UnloadCurrentMap();
 
 	if (g_audio->IsPlaying(m_gameMusicPlayback))
 	{
@@ -317,6 +1441,7 @@ void Game::StartGold()
 	m_gameState = GameState::GAME;
 	m_timeInState = 0.f;
 
+	m_mapAllocationSnapshot = TakeAllocationSnapshot();
 	m_currentMap = new GoldMap(this);
 	m_currentMap->SpawnPlayer(0);
 
@@ -326,6 +1451,48 @@ void Game::StartGold()
 	g_audio->SetNumListeners(1);
 }
 
+void Game::StartTileMap(MapDefinition const& mapDef)
+{
+	DebugRenderClear();
+	UnloadCurrentMap();
+	m_gameState = GameState::GAME;
+	m_timeInState = 0.f;
+
+	m_mapAllocationSnapshot = TakeAllocationSnapshot();
+	m_currentMap = new Map(this, mapDef);
+	m_currentMap->SpawnPlayer(0);
+
+	g_audio->StopSound(m_attractMusicPlayback);
+	if (!g_audio->IsPlaying(m_gameMusicPlayback))
+	{
+		m_gameMusicPlayback = g_audio->StartSound(m_gameMusic, true, m_isMusicMuted ? 0.f : m_musicVolume);
+	}
+
+	g_audio->SetNumListeners(1);
+}
+
+void Game::UnloadCurrentMap()
+{
+	if (!m_currentMap)
+	{
+		return;
+	}
+
+	// Followed voices are keyed by actor UID, which the next map will hand out again to different actors
+	g_voiceManager->StopAll();
+	g_voiceManager->ClearListeners();
+
+	delete m_currentMap;
+	m_currentMap = nullptr;
+	m_renderStateMap = nullptr;
+
+	int numLeaked = ReportAllocationLeaks(m_mapAllocationSnapshot, "Map teardown");
+	if (numLeaked > 0)
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("Map teardown left %d allocations live, run AllocationStats for details", numLeaked), false);
+	}
+}
+
 void Game::UpdateIntroScreen(float deltaSeconds)
 {
 	m_timeInState += deltaSeconds;
@@ -370,9 +1537,9 @@ void Game::UpdateAttractScreen(float deltaSeconds)
 
 	Vec2 screenCenter = 0.5f * Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX), g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY));
 
-	DebugAddScreenText("Press spacebar to Start Game", screenCenter + Vec2::SOUTH * 350.f, 20.f, Vec2(0.5f, 0.5f), 0.f);
+	g_geometryCache->AddScreenText("Game::AttractScreen::StartPrompt", "Press spacebar to Start Game", screenCenter + Vec2::SOUTH * 350.f, 20.f, Vec2(0.5f, 0.5f));
 	//DebugAddScreenText("Press START to join with controller", screenCenter + Vec2::SOUTH * 325.f, 20.f, Vec2(0.5f, 0.5f), 0.f);
-	DebugAddScreenText("Press Escape to exit", screenCenter + Vec2::SOUTH * 375.f, 20.f, Vec2(0.5f, 0.5f), 0.f);
+	g_geometryCache->AddScreenText("Game::AttractScreen::ExitPrompt", "Press Escape to exit", screenCenter + Vec2::SOUTH * 375.f, 20.f, Vec2(0.5f, 0.5f));
 
 	UpdateCameras();
 }
@@ -387,13 +1554,13 @@ void Game::UpdatePlayerViewports()
 
 void Game::RenderIntroScreen() const
 {
-	SpriteSheet* logoSpriteSheet = new SpriteSheet(m_logoTexture, IntVec2(15, 19));
-	SpriteAnimDefinition logoAnimation(logoSpriteSheet, 0, 271, 2.f, SpriteAnimPlaybackType::ONCE);
-	SpriteAnimDefinition logoBlinkAnimation(logoSpriteSheet, 270, 271, 0.2f, SpriteAnimPlaybackType::LOOP);
+	SpriteAnimDefinition logoAnimation(m_logoSpriteSheet, 0, 271, 2.f, SpriteAnimPlaybackType::ONCE);
+	SpriteAnimDefinition logoBlinkAnimation(m_logoSpriteSheet, 270, 271, 0.2f, SpriteAnimPlaybackType::LOOP);
 	
-	std::vector<Vertex_PCU> introScreenVertexes;
-	std::vector<Vertex_PCU> introScreenFadeOutVertexes;
-	std::vector<Vertex_PCU> introScreenTextVerts;
+	std::vector<Vertex_PCU>& introScreenVertexes = g_frameArena->AcquireScratchVertexesPCU();
+	std::vector<Vertex_PCU>& introScreenFadeOutVertexes = g_frameArena->AcquireScratchVertexesPCU();
+	CachedMesh const* developerTextMesh = nullptr;
+	CachedMesh const* logoCreditTextMesh = nullptr;
 	AABB2 animatedLogoBox(Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX), g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY)) * 0.5f - Vec2(320.f, 200.f), Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX), g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY)) * 0.5f + Vec2(320.f, 200.f));
 	if (m_timeInState >= 2.f)
 	{
@@ -401,8 +1568,10 @@ void Game::RenderIntroScreen() const
 		AddVertsForAABB2(introScreenVertexes, animatedLogoBox, Rgba8::WHITE, currentSprite.GetUVs().m_mins, currentSprite.GetUVs().m_maxs);
 	
 		int glyphsToDraw = RoundDownToInt((64.f * m_timeInState - 128.f) / 3.f);
-		g_squirrelFont->AddVertsForTextInBox2D(introScreenTextVerts, AABB2(Vec2(0.f, 100.f), Vec2(g_screenSizeX, 120.f)), 20.f, "Developed by Shreyas (Rey) Nisal", Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.f), TextBoxMode::OVERRUN, glyphsToDraw);
-		g_squirrelFont->AddVertsForTextInBox2D(introScreenTextVerts, AABB2(Vec2(0.f, 70.f), Vec2(g_screenSizeX, 90.f)), 20.f, "Logo by Namita Nisal", Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.f), TextBoxMode::OVERRUN, glyphsToDraw);
+		char const* developerText = "Developed by Shreyas (Rey) Nisal";
+		char const* logoCreditText = "Logo by Namita Nisal";
+		developerTextMesh = g_geometryCache->GetOrBuildTextMesh("Game::IntroScreen::Developer", g_squirrelFont, AABB2(Vec2(0.f, 100.f), Vec2(g_screenSizeX, 120.f)), 20.f, developerText, Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.f), TextBoxMode::OVERRUN, std::min(glyphsToDraw, (int)strlen(developerText)));
+		logoCreditTextMesh = g_geometryCache->GetOrBuildTextMesh("Game::IntroScreen::LogoCredit", g_squirrelFont, AABB2(Vec2(0.f, 70.f), Vec2(g_screenSizeX, 90.f)), 20.f, logoCreditText, Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.f), TextBoxMode::OVERRUN, std::min(glyphsToDraw, (int)strlen(logoCreditText)));
 
 		if (m_timeInState >= 4.5f)
 		{
@@ -425,7 +1594,8 @@ void Game::RenderIntroScreen() const
 	g_renderer->BindShader(nullptr);
 
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(introScreenTextVerts);
+	g_geometryCache->DrawMesh(developerTextMesh);
+	g_geometryCache->DrawMesh(logoCreditTextMesh);
 
 	g_renderer->BindTexture(nullptr);
 	g_renderer->DrawVertexArray(introScreenFadeOutVertexes);
@@ -440,17 +1610,30 @@ void Game::RenderAttractScreen() const
 
 	std::string introText = "After shedding sweat, tears and blood, I somehow made it to the end of SD2.\nHowever, Prof. Butler did not stop coming for me.\nI was given Doomenstein Gold, one final mission.\nI was required to master new weapons, combat new enemies, and accomplish my objective.\n\nHowever, I was tired of fighting billboarded monsters in the creepy lit dungeons, so with Sid's help I stepped outside-\nwith true 3-dimensions and lighting with shadows.\n\nLittle did I know that my rebellion against the requirements was an expected move,\nand Prof. Butler had his army waiting for me.\nIt's now time for this final Gold mission,\nto combat Prof. Butler's army and finally free myself from SD2 once and for all!";
 	std::string creditsText = "\n\nCredits\n\nProgrammer\nShreyas (Rey) Nisal\n\nArt Direction\nEric Robles\n\nLogo Design and Animation\nNamita Nisal\n\nArt Assets\nKenney.nl\nQuaternius\n\nMusic and SFX\nopengameart.org\n\nSpecial Thanks\nProf. Matt Butler\nProf. Squirrel Eiserloh\nSiddhant (Sid) Thakur";
-	int numGlyphs = RoundDownToInt(m_timeInState * introText.length() / 45.f);
-	std::vector<Vertex_PCU> attractScreenTextVerts;
-	g_squirrelFont->AddVertsForTextInBox2D(attractScreenTextVerts, textBox, 40.f, introText + creditsText, Rgba8::WHITE, 0.7f, Vec2(0.f, 1.f), TextBoxMode::SHRINK_TO_FIT, numGlyphs);
+	std::string attractText = introText + creditsText;
+	// Clamped, so the text stops being laid out again once every glyph is revealed
+	int numGlyphs = std::min(RoundDownToInt(m_timeInState * introText.length() / 45.f), (int)attractText.length());
 
-	Vec2 screenCenter = 0.5f * Vec2(g_gameConfigBlackboard.GetValue("screenSizeX", g_screenSizeX), g_gameConfigBlackboard.GetValue("screenSizeY", g_screenSizeY));
+	// Text only changes when another glyph is revealed and the panels only when the screen size changes
+	uint64_t screenKey = GeometryCache::HashValue(g_screenSizeY, GeometryCache::HashValue(g_screenSizeX));
+	CachedMesh const* attractScreenTextMesh = g_geometryCache->GetOrBuildTextMesh("Game::AttractScreen::Text", g_squirrelFont, textBox, 40.f, attractText.c_str(), Rgba8::WHITE, 0.7f, Vec2(0.f, 1.f), TextBoxMode::SHRINK_TO_FIT, numGlyphs);
 
-	std::vector<Vertex_PCU> attractScreenBackgroundVerts;
-	std::vector<Vertex_PCU> attractScreenVertexes;
+	CachedMesh const* attractScreenBackgroundMesh = g_geometryCache->FindMesh("Game::AttractScreen::Background", screenKey);
+	if (!attractScreenBackgroundMesh)
+	{
+		std::vector<Vertex_PCU> attractScreenBackgroundVerts;
+		AddVertsForAABB2(attractScreenBackgroundVerts, AABB2(Vec2::ZERO, Vec2(g_screenSizeX, g_screenSizeY)), Rgba8::WHITE);
+		attractScreenBackgroundMesh = g_geometryCache->UpdateMesh("Game::AttractScreen::Background", screenKey, attractScreenBackgroundVerts);
+	}
+
+	CachedMesh const* attractScreenPanelMesh = g_geometryCache->FindMesh("Game::AttractScreen::Panel", screenKey);
+	if (!attractScreenPanelMesh)
+	{
+		std::vector<Vertex_PCU> attractScreenVertexes;
+		AddVertsForAABB2(attractScreenVertexes, screenBox, Rgba8(0, 0, 0, 185));
+		attractScreenPanelMesh = g_geometryCache->UpdateMesh("Game::AttractScreen::Panel", screenKey, attractScreenVertexes);
+	}
 
-	AddVertsForAABB2(attractScreenVertexes, screenBox, Rgba8(0, 0, 0, 185));
-	AddVertsForAABB2(attractScreenBackgroundVerts, AABB2(Vec2::ZERO, Vec2(g_screenSizeX, g_screenSizeY)), Rgba8::WHITE);
 	g_renderer->SetBlendMode(BlendMode::ALPHA);
 	g_renderer->SetDepthMode(DepthMode::DISABLED);
 	g_renderer->SetModelConstants();
@@ -459,11 +1642,11 @@ void Game::RenderAttractScreen() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(m_attractScreenBackgroundTexture);
-	g_renderer->DrawVertexArray(attractScreenBackgroundVerts);
+	g_geometryCache->DrawMesh(attractScreenBackgroundMesh);
 	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(attractScreenVertexes);
+	g_geometryCache->DrawMesh(attractScreenPanelMesh);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(attractScreenTextVerts);
+	g_geometryCache->DrawMesh(attractScreenTextMesh);
 }
 
 void Game::RenderLobby() const
@@ -9,7 +9,14 @@
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
+#include "Game/AllocationTracker.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/Player.hpp"
+#include "Game/PoseProvider.hpp"
+#include "Game/SnapshotExchange.hpp"
+#include "Game/ViewFrustum.hpp"
+
+#include <vector>
 
 class		App;
 class		Entity;
@@ -17,7 +24,11 @@ class		Player;
 class		Prop;
 class		Texture;
 class		Map;
+class		RenderList;
 class		GoldMap;
+class		SimulationThread;
+class		SpriteSheet;
+struct		MapDefinition;
 
 enum class GameState
 {
@@ -27,15 +38,39 @@ enum class GameState
 	GAME
 };
 
+// Everything the render side reads besides the map's render list, copied once the simulation step has finished
+// It is handed over through its own snapshot exchange, so views never read the player or actors while the next step moves them
+struct GameRenderState
+{
+public:
+	Vec3						m_playerPosition;
+	EulerAngles					m_playerOrientation;
+	// World-space hand poses baked into the render list, the baseline late-latch corrections are taken from
+	TrackedPose					m_leftHandPose;
+	TrackedPose					m_rightHandPose;
+	PlayerHudState				m_hud;
+};
+
 class Game
 {
 public:
 	~Game();
 	Game();
 	void						Update												();
+	// The map steps on the simulation thread between these two calls, while the main thread renders the last published snapshot
+	void						StartSimulation										();
+	void						FinishSimulation									();
+	void						BuildRenderList										();
+	void						AcquireRenderSnapshot								();
 	void						Render												() const;
 	void						RenderCustomScreens									() const;
 	void						RenderScreen										() const;
+	// Re-samples head and hand poses right before an eye renders, and patches the eye cameras and hand weapon draws
+	// Only render-side state changes, the player keeps the poses the frame was simulated with
+	void						LateLatchPoses										();
+	void						LateLatchPoses										(RenderList const& renderList, GameRenderState const& renderState);
+	// Takes ownership of the new provider and hands back the one it replaces
+	PoseProvider*				SetPoseProvider										(PoseProvider* poseProvider);
 
 	void						GoToLobby();
 	void						QuitToLobby();
@@ -43,6 +78,25 @@ public:
 	void						StartGame											();
 	void						QuitToAttractScreen									();
 	void						StartGold();
+	void						StartTileMap(MapDefinition const& mapDef);
+
+	static bool					Event_RenderStats(EventArgs& args);
+	static bool					Event_RenderListBenchmark(EventArgs& args);
+	static bool					Event_NavBenchmark(EventArgs& args);
+	static bool					Event_VoiceStats(EventArgs& args);
+	static bool					Event_VoiceStress(EventArgs& args);
+	static bool					Event_AllocationStats(EventArgs& args);
+	static bool					Event_AllocationSoak(EventArgs& args);
+	static bool					Event_ProjectileStats(EventArgs& args);
+	static bool					Event_ProjectileBenchmark(EventArgs& args);
+	static bool					Event_ActivityStats(EventArgs& args);
+	static bool					Event_SnapshotStress(EventArgs& args);
+	static bool					Event_SimulationStress(EventArgs& args);
+	static bool					Event_LateLatchStats(EventArgs& args);
+	static bool					Event_LateLatchTest(EventArgs& args);
+	static bool					Event_RandomBenchmark(EventArgs& args);
+	static bool					Event_PlacementBenchmark(EventArgs& args);
+	static bool					Event_LoadTileMap(EventArgs& args);
 	
 public:	
 	static constexpr float SCREEN_QUAD_DISTANCE = 2.f;
@@ -68,6 +122,8 @@ public:
 
 	Clock						m_gameClock = Clock();
 	Map*						m_currentMap = nullptr;
+	// Live allocations when the current map was created, compared against what is left once it is torn down
+	AllocationSnapshot			m_mapAllocationSnapshot;
 
 	Vec3						m_sunDirection = Vec3(2.f, -1.f, -1.f);
 	float						m_sunIntensity = 0.9f;
@@ -77,6 +133,13 @@ public:
 	bool						m_isSFXMuted = false;
 	Mat44						m_screenBillboardMatrix = Mat44::IDENTITY;
 
+	PoseProvider*				m_poseProvider = nullptr;
+	// Poses read at the start of the update, which the simulation and render list are built with
+	PoseSample					m_updatePose;
+	LateLatchStats				m_lateLatchStats;
+
+	SnapshotExchange<GameRenderState>	m_renderStates;
+
 private:
 
 	void						UpdateIntroScreen									(float deltaSeconds);
@@ -84,8 +147,13 @@ private:
 	void						UpdateLobby											(float deltaSeconds);
 	void						UpdateGame											(float deltaSeconds);
 	void						UpdatePlayers										(float deltaSeconds);
+	void						UpdateSimulation									();
 	void						UpdatePlayerViewports								();
 	void						UpdateCameras										();
+	void						UpdateEyeCameras									();
+	void						SetEyeCameraTransforms								(Vec3 const& playerPosition, EulerAngles const& playerOrientation, Vec3 const& leftEyeLocalPosition, Vec3 const& rightEyeLocalPosition, EulerAngles const& hmdOrientation);
+	void						ApplyHeadPose										(PoseSample const& pose);
+	void						UpdateViewFrustums									();
 
 	void						HandleDeveloperCheats								();
 
@@ -99,10 +167,17 @@ private:
 	void						RenderHUD											() const;
 
 	void						LoadAssets											();
+	void						UnloadCurrentMap									();
 
 private:
 	Texture*					m_testTexture										= nullptr;
 	Texture*					m_logoTexture										= nullptr;
+	SpriteSheet*				m_logoSpriteSheet									= nullptr;
 	Texture*					m_attractScreenBackgroundTexture					= nullptr;
 	float						m_timeInState										= 0.f;
+	SimulationThread*			m_simulationThread									= nullptr;
+	// Map the published render state was built from, a map loaded since has to publish before its first step
+	Map const*					m_renderStateMap									= nullptr;
+	// Views the render list is built for, the desktop camera and each eye when OpenXR is running
+	std::vector<ViewFrustum>	m_viewFrustums;
 };
\ No newline at end of file
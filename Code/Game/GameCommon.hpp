@@ -11,7 +11,6 @@
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -23,14 +22,23 @@
 #include "Game/ActorUID.hpp"
 
 class App;
+class RandomStreams;
+class GeometryCache;
+class VoiceManager;
+class FrameArena;
+class FramePacer;
 
 extern App*							g_app;
-extern RandomNumberGenerator*		g_RNG;
+extern RandomStreams*				g_randomStreams;
 extern Renderer*					g_renderer;
 extern AudioSystem*					g_audio;
 extern Window*						g_window;
 extern BitmapFont*					g_squirrelFont;
 extern ModelLoader*					g_modelLoader;
+extern GeometryCache*				g_geometryCache;
+extern VoiceManager*				g_voiceManager;
+extern FrameArena*					g_frameArena;
+extern FramePacer*					g_framePacer;
 
 extern float g_screenSizeX;
 extern float g_screenSizeY;
@@ -46,4 +54,39 @@ public:
 };
 
 constexpr float GRAVITY = 100.f;
+constexpr float ACTOR_GRID_CELL_SIZE = 2.f;
+// Channels separate the rolls one random subject makes in a frame (see RandomStreams::GetRNG)
+// Weapons add one per hand, collisions add the other actor's index and projectiles their detonation phase
+constexpr unsigned int RANDOM_CHANNEL_ACTOR_UPDATE = 0;
+constexpr unsigned int RANDOM_CHANNEL_ACTOR_DEATH = 1;
+constexpr unsigned int RANDOM_CHANNEL_WEAPON = 2;
+constexpr unsigned int RANDOM_CHANNEL_COLLISION = 8;
+constexpr unsigned int RANDOM_CHANNEL_PROJECTILE = 0xFFFF0000u;
+// Actors slower than this, with nothing to chase, fall asleep after resting for the delay
+constexpr float ACTOR_SLEEP_SPEED = 0.05f;
+constexpr float ACTOR_SLEEP_DELAY_SECONDS = 1.f;
+// Sleeping actors wake when an awake actor comes this close to their edge, or an enemy walks into their sight sector
+constexpr float ACTOR_WAKE_DISTANCE = 1.f;
+// AIs further than this from every player-controlled actor only update every few frames, with the skipped time folded in
+constexpr float ACTOR_REDUCED_TICK_DISTANCE = 24.f;
+constexpr int ACTOR_REDUCED_TICK_INTERVAL = 4;
+constexpr int TILE_CHUNK_SIZE = 16;
+// AIs chasing a target out of sight further than this follow a hierarchical path, closer ones use the target's flow field
+// The path is replanned once the target strays this many tiles from the tile it was planned to
+constexpr float AI_PATH_MIN_DISTANCE = 16.f;
+constexpr int AI_PATH_REPLAN_TILE_DISTANCE = 4;
+// Tiles every flow field compute on a map may search or bake per frame together, a 64x64 map's field completes in four frames
+constexpr int FLOW_FIELD_TILE_VISITS_PER_FRAME = 2048;
+// Desktop view, tile chunks are culled against it and against each eye's own view when OpenXR is running
+constexpr float WORLD_CAMERA_FOV_DEGREES = 60.f;
+constexpr float WORLD_CAMERA_NEAR = 0.1f;
+constexpr float WORLD_CAMERA_FAR = 1000.f;
+constexpr float XR_CAMERA_NEAR = 0.1f;
+constexpr float XR_CAMERA_FAR = 1000.f;
+// Gold map scatter spacing, two placements stay at least the sum of their radii apart
+// Tuned so the play area gets about as many trees and rocks as the old 8% roll per tile did, around 70 of each
+constexpr float GOLD_TREE_EXCLUSION_RADIUS = 1.1f;
+constexpr float GOLD_ROCK_EXCLUSION_RADIUS = 1.f;
+constexpr float GOLD_TREE_PLACEMENT_WEIGHT = 1.3f;
+constexpr float GOLD_SPAWN_CLEARING_RADIUS = 2.f;
 
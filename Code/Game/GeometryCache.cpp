@@ -0,0 +1,206 @@
+#include "Game/GeometryCache.hpp"
+
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Engine/Renderer/Window.hpp"
+
+#include <string.h>
+
+
+GeometryCache::~GeometryCache()
+{
+	InvalidateAll();
+}
+
+void GeometryCache::BeginFrame()
+{
+	IntVec2 windowDimensions = g_window->GetClientDimensions();
+	if (windowDimensions != m_windowDimensions)
+	{
+		InvalidateAll();
+		m_windowDimensions = windowDimensions;
+	}
+
+	m_lastFrameStats = m_currentFrameStats;
+	m_currentFrameStats = GeometryCacheStats();
+	m_numScreenTextLines = 0;
+}
+
+void GeometryCache::InvalidateAll()
+{
+	for (auto meshIter = m_meshes.begin(); meshIter != m_meshes.end(); ++meshIter)
+	{
+		ReleaseMesh(meshIter->second);
+	}
+	m_meshes.clear();
+}
+
+CachedMesh const* GeometryCache::FindMesh(char const* name, uint64_t contentKey) const
+{
+	auto meshIter = m_meshes.find(name);
+	if (meshIter == m_meshes.end() || meshIter->second.m_contentKey != contentKey)
+	{
+		return nullptr;
+	}
+	return &meshIter->second;
+}
+
+CachedMesh const* GeometryCache::UpdateMesh(char const* name, uint64_t contentKey, std::vector<Vertex_PCU> const& vertexes)
+{
+	auto meshIter = m_meshes.find(name);
+	if (meshIter == m_meshes.end())
+	{
+		meshIter = m_meshes.emplace(name, CachedMesh()).first;
+	}
+	CachedMesh& mesh = meshIter->second;
+
+	int numVertexes = (int)vertexes.size();
+	size_t vertexBytes = vertexes.size() * sizeof(Vertex_PCU);
+	size_t indexBytes = vertexes.size() * sizeof(unsigned int);
+
+	// Buffers are only recreated when the mesh outgrows them, so text whose glyph count changes every few frames does not thrash allocations
+	if (numVertexes > mesh.m_capacity)
+	{
+		ReleaseMesh(mesh);
+		mesh.m_vertexBuffer = g_renderer->CreateVertexBuffer(vertexBytes, VertexType::VERTEX_PCU);
+		mesh.m_indexBuffer = g_renderer->CreateIndexBuffer(indexBytes);
+		mesh.m_capacity = numVertexes;
+
+		std::vector<unsigned int> indexes;
+		indexes.reserve(vertexes.size());
+		for (int vertexIndex = 0; vertexIndex < numVertexes; vertexIndex++)
+		{
+			indexes.push_back((unsigned int)vertexIndex);
+		}
+		g_renderer->CopyCPUToGPU(indexes.data(), indexBytes, mesh.m_indexBuffer);
+		m_currentFrameStats.m_cacheUploadBytes += indexBytes;
+	}
+
+	if (numVertexes > 0)
+	{
+		g_renderer->CopyCPUToGPU(vertexes.data(), vertexBytes, mesh.m_vertexBuffer);
+	}
+	mesh.m_indexCount = numVertexes;
+	mesh.m_contentKey = contentKey;
+
+	m_currentFrameStats.m_numCacheUploads++;
+	m_currentFrameStats.m_cacheUploadBytes += vertexBytes;
+	return &mesh;
+}
+
+void GeometryCache::DrawMesh(CachedMesh const* mesh)
+{
+	if (!mesh || mesh->m_indexCount == 0)
+	{
+		return;
+	}
+
+	g_renderer->DrawIndexBuffer(mesh->m_vertexBuffer, mesh->m_indexBuffer, mesh->m_indexCount);
+	m_currentFrameStats.m_numCachedDraws++;
+}
+
+void GeometryCache::DrawDynamicVertexArray(std::vector<Vertex_PCU> const& vertexes)
+{
+	g_renderer->DrawVertexArray(vertexes);
+	RecordDynamicUpload(vertexes.size() * sizeof(Vertex_PCU));
+}
+
+void GeometryCache::RecordDynamicUpload(size_t numBytes)
+{
+	m_currentFrameStats.m_numDynamicDraws++;
+	m_currentFrameStats.m_dynamicUploadBytes += numBytes;
+}
+
+CachedMesh const* GeometryCache::GetOrBuildTextMesh(char const* name, BitmapFont* font, AABB2 const& box, float cellHeight, char const* text, Rgba8 const& tint, float cellAspect, Vec2 const& alignment, TextBoxMode mode, int maxGlyphsToDraw)
+{
+	uint64_t textKey = HashBytes(text, strlen(text), HashValue(font));
+	textKey = HashValue(box, textKey);
+	textKey = HashValue(cellHeight, textKey);
+	textKey = HashValue(tint, textKey);
+	textKey = HashValue(cellAspect, textKey);
+	textKey = HashValue(alignment, textKey);
+	textKey = HashValue(mode, textKey);
+	textKey = HashValue(maxGlyphsToDraw, textKey);
+
+	CachedMesh const* textMesh = FindMesh(name, textKey);
+	if (textMesh)
+	{
+		m_currentFrameStats.m_numTextBlocksReused++;
+		return textMesh;
+	}
+
+	m_textVertexes.clear();
+	font->AddVertsForTextInBox2D(m_textVertexes, box, cellHeight, text, tint, cellAspect, alignment, mode, maxGlyphsToDraw);
+	m_currentFrameStats.m_numTextBlocksRebuilt++;
+	return UpdateMesh(name, textKey, m_textVertexes);
+}
+
+void GeometryCache::AddScreenText(char const* name, char const* text, Vec2 const& position, float cellHeight, Vec2 const& alignment, Rgba8 const& tint)
+{
+	if (m_numScreenTextLines == (int)m_screenTextLines.size())
+	{
+		m_screenTextLines.emplace_back();
+	}
+	ScreenTextLine& line = m_screenTextLines[m_numScreenTextLines];
+	m_numScreenTextLines++;
+
+	line.m_name.assign(name);
+	line.m_text.assign(text);
+	line.m_position = position;
+	line.m_cellHeight = cellHeight;
+	line.m_alignment = alignment;
+	line.m_tint = tint;
+}
+
+void GeometryCache::RenderScreenText(BitmapFont* font, AABB2 const& screenBounds)
+{
+	if (m_numScreenTextLines == 0)
+	{
+		return;
+	}
+
+	g_renderer->SetBlendMode(BlendMode::ALPHA);
+	g_renderer->SetDepthMode(DepthMode::DISABLED);
+	g_renderer->SetModelConstants();
+	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_NONE);
+	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
+	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
+	g_renderer->BindShader(nullptr);
+	g_renderer->BindTexture(font->GetTexture());
+
+	// A screen-sized box on the aligned side of the position puts the aligned corner of the text exactly on it
+	Vec2 screenDimensions = screenBounds.GetDimensions();
+	for (int lineIndex = 0; lineIndex < m_numScreenTextLines; lineIndex++)
+	{
+		ScreenTextLine const& line = m_screenTextLines[lineIndex];
+		AABB2 textBox(line.m_position - line.m_alignment * screenDimensions, line.m_position + (Vec2(1.f, 1.f) - line.m_alignment) * screenDimensions);
+		CachedMesh const* textMesh = GetOrBuildTextMesh(line.m_name.c_str(), font, textBox, line.m_cellHeight, line.m_text.c_str(), line.m_tint, 0.7f, line.m_alignment, TextBoxMode::OVERRUN);
+		DrawMesh(textMesh);
+	}
+}
+
+uint64_t GeometryCache::HashBytes(void const* data, size_t numBytes, uint64_t seed)
+{
+	// FNV-1a, chained through the seed so several inputs can be folded into one key
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>(data);
+	uint64_t hash = seed;
+	for (size_t byteIndex = 0; byteIndex < numBytes; byteIndex++)
+	{
+		hash ^= (uint64_t)bytes[byteIndex];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void GeometryCache::ReleaseMesh(CachedMesh& mesh)
+{
+	delete mesh.m_vertexBuffer;
+	mesh.m_vertexBuffer = nullptr;
+	delete mesh.m_indexBuffer;
+	mesh.m_indexBuffer = nullptr;
+	mesh.m_indexCount = 0;
+	mesh.m_capacity = 0;
+}
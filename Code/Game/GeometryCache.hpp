@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class IndexBuffer;
+class VertexBuffer;
+
+struct CachedMesh
+{
+public:
+	VertexBuffer*	m_vertexBuffer = nullptr;
+	IndexBuffer*	m_indexBuffer = nullptr;
+	int				m_indexCount = 0;
+	uint64_t		m_contentKey = 0;
+	int				m_capacity = 0;
+};
+
+struct GeometryCacheStats
+{
+public:
+	int			m_numCachedDraws = 0;
+	int			m_numCacheUploads = 0;
+	size_t		m_cacheUploadBytes = 0;
+	int			m_numDynamicDraws = 0;
+	size_t		m_dynamicUploadBytes = 0;
+	int			m_numTextBlocksRebuilt = 0;
+	int			m_numTextBlocksReused = 0;
+};
+
+// A line of screen text queued during update and drawn from its cached mesh in the screen pass, replacing per-frame debug screen text
+// Name and text are copied, so callers can pass frame arena or stack strings
+struct ScreenTextLine
+{
+public:
+	std::string	m_name;
+	std::string	m_text;
+	Vec2		m_position = Vec2::ZERO;
+	float		m_cellHeight = 0.f;
+	Vec2		m_alignment = Vec2::ZERO;
+	Rgba8		m_tint = Rgba8::WHITE;
+};
+
+// Keeps constant or rarely changing meshes (skybox, screen quads, HUD) in GPU buffers across frames
+// A mesh is identified by name and validated by a content key hashed from whatever inputs generate it, so callers only rebuild vertexes when the key changes
+// Everything is invalidated when the window is resized, since most cached meshes are laid out in screen space
+class GeometryCache
+{
+public:
+	~GeometryCache();
+	GeometryCache() = default;
+
+	void					BeginFrame();
+	void					InvalidateAll();
+
+	CachedMesh const*		FindMesh(char const* name, uint64_t contentKey) const;
+	CachedMesh const*		UpdateMesh(char const* name, uint64_t contentKey, std::vector<Vertex_PCU> const& vertexes);
+	void					DrawMesh(CachedMesh const* mesh);
+
+	void					DrawDynamicVertexArray(std::vector<Vertex_PCU> const& vertexes);
+	void					RecordDynamicUpload(size_t numBytes);
+
+	// Text is laid out only when the string or any layout input changes, otherwise the mesh from an earlier frame is reused
+	CachedMesh const*		GetOrBuildTextMesh(char const* name, BitmapFont* font, AABB2 const& box, float cellHeight, char const* text, Rgba8 const& tint, float cellAspect, Vec2 const& alignment, TextBoxMode mode = TextBoxMode::SHRINK_TO_FIT, int maxGlyphsToDraw = 99999999);
+	void					AddScreenText(char const* name, char const* text, Vec2 const& position, float cellHeight, Vec2 const& alignment, Rgba8 const& tint = Rgba8::WHITE);
+	void					RenderScreenText(BitmapFont* font, AABB2 const& screenBounds);
+
+	GeometryCacheStats const&	GetLastFrameStats() const { return m_lastFrameStats; }
+	int						GetNumCachedMeshes() const { return (int)m_meshes.size(); }
+
+	static uint64_t			HashBytes(void const* data, size_t numBytes, uint64_t seed = 14695981039346656037ull);
+	template <typename T>
+	static uint64_t			HashValue(T const& value, uint64_t seed = 14695981039346656037ull) { return HashBytes(&value, sizeof(T), seed); }
+
+private:
+	void					ReleaseMesh(CachedMesh& mesh);
+
+private:
+	std::map<std::string, CachedMesh, std::less<>>	m_meshes;
+	IntVec2								m_windowDimensions = IntVec2(-1, -1);
+	GeometryCacheStats					m_currentFrameStats;
+	GeometryCacheStats					m_lastFrameStats;
+	// Lines are reused across frames so their strings keep their capacity
+	std::vector<ScreenTextLine>			m_screenTextLines;
+	int									m_numScreenTextLines = 0;
+	std::vector<Vertex_PCU>				m_textVertexes;
+};
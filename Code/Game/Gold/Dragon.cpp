@@ -9,6 +9,7 @@ Dragon::Dragon(Map* map, SpawnInfo const& spawnInfo, ActorUID uid)
 
 }
 
-void Dragon::Render() const
+void Dragon::AddDrawItems(RenderList& renderList) const
 {
+	UNUSED(renderList);
 }
@@ -10,7 +10,7 @@ public:
 	~Dragon() = default;
 	Dragon(Map* map, SpawnInfo const& spawnInfo, ActorUID uid);
 
-	virtual void				Render() const override;
+	virtual void				AddDrawItems(RenderList& renderList) const override;
 
 public:
 	Model* m_model = nullptr;
@@ -1,10 +1,16 @@
 #include "Game/Gold/GoldMap.hpp"
 
+#include "Game/AllocationTracker.hpp"
+#include "Game/CounterRNG.hpp"
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/GeometryCache.hpp"
 #include "Game/Player.hpp"
+#include "Game/PoissonDiskPlacement.hpp"
 #include "Game/Gold/Tree.hpp"
 #include "Game/Gold/Rock.hpp"
+#include "Game/Gold/StaticMesh.hpp"
 #include "Game/Gold/PlayerActor.hpp"
 #include "Game/Gold/Dragon.hpp"
 #include "Game/WeaponDefinition.hpp"
@@ -15,10 +21,21 @@
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/VirtualReality/OpenXR.hpp"
 
+#include <algorithm>
 #include <string>
 
 GoldMap::~GoldMap()
 {
+	for (int staticActorIndex = 0; staticActorIndex < (int)m_staticActors.size(); staticActorIndex++)
+	{
+		delete m_staticActors[staticActorIndex];
+	}
+	m_staticActors.clear();
+
+	if (m_fullscreenVBO)
+	{
+		TrackFree(AllocationCategory::GPU_BUFFERS, 6 * sizeof(Vertex_PCU));
+	}
 	delete m_fullscreenVBO;
 	m_fullscreenVBO = nullptr;
 }
@@ -26,7 +43,6 @@ GoldMap::~GoldMap()
 GoldMap::GoldMap(Game* game)
 {
 	m_game = game;
-	m_blockModel = g_modelLoader->CreateModelFromObj("Data/Models/block", Mat44(Vec3::SOUTH, Vec3::SKYWARD, Vec3::WEST, Vec3::ZERO));
 	m_shader = g_renderer->CreateOrGetShader("Data/Shaders/DiffuseUseShadows", VertexType::VERTEX_PCUTBN);
 	m_diffuseShader = g_renderer->CreateOrGetShader("Data/Shaders/Diffuse", VertexType::VERTEX_PCUTBN);
 	m_skyboxTexture = g_renderer->CreateOrGetTextureFromFile("Data/Images/SpaceSkybox.png");
@@ -39,8 +55,8 @@ GoldMap::GoldMap(Game* game)
 	CreateSpawnPoint(playerSpawnInfo);
 
 	PlaceCliffs();
-	PlaceTrees();
-	PlaceRocks();
+	PlaceTreesAndRocks();
+	m_projectiles.SetStaticActors(m_staticActors);
 
 	m_renderTargetTexture = g_renderer->CreateRenderTargetTexture("GoldMap::RenderTexture", g_window->GetClientDimensions());
 
@@ -55,90 +71,131 @@ GoldMap::GoldMap(Game* game)
 		Vertex_PCU(Vec3(-1.f, 1.f, 0.5f), Rgba8::WHITE, Vec2(0.f, 0.f))
 	};
 	m_fullscreenVBO = g_renderer->CreateVertexBuffer(sizeof(fullscreenQuad));
+	TrackAllocation(AllocationCategory::GPU_BUFFERS, sizeof(fullscreenQuad));
 	g_renderer->CopyCPUToGPU(fullscreenQuad, sizeof(fullscreenQuad), m_fullscreenVBO);
 
 	m_shadowShader = g_renderer->CreateOrGetShader("Data/Shaders/ShadowShader", VertexType::VERTEX_PCUTBN);
 	m_shadowMap = g_renderer->CreateDepthBuffer("GoldMap::ShadowMap", g_window->GetClientDimensions());
 
+	BuildStaticBatches();
+	BuildNavigationGrid();
+	CreateParticleMesh();
 }
 
-void GoldMap::PlaceCliffs()
+void GoldMap::BuildNavigationGrid()
 {
-	for (int y = 0; y < 50; y += 4)
+	// The outdoor map has no tile grid, so tiles whose centers lie inside a static actor's collision disc are blocked instead
+	m_navigationBlockedTiles.assign(m_dimensions.x * m_dimensions.y, 0);
+	for (int staticActorIndex = 0; staticActorIndex < (int)m_staticActors.size(); staticActorIndex++)
 	{
-		for (int x = 0; x < 50; x += 4)
+		StaticActor const* staticActor = m_staticActors[staticActorIndex];
+		Vec2 center = staticActor->m_position.GetXY();
+		float radius = staticActor->m_physicsRadius;
+
+		int minTileX = std::max(RoundDownToInt(center.x - radius), 0);
+		int minTileY = std::max(RoundDownToInt(center.y - radius), 0);
+		int maxTileX = std::min(RoundDownToInt(center.x + radius), m_dimensions.x - 1);
+		int maxTileY = std::min(RoundDownToInt(center.y + radius), m_dimensions.y - 1);
+		for (int tileY = minTileY; tileY <= maxTileY; tileY++)
 		{
-			if (x == 0 || x == 48)
-			{
-				float scale = g_RNG->RollRandomFloatInRange(10.f, 15.f);
-				float rollDegrees = g_RNG->RollRandomFloatInRange(-10.f, 10.f);
-				float pitchDegrees = g_RNG->RollRandomFloatInRange(-10.f, 10.f);
-				float yawDegrees = g_RNG->RollRandomFloatInRange(75.f, 105.f);
-				unsigned char color = (unsigned char)g_RNG->RollRandomIntInRange(100, 200);
-				m_staticActors.push_back(new Rock(this, Vec3((float)x, (float)y, -1.5f), EulerAngles(yawDegrees, pitchDegrees, rollDegrees), scale, Rgba8(color, color, color, 255)));
-			}
-			else if (y == 0 || y == 48)
+			for (int tileX = minTileX; tileX <= maxTileX; tileX++)
 			{
-				float scale = g_RNG->RollRandomFloatInRange(10.f, 15.f);
-				float rollDegrees = g_RNG->RollRandomFloatInRange(-10.f, 10.f);
-				float pitchDegrees = g_RNG->RollRandomFloatInRange(-10.f, 10.f);
-				float yawDegrees = g_RNG->RollRandomFloatInRange(-15.f, 15.f);
-				unsigned char color = (unsigned char)g_RNG->RollRandomIntInRange(100, 200);
-				m_staticActors.push_back(new Rock(this, Vec3((float)x, (float)y, -1.5f), EulerAngles(yawDegrees, pitchDegrees, rollDegrees), scale, Rgba8(color, color, color, 255)));
+				if (IsPointInsideDisc2D(Vec2((float)tileX + 0.5f, (float)tileY + 0.5f), center, radius))
+				{
+					m_navigationBlockedTiles[tileX + tileY * m_dimensions.x] = 1;
+				}
 			}
 		}
 	}
+	m_navigationVersion++;
+	m_navGraph.Build(m_navigationBlockedTiles, m_dimensions);
 }
 
-void GoldMap::PlaceTrees()
+void GoldMap::PlaceCliffs()
 {
-	for (int y = 10; y < 40; y++)
+	// Cliffs, trees and rocks each roll on their own channel, so changing one never reshuffles the others
+	CounterRNG placementRNG = g_randomStreams->GetRNG(RandomStream::MAP_GENERATION, GetRandomSubjectForName(m_definition.m_name.c_str()), 0, 0);
+	// Cliffs ring the map every 4 tiles, the far ring on the last multiple of 4 inside the map
+	int farCliffX = ((m_dimensions.x - 1) / 4) * 4;
+	int farCliffY = ((m_dimensions.y - 1) / 4) * 4;
+	for (int y = 0; y < m_dimensions.y; y += 4)
 	{
-		for (int x = 10; x < 40; x++)
+		for (int x = 0; x < m_dimensions.x; x += 4)
 		{
-			if (g_RNG->RollRandomChance(0.08f))
+			if (x == 0 || x == farCliffX)
 			{
-				if (IsValidSpawnLocation((float)x, (float)y))
-				{
-					m_staticActors.push_back(new Tree(this, Vec3((float)x, (float)y, 0.f)));
-				}
+				float scale = placementRNG.RollRandomFloatInRange(10.f, 15.f);
+				float rollDegrees = placementRNG.RollRandomFloatInRange(-10.f, 10.f);
+				float pitchDegrees = placementRNG.RollRandomFloatInRange(-10.f, 10.f);
+				float yawDegrees = placementRNG.RollRandomFloatInRange(75.f, 105.f);
+				unsigned char color = (unsigned char)placementRNG.RollRandomIntInRange(100, 200);
+				m_staticActors.push_back(new Rock(this, Vec3((float)x, (float)y, -1.5f), EulerAngles(yawDegrees, pitchDegrees, rollDegrees), scale, Rgba8(color, color, color, 255)));
+			}
+			else if (y == 0 || y == farCliffY)
+			{
+				float scale = placementRNG.RollRandomFloatInRange(10.f, 15.f);
+				float rollDegrees = placementRNG.RollRandomFloatInRange(-10.f, 10.f);
+				float pitchDegrees = placementRNG.RollRandomFloatInRange(-10.f, 10.f);
+				float yawDegrees = placementRNG.RollRandomFloatInRange(-15.f, 15.f);
+				unsigned char color = (unsigned char)placementRNG.RollRandomIntInRange(100, 200);
+				m_staticActors.push_back(new Rock(this, Vec3((float)x, (float)y, -1.5f), EulerAngles(yawDegrees, pitchDegrees, rollDegrees), scale, Rgba8(color, color, color, 255)));
 			}
 		}
 	}
 }
 
-void GoldMap::PlaceRocks()
+void GoldMap::PlaceTreesAndRocks()
 {
-	for (int y = 10; y < 40; y++)
+	// One blue-noise pass for both, so trees and rocks keep their distance from each other as well as from their own kind
+	unsigned int mapSubject = GetRandomSubjectForName(m_definition.m_name.c_str());
+	CounterRNG placementRNG = g_randomStreams->GetRNG(RandomStream::MAP_GENERATION, mapSubject, 0, 1);
+	CounterRNG rockRNG = g_randomStreams->GetRNG(RandomStream::MAP_GENERATION, mapSubject, 0, 2);
+
+	// Model 0 is a tree, model 1 a rock
+	std::vector<PlacementModel> models(2);
+	models[0].m_exclusionRadius = GOLD_TREE_EXCLUSION_RADIUS;
+	models[0].m_weight = GOLD_TREE_PLACEMENT_WEIGHT;
+	models[1].m_exclusionRadius = GOLD_ROCK_EXCLUSION_RADIUS;
+
+	PoissonDiskPlacer placer(AABB2(Vec2(10.f, 10.f), Vec2((float)m_dimensions.x - 10.f, (float)m_dimensions.y - 10.f)), models);
+	for (int staticActorIndex = 0; staticActorIndex < (int)m_staticActors.size(); staticActorIndex++)
+	{
+		placer.AddObstacle(m_staticActors[staticActorIndex]->m_position.GetXY(), m_staticActors[staticActorIndex]->m_physicsRadius);
+	}
+	for (int spawnPointIndex = 0; spawnPointIndex < (int)m_spawnPoints.size(); spawnPointIndex++)
+	{
+		placer.AddObstacle(m_spawnPoints[spawnPointIndex]->m_position.GetXY(), GOLD_SPAWN_CLEARING_RADIUS);
+	}
+
+	std::vector<Placement> placements;
+	placer.Generate(placements, placementRNG);
+	for (int placementIndex = 0; placementIndex < (int)placements.size(); placementIndex++)
 	{
-		for (int x = 10; x < 40; x++)
+		Placement const& placement = placements[placementIndex];
+		Vec3 position(placement.m_position.x, placement.m_position.y, 0.f);
+		if (placement.m_modelIndex == 0)
 		{
-			if (g_RNG->RollRandomChance(0.08f))
-			{
-				if (IsValidSpawnLocation((float)x, (float)y))
-				{
-					float scale = g_RNG->RollRandomFloatInRange(0.25f, 2.5f);
-					//float rollDegrees = g_RNG->RollRandomFloatInRange(-10.f, 10.f);
-					//float pitchDegrees = g_RNG->RollRandomFloatInRange(-10.f, 10.f);
-					float rollDegrees = 0.f;
-					float pitchDegrees = 0.f;
-					float yawDegrees = g_RNG->RollRandomFloatInRange(0.f, 360.f);
-					unsigned char color = (unsigned char)g_RNG->RollRandomIntInRange(100, 200);
-					m_staticActors.push_back(new Rock(this, Vec3((float)x, (float)y, 0.f), EulerAngles(yawDegrees, pitchDegrees, rollDegrees), scale, Rgba8(color, color, color, 255)));
-				}
-			}
+			m_staticActors.push_back(new Tree(this, position));
+		}
+		else
+		{
+			float scale = rockRNG.RollRandomFloatInRange(0.25f, 2.5f);
+			float yawDegrees = rockRNG.RollRandomFloatInRange(0.f, 360.f);
+			unsigned char color = (unsigned char)rockRNG.RollRandomIntInRange(100, 200);
+			m_staticActors.push_back(new Rock(this, position, EulerAngles(yawDegrees, 0.f, 0.f), scale, Rgba8(color, color, color, 255)));
 		}
 	}
 }
 
 void GoldMap::SpawnWave()
 {
+	CounterRNG spawnRNG = g_randomStreams->GetRNG(RandomStream::SPAWNING, GetRandomSubjectForName(m_definition.m_name.c_str()), m_frameIndex, (unsigned int)m_level);
 	for (int enemySoldierIndex = 0; enemySoldierIndex < SOLDIERS_IN_WAVE[m_level]; enemySoldierIndex++)
 	{
 		SpawnInfo soldierSpawnInfo;
 		soldierSpawnInfo.m_actor = m_level == 0 ? "EnemyKnifeSoldier" : "EnemyPistolSoldier";
-		soldierSpawnInfo.m_position = g_RNG->RollRandomVec3InAABB3(AABB3(Vec3(10.f, 10.f, 1.f), Vec3((float)m_dimensions.x - 10.f, (float)m_dimensions.y - 10.f, 3.f)));
-		soldierSpawnInfo.m_orientation = EulerAngles(g_RNG->RollRandomFloatInRange(-45.f, 45.f), 0.f, 0.f);
+		soldierSpawnInfo.m_position = spawnRNG.RollRandomVec3InAABB3(AABB3(Vec3(10.f, 10.f, 1.f), Vec3((float)m_dimensions.x - 10.f, (float)m_dimensions.y - 10.f, 3.f)));
+		soldierSpawnInfo.m_orientation = EulerAngles(spawnRNG.RollRandomFloatInRange(-45.f, 45.f), 0.f, 0.f);
 		SpawnActor(soldierSpawnInfo);
 	}
 
@@ -146,32 +203,49 @@ void GoldMap::SpawnWave()
 	{
 		SpawnInfo tankSpawnInfo;
 		tankSpawnInfo.m_actor = "Tank";
-		tankSpawnInfo.m_position = g_RNG->RollRandomVec3InAABB3(AABB3(Vec3(10.f, 10.f, 0.2f), Vec3((float)m_dimensions.x - 10.f, (float)m_dimensions.y - 10.f, 0.5f)));
-		tankSpawnInfo.m_orientation = EulerAngles(g_RNG->RollRandomFloatInRange(0.f, 360.f), 0.f, 0.f);
+		tankSpawnInfo.m_position = spawnRNG.RollRandomVec3InAABB3(AABB3(Vec3(10.f, 10.f, 0.2f), Vec3((float)m_dimensions.x - 10.f, (float)m_dimensions.y - 10.f, 0.5f)));
+		tankSpawnInfo.m_orientation = EulerAngles(spawnRNG.RollRandomFloatInRange(0.f, 360.f), 0.f, 0.f);
 		SpawnActor(tankSpawnInfo);
 	}
 
 	m_remainingEnemies += SOLDIERS_IN_WAVE[m_level] + TANKS_IN_WAVE[m_level];
 }
 
-void GoldMap::Update()
+void GoldMap::UpdateMainThread()
 {
 	ShowLevelMessage();
 	HandleWaveStart();
 
 	if (m_isCombatMode)
 	{
-		DebugAddScreenText(Stringf("Enemies Remaining: %d / %d", m_remainingEnemies, (SOLDIERS_IN_WAVE[m_level] + TANKS_IN_WAVE[m_level])), Vec2::ZERO, 25.f, Vec2::ZERO, 0.f, Rgba8::MAROON, Rgba8::RED);
+		g_geometryCache->AddScreenText("GoldMap::EnemiesRemaining", g_frameArena->Format("Enemies Remaining: %d / %d", m_remainingEnemies, (SOLDIERS_IN_WAVE[m_level] + TANKS_IN_WAVE[m_level])), Vec2::ZERO, 25.f, Vec2::ZERO, Rgba8::MAROON);
+	}
+
+	if (m_game->m_drawDebug)
+	{
+		for (int actorIndex = 0; actorIndex < (int)m_staticActors.size(); actorIndex++)
+		{
+			m_staticActors[actorIndex]->RenderDebug();
+		}
 	}
+}
 
+void GoldMap::Update()
+{
 	UpdateActors();
 	UpdateVisualActors();
+	RebuildActorGrid();
+	UpdateActivityTiers();
 	CollideActors();
 	CollideActorsWithStaticActors();
 	CollideActorsWithMap();
+	StoreActorSweepStartPositions();
+	m_projectiles.Update();
 	UpdateActorPivotPositions();
 	
 	DeleteDestroyedActors();
+	DeleteUnusedFlowFields();
+	m_flowFieldTileVisitsRemaining = FLOW_FIELD_TILE_VISITS_PER_FRAME;
 }
 
 void GoldMap::UpdateActorPivotPositions()
@@ -186,53 +260,172 @@ void GoldMap::UpdateActorPivotPositions()
 	}
 }
 
-void GoldMap::Render() const
+void GoldMap::BuildRenderList(std::vector<ViewFrustum> const& viewFrustums)
 {
-	// Render pass
-	g_renderer->ClearRTV(Rgba8::BLACK, m_renderTargetTexture);
+	// The outdoor map has no tile chunks to cull
+	UNUSED(viewFrustums);
 
-	std::vector<Vertex_PCU> skyboxVerts;
-	AddVertsForAABB3(skyboxVerts, AABB3(Vec3(-150.f, -150.f, -100.f), Vec3(150.f, 150.f, 100.f)), Rgba8::DEEP_SKY_BLUE, AABB2(Vec2::ZERO, Vec2(1.f, 1.f)));
-	g_renderer->SetBlendMode(BlendMode::ALPHA);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_FRONT);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->BindShader(nullptr);
-	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(skyboxVerts);
+	RenderList& renderList = m_renderSnapshots.GetWriteBuffer();
+	renderList.BeginBuild();
 
-	g_renderer->BindShader(m_shader);
-	g_renderer->BindDepthBuffer(m_shadowMap);
-	RenderScene();
+	// Skybox never changes, so it is uploaded once and kept in the geometry cache
+	AABB3 const skyboxBounds(Vec3(-150.f, -150.f, -100.f), Vec3(150.f, 150.f, 100.f));
+	uint64_t skyboxKey = GeometryCache::HashValue(skyboxBounds);
+	CachedMesh const* skyboxMesh = g_geometryCache->FindMesh("GoldMap::Skybox", skyboxKey);
+	if (!skyboxMesh)
+	{
+		std::vector<Vertex_PCU> skyboxVerts;
+		AddVertsForAABB3(skyboxVerts, skyboxBounds, Rgba8::DEEP_SKY_BLUE, AABB2(Vec2::ZERO, Vec2(1.f, 1.f)));
+		skyboxMesh = g_geometryCache->UpdateMesh("GoldMap::Skybox", skyboxKey, skyboxVerts);
+	}
+	DrawItem skyboxItem;
+	skyboxItem.m_vertexBuffer = skyboxMesh->m_vertexBuffer;
+	skyboxItem.m_indexBuffer = skyboxMesh->m_indexBuffer;
+	skyboxItem.m_indexCount = skyboxMesh->m_indexCount;
+	skyboxItem.m_blendMode = BlendMode::ALPHA;
+	skyboxItem.m_cullMode = RasterizerCullMode::CULL_FRONT;
+	renderList.SetDefaultShader(nullptr);
+	renderList.AddDrawItem(skyboxItem);
 
-	g_renderer->SetBlendMode(BlendMode::ALPHA);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->BindShader(m_diffuseShader);
-	g_renderer->BindTexture(nullptr);
-	RenderVisualActors();
+	renderList.SetDefaultShader(m_shader);
+	AddSceneDrawItems(renderList);
 
-	g_renderer->BindDepthBuffer(nullptr);
+	renderList.SetDefaultShader(m_diffuseShader);
+	AddVisualActorDrawItems(renderList);
+
+	renderList.EndBuild();
+	m_renderSnapshots.Publish();
+
+	if (m_game->m_sunDirection != m_shadowCasterSunDirection)
+	{
+		InvalidateStaticShadows();
+	}
 }
 
-void GoldMap::RenderScreen() const
+void GoldMap::BuildStaticBatches()
 {
-	// Render screen
-	g_renderer->SetDepthMode(DepthMode::DISABLED);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetModelConstants();
-	g_renderer->BindShader(nullptr);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->SetBlendMode(BlendMode::ALPHA);
-	g_renderer->BindTexture(nullptr);
-	m_game->m_player->RenderScreen();
+	m_staticBatches.Clear();
+
+	// The floor is one block per tile under the map, it never moves so it is merged along with the static actors
+	StaticMesh const* blockMesh = StaticMesh::GetOrLoad("Data/Models/block", StaticActor::GetModelImportTransform());
+	for (int y = 0; y < m_dimensions.y; y++)
+	{
+		for (int x = 0; x < m_dimensions.x; x++)
+		{
+			m_staticBatches.AddInstance(blockMesh, Mat44::CreateTranslation3D(Vec3((float)x, (float)y, -1.f)), Rgba8::WHITE);
+		}
+	}
+
+	for (int staticActorIndex = 0; staticActorIndex < (int)m_staticActors.size(); staticActorIndex++)
+	{
+		if (m_staticActors[staticActorIndex])
+		{
+			m_staticBatches.AddStaticActor(m_staticActors[staticActorIndex]);
+		}
+	}
+	m_staticBatches.Build();
+
+	InvalidateStaticShadows();
+}
+
+void GoldMap::InvalidateStaticShadows()
+{
+	BuildShadowCasterList();
+	m_isStaticShadowMapDirty = true;
+}
+
+void GoldMap::BuildShadowCasterList()
+{
+	m_shadowCasterSunDirection = m_game->m_sunDirection;
+
+	Vec3 lightForward = m_shadowCasterSunDirection.GetNormalized();
+	Vec3 lightLeft = CrossProduct3D(Vec3::SKYWARD, lightForward);
+	if (lightLeft.GetLengthSquared() < 0.0001f)
+	{
+		lightLeft = Vec3::NORTH;
+	}
+	lightLeft = lightLeft.GetNormalized();
+	Vec3 lightUp = CrossProduct3D(lightForward, lightLeft);
+
+	// Only the floor receives shadows, so its footprint in light space bounds every shadow that can be seen
+	Vec3 const receiverMins(0.f, 0.f, -1.f);
+	Vec3 const receiverMaxs((float)m_dimensions.x, (float)m_dimensions.y, 0.f);
+	AABB2 receiverLightBounds(Vec2(FLT_MAX, FLT_MAX), Vec2(-FLT_MAX, -FLT_MAX));
+	float receiverMaxLightDepth = -FLT_MAX;
+	for (int cornerIndex = 0; cornerIndex < 8; cornerIndex++)
+	{
+		Vec3 corner((cornerIndex & 1) ? receiverMaxs.x : receiverMins.x, (cornerIndex & 2) ? receiverMaxs.y : receiverMins.y, (cornerIndex & 4) ? receiverMaxs.z : receiverMins.z);
+		Vec2 cornerLightPosition(DotProduct3D(corner, lightLeft), DotProduct3D(corner, lightUp));
+		receiverLightBounds.m_mins.x = std::min(receiverLightBounds.m_mins.x, cornerLightPosition.x);
+		receiverLightBounds.m_mins.y = std::min(receiverLightBounds.m_mins.y, cornerLightPosition.y);
+		receiverLightBounds.m_maxs.x = std::max(receiverLightBounds.m_maxs.x, cornerLightPosition.x);
+		receiverLightBounds.m_maxs.y = std::max(receiverLightBounds.m_maxs.y, cornerLightPosition.y);
+		receiverMaxLightDepth = std::max(receiverMaxLightDepth, DotProduct3D(corner, lightForward));
+	}
+
+	m_numShadowCastersCulled = 0;
+	m_shadowCasterBatches.Clear();
+	for (int staticActorIndex = 0; staticActorIndex < (int)m_staticActors.size(); staticActorIndex++)
+	{
+		StaticActor const* staticActor = m_staticActors[staticActorIndex];
+		if (!staticActor)
+		{
+			continue;
+		}
+
+		if (!IsShadowCasterVisibleToLight(staticActor, lightForward, lightLeft, lightUp, receiverLightBounds, receiverMaxLightDepth))
+		{
+			m_numShadowCastersCulled++;
+			continue;
+		}
+
+		m_shadowCasterBatches.AddStaticActor(staticActor);
+	}
+	m_shadowCasterBatches.Build();
+
+	m_shadowCasterList.BeginBuild();
+	m_shadowCasterList.SetDefaultShader(m_shadowShader);
+	m_shadowCasterBatches.AddDrawItems(m_shadowCasterList);
+	m_shadowCasterList.EndBuild();
+}
+
+bool GoldMap::IsShadowCasterVisibleToLight(StaticActor const* staticActor, Vec3 const& lightForward, Vec3 const& lightLeft, Vec3 const& lightUp, AABB2 const& receiverLightBounds, float receiverMaxLightDepth) const
+{
+	Vec3 boundsCenter;
+	float boundsRadius = 0.f;
+	staticActor->GetBoundingSphere(boundsCenter, boundsRadius);
+
+	// Casters entirely beyond the receivers along the light direction can't shadow them
+	if (DotProduct3D(boundsCenter, lightForward) - boundsRadius > receiverMaxLightDepth)
+	{
+		return false;
+	}
+
+	Vec2 centerLightPosition(DotProduct3D(boundsCenter, lightLeft), DotProduct3D(boundsCenter, lightUp));
+	Vec2 nearestPointOnReceivers(GetClamped(centerLightPosition.x, receiverLightBounds.m_mins.x, receiverLightBounds.m_maxs.x), GetClamped(centerLightPosition.y, receiverLightBounds.m_mins.y, receiverLightBounds.m_maxs.y));
+	return IsPointInsideDisc2D(nearestPointOnReceivers, centerLightPosition, boundsRadius);
+}
+
+void GoldMap::Render() const
+{
+	// Render pass
+	g_renderer->ClearRTV(Rgba8::BLACK, m_renderTargetTexture);
+
+	g_renderer->SetLightConstants(m_game->m_sunDirection.GetNormalized(), m_game->m_sunIntensity, m_game->m_ambientIntensity);
+	g_renderer->BindDepthBuffer(m_shadowMap);
+	m_renderSnapshots.GetReadBuffer().Submit();
+	g_renderer->BindDepthBuffer(nullptr);
 }
 
 void GoldMap::RenderCustomScreens() const
 {
+	if (!m_isStaticShadowMapDirty)
+	{
+		return;
+	}
+	m_isStaticShadowMapDirty = false;
+	m_numStaticShadowMapRenders++;
+
 	// Shadow Pass
 	g_renderer->BeginCamera(g_app->m_worldCamera);
 	g_renderer->ClearDSV(m_shadowMap);
@@ -246,50 +439,24 @@ void GoldMap::RenderCustomScreens() const
 	g_renderer->BindShader(m_shadowShader);
 	g_renderer->BindTexture(nullptr);
 	g_renderer->SetDSV(m_shadowMap);
-	RenderStaticActors();
+	m_shadowCasterList.Submit();
 	g_renderer->EndCamera(g_app->m_worldCamera);
 	// End Shadow pass
 }
 
-void GoldMap::RenderScene() const
-{
-	g_renderer->SetBlendMode(BlendMode::OPAQUE);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->SetLightConstants(m_game->m_sunDirection.GetNormalized(), m_game->m_sunIntensity, m_game->m_ambientIntensity);
-	//g_theRenderer->BindShader(m_shader);
-	g_renderer->BindTexture(nullptr);
-
-	for (int y = 0; y < 50; y++)
-	{
-		for (int x = 0; x < 50; x++)
-		{
-			g_renderer->SetModelConstants(Mat44::CreateTranslation3D(Vec3((float)x, (float)y, -1.f)), Rgba8::WHITE);
-			g_renderer->DrawIndexBuffer(m_blockModel->GetVertexBuffer(), m_blockModel->GetIndexBuffer(), m_blockModel->GetIndexCount());
-		}
-	}
-
-	RenderStaticActors();
-	RenderActors();
-}
-
-void GoldMap::RenderStaticActors() const
+void GoldMap::AddSceneDrawItems(RenderList& renderList) const
 {
-	for (int actorIndex = 0; actorIndex < (int)m_staticActors.size(); actorIndex++)
-	{
-		m_staticActors[actorIndex]->Render();
-	}
+	m_staticBatches.AddDrawItems(renderList);
+	AddActorDrawItems(renderList);
 }
 
-void GoldMap::RenderVisualActors() const
+void GoldMap::AddVisualActorDrawItems(RenderList& renderList) const
 {
 	for (int actorIndex = 0; actorIndex < (int)m_visualActors.size(); actorIndex++)
 	{
 		if (m_visualActors[actorIndex])
 		{
-			m_visualActors[actorIndex]->Render();
+			m_visualActors[actorIndex]->AddDrawItems(renderList);
 		}
 	}
 }
@@ -369,7 +536,7 @@ void GoldMap::CollideActorsWithStaticActors()
 	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
 	{
 		Actor*& actor = m_actors[actorIndex];
-		if (!actor)
+		if (!actor || actor->m_activityTier == ActivityTier::SLEEPING)
 		{
 			continue;
 		}
@@ -386,6 +553,21 @@ void GoldMap::CollideActorsWithStaticActors()
 			if (DoZCylindersOverlap(actor->m_position, actor->m_position + Vec3::SKYWARD * actor->m_physicsHeight, actor->m_physicsRadius, staticActor->m_position, staticActor->m_position + Vec3::SKYWARD * staticActor->m_physicsHeight, staticActor->m_physicsRadius))
 			{
 				actor->OnCollideWithStatic(staticActor);
+				continue;
+			}
+
+			// Moves longer than the radius can carry the actor through a thin trunk, so it is moved back to first contact
+			Vec3 displacement = actor->GetSweepDisplacement();
+			if (displacement.GetLengthSquared() < actor->m_physicsRadius * actor->m_physicsRadius)
+			{
+				continue;
+			}
+			Vec3 sweepStart = actor->GetSweepStartPosition();
+			SweepResult result = SweepZCylinderVsZCylinder(sweepStart, displacement, actor->m_physicsRadius, actor->m_physicsHeight, staticActor->m_position, staticActor->m_physicsRadius, staticActor->m_physicsHeight);
+			if (result.m_didImpact)
+			{
+				actor->m_position = sweepStart + displacement * result.m_timeOfImpact;
+				actor->OnCollideWithStatic(staticActor);
 			}
 		}
 	}
@@ -407,20 +589,6 @@ void GoldMap::CollideActorWithFloorAndCeiling(Actor* actor)
 	}
 }
 
-bool GoldMap::IsValidSpawnLocation(float x, float y) const
-{
-	for (int staticActorIndex = 0; staticActorIndex < (int)m_staticActors.size(); staticActorIndex++)
-	{
-		StaticActor* const& staticActor = m_staticActors[staticActorIndex];
-		if (IsPointInsideDisc2D(Vec2(x, y), staticActor->m_position.GetXY(), staticActor->m_physicsRadius))
-		{
-			return false;
-		}
-	}
-
-	return true;
-}
-
 void GoldMap::DeleteDestroyedActors()
 {
 	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
@@ -464,22 +632,22 @@ void GoldMap::ShowLevelMessage()
 	{
 		case 0:
 		{
-			DebugAddScreenText("You ready? Hit R to start wave!", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f), 0.f);
+			g_geometryCache->AddScreenText("GoldMap::LevelMessage", "You ready? Hit R to start wave!", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f));
 			break;
 		}
 		case 1:
 		{
-			DebugAddScreenText("That was easy, wasn't it? Let's give them guns now! R when you're ready.", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f), 0.f);
+			g_geometryCache->AddScreenText("GoldMap::LevelMessage", "That was easy, wasn't it? Let's give them guns now! R when you're ready.", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f));
 			break;
 		}
 		case 2:
 		{
-			DebugAddScreenText("Alright, time to prove yourself as a hardcore gamer now! R when you're ready", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f), 0.f);
+			g_geometryCache->AddScreenText("GoldMap::LevelMessage", "Alright, time to prove yourself as a hardcore gamer now! R when you're ready", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f));
 			break;
 		}
 		case 3:
 		{
-			DebugAddScreenText("That. Was. Awesome! Hop around this cool map or hit escape to return to the Attract screen.", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f), 0.f);
+			g_geometryCache->AddScreenText("GoldMap::LevelMessage", "That. Was. Awesome! Hop around this cool map or hit escape to return to the Attract screen.", Vec2(g_screenSizeX, 0.f), 20.f, Vec2(1.f, 0.f));
 			break;
 		}
 	}
@@ -2,6 +2,7 @@
 
 #include "Game/Map.hpp"
 #include "Game/Gold/StaticActor.hpp"
+#include "Game/Gold/StaticBatch.hpp"
 
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Renderer/Shader.hpp"
@@ -26,21 +27,28 @@ public:
 	GoldMap(Game* game);
 
 	void PlaceCliffs();
-	void PlaceTrees();
-	void PlaceRocks();
+	void PlaceTreesAndRocks();
 
 	void SpawnWave();
 	void ShowLevelMessage();
 	void IncrementLevel();
 	void HandleWaveStart();
 
+	virtual IntVec2 GetWorldDimensions() const override { return m_dimensions; }
+	virtual float GetCeilingHeight() const override { return FLT_MAX; }
+
 	virtual void Update() override;
+	virtual void UpdateMainThread() override;
+	virtual void BuildRenderList(std::vector<ViewFrustum> const& viewFrustums) override;
 	virtual void Render() const override;
-	virtual void RenderScreen() const override;
 	virtual void RenderCustomScreens() const override;
-	void RenderScene() const;
-	virtual void RenderStaticActors() const;
-	void RenderVisualActors() const;
+	void AddSceneDrawItems(RenderList& renderList) const;
+	void BuildStaticBatches();
+	virtual void BuildNavigationGrid() override;
+	void BuildShadowCasterList();
+	void InvalidateStaticShadows();
+	bool IsShadowCasterVisibleToLight(StaticActor const* staticActor, Vec3 const& lightForward, Vec3 const& lightLeft, Vec3 const& lightUp, AABB2 const& receiverLightBounds, float receiverMaxLightDepth) const;
+	void AddVisualActorDrawItems(RenderList& renderList) const;
 	void UpdateVisualActors();
 
 	void CollideActorsWithStaticActors();
@@ -49,7 +57,6 @@ public:
 	//virtual void SpawnPlayer(int playerIndex) override;
 	//virtual Actor* SpawnActor(SpawnInfo spawnInfo) override;
 
-	bool IsValidSpawnLocation(float x, float y) const;
 	void UpdateActorPivotPositions();
 
 	virtual void DeleteDestroyedActors() override;
@@ -60,8 +67,9 @@ public:
 public:
 	IntVec2 m_dimensions = IntVec2::ZERO;
 	Shader* m_shader = nullptr;
-	Model* m_blockModel = nullptr;
 	std::vector<StaticActor*> m_staticActors;
+	StaticBatchBuilder m_staticBatches;
+	StaticBatchBuilder m_shadowCasterBatches;
 	Texture* m_skyboxTexture = nullptr;
 
 	Texture* m_renderTargetTexture = nullptr;
@@ -69,6 +77,12 @@ public:
 	Texture* m_shadowMap = nullptr;
 	Shader* m_shadowShader = nullptr;
 	Shader* m_diffuseShader = nullptr;
+	RenderList m_shadowCasterList;
+	// Static casters are rendered into the shadow map only when the sun moves or the static actors change
+	Vec3 m_shadowCasterSunDirection = Vec3::ZERO;
+	mutable bool m_isStaticShadowMapDirty = true;
+	int m_numShadowCastersCulled = 0;
+	mutable int m_numStaticShadowMapRenders = 0;
 
 	int m_remainingEnemies = 0;
 	int m_level = 0;
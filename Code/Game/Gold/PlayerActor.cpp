@@ -1,5 +1,7 @@
 #include "Game/Gold/PlayerActor.hpp"
 
+#include "Game/GameCommon.hpp"
+
 
 PlayerActor::PlayerActor(Map* map, ActorUID const& uid, Vec3 const& position, EulerAngles const& orientation)
 {
@@ -19,6 +21,7 @@ Vec3 const PlayerActor::GetEyePosition() const
 	return m_position + Vec3::SKYWARD * m_physicsHeight;
 }
 
-void PlayerActor::Render() const
+void PlayerActor::AddDrawItems(RenderList& renderList) const
 {
+	UNUSED(renderList);
 }
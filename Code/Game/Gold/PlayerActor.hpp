@@ -15,7 +15,7 @@ public:
 	PlayerActor(Map* map, ActorUID const& uid, Vec3 const& position, EulerAngles const& orientation);
 
 	virtual Vec3 const GetEyePosition() const override;
-	virtual void Render() const override;
+	virtual void AddDrawItems(RenderList& renderList) const override;
 
 public:
 	Model* m_model = nullptr;
@@ -1,5 +1,6 @@
 #include "Game/Gold/Rock.hpp"
 
+#include "Game/CounterRNG.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 
@@ -19,28 +20,13 @@ Rock::Rock(Map* map, Vec3 const& position, EulerAngles const& orientation, float
 	m_physicsHeight = scale * 0.5f;
 	m_physicsRadius = scale * 0.3f;
 
-	std::string modelFileName = "Data/Models/rocka";
-	if (g_RNG->RollRandomChance(0.5f))
+	m_modelFileName = "Data/Models/rocka";
+	// Keyed by position in sixteenths of a tile, so a rock keeps its model no matter what else was placed first
+	// Scattered placements sit well over a sixteenth apart, and the key stays unique for maps up to 4096 tiles across
+	unsigned int positionChannel = ((unsigned int)RoundDownToInt(position.x * 16.f) & 0xFFFF) | ((unsigned int)RoundDownToInt(position.y * 16.f) << 16);
+	CounterRNG modelRNG = g_randomStreams->GetRNG(RandomStream::MAP_GENERATION, GetRandomSubjectForName("Rock"), 0, positionChannel);
+	if (modelRNG.RollRandomChance(0.5f))
 	{
-		modelFileName = "Data/Models/rockb";
-	}
-
-	m_model = g_modelLoader->CreateOrGetModelFromObj(modelFileName.c_str(), Mat44(Vec3::SOUTH, Vec3::SKYWARD, Vec3::WEST, Vec3::ZERO));
-}
-
-void Rock::Render() const
-{
-	g_renderer->SetBlendMode(BlendMode::OPAQUE);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->BindTexture(nullptr);
-	g_renderer->SetModelConstants(m_transform, m_tint);
-	g_renderer->DrawIndexBuffer(m_model->GetVertexBuffer(), m_model->GetIndexBuffer(), m_model->GetIndexCount());
-
-	if (m_map->m_game->m_drawDebug)
-	{
-		RenderDebug();
+		m_modelFileName = "Data/Models/rockb";
 	}
 }
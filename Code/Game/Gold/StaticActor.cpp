@@ -1,5 +1,7 @@
 #include "Game/Gold/StaticActor.hpp"
 
+#include "Game/AllocationTracker.hpp"
+
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 
 StaticActor::StaticActor(Map* map, Vec3 const& position)
@@ -8,6 +10,25 @@ StaticActor::StaticActor(Map* map, Vec3 const& position)
 {
 }
 
+void* StaticActor::operator new(size_t numBytes)
+{
+	TrackAllocation(AllocationCategory::ACTORS, numBytes);
+	return ::operator new(numBytes);
+}
+
+void StaticActor::operator delete(void* pointer, size_t numBytes)
+{
+	TrackFree(AllocationCategory::ACTORS, numBytes);
+	::operator delete(pointer);
+}
+
+void StaticActor::GetBoundingSphere(Vec3& out_center, float& out_radius) const
+{
+	// Models extend past the collision cylinder (canopies, rock overhangs), so the sphere is deliberately generous
+	out_center = m_position + Vec3::SKYWARD * (m_physicsHeight * 0.5f);
+	out_radius = 2.f * (m_physicsRadius > m_physicsHeight ? m_physicsRadius : m_physicsHeight);
+}
+
 void StaticActor::RenderDebug() const
 {
 	DebugAddWorldWireCylinder(m_position, m_position + Vec3::SKYWARD * m_physicsHeight, m_physicsRadius, 0.f, Rgba8::MAGENTA, Rgba8::MAGENTA);	
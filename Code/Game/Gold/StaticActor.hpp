@@ -1,21 +1,34 @@
 #pragma once
 
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/Vec3.hpp"
 
 #include "Game/Map.hpp"
 
+#include <string>
+
 class StaticActor
 {
 public:
 	virtual ~StaticActor() = default;
 	StaticActor(Map* map, Vec3 const& position);
 
-	virtual void Render() const = 0;
+	static void* operator new(size_t numBytes);
+	static void operator delete(void* pointer, size_t numBytes);
+
+	// Static models are authored in the same basis as the rest of Gold's OBJ files
+	static Mat44 const GetModelImportTransform() { return Mat44(Vec3::SOUTH, Vec3::SKYWARD, Vec3::WEST, Vec3::ZERO); }
+
+	virtual Mat44 const GetModelMatrix() const = 0;
+	virtual Rgba8 const GetTint() const { return Rgba8::WHITE; }
 	virtual void RenderDebug() const;
+	virtual void GetBoundingSphere(Vec3& out_center, float& out_radius) const;
 
 public:
 	Map* m_map;
 	Vec3 m_position;
+	std::string m_modelFileName;
 	float m_physicsHeight = 0.f;
 	float m_physicsRadius = 0.f;
 	bool isOptional = false;
@@ -0,0 +1,159 @@
+#include "Game/Gold/StaticBatch.hpp"
+
+#include "Game/AllocationTracker.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Gold/StaticActor.hpp"
+#include "Game/Gold/StaticMesh.hpp"
+
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+#include <string.h>
+
+
+StaticBatchBuilder::~StaticBatchBuilder()
+{
+	ReleaseBuffers();
+}
+
+void StaticBatchBuilder::Clear()
+{
+	m_instances.clear();
+}
+
+void StaticBatchBuilder::AddStaticActor(StaticActor const* staticActor)
+{
+	AddInstance(StaticMesh::GetOrLoad(staticActor->GetModelFileName(), GetStaticModelImportTransform()), staticActor->GetModelMatrix(), staticActor->GetTint());
+}
+
+void StaticBatchBuilder::AddInstance(StaticMesh const* mesh, Mat44 const& modelMatrix, Rgba8 const& tint)
+{
+	if (!mesh || mesh->m_indexes.empty())
+	{
+		return;
+	}
+
+	StaticInstance instance;
+	instance.m_mesh = mesh;
+	instance.m_modelMatrix = modelMatrix;
+	instance.m_tint = tint;
+	m_instances.push_back(instance);
+}
+
+void StaticBatchBuilder::Build()
+{
+	if (m_vertexBuffer && IsSameAsBuiltInstances())
+	{
+		return;
+	}
+
+	std::vector<Vertex_PCUTBN> vertexes;
+	std::vector<unsigned int> indexes;
+	size_t numVertexes = 0;
+	size_t numIndexes = 0;
+	for (int instanceIndex = 0; instanceIndex < (int)m_instances.size(); instanceIndex++)
+	{
+		numVertexes += m_instances[instanceIndex].m_mesh->m_vertexes.size();
+		numIndexes += m_instances[instanceIndex].m_mesh->m_indexes.size();
+	}
+	vertexes.reserve(numVertexes);
+	indexes.reserve(numIndexes);
+
+	for (int instanceIndex = 0; instanceIndex < (int)m_instances.size(); instanceIndex++)
+	{
+		StaticInstance const& instance = m_instances[instanceIndex];
+		StaticMesh const* mesh = instance.m_mesh;
+		unsigned int firstVertexIndex = (unsigned int)vertexes.size();
+
+		// Static actors only rotate and scale uniformly, so the model matrix carries normals as well as positions
+		for (int vertexIndex = 0; vertexIndex < (int)mesh->m_vertexes.size(); vertexIndex++)
+		{
+			Vertex_PCUTBN vertex = mesh->m_vertexes[vertexIndex];
+			vertex.m_position = instance.m_modelMatrix.TransformPosition3D(vertex.m_position);
+			vertex.m_normal = instance.m_modelMatrix.TransformVectorQuantity3D(vertex.m_normal).GetNormalized();
+			vertex.m_color.r = (unsigned char)(((int)vertex.m_color.r * (int)instance.m_tint.r) / 255);
+			vertex.m_color.g = (unsigned char)(((int)vertex.m_color.g * (int)instance.m_tint.g) / 255);
+			vertex.m_color.b = (unsigned char)(((int)vertex.m_color.b * (int)instance.m_tint.b) / 255);
+			vertex.m_color.a = (unsigned char)(((int)vertex.m_color.a * (int)instance.m_tint.a) / 255);
+			vertexes.push_back(vertex);
+		}
+		for (int indexIndex = 0; indexIndex < (int)mesh->m_indexes.size(); indexIndex++)
+		{
+			indexes.push_back(firstVertexIndex + mesh->m_indexes[indexIndex]);
+		}
+	}
+
+	// Buffers are only recreated when the merged mesh outgrows them, shadow caster sets shrink and grow as the sun moves
+	size_t vertexBytes = vertexes.size() * sizeof(Vertex_PCUTBN);
+	size_t indexBytes = indexes.size() * sizeof(unsigned int);
+	if (vertexBytes > m_vertexBufferBytes || indexBytes > m_indexBufferBytes)
+	{
+		ReleaseBuffers();
+		m_vertexBufferBytes = vertexBytes;
+		m_indexBufferBytes = indexBytes;
+		m_vertexBuffer = g_renderer->CreateVertexBuffer(m_vertexBufferBytes, VertexType::VERTEX_PCUTBN);
+		m_indexBuffer = g_renderer->CreateIndexBuffer(m_indexBufferBytes);
+		TrackAllocation(AllocationCategory::GPU_BUFFERS, m_vertexBufferBytes);
+		TrackAllocation(AllocationCategory::GPU_BUFFERS, m_indexBufferBytes);
+	}
+	if (!indexes.empty())
+	{
+		g_renderer->CopyCPUToGPU(vertexes.data(), vertexBytes, m_vertexBuffer);
+		g_renderer->CopyCPUToGPU(indexes.data(), indexBytes, m_indexBuffer);
+	}
+
+	m_numVertexes = (int)vertexes.size();
+	m_indexCount = (int)indexes.size();
+	m_builtInstances = m_instances;
+	m_numBuilds++;
+}
+
+void StaticBatchBuilder::AddDrawItems(RenderList& renderList) const
+{
+	if (m_indexCount == 0)
+	{
+		return;
+	}
+
+	renderList.AddIndexedDraw(m_vertexBuffer, m_indexBuffer, m_indexCount, Mat44::IDENTITY);
+}
+
+bool StaticBatchBuilder::IsSameAsBuiltInstances() const
+{
+	if (m_instances.size() != m_builtInstances.size())
+	{
+		return false;
+	}
+
+	for (int instanceIndex = 0; instanceIndex < (int)m_instances.size(); instanceIndex++)
+	{
+		StaticInstance const& instance = m_instances[instanceIndex];
+		StaticInstance const& builtInstance = m_builtInstances[instanceIndex];
+		if (instance.m_mesh != builtInstance.m_mesh || memcmp(&instance.m_modelMatrix, &builtInstance.m_modelMatrix, sizeof(Mat44)) != 0 || memcmp(&instance.m_tint, &builtInstance.m_tint, sizeof(Rgba8)) != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void StaticBatchBuilder::ReleaseBuffers()
+{
+	if (m_vertexBuffer)
+	{
+		TrackFree(AllocationCategory::GPU_BUFFERS, m_vertexBufferBytes);
+	}
+	delete m_vertexBuffer;
+	m_vertexBuffer = nullptr;
+
+	if (m_indexBuffer)
+	{
+		TrackFree(AllocationCategory::GPU_BUFFERS, m_indexBufferBytes);
+	}
+	delete m_indexBuffer;
+	m_indexBuffer = nullptr;
+
+	m_vertexBufferBytes = 0;
+	m_indexBufferBytes = 0;
+}
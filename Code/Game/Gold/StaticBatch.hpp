@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Game/RenderList.hpp"
+
+#include <vector>
+
+class IndexBuffer;
+class StaticActor;
+class StaticMesh;
+class VertexBuffer;
+
+struct StaticInstance
+{
+public:
+	StaticMesh const* m_mesh = nullptr;
+	Mat44 m_modelMatrix = Mat44::IDENTITY;
+	Rgba8 m_tint = Rgba8::WHITE;
+};
+
+// Bakes static geometry into one vertex and index buffer, pre-transformed and pre-tinted, so all of it is submitted as a single draw item
+// The renderer has no instanced draw, so merging on the CPU is the only way to stop paying a draw call per static actor
+// Instances are collected between Clear and Build, and the buffers are only rebuilt when the instances differ from the last build
+class StaticBatchBuilder
+{
+public:
+	~StaticBatchBuilder();
+	StaticBatchBuilder() = default;
+
+	void Clear();
+	void AddStaticActor(StaticActor const* staticActor);
+	void AddInstance(StaticMesh const* mesh, Mat44 const& modelMatrix, Rgba8 const& tint);
+	void Build();
+	void AddDrawItems(RenderList& renderList) const;
+
+	int GetNumInstances() const { return (int)m_builtInstances.size(); }
+	int GetNumVertexes() const { return m_numVertexes; }
+	int GetNumBuilds() const { return m_numBuilds; }
+
+private:
+	bool IsSameAsBuiltInstances() const;
+	void ReleaseBuffers();
+
+private:
+	std::vector<StaticInstance> m_instances;
+	std::vector<StaticInstance> m_builtInstances;
+	VertexBuffer* m_vertexBuffer = nullptr;
+	IndexBuffer* m_indexBuffer = nullptr;
+	size_t m_vertexBufferBytes = 0;
+	size_t m_indexBufferBytes = 0;
+	int m_numVertexes = 0;
+	int m_indexCount = 0;
+	int m_numBuilds = 0;
+};
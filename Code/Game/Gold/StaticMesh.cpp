@@ -0,0 +1,221 @@
+#include "Game/Gold/StaticMesh.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <fstream>
+#include <stdio.h>
+
+
+std::map<std::string, StaticMesh> StaticMesh::s_meshes;
+
+
+// OBJ indexes are 1-based, negative ones count back from the end of the list so far
+static int GetObjElementIndex(int objIndex, int numElements)
+{
+	if (objIndex > 0)
+	{
+		return objIndex - 1;
+	}
+	if (objIndex < 0)
+	{
+		return numElements + objIndex;
+	}
+	return -1;
+}
+
+static void ReadMaterialColors(std::string const& materialFileName, std::map<std::string, Rgba8>& out_materialColors)
+{
+	std::ifstream materialFile(materialFileName);
+	std::string line;
+	std::string materialName;
+	while (std::getline(materialFile, line))
+	{
+		char name[256] = {};
+		float r = 1.f;
+		float g = 1.f;
+		float b = 1.f;
+		if (sscanf_s(line.c_str(), "newmtl %255s", name, (unsigned int)sizeof(name)) == 1)
+		{
+			materialName = name;
+			out_materialColors[materialName] = Rgba8::WHITE;
+		}
+		else if (sscanf_s(line.c_str(), "Kd %f %f %f", &r, &g, &b) == 3 && !materialName.empty())
+		{
+			out_materialColors[materialName] = Rgba8((unsigned char)RoundDownToInt(r * 255.f + 0.5f), (unsigned char)RoundDownToInt(g * 255.f + 0.5f), (unsigned char)RoundDownToInt(b * 255.f + 0.5f), 255);
+		}
+	}
+}
+
+StaticMesh const* StaticMesh::GetOrLoad(std::string const& fileName, Mat44 const& importTransform)
+{
+	auto meshIter = s_meshes.find(fileName);
+	if (meshIter != s_meshes.end())
+	{
+		return &meshIter->second;
+	}
+
+	StaticMesh& mesh = s_meshes[fileName];
+	mesh.LoadFromObj(fileName, importTransform);
+	return &mesh;
+}
+
+void StaticMesh::LoadFromObj(std::string const& fileName, Mat44 const& importTransform)
+{
+	// Model names are given without the extension, the same way the model loader takes them
+	std::ifstream objFile(fileName + ".obj");
+	if (!objFile.is_open())
+	{
+		ERROR_RECOVERABLE(Stringf("Could not open static mesh \"%s.obj\"", fileName.c_str()));
+		return;
+	}
+
+	std::string directory;
+	size_t lastSlashIndex = fileName.find_last_of("/\\");
+	if (lastSlashIndex != std::string::npos)
+	{
+		directory = fileName.substr(0, lastSlashIndex + 1);
+	}
+
+	std::map<std::string, Rgba8> materialColors;
+	std::vector<Vec3> positions;
+	std::vector<Vec2> uvs;
+	std::vector<Vec3> normals;
+	// Corners sharing a position, uv, normal and color share a vertex
+	std::map<std::string, unsigned int> cornerVertexIndexes;
+	std::string materialName;
+	Rgba8 materialColor = Rgba8::WHITE;
+
+	std::string line;
+	while (std::getline(objFile, line))
+	{
+		float x = 0.f;
+		float y = 0.f;
+		float z = 0.f;
+		char name[256] = {};
+		if (line.compare(0, 2, "v ") == 0 && sscanf_s(line.c_str(), "v %f %f %f", &x, &y, &z) == 3)
+		{
+			positions.push_back(importTransform.TransformPosition3D(Vec3(x, y, z)));
+		}
+		else if (line.compare(0, 3, "vt ") == 0 && sscanf_s(line.c_str(), "vt %f %f", &x, &y) == 2)
+		{
+			uvs.push_back(Vec2(x, y));
+		}
+		else if (line.compare(0, 3, "vn ") == 0 && sscanf_s(line.c_str(), "vn %f %f %f", &x, &y, &z) == 3)
+		{
+			normals.push_back(importTransform.TransformVectorQuantity3D(Vec3(x, y, z)).GetNormalized());
+		}
+		else if (sscanf_s(line.c_str(), "mtllib %255s", name, (unsigned int)sizeof(name)) == 1)
+		{
+			ReadMaterialColors(directory + name, materialColors);
+		}
+		else if (sscanf_s(line.c_str(), "usemtl %255s", name, (unsigned int)sizeof(name)) == 1)
+		{
+			materialName = name;
+			auto colorIter = materialColors.find(materialName);
+			materialColor = colorIter != materialColors.end() ? colorIter->second : Rgba8::WHITE;
+		}
+		else if (line.compare(0, 2, "f ") == 0)
+		{
+			std::vector<unsigned int> faceVertexIndexes;
+			std::vector<bool> cornerNeedsNormal;
+			char const* cornerText = line.c_str() + 2;
+			while (*cornerText != '\0')
+			{
+				while (*cornerText == ' ' || *cornerText == '\t')
+				{
+					cornerText++;
+				}
+				if (*cornerText == '\0' || *cornerText == '\r')
+				{
+					break;
+				}
+
+				// v, v/vt, v//vn or v/vt/vn
+				int positionIndex = 0;
+				int uvIndex = 0;
+				int normalIndex = 0;
+				if (sscanf_s(cornerText, "%d/%d/%d", &positionIndex, &uvIndex, &normalIndex) != 3)
+				{
+					uvIndex = 0;
+					normalIndex = 0;
+					if (sscanf_s(cornerText, "%d//%d", &positionIndex, &normalIndex) != 2)
+					{
+						normalIndex = 0;
+						sscanf_s(cornerText, "%d/%d", &positionIndex, &uvIndex);
+					}
+				}
+				while (*cornerText != '\0' && *cornerText != ' ' && *cornerText != '\t' && *cornerText != '\r')
+				{
+					cornerText++;
+				}
+
+				positionIndex = GetObjElementIndex(positionIndex, (int)positions.size());
+				uvIndex = GetObjElementIndex(uvIndex, (int)uvs.size());
+				normalIndex = GetObjElementIndex(normalIndex, (int)normals.size());
+				if (positionIndex < 0 || positionIndex >= (int)positions.size())
+				{
+					continue;
+				}
+				if (normalIndex >= (int)normals.size())
+				{
+					normalIndex = -1;
+				}
+				if (uvIndex >= (int)uvs.size())
+				{
+					uvIndex = -1;
+				}
+
+				std::string cornerKey = Stringf("%d/%d/%d/%s", positionIndex, uvIndex, normalIndex, materialName.c_str());
+				auto cornerIter = cornerVertexIndexes.find(cornerKey);
+				if (cornerIter != cornerVertexIndexes.end() && normalIndex >= 0)
+				{
+					faceVertexIndexes.push_back(cornerIter->second);
+					cornerNeedsNormal.push_back(false);
+					continue;
+				}
+
+				Vertex_PCUTBN vertex;
+				vertex.m_position = positions[positionIndex];
+				vertex.m_color = materialColor;
+				vertex.m_uvTexCoords = uvIndex >= 0 ? uvs[uvIndex] : Vec2::ZERO;
+				vertex.m_normal = normalIndex >= 0 ? normals[normalIndex] : Vec3::ZERO;
+				unsigned int vertexIndex = (unsigned int)m_vertexes.size();
+				m_vertexes.push_back(vertex);
+				if (normalIndex >= 0)
+				{
+					cornerVertexIndexes[cornerKey] = vertexIndex;
+				}
+				faceVertexIndexes.push_back(vertexIndex);
+				cornerNeedsNormal.push_back(normalIndex < 0);
+			}
+
+			if (faceVertexIndexes.size() < 3)
+			{
+				continue;
+			}
+
+			// Corners without a normal get the flat face normal, their vertexes are never shared so nothing else is affected
+			Vec3 const& a = m_vertexes[faceVertexIndexes[0]].m_position;
+			Vec3 const& b = m_vertexes[faceVertexIndexes[1]].m_position;
+			Vec3 const& c = m_vertexes[faceVertexIndexes[2]].m_position;
+			Vec3 faceNormal = CrossProduct3D(b - a, c - a).GetNormalized();
+			for (int cornerIndex = 0; cornerIndex < (int)faceVertexIndexes.size(); cornerIndex++)
+			{
+				if (cornerNeedsNormal[cornerIndex])
+				{
+					m_vertexes[faceVertexIndexes[cornerIndex]].m_normal = faceNormal;
+				}
+			}
+
+			// Polygons are fanned from their first corner
+			for (int cornerIndex = 1; cornerIndex + 1 < (int)faceVertexIndexes.size(); cornerIndex++)
+			{
+				m_indexes.push_back(faceVertexIndexes[0]);
+				m_indexes.push_back(faceVertexIndexes[cornerIndex]);
+				m_indexes.push_back(faceVertexIndexes[cornerIndex + 1]);
+			}
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// CPU copy of an OBJ model's triangles, with material colors baked into the vertexes
+// The engine's Model only keeps its GPU buffers, so static geometry that gets merged into larger buffers reads the file again here
+class StaticMesh
+{
+public:
+	~StaticMesh() = default;
+	StaticMesh() = default;
+
+	// Meshes are cached by file name, the import transform only applies to the first load
+	static StaticMesh const*					GetOrLoad(std::string const& fileName, Mat44 const& importTransform);
+
+private:
+	void										LoadFromObj(std::string const& fileName, Mat44 const& importTransform);
+
+public:
+	std::vector<Vertex_PCUTBN>					m_vertexes;
+	std::vector<unsigned int>					m_indexes;
+
+	static std::map<std::string, StaticMesh>	s_meshes;
+};
@@ -1,5 +1,6 @@
 #include "Game/Gold/Tree.hpp"
 
+#include "Game/CounterRNG.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 
@@ -10,48 +11,36 @@
 Tree::Tree(Map* map, Vec3 const& position, float scale)
 	: StaticActor(map, position)
 {
-	int treeModelIndex = g_RNG->RollRandomIntInRange(0, 2);
-	std::string modelFileName;
+	// Keyed by position in sixteenths of a tile, so a tree keeps its model no matter what else was placed first
+	// Scattered placements sit well over a sixteenth apart, and the key stays unique for maps up to 4096 tiles across
+	unsigned int positionChannel = ((unsigned int)RoundDownToInt(position.x * 16.f) & 0xFFFF) | ((unsigned int)RoundDownToInt(position.y * 16.f) << 16);
+	CounterRNG modelRNG = g_randomStreams->GetRNG(RandomStream::MAP_GENERATION, GetRandomSubjectForName("Tree"), 0, positionChannel);
+	int treeModelIndex = modelRNG.RollRandomIntInRange(0, 2);
 	switch (treeModelIndex)
 	{
 		case 0:
 		{
-			modelFileName = "Data/Models/tree";
+			m_modelFileName = "Data/Models/tree";
 			break;
 		}
 		case 1:
 		{
-			modelFileName = "Data/Models/treePine";
+			m_modelFileName = "Data/Models/treePine";
 			break;
 		}
 		case 2:
 		{
-			modelFileName = "Data/Models/treePineSmall";
+			m_modelFileName = "Data/Models/treePineSmall";
 			break;
 		}
 	}
 
 	m_physicsHeight = scale;
 	m_physicsRadius = scale * 0.2f;
-
-	m_model = g_modelLoader->CreateOrGetModelFromObj(modelFileName.c_str(), Mat44(Vec3::SOUTH, Vec3::SKYWARD, Vec3::WEST, Vec3::ZERO));
 }
 
-void Tree::Render() const
+Mat44 const Tree::GetModelMatrix() const
 {
-	g_renderer->SetBlendMode(BlendMode::OPAQUE);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->BindTexture(nullptr);
-	g_renderer->SetModelConstants(Mat44::CreateTranslation3D(m_position));
-	g_renderer->DrawIndexBuffer(m_model->GetVertexBuffer(), m_model->GetIndexBuffer(), m_model->GetIndexCount());
-
-
-	if (m_map->m_game->m_drawDebug)
-	{
-		RenderDebug();
-	}
+	return Mat44::CreateTranslation3D(m_position);
 }
 
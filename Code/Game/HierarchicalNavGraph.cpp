@@ -0,0 +1,618 @@
+#include "Game/HierarchicalNavGraph.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+
+constexpr float NAV_UNREACHABLE_COST = 999999.f;
+constexpr float NAV_DIAGONAL_COST = 1.41421356f;
+// Border runs at least this long get a portal at each end instead of one in the middle
+constexpr int NAV_LONG_BORDER_RUN_LENGTH = 6;
+
+void HierarchicalNavGraph::Build(std::vector<unsigned char> const& blockedTiles, IntVec2 const& dimensions, int clusterSize)
+{
+	m_dimensions = dimensions;
+	m_clusterSize = clusterSize;
+	m_clusterGridDimensions = IntVec2((dimensions.x + clusterSize - 1) / clusterSize, (dimensions.y + clusterSize - 1) / clusterSize);
+
+	// Each of the four borders yields at most one portal per tile along it
+	int numClusters = m_clusterGridDimensions.x * m_clusterGridDimensions.y;
+	m_maxPortalsPerCluster = 4 * clusterSize;
+	m_numNodeSlots = numClusters * m_maxPortalsPerCluster;
+	m_searchStamp = 0;
+	m_searchStamps.assign(m_numNodeSlots + 2, 0);
+	m_closedStamps.assign(m_numNodeSlots + 2, 0);
+	m_searchCosts.assign(m_numNodeSlots + 2, NAV_UNREACHABLE_COST);
+	m_searchParents.assign(m_numNodeSlots + 2, -1);
+	m_clusters.clear();
+	m_clusters.resize(numClusters);
+	m_eastBorderCrossings.clear();
+	m_eastBorderCrossings.resize(numClusters);
+	m_northBorderCrossings.clear();
+	m_northBorderCrossings.resize(numClusters);
+
+	for (int clusterIndex = 0; clusterIndex < numClusters; clusterIndex++)
+	{
+		NavCluster& cluster = m_clusters[clusterIndex];
+		int clusterX = clusterIndex % m_clusterGridDimensions.x;
+		int clusterY = clusterIndex / m_clusterGridDimensions.x;
+		cluster.m_minTileCoords = IntVec2(clusterX * clusterSize, clusterY * clusterSize);
+		cluster.m_maxTileCoords = IntVec2(std::min((clusterX + 1) * clusterSize, dimensions.x) - 1, std::min((clusterY + 1) * clusterSize, dimensions.y) - 1);
+	}
+
+	for (int clusterIndex = 0; clusterIndex < numClusters; clusterIndex++)
+	{
+		BuildBorderPortals(blockedTiles, clusterIndex);
+	}
+	for (int clusterIndex = 0; clusterIndex < numClusters; clusterIndex++)
+	{
+		RebuildClusterPortals(clusterIndex);
+		ComputeClusterCosts(blockedTiles, clusterIndex);
+	}
+	for (int clusterIndex = 0; clusterIndex < numClusters; clusterIndex++)
+	{
+		ResolveClusterExits(clusterIndex);
+	}
+}
+
+void HierarchicalNavGraph::UpdateTile(std::vector<unsigned char> const& blockedTiles, IntVec2 const& tileCoords)
+{
+	if (tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= m_dimensions.x || tileCoords.y >= m_dimensions.y)
+	{
+		return;
+	}
+
+	int clusterX = tileCoords.x / m_clusterSize;
+	int clusterY = tileCoords.y / m_clusterSize;
+	int clusterIndex = clusterX + clusterY * m_clusterGridDimensions.x;
+
+	// A tile can only change the borders it lies on, which belong to this cluster and its west and south neighbors
+	BuildBorderPortals(blockedTiles, clusterIndex);
+	if (clusterX > 0)
+	{
+		BuildBorderPortals(blockedTiles, clusterIndex - 1);
+	}
+	if (clusterY > 0)
+	{
+		BuildBorderPortals(blockedTiles, clusterIndex - m_clusterGridDimensions.x);
+	}
+
+	// Portal sets can change for the cluster and its four neighbors
+	for (int offsetY = -1; offsetY <= 1; offsetY++)
+	{
+		for (int offsetX = -1; offsetX <= 1; offsetX++)
+		{
+			int affectedX = clusterX + offsetX;
+			int affectedY = clusterY + offsetY;
+			if ((offsetX != 0 && offsetY != 0) || affectedX < 0 || affectedY < 0 || affectedX >= m_clusterGridDimensions.x || affectedY >= m_clusterGridDimensions.y)
+			{
+				continue;
+			}
+			int affectedClusterIndex = affectedX + affectedY * m_clusterGridDimensions.x;
+			RebuildClusterPortals(affectedClusterIndex);
+			ComputeClusterCosts(blockedTiles, affectedClusterIndex);
+		}
+	}
+
+	// Exits pointing into a rebuilt cluster may now name different portal slots, which reaches one cluster further out
+	for (int offsetY = -2; offsetY <= 2; offsetY++)
+	{
+		for (int offsetX = -2; offsetX <= 2; offsetX++)
+		{
+			int affectedX = clusterX + offsetX;
+			int affectedY = clusterY + offsetY;
+			if (abs(offsetX) + abs(offsetY) > 2 || affectedX < 0 || affectedY < 0 || affectedX >= m_clusterGridDimensions.x || affectedY >= m_clusterGridDimensions.y)
+			{
+				continue;
+			}
+			ResolveClusterExits(affectedX + affectedY * m_clusterGridDimensions.x);
+		}
+	}
+}
+
+bool HierarchicalNavGraph::FindPath(std::vector<unsigned char> const& blockedTiles, IntVec2 const& startTileCoords, IntVec2 const& goalTileCoords, std::vector<IntVec2>& out_waypoints, float* out_pathCost) const
+{
+	m_numNodesExpandedByLastQuery = 0;
+	if (startTileCoords.x < 0 || startTileCoords.y < 0 || startTileCoords.x >= m_dimensions.x || startTileCoords.y >= m_dimensions.y)
+	{
+		return false;
+	}
+	if (!IsTileWalkable(blockedTiles, goalTileCoords.x, goalTileCoords.y))
+	{
+		return false;
+	}
+
+	int startTileIndex = startTileCoords.x + startTileCoords.y * m_dimensions.x;
+	int goalTileIndex = goalTileCoords.x + goalTileCoords.y * m_dimensions.x;
+	int startClusterIndex = GetClusterIndexForTile(startTileIndex);
+	int goalClusterIndex = GetClusterIndexForTile(goalTileIndex);
+	NavCluster const& startCluster = m_clusters[startClusterIndex];
+	NavCluster const& goalCluster = m_clusters[goalClusterIndex];
+	int startClusterWidth = startCluster.m_maxTileCoords.x - startCluster.m_minTileCoords.x + 1;
+	int goalClusterWidth = goalCluster.m_maxTileCoords.x - goalCluster.m_minTileCoords.x + 1;
+
+	// Start and goal are temporarily connected to the portals of their clusters
+	int startNodeId = m_numNodeSlots;
+	int goalNodeId = m_numNodeSlots + 1;
+	m_searchStamp++;
+	m_openList.clear();
+
+	SearchInsideCluster(blockedTiles, goalCluster, goalTileIndex, m_clusterSearchCosts);
+	m_goalPortalCosts.resize(goalCluster.m_portals.size());
+	for (int portalIndex = 0; portalIndex < (int)goalCluster.m_portals.size(); portalIndex++)
+	{
+		IntVec2 const& tileCoords = goalCluster.m_portals[portalIndex].m_tileCoords;
+		int localIndex = (tileCoords.x - goalCluster.m_minTileCoords.x) + (tileCoords.y - goalCluster.m_minTileCoords.y) * goalClusterWidth;
+		m_goalPortalCosts[portalIndex] = m_clusterSearchCosts[localIndex];
+	}
+
+	auto pushNode = [&](int nodeId, int parentNodeId, float cost, IntVec2 const& nodeTileCoords)
+	{
+		if (m_closedStamps[nodeId] == m_searchStamp || (m_searchStamps[nodeId] == m_searchStamp && cost >= m_searchCosts[nodeId]))
+		{
+			return;
+		}
+		m_searchStamps[nodeId] = m_searchStamp;
+		m_searchCosts[nodeId] = cost;
+		m_searchParents[nodeId] = parentNodeId;
+		m_openList.push_back(std::make_pair(cost + GetOctileDistance(nodeTileCoords, goalTileCoords), nodeId));
+		std::push_heap(m_openList.begin(), m_openList.end(), std::greater<std::pair<float, int>>());
+	};
+
+	SearchInsideCluster(blockedTiles, startCluster, startTileIndex, m_clusterSearchCosts);
+	m_searchStamps[startNodeId] = m_searchStamp;
+	m_closedStamps[startNodeId] = m_searchStamp;
+	m_searchCosts[startNodeId] = 0.f;
+	for (int portalIndex = 0; portalIndex < (int)startCluster.m_portals.size(); portalIndex++)
+	{
+		IntVec2 const& tileCoords = startCluster.m_portals[portalIndex].m_tileCoords;
+		int localIndex = (tileCoords.x - startCluster.m_minTileCoords.x) + (tileCoords.y - startCluster.m_minTileCoords.y) * startClusterWidth;
+		if (m_clusterSearchCosts[localIndex] < NAV_UNREACHABLE_COST)
+		{
+			pushNode(startClusterIndex * m_maxPortalsPerCluster + portalIndex, startNodeId, m_clusterSearchCosts[localIndex], tileCoords);
+		}
+	}
+	if (startClusterIndex == goalClusterIndex)
+	{
+		int localGoalIndex = (goalTileCoords.x - startCluster.m_minTileCoords.x) + (goalTileCoords.y - startCluster.m_minTileCoords.y) * startClusterWidth;
+		if (m_clusterSearchCosts[localGoalIndex] < NAV_UNREACHABLE_COST)
+		{
+			pushNode(goalNodeId, startNodeId, m_clusterSearchCosts[localGoalIndex], goalTileCoords);
+		}
+	}
+
+	bool isGoalReached = false;
+	while (!m_openList.empty())
+	{
+		std::pop_heap(m_openList.begin(), m_openList.end(), std::greater<std::pair<float, int>>());
+		int nodeId = m_openList.back().second;
+		m_openList.pop_back();
+		if (m_closedStamps[nodeId] == m_searchStamp)
+		{
+			continue;
+		}
+		m_closedStamps[nodeId] = m_searchStamp;
+		m_numNodesExpandedByLastQuery++;
+
+		if (nodeId == goalNodeId)
+		{
+			isGoalReached = true;
+			break;
+		}
+
+		int clusterIndex = nodeId / m_maxPortalsPerCluster;
+		int portalIndex = nodeId - clusterIndex * m_maxPortalsPerCluster;
+		NavCluster const& cluster = m_clusters[clusterIndex];
+		NavPortal const& portal = cluster.m_portals[portalIndex];
+		int firstNodeId = clusterIndex * m_maxPortalsPerCluster;
+		float nodeCost = m_searchCosts[nodeId];
+
+		for (int edgeIndex = 0; edgeIndex < (int)portal.m_intraEdges.size(); edgeIndex++)
+		{
+			std::pair<int, float> const& edge = portal.m_intraEdges[edgeIndex];
+			pushNode(firstNodeId + edge.first, nodeId, nodeCost + edge.second, cluster.m_portals[edge.first].m_tileCoords);
+		}
+
+		for (int exitIndex = 0; exitIndex < (int)portal.m_exitNodeIds.size(); exitIndex++)
+		{
+			int exitNodeId = portal.m_exitNodeIds[exitIndex];
+			if (exitNodeId >= 0)
+			{
+				int exitTileIndex = portal.m_exitTileIndexes[exitIndex];
+				pushNode(exitNodeId, nodeId, nodeCost + 1.f, IntVec2(exitTileIndex % m_dimensions.x, exitTileIndex / m_dimensions.x));
+			}
+		}
+
+		if (clusterIndex == goalClusterIndex && m_goalPortalCosts[portalIndex] < NAV_UNREACHABLE_COST)
+		{
+			pushNode(goalNodeId, nodeId, nodeCost + m_goalPortalCosts[portalIndex], goalTileCoords);
+		}
+	}
+
+	if (!isGoalReached)
+	{
+		return false;
+	}
+
+	if (out_pathCost)
+	{
+		*out_pathCost = m_searchCosts[goalNodeId];
+	}
+
+	size_t firstWaypointIndex = out_waypoints.size();
+	out_waypoints.push_back(goalTileCoords);
+	for (int nodeId = m_searchParents[goalNodeId]; nodeId >= 0 && nodeId != startNodeId; nodeId = m_searchParents[nodeId])
+	{
+		int clusterIndex = nodeId / m_maxPortalsPerCluster;
+		out_waypoints.push_back(m_clusters[clusterIndex].m_portals[nodeId - clusterIndex * m_maxPortalsPerCluster].m_tileCoords);
+	}
+	std::reverse(out_waypoints.begin() + firstWaypointIndex, out_waypoints.end());
+	return true;
+}
+
+bool HierarchicalNavGraph::FindLocalPath(std::vector<unsigned char> const& blockedTiles, IntVec2 const& startTileCoords, IntVec2 const& goalTileCoords, std::vector<IntVec2>& out_tileSteps) const
+{
+	if (startTileCoords.x < 0 || startTileCoords.y < 0 || startTileCoords.x >= m_dimensions.x || startTileCoords.y >= m_dimensions.y)
+	{
+		return false;
+	}
+	if (!IsTileWalkable(blockedTiles, goalTileCoords.x, goalTileCoords.y))
+	{
+		return false;
+	}
+
+	int startTileIndex = startTileCoords.x + startTileCoords.y * m_dimensions.x;
+	int goalTileIndex = goalTileCoords.x + goalTileCoords.y * m_dimensions.x;
+	int clusterIndex = GetClusterIndexForTile(startTileIndex);
+	if (clusterIndex != GetClusterIndexForTile(goalTileIndex))
+	{
+		// Portal pairs on either side of a border are neighbors, so crossing is a single step
+		if (abs(goalTileCoords.x - startTileCoords.x) > 1 || abs(goalTileCoords.y - startTileCoords.y) > 1)
+		{
+			return false;
+		}
+		out_tileSteps.push_back(goalTileCoords);
+		return true;
+	}
+
+	// Search outward from the goal, then walk downhill from the start so the steps come out in order
+	NavCluster const& cluster = m_clusters[clusterIndex];
+	int clusterWidth = cluster.m_maxTileCoords.x - cluster.m_minTileCoords.x + 1;
+	SearchInsideCluster(blockedTiles, cluster, goalTileIndex, m_clusterSearchCosts);
+
+	auto getCost = [&](int tileX, int tileY)
+	{
+		if (tileX < cluster.m_minTileCoords.x || tileY < cluster.m_minTileCoords.y || tileX > cluster.m_maxTileCoords.x || tileY > cluster.m_maxTileCoords.y)
+		{
+			return NAV_UNREACHABLE_COST;
+		}
+		return m_clusterSearchCosts[(tileX - cluster.m_minTileCoords.x) + (tileY - cluster.m_minTileCoords.y) * clusterWidth];
+	};
+
+	static int const neighborOffsetsX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static int const neighborOffsetsY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	IntVec2 tileCoords = startTileCoords;
+	float tileCost = getCost(tileCoords.x, tileCoords.y);
+	if (tileCost >= NAV_UNREACHABLE_COST)
+	{
+		return false;
+	}
+	while (tileCost > 0.f)
+	{
+		IntVec2 nextTileCoords = tileCoords;
+		float nextTileCost = tileCost;
+		for (int neighborIndex = 0; neighborIndex < 8; neighborIndex++)
+		{
+			int neighborX = tileCoords.x + neighborOffsetsX[neighborIndex];
+			int neighborY = tileCoords.y + neighborOffsetsY[neighborIndex];
+			bool isDiagonal = neighborX != tileCoords.x && neighborY != tileCoords.y;
+			if (isDiagonal && (!IsTileWalkable(blockedTiles, neighborX, tileCoords.y) || !IsTileWalkable(blockedTiles, tileCoords.x, neighborY)))
+			{
+				continue;
+			}
+			float neighborCost = getCost(neighborX, neighborY);
+			if (neighborCost < nextTileCost)
+			{
+				nextTileCoords = IntVec2(neighborX, neighborY);
+				nextTileCost = neighborCost;
+			}
+		}
+		if (nextTileCost >= tileCost)
+		{
+			return false;
+		}
+		tileCoords = nextTileCoords;
+		tileCost = nextTileCost;
+		out_tileSteps.push_back(tileCoords);
+	}
+	return true;
+}
+
+NavGraphStats const HierarchicalNavGraph::GetStats() const
+{
+	NavGraphStats stats;
+	stats.m_numClusters = (int)m_clusters.size();
+	for (int clusterIndex = 0; clusterIndex < (int)m_clusters.size(); clusterIndex++)
+	{
+		stats.m_numPortals += (int)m_clusters[clusterIndex].m_portals.size();
+	}
+	stats.m_numNodesExpanded = m_numNodesExpandedByLastQuery;
+	return stats;
+}
+
+void HierarchicalNavGraph::BuildBorderPortals(std::vector<unsigned char> const& blockedTiles, int clusterIndex)
+{
+	NavCluster const& cluster = m_clusters[clusterIndex];
+	int clusterX = clusterIndex % m_clusterGridDimensions.x;
+	int clusterY = clusterIndex / m_clusterGridDimensions.x;
+
+	auto addCrossingsForRun = [&](std::vector<std::pair<int, int>>& crossings, int runStart, int runEnd, bool isEastBorder)
+	{
+		auto addCrossing = [&](int runPosition)
+		{
+			if (isEastBorder)
+			{
+				int tileIndex = cluster.m_maxTileCoords.x + runPosition * m_dimensions.x;
+				crossings.push_back(std::make_pair(tileIndex, tileIndex + 1));
+			}
+			else
+			{
+				int tileIndex = runPosition + cluster.m_maxTileCoords.y * m_dimensions.x;
+				crossings.push_back(std::make_pair(tileIndex, tileIndex + m_dimensions.x));
+			}
+		};
+
+		if (runEnd - runStart + 1 >= NAV_LONG_BORDER_RUN_LENGTH)
+		{
+			addCrossing(runStart);
+			addCrossing(runEnd);
+		}
+		else
+		{
+			addCrossing((runStart + runEnd) / 2);
+		}
+	};
+
+	std::vector<std::pair<int, int>>& eastCrossings = m_eastBorderCrossings[clusterIndex];
+	eastCrossings.clear();
+	if (clusterX < m_clusterGridDimensions.x - 1)
+	{
+		int borderX = cluster.m_maxTileCoords.x;
+		int runStart = -1;
+		for (int tileY = cluster.m_minTileCoords.y; tileY <= cluster.m_maxTileCoords.y + 1; tileY++)
+		{
+			bool isOpen = tileY <= cluster.m_maxTileCoords.y && IsTileWalkable(blockedTiles, borderX, tileY) && IsTileWalkable(blockedTiles, borderX + 1, tileY);
+			if (isOpen && runStart < 0)
+			{
+				runStart = tileY;
+			}
+			else if (!isOpen && runStart >= 0)
+			{
+				addCrossingsForRun(eastCrossings, runStart, tileY - 1, true);
+				runStart = -1;
+			}
+		}
+	}
+
+	std::vector<std::pair<int, int>>& northCrossings = m_northBorderCrossings[clusterIndex];
+	northCrossings.clear();
+	if (clusterY < m_clusterGridDimensions.y - 1)
+	{
+		int borderY = cluster.m_maxTileCoords.y;
+		int runStart = -1;
+		for (int tileX = cluster.m_minTileCoords.x; tileX <= cluster.m_maxTileCoords.x + 1; tileX++)
+		{
+			bool isOpen = tileX <= cluster.m_maxTileCoords.x && IsTileWalkable(blockedTiles, tileX, borderY) && IsTileWalkable(blockedTiles, tileX, borderY + 1);
+			if (isOpen && runStart < 0)
+			{
+				runStart = tileX;
+			}
+			else if (!isOpen && runStart >= 0)
+			{
+				addCrossingsForRun(northCrossings, runStart, tileX - 1, false);
+				runStart = -1;
+			}
+		}
+	}
+}
+
+void HierarchicalNavGraph::RebuildClusterPortals(int clusterIndex)
+{
+	NavCluster& cluster = m_clusters[clusterIndex];
+	cluster.m_portals.clear();
+	int clusterX = clusterIndex % m_clusterGridDimensions.x;
+	int clusterY = clusterIndex / m_clusterGridDimensions.x;
+
+	auto addPortal = [&](int tileIndex, int exitTileIndex)
+	{
+		int portalIndex = GetPortalIndexForTile(cluster, tileIndex);
+		if (portalIndex < 0)
+		{
+			cluster.m_portals.emplace_back();
+			cluster.m_portals.back().m_tileIndex = tileIndex;
+			cluster.m_portals.back().m_tileCoords = IntVec2(tileIndex % m_dimensions.x, tileIndex / m_dimensions.x);
+			portalIndex = (int)cluster.m_portals.size() - 1;
+		}
+		cluster.m_portals[portalIndex].m_exitTileIndexes.push_back(exitTileIndex);
+	};
+
+	for (int crossingIndex = 0; crossingIndex < (int)m_eastBorderCrossings[clusterIndex].size(); crossingIndex++)
+	{
+		std::pair<int, int> const& crossing = m_eastBorderCrossings[clusterIndex][crossingIndex];
+		addPortal(crossing.first, crossing.second);
+	}
+	for (int crossingIndex = 0; crossingIndex < (int)m_northBorderCrossings[clusterIndex].size(); crossingIndex++)
+	{
+		std::pair<int, int> const& crossing = m_northBorderCrossings[clusterIndex][crossingIndex];
+		addPortal(crossing.first, crossing.second);
+	}
+	if (clusterX > 0)
+	{
+		std::vector<std::pair<int, int>> const& westCrossings = m_eastBorderCrossings[clusterIndex - 1];
+		for (int crossingIndex = 0; crossingIndex < (int)westCrossings.size(); crossingIndex++)
+		{
+			addPortal(westCrossings[crossingIndex].second, westCrossings[crossingIndex].first);
+		}
+	}
+	if (clusterY > 0)
+	{
+		std::vector<std::pair<int, int>> const& southCrossings = m_northBorderCrossings[clusterIndex - m_clusterGridDimensions.x];
+		for (int crossingIndex = 0; crossingIndex < (int)southCrossings.size(); crossingIndex++)
+		{
+			addPortal(southCrossings[crossingIndex].second, southCrossings[crossingIndex].first);
+		}
+	}
+}
+
+void HierarchicalNavGraph::ComputeClusterCosts(std::vector<unsigned char> const& blockedTiles, int clusterIndex)
+{
+	NavCluster& cluster = m_clusters[clusterIndex];
+	int numPortals = (int)cluster.m_portals.size();
+	int clusterWidth = cluster.m_maxTileCoords.x - cluster.m_minTileCoords.x + 1;
+	m_portalCosts.assign(numPortals * numPortals, NAV_UNREACHABLE_COST);
+
+	for (int portalIndex = 0; portalIndex < numPortals; portalIndex++)
+	{
+		SearchInsideCluster(blockedTiles, cluster, cluster.m_portals[portalIndex].m_tileIndex, m_clusterSearchCosts);
+		for (int otherPortalIndex = 0; otherPortalIndex < numPortals; otherPortalIndex++)
+		{
+			IntVec2 const& tileCoords = cluster.m_portals[otherPortalIndex].m_tileCoords;
+			int localIndex = (tileCoords.x - cluster.m_minTileCoords.x) + (tileCoords.y - cluster.m_minTileCoords.y) * clusterWidth;
+			m_portalCosts[portalIndex * numPortals + otherPortalIndex] = m_clusterSearchCosts[localIndex];
+		}
+	}
+
+	for (int portalIndex = 0; portalIndex < numPortals; portalIndex++)
+	{
+		NavPortal& portal = cluster.m_portals[portalIndex];
+		portal.m_intraEdges.clear();
+		for (int otherPortalIndex = 0; otherPortalIndex < numPortals; otherPortalIndex++)
+		{
+			float edgeCost = m_portalCosts[portalIndex * numPortals + otherPortalIndex];
+			if (otherPortalIndex == portalIndex || edgeCost >= NAV_UNREACHABLE_COST)
+			{
+				continue;
+			}
+
+			bool isDominated = false;
+			for (int viaPortalIndex = 0; viaPortalIndex < numPortals && !isDominated; viaPortalIndex++)
+			{
+				if (viaPortalIndex != portalIndex && viaPortalIndex != otherPortalIndex)
+				{
+					isDominated = m_portalCosts[portalIndex * numPortals + viaPortalIndex] + m_portalCosts[viaPortalIndex * numPortals + otherPortalIndex] <= edgeCost + 0.001f;
+				}
+			}
+			if (!isDominated)
+			{
+				portal.m_intraEdges.push_back(std::make_pair(otherPortalIndex, edgeCost));
+			}
+		}
+	}
+}
+
+void HierarchicalNavGraph::ResolveClusterExits(int clusterIndex)
+{
+	NavCluster& cluster = m_clusters[clusterIndex];
+	for (int portalIndex = 0; portalIndex < (int)cluster.m_portals.size(); portalIndex++)
+	{
+		NavPortal& portal = cluster.m_portals[portalIndex];
+		portal.m_exitNodeIds.resize(portal.m_exitTileIndexes.size());
+		for (int exitIndex = 0; exitIndex < (int)portal.m_exitTileIndexes.size(); exitIndex++)
+		{
+			int exitClusterIndex = GetClusterIndexForTile(portal.m_exitTileIndexes[exitIndex]);
+			int exitPortalIndex = GetPortalIndexForTile(m_clusters[exitClusterIndex], portal.m_exitTileIndexes[exitIndex]);
+			portal.m_exitNodeIds[exitIndex] = (exitPortalIndex >= 0 ? exitClusterIndex * m_maxPortalsPerCluster + exitPortalIndex : -1);
+		}
+	}
+}
+
+void HierarchicalNavGraph::SearchInsideCluster(std::vector<unsigned char> const& blockedTiles, NavCluster const& cluster, int startTileIndex, std::vector<float>& out_costs) const
+{
+	int clusterWidth = cluster.m_maxTileCoords.x - cluster.m_minTileCoords.x + 1;
+	int clusterHeight = cluster.m_maxTileCoords.y - cluster.m_minTileCoords.y + 1;
+	out_costs.assign(clusterWidth * clusterHeight, NAV_UNREACHABLE_COST);
+	m_clusterOpenList.clear();
+
+	auto isInsideAndWalkable = [&](int tileX, int tileY)
+	{
+		return tileX >= cluster.m_minTileCoords.x && tileY >= cluster.m_minTileCoords.y && tileX <= cluster.m_maxTileCoords.x && tileY <= cluster.m_maxTileCoords.y && blockedTiles[tileX + tileY * m_dimensions.x] == 0;
+	};
+
+	int startLocalIndex = (startTileIndex % m_dimensions.x - cluster.m_minTileCoords.x) + (startTileIndex / m_dimensions.x - cluster.m_minTileCoords.y) * clusterWidth;
+	out_costs[startLocalIndex] = 0.f;
+	m_clusterOpenList.push_back(std::make_pair(0.f, startLocalIndex));
+
+	static int const neighborOffsetsX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static int const neighborOffsetsY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	while (!m_clusterOpenList.empty())
+	{
+		std::pop_heap(m_clusterOpenList.begin(), m_clusterOpenList.end(), std::greater<std::pair<float, int>>());
+		std::pair<float, int> current = m_clusterOpenList.back();
+		m_clusterOpenList.pop_back();
+		if (current.first > out_costs[current.second])
+		{
+			continue;
+		}
+
+		int tileX = current.second % clusterWidth + cluster.m_minTileCoords.x;
+		int tileY = current.second / clusterWidth + cluster.m_minTileCoords.y;
+		for (int neighborIndex = 0; neighborIndex < 8; neighborIndex++)
+		{
+			int neighborX = tileX + neighborOffsetsX[neighborIndex];
+			int neighborY = tileY + neighborOffsetsY[neighborIndex];
+			if (!isInsideAndWalkable(neighborX, neighborY))
+			{
+				continue;
+			}
+
+			bool isDiagonal = neighborX != tileX && neighborY != tileY;
+			if (isDiagonal && (!isInsideAndWalkable(neighborX, tileY) || !isInsideAndWalkable(tileX, neighborY)))
+			{
+				continue;
+			}
+
+			int neighborLocalIndex = (neighborX - cluster.m_minTileCoords.x) + (neighborY - cluster.m_minTileCoords.y) * clusterWidth;
+			float neighborCost = current.first + (isDiagonal ? NAV_DIAGONAL_COST : 1.f);
+			if (neighborCost < out_costs[neighborLocalIndex])
+			{
+				out_costs[neighborLocalIndex] = neighborCost;
+				m_clusterOpenList.push_back(std::make_pair(neighborCost, neighborLocalIndex));
+				std::push_heap(m_clusterOpenList.begin(), m_clusterOpenList.end(), std::greater<std::pair<float, int>>());
+			}
+		}
+	}
+}
+
+int HierarchicalNavGraph::GetClusterIndexForTile(int tileIndex) const
+{
+	int clusterX = (tileIndex % m_dimensions.x) / m_clusterSize;
+	int clusterY = (tileIndex / m_dimensions.x) / m_clusterSize;
+	return clusterX + clusterY * m_clusterGridDimensions.x;
+}
+
+int HierarchicalNavGraph::GetPortalIndexForTile(NavCluster const& cluster, int tileIndex) const
+{
+	for (int portalIndex = 0; portalIndex < (int)cluster.m_portals.size(); portalIndex++)
+	{
+		if (cluster.m_portals[portalIndex].m_tileIndex == tileIndex)
+		{
+			return portalIndex;
+		}
+	}
+	return -1;
+}
+
+float HierarchicalNavGraph::GetOctileDistance(IntVec2 const& tileCoordsA, IntVec2 const& tileCoordsB) const
+{
+	int deltaX = abs(tileCoordsA.x - tileCoordsB.x);
+	int deltaY = abs(tileCoordsA.y - tileCoordsB.y);
+	int minDelta = std::min(deltaX, deltaY);
+	int maxDelta = std::max(deltaX, deltaY);
+	return (float)maxDelta + (NAV_DIAGONAL_COST - 1.f) * (float)minDelta;
+}
+
+bool HierarchicalNavGraph::IsTileWalkable(std::vector<unsigned char> const& blockedTiles, int tileX, int tileY) const
+{
+	return tileX >= 0 && tileY >= 0 && tileX < m_dimensions.x && tileY < m_dimensions.y && blockedTiles[tileX + tileY * m_dimensions.x] == 0;
+}
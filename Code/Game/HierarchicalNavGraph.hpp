@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+
+#include <utility>
+#include <vector>
+
+// A portal tile inside a cluster, linked to the tiles across the cluster border it can step into
+struct NavPortal
+{
+public:
+	int					m_tileIndex = -1;
+	IntVec2				m_tileCoords = IntVec2(-1, -1);
+	std::vector<int>	m_exitTileIndexes;
+	std::vector<int>	m_exitNodeIds;
+	// Walks to other portals in the same cluster, minus any walk that is no shorter than going through a third portal
+	std::vector<std::pair<int, float>>	m_intraEdges;
+};
+
+struct NavCluster
+{
+public:
+	IntVec2					m_minTileCoords = IntVec2(0, 0);
+	IntVec2					m_maxTileCoords = IntVec2(0, 0);
+	std::vector<NavPortal>	m_portals;
+};
+
+struct NavGraphStats
+{
+public:
+	int		m_numClusters = 0;
+	int		m_numPortals = 0;
+	int		m_numNodesExpanded = 0;
+};
+
+// Hierarchical pathfinding layer over a blocked tile grid (HPA*)
+// The grid is split into square clusters, and walkable runs along cluster borders become portal pairs
+// Long-range searches run over the small portal graph, and changing a tile only rebuilds the clusters touching it
+// Node ids are stable slots per cluster, so local rebuilds never renumber the rest of the graph
+class HierarchicalNavGraph
+{
+public:
+	~HierarchicalNavGraph() = default;
+	HierarchicalNavGraph() = default;
+
+	void					Build(std::vector<unsigned char> const& blockedTiles, IntVec2 const& dimensions, int clusterSize = 16);
+	void					UpdateTile(std::vector<unsigned char> const& blockedTiles, IntVec2 const& tileCoords);
+
+	// Waypoints are the portal tiles to walk through in order, ending at the goal tile
+	bool					FindPath(std::vector<unsigned char> const& blockedTiles, IntVec2 const& startTileCoords, IntVec2 const& goalTileCoords, std::vector<IntVec2>& out_waypoints, float* out_pathCost = nullptr) const;
+	// Expands one leg between consecutive waypoints into tile steps, ending at the goal tile
+	// Legs either stay inside one cluster or step straight across a border, anything else fails
+	bool					FindLocalPath(std::vector<unsigned char> const& blockedTiles, IntVec2 const& startTileCoords, IntVec2 const& goalTileCoords, std::vector<IntVec2>& out_tileSteps) const;
+
+	NavGraphStats const		GetStats() const;
+
+private:
+	void					BuildBorderPortals(std::vector<unsigned char> const& blockedTiles, int clusterIndex);
+	void					RebuildClusterPortals(int clusterIndex);
+	void					ComputeClusterCosts(std::vector<unsigned char> const& blockedTiles, int clusterIndex);
+	void					ResolveClusterExits(int clusterIndex);
+	// Dijkstra limited to the cluster's tiles, costs per tile are written to out_costs indexed relative to the cluster
+	void					SearchInsideCluster(std::vector<unsigned char> const& blockedTiles, NavCluster const& cluster, int startTileIndex, std::vector<float>& out_costs) const;
+
+	int						GetClusterIndexForTile(int tileIndex) const;
+	int						GetPortalIndexForTile(NavCluster const& cluster, int tileIndex) const;
+	float					GetOctileDistance(IntVec2 const& tileCoordsA, IntVec2 const& tileCoordsB) const;
+	bool					IsTileWalkable(std::vector<unsigned char> const& blockedTiles, int tileX, int tileY) const;
+
+private:
+	IntVec2					m_dimensions = IntVec2(0, 0);
+	int						m_clusterSize = 16;
+	IntVec2					m_clusterGridDimensions = IntVec2(0, 0);
+	std::vector<NavCluster>	m_clusters;
+	// Walkable tile pairs crossing each cluster's east and north borders, owned by the cluster on the west/south side
+	std::vector<std::vector<std::pair<int, int>>>	m_eastBorderCrossings;
+	std::vector<std::vector<std::pair<int, int>>>	m_northBorderCrossings;
+	int						m_maxPortalsPerCluster = 0;
+	int						m_numNodeSlots = 0;
+
+	// Search state is stamped per query instead of cleared, so a query only touches the nodes it visits
+	mutable int							m_numNodesExpandedByLastQuery = 0;
+	mutable unsigned int				m_searchStamp = 0;
+	mutable std::vector<unsigned int>	m_searchStamps;
+	mutable std::vector<unsigned int>	m_closedStamps;
+	mutable std::vector<float>			m_searchCosts;
+	mutable std::vector<int>			m_searchParents;
+	mutable std::vector<float>			m_goalPortalCosts;
+	mutable std::vector<std::pair<float, int>>	m_openList;
+	mutable std::vector<float>			m_clusterSearchCosts;
+	std::vector<float>					m_portalCosts;
+	mutable std::vector<std::pair<float, int>>	m_clusterOpenList;
+};
@@ -2,6 +2,8 @@
 
 #include "Game/Actor.hpp"
 #include "Game/AI.hpp"
+#include "Game/AllocationTracker.hpp"
+#include "Game/CounterRNG.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/MapDefinition.hpp"
@@ -11,19 +13,68 @@
 #include "Game/Gold/Particle.hpp"
 
 #include "Engine/Core/Image.hpp"
-#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/AABB3.hpp"
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Renderer/VertexBuffer.hpp"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
 Map::~Map()
 {
-	delete m_tileVertexBuffer;
-	m_tileVertexBuffer = nullptr;
+	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	{
+		delete m_actors[actorIndex];
+	}
+	m_actors.clear();
+
+	for (int actorIndex = 0; actorIndex < (int)m_spawnPoints.size(); actorIndex++)
+	{
+		delete m_spawnPoints[actorIndex];
+	}
+	m_spawnPoints.clear();
+
+	for (int actorIndex = 0; actorIndex < (int)m_visualActors.size(); actorIndex++)
+	{
+		delete m_visualActors[actorIndex];
+	}
+	m_visualActors.clear();
+
+	for (int controllerIndex = 0; controllerIndex < (int)m_aiControllers.size(); controllerIndex++)
+	{
+		delete m_aiControllers[controllerIndex];
+	}
+	m_aiControllers.clear();
 
-	delete m_tileIndexBuffer;
-	m_tileIndexBuffer = nullptr;
+	for (int chunkIndex = 0; chunkIndex < (int)m_tileChunks.size(); chunkIndex++)
+	{
+		ReleaseTileChunkBuffers(m_tileChunks[chunkIndex]);
+	}
+	m_tileChunks.clear();
+
+	for (int flowFieldIndex = 0; flowFieldIndex < (int)m_flowFields.size(); flowFieldIndex++)
+	{
+		delete m_flowFields[flowFieldIndex];
+	}
+	m_flowFields.clear();
+
+	if (m_particleVertexBuffer)
+	{
+		TrackFree(AllocationCategory::GPU_BUFFERS, m_particleVertexBuffer->m_size);
+	}
+	delete m_particleVertexBuffer;
+	m_particleVertexBuffer = nullptr;
+
+	if (m_particleIndexBuffer)
+	{
+		TrackFree(AllocationCategory::GPU_BUFFERS, m_particleIndexBuffer->m_size);
+	}
+	delete m_particleIndexBuffer;
+	m_particleIndexBuffer = nullptr;
 }
 
 Map::Map(Game* game, MapDefinition mapDef)
@@ -40,7 +91,8 @@ Map::Map(Game* game, MapDefinition mapDef)
 		ERROR_AND_DIE("No image provided in map definition, could not generate map!");
 	}
 
-	CreateTileHeatMaps();
+	BuildNavigationGrid();
+	CreateParticleMesh();
 
 	for (int spawnIndex = 0; spawnIndex < (int)m_definition.m_spawnInfos.size(); spawnIndex++)
 	{
@@ -63,7 +115,9 @@ void Map::ConstructMapFromImage()
 
 	int numTiles = m_definition.m_dimensions.x * m_definition.m_dimensions.y;
 	m_tiles.resize(numTiles);
+	m_solidGrid.Initialize(m_definition.m_dimensions);
 
+	CounterRNG tileRNG = g_randomStreams->GetRNG(RandomStream::MAP_GENERATION, GetRandomSubjectForName(m_definition.m_name.c_str()));
 	for (int tileY = 0; tileY < GetDimensions().y; tileY++)
 	{
 		for (int tileX = 0; tileX < GetDimensions().x; tileX++)
@@ -75,7 +129,7 @@ void Map::ConstructMapFromImage()
 				if (tileDefIter->second.m_mapImageColor.r == mapImageTexelColor.r && tileDefIter->second.m_mapImageColor.g == mapImageTexelColor.g && tileDefIter->second.m_mapImageColor.b == mapImageTexelColor.b)
 				{
 					wasMatchingTileFound = true;
-					if (g_RNG->RollRandomIntInRange(0, 254) < static_cast<int>(mapImageTexelColor.a))
+					if (tileRNG.RollRandomIntInRange(0, 254) < static_cast<int>(mapImageTexelColor.a))
 					{
 						SetTileType(IntVec2(tileX, tileY), tileDefIter->first);
 					}
@@ -93,88 +147,444 @@ void Map::ConstructMapFromImage()
 
 void Map::InitializeTiles()
 {
-	int estimatedVertexCount = 3 * 2 * m_definition.m_dimensions.x * m_definition.m_dimensions.y;
+	IntVec2 dimensions = m_definition.m_dimensions;
+	m_tileChunkGridDimensions = IntVec2((dimensions.x + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE, (dimensions.y + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE);
+	m_tileChunks.resize(m_tileChunkGridDimensions.x * m_tileChunkGridDimensions.y);
+
+	for (int chunkY = 0; chunkY < m_tileChunkGridDimensions.y; chunkY++)
+	{
+		for (int chunkX = 0; chunkX < m_tileChunkGridDimensions.x; chunkX++)
+		{
+			TileChunk& chunk = m_tileChunks[chunkX + chunkY * m_tileChunkGridDimensions.x];
+			chunk.m_minTileCoords = IntVec2(chunkX * TILE_CHUNK_SIZE, chunkY * TILE_CHUNK_SIZE);
+			chunk.m_maxTileCoords = IntVec2(std::min(chunk.m_minTileCoords.x + TILE_CHUNK_SIZE, dimensions.x), std::min(chunk.m_minTileCoords.y + TILE_CHUNK_SIZE, dimensions.y));
+
+			Vec3 chunkMins((float)chunk.m_minTileCoords.x, (float)chunk.m_minTileCoords.y, 0.f);
+			Vec3 chunkMaxs((float)chunk.m_maxTileCoords.x, (float)chunk.m_maxTileCoords.y, 1.f);
+			chunk.m_boundsCenter = (chunkMins + chunkMaxs) * 0.5f;
+			chunk.m_boundsRadius = (chunkMaxs - chunkMins).GetLength() * 0.5f;
+			chunk.m_isDirty = true;
+		}
+	}
+
+	RebuildDirtyTileChunks();
+}
+
+void Map::MarkTileChunksDirty(IntVec2 const& tileCoords)
+{
+	if (m_tileChunks.empty())
+	{
+		return;
+	}
+
+	// Wall faces depend on the cardinal neighbours, so a change on a chunk edge also dirties the chunk across that edge
+	IntVec2 const affectedTileCoords[5] = { tileCoords, tileCoords + IntVec2::EAST, tileCoords + IntVec2::WEST, tileCoords + IntVec2::NORTH, tileCoords + IntVec2::SOUTH };
+	for (int affectedIndex = 0; affectedIndex < 5; affectedIndex++)
+	{
+		IntVec2 const& affectedTile = affectedTileCoords[affectedIndex];
+		if (affectedTile.x < 0 || affectedTile.y < 0 || affectedTile.x >= GetDimensions().x || affectedTile.y >= GetDimensions().y)
+		{
+			continue;
+		}
+		m_tileChunks[(affectedTile.x / TILE_CHUNK_SIZE) + (affectedTile.y / TILE_CHUNK_SIZE) * m_tileChunkGridDimensions.x].m_isDirty = true;
+	}
+}
+
+void Map::RebuildDirtyTileChunks()
+{
+	for (int chunkIndex = 0; chunkIndex < (int)m_tileChunks.size(); chunkIndex++)
+	{
+		if (m_tileChunks[chunkIndex].m_isDirty)
+		{
+			RebuildTileChunk(m_tileChunks[chunkIndex]);
+		}
+	}
+}
+
+void Map::AddVertsForTileChunk(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, TileChunk const& chunk) const
+{
+	// Coplanar faces of neighbouring tiles with the same definition are merged into one quad, and the tile shader repeats the sprite once per tile across it
+	// Merging stops at the chunk edge so a chunk can still be rebuilt on its own
+	auto isInChunk = [&](int tileX, int tileY)
+	{
+		return tileX >= chunk.m_minTileCoords.x && tileY >= chunk.m_minTileCoords.y && tileX < chunk.m_maxTileCoords.x && tileY < chunk.m_maxTileCoords.y;
+	};
+
+	// Floors and ceilings grow along x first, then along y for as long as the whole next row matches
+	int chunkWidth = chunk.m_maxTileCoords.x - chunk.m_minTileCoords.x;
+	int chunkHeight = chunk.m_maxTileCoords.y - chunk.m_minTileCoords.y;
+	std::vector<unsigned char> isTileMerged(chunkWidth * chunkHeight, 0);
+	auto canMergeFloor = [&](int tileX, int tileY, TileDefinition const* definition)
+	{
+		Tile const& tile = m_tiles[tileX + tileY * GetDimensions().x];
+		return !tile.IsSolid() && tile.m_tileDefinition == definition && !isTileMerged[(tileX - chunk.m_minTileCoords.x) + (tileY - chunk.m_minTileCoords.y) * chunkWidth];
+	};
+	for (int tileY = chunk.m_minTileCoords.y; tileY < chunk.m_maxTileCoords.y; tileY++)
+	{
+		for (int tileX = chunk.m_minTileCoords.x; tileX < chunk.m_maxTileCoords.x; tileX++)
+		{
+			int tileIndex = tileX + tileY * GetDimensions().x;
+			TileDefinition const* definition = m_tiles[tileIndex].m_tileDefinition;
+			if (!canMergeFloor(tileX, tileY, definition))
+			{
+				continue;
+			}
+
+			int rectMaxX = tileX + 1;
+			while (rectMaxX < chunk.m_maxTileCoords.x && canMergeFloor(rectMaxX, tileY, definition))
+			{
+				rectMaxX++;
+			}
+			int rectMaxY = tileY + 1;
+			while (rectMaxY < chunk.m_maxTileCoords.y)
+			{
+				bool isRowMergeable = true;
+				for (int rowTileX = tileX; rowTileX < rectMaxX && isRowMergeable; rowTileX++)
+				{
+					isRowMergeable = canMergeFloor(rowTileX, rectMaxY, definition);
+				}
+				if (!isRowMergeable)
+				{
+					break;
+				}
+				rectMaxY++;
+			}
+
+			for (int rectTileY = tileY; rectTileY < rectMaxY; rectTileY++)
+			{
+				for (int rectTileX = tileX; rectTileX < rectMaxX; rectTileX++)
+				{
+					isTileMerged[(rectTileX - chunk.m_minTileCoords.x) + (rectTileY - chunk.m_minTileCoords.y) * chunkWidth] = 1;
+				}
+			}
+			AddVertsForTile(verts, indexes, tileIndex, IntVec2(rectMaxX - tileX, rectMaxY - tileY));
+		}
+	}
+
+	// Wall faces merge into runs along the face, east and west faces run along y and north and south faces along x
+	unsigned int const wallFaces[4] = { TileSolidityGrid::NEIGHBOR_EAST, TileSolidityGrid::NEIGHBOR_WEST, TileSolidityGrid::NEIGHBOR_NORTH, TileSolidityGrid::NEIGHBOR_SOUTH };
+	for (int faceIndex = 0; faceIndex < 4; faceIndex++)
+	{
+		unsigned int wallFace = wallFaces[faceIndex];
+		IntVec2 faceOffset = IntVec2(wallFace == TileSolidityGrid::NEIGHBOR_EAST ? 1 : (wallFace == TileSolidityGrid::NEIGHBOR_WEST ? -1 : 0), wallFace == TileSolidityGrid::NEIGHBOR_NORTH ? 1 : (wallFace == TileSolidityGrid::NEIGHBOR_SOUTH ? -1 : 0));
+		IntVec2 runStep = faceOffset.x != 0 ? IntVec2(0, 1) : IntVec2(1, 0);
+		auto hasWallFace = [&](int tileX, int tileY, TileDefinition const* definition)
+		{
+			Tile const& tile = m_tiles[tileX + tileY * GetDimensions().x];
+			return tile.IsSolid() && tile.m_tileDefinition == definition && !m_solidGrid.IsTileSolid(tileX + faceOffset.x, tileY + faceOffset.y);
+		};
+
+		for (int tileY = chunk.m_minTileCoords.y; tileY < chunk.m_maxTileCoords.y; tileY++)
+		{
+			for (int tileX = chunk.m_minTileCoords.x; tileX < chunk.m_maxTileCoords.x; tileX++)
+			{
+				int tileIndex = tileX + tileY * GetDimensions().x;
+				TileDefinition const* definition = m_tiles[tileIndex].m_tileDefinition;
+				if (!hasWallFace(tileX, tileY, definition))
+				{
+					continue;
+				}
+				// Runs are only emitted from their first tile
+				int previousTileX = tileX - runStep.x;
+				int previousTileY = tileY - runStep.y;
+				if (isInChunk(previousTileX, previousTileY) && hasWallFace(previousTileX, previousTileY, definition))
+				{
+					continue;
+				}
+
+				int runLength = 1;
+				while (isInChunk(tileX + runStep.x * runLength, tileY + runStep.y * runLength) && hasWallFace(tileX + runStep.x * runLength, tileY + runStep.y * runLength, definition))
+				{
+					runLength++;
+				}
+				AddVertsForWall(verts, indexes, tileIndex, wallFace, runLength);
+			}
+		}
+	}
+}
+
+void Map::RebuildTileChunk(TileChunk& chunk)
+{
+	int estimatedVertexCount = 4 * 4 * (chunk.m_maxTileCoords.x - chunk.m_minTileCoords.x) * (chunk.m_maxTileCoords.y - chunk.m_minTileCoords.y);
 	std::vector<Vertex_PCUTBN> tileVertexes;
 	std::vector<unsigned int> tileIndexes;
 	tileVertexes.reserve(estimatedVertexCount);
 	tileIndexes.reserve(estimatedVertexCount);
+	AddVertsForTileChunk(tileVertexes, tileIndexes, chunk);
 
-	for (int tileIndex = 0; tileIndex < static_cast<int>(m_tiles.size()); tileIndex++)
+	// Buffers are only recreated when the chunk outgrows them, so opening and closing a door reuses the same allocation
+	if ((int)tileVertexes.size() > chunk.m_vertexCapacity)
 	{
-		if (m_tiles[tileIndex].IsSolid())
+		if (chunk.m_vertexBuffer)
 		{
-			AABB2 tileWallUVs = m_definition.m_terrainSpriteSheet->GetSpriteUVs(m_tiles[tileIndex].GetWallSpriteCoords().y * m_definition.m_spriteSheetDimensions.x + m_tiles[tileIndex].GetWallSpriteCoords().x);
-			AddVertsForWall(tileVertexes, tileIndexes, tileIndex, tileWallUVs);
+			TrackFree(AllocationCategory::GPU_BUFFERS, chunk.m_vertexCapacity * sizeof(Vertex_PCUTBN));
 		}
-		else
+		delete chunk.m_vertexBuffer;
+		chunk.m_vertexBuffer = g_renderer->CreateVertexBuffer(tileVertexes.size() * sizeof(Vertex_PCUTBN), VertexType::VERTEX_PCUTBN);
+		chunk.m_vertexCapacity = (int)tileVertexes.size();
+		TrackAllocation(AllocationCategory::GPU_BUFFERS, chunk.m_vertexCapacity * sizeof(Vertex_PCUTBN));
+	}
+	if ((int)tileIndexes.size() > chunk.m_indexCapacity)
+	{
+		if (chunk.m_indexBuffer)
+		{
+			TrackFree(AllocationCategory::GPU_BUFFERS, chunk.m_indexCapacity * sizeof(unsigned int));
+		}
+		delete chunk.m_indexBuffer;
+		chunk.m_indexBuffer = g_renderer->CreateIndexBuffer(tileIndexes.size() * sizeof(unsigned int));
+		chunk.m_indexCapacity = (int)tileIndexes.size();
+		TrackAllocation(AllocationCategory::GPU_BUFFERS, chunk.m_indexCapacity * sizeof(unsigned int));
+	}
+	if (!tileIndexes.empty())
+	{
+		g_renderer->CopyCPUToGPU(reinterpret_cast<void*>(tileVertexes.data()), tileVertexes.size() * sizeof(Vertex_PCUTBN), chunk.m_vertexBuffer);
+		g_renderer->CopyCPUToGPU(reinterpret_cast<void*>(tileIndexes.data()), tileIndexes.size() * sizeof(unsigned int), chunk.m_indexBuffer);
+	}
+
+	// Every tile used to emit four wall quads or a floor and ceiling quad, each quad being 4 vertexes and 6 indexes
+	int numUnculledQuads = 0;
+	for (int tileY = chunk.m_minTileCoords.y; tileY < chunk.m_maxTileCoords.y; tileY++)
+	{
+		for (int tileX = chunk.m_minTileCoords.x; tileX < chunk.m_maxTileCoords.x; tileX++)
+		{
+			numUnculledQuads += m_tiles[tileX + tileY * GetDimensions().x].IsSolid() ? 4 : 2;
+		}
+	}
+
+	m_numTileVertexes += (int)tileVertexes.size() - chunk.m_numVertexes;
+	m_numTileIndexes += (int)tileIndexes.size() - chunk.m_numIndexes;
+	m_numUnculledTileVertexes += numUnculledQuads * 4 - chunk.m_numUnculledVertexes;
+	m_numUnculledTileIndexes += numUnculledQuads * 6 - chunk.m_numUnculledIndexes;
+
+	chunk.m_numVertexes = (int)tileVertexes.size();
+	chunk.m_numIndexes = (int)tileIndexes.size();
+	chunk.m_numUnculledVertexes = numUnculledQuads * 4;
+	chunk.m_numUnculledIndexes = numUnculledQuads * 6;
+	chunk.m_isDirty = false;
+	m_numTileChunkRebuilds++;
+}
+
+void Map::ReleaseTileChunkBuffers(TileChunk& chunk)
+{
+	if (chunk.m_vertexBuffer)
+	{
+		TrackFree(AllocationCategory::GPU_BUFFERS, chunk.m_vertexCapacity * sizeof(Vertex_PCUTBN));
+	}
+	delete chunk.m_vertexBuffer;
+	chunk.m_vertexBuffer = nullptr;
+
+	if (chunk.m_indexBuffer)
+	{
+		TrackFree(AllocationCategory::GPU_BUFFERS, chunk.m_indexCapacity * sizeof(unsigned int));
+	}
+	delete chunk.m_indexBuffer;
+	chunk.m_indexBuffer = nullptr;
+
+	chunk.m_vertexCapacity = 0;
+	chunk.m_indexCapacity = 0;
+}
+
+bool Map::IsTileChunkVisible(TileChunk const& chunk, std::vector<ViewFrustum> const& viewFrustums) const
+{
+	// The list is built once and replayed for every view, so a chunk is kept if any view can see it
+	for (int viewIndex = 0; viewIndex < (int)viewFrustums.size(); viewIndex++)
+	{
+		if (viewFrustums[viewIndex].IsSphereInside(chunk.m_boundsCenter, chunk.m_boundsRadius))
 		{
-			AABB2 tileFloorUVs = m_definition.m_terrainSpriteSheet->GetSpriteUVs(m_tiles[tileIndex].GetFloorSpriteCoords().y * m_definition.m_spriteSheetDimensions.x + m_tiles[tileIndex].GetFloorSpriteCoords().x);
-			AABB2 tileCeilingUVs = m_definition.m_terrainSpriteSheet->GetSpriteUVs(m_tiles[tileIndex].GetCeilingSpriteCoords().y * m_definition.m_spriteSheetDimensions.x + m_tiles[tileIndex].GetCeilingSpriteCoords().x);
-			AddVertsForTile(tileVertexes, tileIndexes, tileIndex, tileFloorUVs, tileCeilingUVs);
+			return true;
 		}
 	}
+	return false;
+}
 
-	m_tileVertexBuffer = g_renderer->CreateVertexBuffer(tileVertexes.size() * sizeof(Vertex_PCUTBN), VertexType::VERTEX_PCUTBN);
-	m_tileIndexBuffer = g_renderer->CreateIndexBuffer(tileIndexes.size() * sizeof(unsigned int));
-	g_renderer->CopyCPUToGPU(reinterpret_cast<void*>(tileVertexes.data()), tileVertexes.size() * sizeof(Vertex_PCUTBN), m_tileVertexBuffer);
-	g_renderer->CopyCPUToGPU(reinterpret_cast<void*>(tileIndexes.data()), tileIndexes.size() * sizeof(unsigned int), m_tileIndexBuffer);
+void Map::BuildNavigationGrid()
+{
+	IntVec2 dimensions = GetWorldDimensions();
+	m_navigationBlockedTiles.assign(dimensions.x * dimensions.y, 0);
+	for (int tileIndex = 0; tileIndex < (int)m_navigationBlockedTiles.size(); tileIndex++)
+	{
+		m_navigationBlockedTiles[tileIndex] = m_solidGrid.IsTileSolid(tileIndex % dimensions.x, tileIndex / dimensions.x) ? 1 : 0;
+	}
+	m_navigationVersion++;
+	m_navGraph.Build(m_navigationBlockedTiles, dimensions);
 }
 
-void Map::CreateTileHeatMaps()
+bool Map::IsTileBlockedForNavigation(IntVec2 const& tileCoords) const
 {
-	m_solidMap = new TileHeatMap(m_definition.m_dimensions);
-	std::vector<float> heatMapValues(m_definition.m_dimensions.x * m_definition.m_dimensions.y);
-	
-	for (int tileIndex = 0; tileIndex < m_definition.m_dimensions.x * m_definition.m_dimensions.y; tileIndex++)
+	IntVec2 dimensions = GetWorldDimensions();
+	if (tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= dimensions.x || tileCoords.y >= dimensions.y)
+	{
+		return true;
+	}
+	return m_navigationBlockedTiles[tileCoords.x + tileCoords.y * dimensions.x] != 0;
+}
+
+FlowField const* Map::GetFlowFieldToActor(Actor const* target)
+{
+	if (!target)
+	{
+		return nullptr;
+	}
+
+	FlowField* flowField = nullptr;
+	for (int flowFieldIndex = 0; flowFieldIndex < (int)m_flowFields.size(); flowFieldIndex++)
 	{
-		if (m_tiles[tileIndex].IsSolid())
+		if (m_flowFields[flowFieldIndex]->m_targetUID == target->m_UID)
 		{
-			heatMapValues[tileIndex] = 0.f;
+			flowField = m_flowFields[flowFieldIndex];
+			break;
 		}
-		else
+	}
+	if (!flowField)
+	{
+		flowField = new FlowField();
+		flowField->m_targetUID = target->m_UID;
+		m_flowFields.push_back(flowField);
+	}
+
+	// Only recompute when the target moves to a different tile or the navigation grid changed
+	// A compute in flight is left to finish unless the grid changed under it, otherwise a target crossing tiles faster than the budget allows would restart it forever
+	IntVec2 targetTileCoords(RoundDownToInt(target->m_position.x), RoundDownToInt(target->m_position.y));
+	bool isFieldStale = flowField->GetGoalTileCoords() != targetTileCoords || flowField->m_navigationVersion != m_navigationVersion;
+	bool isPendingComputeStale = !flowField->IsComputePending() || flowField->m_pendingNavigationVersion != m_navigationVersion;
+	if (isFieldStale && isPendingComputeStale)
+	{
+		flowField->BeginCompute(GetWorldDimensions(), targetTileCoords);
+		flowField->m_pendingNavigationVersion = m_navigationVersion;
+	}
+
+	// Computes share a per-frame tile budget, agents follow the previous field until the new one is done
+	// A field that has never completed is finished right away so agents always have something to follow
+	if (flowField->IsComputePending())
+	{
+		int maxTileVisits = flowField->HasCompletedCompute() ? m_flowFieldTileVisitsRemaining : INT_MAX;
+		int numTileVisits = flowField->ContinueCompute(m_navigationBlockedTiles, maxTileVisits);
+		m_flowFieldTileVisitsRemaining = std::max(m_flowFieldTileVisitsRemaining - numTileVisits, 0);
+		if (!flowField->IsComputePending())
 		{
-			heatMapValues[tileIndex] = 1.f;
+			flowField->m_navigationVersion = flowField->m_pendingNavigationVersion;
 		}
 	}
-	m_solidMap->SetAllValues(heatMapValues);
+
+	return flowField;
+}
+
+bool Map::FindPath(Vec3 const& startPosition, Vec3 const& goalPosition, std::vector<Vec2>& out_waypoints) const
+{
+	std::vector<IntVec2> waypointTiles;
+	IntVec2 startTileCoords(RoundDownToInt(startPosition.x), RoundDownToInt(startPosition.y));
+	IntVec2 goalTileCoords(RoundDownToInt(goalPosition.x), RoundDownToInt(goalPosition.y));
+	if (!m_navGraph.FindPath(m_navigationBlockedTiles, startTileCoords, goalTileCoords, waypointTiles))
+	{
+		return false;
+	}
+
+	for (int waypointIndex = 0; waypointIndex < (int)waypointTiles.size(); waypointIndex++)
+	{
+		out_waypoints.push_back(Vec2((float)waypointTiles[waypointIndex].x + 0.5f, (float)waypointTiles[waypointIndex].y + 0.5f));
+	}
+	return true;
 }
 
-void Map::RenderTiles() const
+bool Map::FindLocalPath(Vec2 const& startPosition, Vec2 const& goalPosition, std::vector<Vec2>& out_tileSteps) const
 {
-	g_renderer->SetBlendMode(BlendMode::OPAQUE);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->SetModelConstants();
-	g_renderer->SetLightConstants(m_game->m_sunDirection.GetNormalized(), m_game->m_sunIntensity, m_game->m_ambientIntensity);
-	g_renderer->BindShader(m_definition.m_shader);
-	g_renderer->BindTexture(m_definition.m_terrainSpriteSheet->GetTexture());
-	g_renderer->DrawIndexBuffer(m_tileVertexBuffer, m_tileIndexBuffer, (int)(m_tileIndexBuffer->m_size / sizeof(unsigned int)));
+	std::vector<IntVec2> stepTiles;
+	IntVec2 startTileCoords(RoundDownToInt(startPosition.x), RoundDownToInt(startPosition.y));
+	IntVec2 goalTileCoords(RoundDownToInt(goalPosition.x), RoundDownToInt(goalPosition.y));
+	if (!m_navGraph.FindLocalPath(m_navigationBlockedTiles, startTileCoords, goalTileCoords, stepTiles))
+	{
+		return false;
+	}
+
+	for (int stepIndex = 0; stepIndex < (int)stepTiles.size(); stepIndex++)
+	{
+		out_tileSteps.push_back(Vec2((float)stepTiles[stepIndex].x + 0.5f, (float)stepTiles[stepIndex].y + 0.5f));
+	}
+	return true;
+}
+
+void Map::DeleteUnusedFlowFields()
+{
+	for (int flowFieldIndex = 0; flowFieldIndex < (int)m_flowFields.size(); flowFieldIndex++)
+	{
+		if (!GetActorByUID(m_flowFields[flowFieldIndex]->m_targetUID))
+		{
+			delete m_flowFields[flowFieldIndex];
+			m_flowFields.erase(m_flowFields.begin() + flowFieldIndex);
+			flowFieldIndex--;
+		}
+	}
+}
+
+void Map::AddTileDrawItems(RenderList& renderList, std::vector<ViewFrustum> const& viewFrustums) const
+{
+	m_numTileChunksDrawn = 0;
+	m_numTileChunksCulled = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)m_tileChunks.size(); chunkIndex++)
+	{
+		TileChunk const& chunk = m_tileChunks[chunkIndex];
+		if (chunk.m_numIndexes == 0)
+		{
+			continue;
+		}
+		if (!IsTileChunkVisible(chunk, viewFrustums))
+		{
+			m_numTileChunksCulled++;
+			continue;
+		}
+
+		DrawItem drawItem;
+		drawItem.m_vertexBuffer = chunk.m_vertexBuffer;
+		drawItem.m_indexBuffer = chunk.m_indexBuffer;
+		drawItem.m_indexCount = chunk.m_numIndexes;
+		drawItem.m_texture = m_definition.m_terrainSpriteSheet->GetTexture();
+		drawItem.m_shader = m_definition.m_tileShader;
+		renderList.AddDrawItem(drawItem);
+		m_numTileChunksDrawn++;
+	}
+}
+
+// Quads carry a uv that counts tiles across them, and the sprite's rectangle on the atlas in the tangent and bitangent for the tile shader to wrap the uv into
+static void AddVertsForRepeatedSpriteQuad3D(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, Vec3 const& bottomLeft, Vec3 const& bottomRight, Vec3 const& topRight, Vec3 const& topLeft, Rgba8 const& color, Vec2 const& numRepeats, AABB2 const& spriteUVs)
+{
+	int firstVertexIndex = (int)verts.size();
+	AddVertsForQuad3D(verts, indexes, bottomLeft, bottomRight, topRight, topLeft, color, AABB2(Vec2::ZERO, numRepeats));
+	for (int vertexIndex = firstVertexIndex; vertexIndex < (int)verts.size(); vertexIndex++)
+	{
+		verts[vertexIndex].m_tangent = Vec3(spriteUVs.m_mins.x, spriteUVs.m_mins.y, 0.f);
+		verts[vertexIndex].m_bitangent = Vec3(spriteUVs.m_maxs.x - spriteUVs.m_mins.x, spriteUVs.m_maxs.y - spriteUVs.m_mins.y, 0.f);
+	}
 }
 
-void Map::AddVertsForTile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, AABB2 const& floorUVs, AABB2 const& ceilingUVs) const
+void Map::AddVertsForTile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, IntVec2 const& numTiles) const
 {
 	Tile tile = m_tiles[tileIndex];
+	AABB2 floorUVs = m_definition.m_terrainSpriteSheet->GetSpriteUVs(tile.GetFloorSpriteCoords().y * m_definition.m_spriteSheetDimensions.x + tile.GetFloorSpriteCoords().x);
+	AABB2 ceilingUVs = m_definition.m_terrainSpriteSheet->GetSpriteUVs(tile.GetCeilingSpriteCoords().y * m_definition.m_spriteSheetDimensions.x + tile.GetCeilingSpriteCoords().x);
 	AABB2 bounds = tile.GetBounds();
+	bounds.m_maxs = bounds.m_mins + Vec2((float)numTiles.x, (float)numTiles.y);
 	Rgba8 color = tile.GetColor();
 	Vec3 BL = bounds.m_mins.ToVec3();
 	Vec3 BR = Vec3(bounds.m_maxs.x, bounds.m_mins.y, 0.f);
 	Vec3 TR = bounds.m_maxs.ToVec3();
 	Vec3 TL = Vec3(bounds.m_mins.x, bounds.m_maxs.y, 0.f);
-	AddVertsForQuad3D(verts, indexes, BL, BR, TR, TL , color, AABB2(floorUVs.m_mins, floorUVs.m_maxs));
+	AddVertsForRepeatedSpriteQuad3D(verts, indexes, BL, BR, TR, TL, color, Vec2((float)numTiles.x, (float)numTiles.y), floorUVs);
 
+	// The ceiling is wound the other way, so its first edge runs along y
 	Vec3 ceilingBL = Vec3(BL.x, BL.y, 1.f);
 	Vec3 ceilingBR = Vec3(BR.x, BR.y, 1.f);
 	Vec3 ceilingTR = Vec3(TR.x, TR.y, 1.f);
 	Vec3 ceilingTL = Vec3(TL.x, TL.y, 1.f);
-	AddVertsForQuad3D(verts, indexes, ceilingTR, ceilingBR, ceilingBL, ceilingTL, color, AABB2(ceilingUVs.m_mins, ceilingUVs.m_maxs));
+	AddVertsForRepeatedSpriteQuad3D(verts, indexes, ceilingTR, ceilingBR, ceilingBL, ceilingTL, color, Vec2((float)numTiles.y, (float)numTiles.x), ceilingUVs);
 }
 
-void Map::AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, AABB2 const& wallUVs) const
+void Map::AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, unsigned int wallFace, int numTiles) const
 {
 	Tile tile = m_tiles[tileIndex];
+	AABB2 wallUVs = m_definition.m_terrainSpriteSheet->GetSpriteUVs(tile.GetWallSpriteCoords().y * m_definition.m_spriteSheetDimensions.x + tile.GetWallSpriteCoords().x);
 	AABB2 bounds = tile.GetBounds();
+	bool isRunAlongY = wallFace == TileSolidityGrid::NEIGHBOR_EAST || wallFace == TileSolidityGrid::NEIGHBOR_WEST;
+	bounds.m_maxs = bounds.m_mins + (isRunAlongY ? Vec2(1.f, (float)numTiles) : Vec2((float)numTiles, 1.f));
 	Rgba8 color = tile.GetColor();
 	Vec3 wallMins = Vec3(bounds.m_mins.x, bounds.m_mins.y, 0.f);
 	Vec3 wallMaxs = Vec3(bounds.m_maxs.x, bounds.m_maxs.y, 1.f);
@@ -187,20 +597,209 @@ void Map::AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigne
 	Vec3 TRB = Vec3(wallMaxs.x, wallMins.y, wallMaxs.z);
 	Vec3 TLB = Vec3(wallMaxs.x, wallMaxs.y, wallMaxs.z);
 
-	AddVertsForQuad3D(verts, indexes, BRB, BLB, TLB, TRB, color, wallUVs); // +X
-	AddVertsForQuad3D(verts, indexes, BLF, BRF, TRF, TLF, color, wallUVs); // -X
-	AddVertsForQuad3D(verts, indexes, BLB, BLF, TLF, TLB, color, wallUVs); // +Y
-	AddVertsForQuad3D(verts, indexes, BRF, BRB, TRB, TRF, color, wallUVs); // -Y
+	// Faces pressed against a neighbouring wall can never be seen, so the caller only asks for faces toward open or out-of-map tiles
+	Vec2 numRepeats((float)numTiles, 1.f);
+	switch (wallFace)
+	{
+		case TileSolidityGrid::NEIGHBOR_EAST:
+		{
+			AddVertsForRepeatedSpriteQuad3D(verts, indexes, BRB, BLB, TLB, TRB, color, numRepeats, wallUVs); // +X
+			break;
+		}
+		case TileSolidityGrid::NEIGHBOR_WEST:
+		{
+			AddVertsForRepeatedSpriteQuad3D(verts, indexes, BLF, BRF, TRF, TLF, color, numRepeats, wallUVs); // -X
+			break;
+		}
+		case TileSolidityGrid::NEIGHBOR_NORTH:
+		{
+			AddVertsForRepeatedSpriteQuad3D(verts, indexes, BLB, BLF, TLF, TLB, color, numRepeats, wallUVs); // +Y
+			break;
+		}
+		case TileSolidityGrid::NEIGHBOR_SOUTH:
+		{
+			AddVertsForRepeatedSpriteQuad3D(verts, indexes, BRF, BRB, TRB, TRF, color, numRepeats, wallUVs); // -Y
+			break;
+		}
+	}
 }
 
 void Map::UpdateActors()
 {
+	float deltaSeconds = m_game->m_gameClock.GetDeltaSeconds();
+	m_frameIndex++;
+	m_activityStats.m_numUpdated = 0;
+
 	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
 	{
 		Actor*& actor = m_actors[actorIndex];
-		if (actor)
+		if (!actor)
+		{
+			continue;
+		}
+
+		if (actor->m_activityTier == ActivityTier::SLEEPING)
+		{
+			continue;
+		}
+		if (actor->m_activityTier == ActivityTier::REDUCED && (m_frameIndex + (unsigned int)actorIndex) % ACTOR_REDUCED_TICK_INTERVAL != 0)
+		{
+			actor->m_pendingUpdateSeconds += deltaSeconds;
+			continue;
+		}
+
+		actor->Update();
+		m_activityStats.m_numUpdated++;
+	}
+}
+
+void Map::UpdateActivityTiers()
+{
+	float deltaSeconds = m_game->m_gameClock.GetDeltaSeconds();
+	m_activityStats.m_numActive = 0;
+	m_activityStats.m_numReduced = 0;
+	m_activityStats.m_numSleeping = 0;
+
+	// Wakers are the players and anything still moving, the only actors that can disturb a sleeper
+	// Sleepers never look for wakers, each waker marks and wakes the actors in the grid cells around it instead
+	m_activityWakers.clear();
+	m_activityPlayerPositions.clear();
+	float maxPhysicsRadius = 0.f;
+	float maxSightRadius = 0.f;
+	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	{
+		Actor* actor = m_actors[actorIndex];
+		if (!IsActorAlive(actor))
+		{
+			continue;
+		}
+		maxPhysicsRadius = std::max(maxPhysicsRadius, actor->m_physicsRadius);
+		if (actor->m_controller)
+		{
+			maxSightRadius = std::max(maxSightRadius, actor->m_definition.m_sightRadius);
+		}
+
+		bool isPlayer = actor->m_controller && actor->m_controller->IsPlayer();
+		if (isPlayer)
+		{
+			m_activityPlayerPositions.push_back(actor->m_position);
+		}
+		if (actor->m_activityTier != ActivityTier::SLEEPING && (isPlayer || !actor->IsAtRest()))
+		{
+			m_activityWakers.push_back(actor);
+		}
+	}
+	for (int wakerIndex = 0; wakerIndex < (int)m_activityWakers.size(); wakerIndex++)
+	{
+		WakeActorsNearWaker(m_activityWakers[wakerIndex], std::max(maxPhysicsRadius + ACTOR_WAKE_DISTANCE, maxSightRadius));
+	}
+
+	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	{
+		Actor* actor = m_actors[actorIndex];
+		if (!IsActorAlive(actor))
+		{
+			// Dead actors still update so their corpse timer can expire
+			if (actor)
+			{
+				actor->m_activityTier = ActivityTier::ACTIVE;
+			}
+			continue;
+		}
+
+		if (actor->m_controller && actor->m_controller->IsPlayer())
+		{
+			actor->WakeUp();
+			m_activityStats.m_numActive++;
+			continue;
+		}
+
+		// Damage and impulses wake sleepers as they happen, so a sleeper is only checked for having been moved some other way
+		bool isAtRest = actor->IsAtRest();
+		if (actor->m_activityTier == ActivityTier::SLEEPING)
+		{
+			if (!isAtRest)
+			{
+				actor->WakeUp();
+			}
+		}
+		else if (isAtRest)
+		{
+			actor->m_secondsAtRest += deltaSeconds;
+			if (actor->m_secondsAtRest >= ACTOR_SLEEP_DELAY_SECONDS && actor->m_nearWakerFrameIndex != m_frameIndex)
+			{
+				actor->m_activityTier = ActivityTier::SLEEPING;
+				actor->m_velocity = Vec3::ZERO;
+				actor->m_pendingUpdateSeconds = 0.f;
+				m_activityStats.m_numFellAsleep++;
+			}
+		}
+		else
+		{
+			actor->m_secondsAtRest = 0.f;
+		}
+
+		if (actor->m_activityTier == ActivityTier::SLEEPING)
+		{
+			m_activityStats.m_numSleeping++;
+			continue;
+		}
+
+		// Only AIs drop to a reduced tick, anything without a controller may be a pickup or prop a player can walk into
+		bool isFarFromPlayers = actor->m_controller != nullptr;
+		for (int playerIndex = 0; playerIndex < (int)m_activityPlayerPositions.size() && isFarFromPlayers; playerIndex++)
+		{
+			if (GetDistanceSquared2D(actor->m_position.GetXY(), m_activityPlayerPositions[playerIndex].GetXY()) < ACTOR_REDUCED_TICK_DISTANCE * ACTOR_REDUCED_TICK_DISTANCE)
+			{
+				isFarFromPlayers = false;
+			}
+		}
+
+		actor->m_activityTier = isFarFromPlayers ? ActivityTier::REDUCED : ActivityTier::ACTIVE;
+		if (isFarFromPlayers)
+		{
+			m_activityStats.m_numReduced++;
+		}
+		else
+		{
+			m_activityStats.m_numActive++;
+		}
+	}
+}
+
+void Map::WakeActorsNearWaker(Actor const* waker, float queryRadius)
+{
+	m_activityNearbyActors.clear();
+	GetActorsInRadius(waker->m_position, queryRadius, m_activityNearbyActors);
+	for (int nearbyIndex = 0; nearbyIndex < (int)m_activityNearbyActors.size(); nearbyIndex++)
+	{
+		Actor* nearbyActor = m_activityNearbyActors[nearbyIndex];
+		if (nearbyActor == waker || !IsActorAlive(nearbyActor))
+		{
+			continue;
+		}
+
+		// Marked actors stay awake this frame, otherwise a resting actor could fall asleep with a waker about to push it
+		float wakeRadius = nearbyActor->m_physicsRadius + ACTOR_WAKE_DISTANCE;
+		if (GetDistanceSquared2D(waker->m_position.GetXY(), nearbyActor->m_position.GetXY()) < wakeRadius * wakeRadius)
+		{
+			nearbyActor->m_nearWakerFrameIndex = m_frameIndex;
+			nearbyActor->WakeUp();
+			continue;
+		}
+
+		// A sleeping AI still has to notice enemies walking into view, line of sight is left to its own update once awake
+		if (nearbyActor->m_activityTier != ActivityTier::SLEEPING || !nearbyActor->m_controller || nearbyActor->m_definition.m_sightRadius <= 0.f)
+		{
+			continue;
+		}
+		if (waker->m_definition.m_faction == nearbyActor->m_definition.m_faction || waker->m_definition.m_faction == Faction::INVALID)
+		{
+			continue;
+		}
+		if (IsPointInsideDirectedSector2D(waker->m_position.GetXY(), nearbyActor->m_position.GetXY(), nearbyActor->GetForwardNormal().GetXY(), nearbyActor->m_definition.m_sightAngle, nearbyActor->m_definition.m_sightRadius))
 		{
-			actor->Update();
+			nearbyActor->WakeUp();
 		}
 	}
 }
@@ -208,32 +807,91 @@ void Map::UpdateActors()
 void Map::Update()
 {
 	UpdateActors();
+	RebuildActorGrid();
+	UpdateActivityTiers();
 	CollideActors();
 	CollideActorsWithMap();
+	StoreActorSweepStartPositions();
+	m_projectiles.Update();
 
 	DeleteDestroyedActors();
+	DeleteUnusedFlowFields();
+	m_flowFieldTileVisitsRemaining = FLOW_FIELD_TILE_VISITS_PER_FRAME;
+}
+
+void Map::UpdateMainThread()
+{
+}
+
+void Map::BuildRenderList(std::vector<ViewFrustum> const& viewFrustums)
+{
+	RebuildDirtyTileChunks();
+
+	RenderList& renderList = m_renderSnapshots.GetWriteBuffer();
+	renderList.BeginBuild();
+	renderList.SetDefaultShader(m_definition.m_shader);
+	AddTileDrawItems(renderList, viewFrustums);
+	AddActorDrawItems(renderList);
+	renderList.EndBuild();
+	m_renderSnapshots.Publish();
 }
 
 void Map::Render() const
 {
+	g_renderer->SetLightConstants(m_game->m_sunDirection.GetNormalized(), m_game->m_sunIntensity, m_game->m_ambientIntensity);
+	m_renderSnapshots.GetReadBuffer().Submit();
+}
+
+void Map::RenderCustomScreens() const
+{
+}
+
+void Map::RenderScreen() const
+{
+	g_renderer->SetDepthMode(DepthMode::DISABLED);
+	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
+	g_renderer->SetModelConstants();
+	g_renderer->BindShader(nullptr);
+	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
+	g_renderer->SetBlendMode(BlendMode::ALPHA);
+	g_renderer->BindTexture(nullptr);
+	m_game->m_player->RenderScreen(m_game->m_renderStates.GetReadBuffer().m_hud);
 }
 
-void Map::RenderActors() const
+void Map::AddActorDrawItems(RenderList& renderList) const
 {
 	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
 	{
 		Actor* const& actor = m_actors[actorIndex];
 		if (actor)
 		{
-			actor->Render();
+			actor->AddDrawItems(renderList);
 		}
 	}
+
+	m_projectiles.AddDrawItems(renderList);
 }
 
 void Map::SetTileType(IntVec2 const& tileCoords, std::string tileTypeName)
 {
 	int tileIndex = tileCoords.x + tileCoords.y * GetDimensions().x;
 	m_tiles[tileIndex] = Tile(tileTypeName, tileCoords.x, tileCoords.y);
+	m_solidGrid.SetTileSolid(tileCoords, m_tiles[tileIndex].IsSolid());
+	MarkTileChunksDirty(tileCoords);
+
+	// Tiles set while the map is still being constructed are picked up when the navigation grid is built
+	if (tileIndex >= (int)m_navigationBlockedTiles.size())
+	{
+		return;
+	}
+
+	unsigned char isBlocked = m_solidGrid.IsTileSolid(tileCoords.x, tileCoords.y) ? 1 : 0;
+	if (m_navigationBlockedTiles[tileIndex] != isBlocked)
+	{
+		m_navigationBlockedTiles[tileIndex] = isBlocked;
+		m_navigationVersion++;
+		m_navGraph.UpdateTile(m_navigationBlockedTiles, tileCoords);
+	}
 }
 
 DoomRaycastResult Map::RaycastVsAll(Vec3 const& startPos, Vec3 const& fwdNormal, float maxDistance, Actor* actorToExclude) const
@@ -302,7 +960,7 @@ DoomRaycastResult Map::RaycastVsWalls(Vec3 const& startPos, Vec3 const& fwdNorma
 	result.m_rayForwardNormal = fwdNormal;
 	result.m_rayMaxLength = maxDistance;
 
-	RaycastResult3D raycastVsTilesResult = m_solidMap->Raycast(startPos, fwdNormal, maxDistance, 0.f, 1.f);
+	RaycastResult3D raycastVsTilesResult = m_solidGrid.Raycast(startPos, fwdNormal, maxDistance);
 	if (raycastVsTilesResult.m_didImpact)
 	{
 		result.m_didImpact = true;
@@ -347,52 +1005,141 @@ DoomRaycastResult Map::RaycastVsWalls(Vec3 const& startPos, Vec3 const& fwdNorma
 
 void Map::CollideActors()
 {
-	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	// Broad phase, each actor's sweep this frame is bounded by a disc around its midpoint
+	// Padding every query by the largest bound makes the grid search symmetric, so a pair of awake actors is only tested from its lower index
+	// Actors spawned by a collision are left for next frame
+	int numActors = (int)m_actors.size();
+	m_collisionSweepBounds.resize(numActors);
+	float maxSweepBoundRadius = 0.f;
+	for (int actorIndex = 0; actorIndex < numActors; actorIndex++)
 	{
+		Actor const* actor = m_actors[actorIndex];
 		if (!IsActorAlive(m_actors[actorIndex]))
 		{
 			continue;
 		}
+		Vec3 sweepStart = actor->GetSweepStartPosition();
+		m_collisionSweepBounds[actorIndex].m_center = (sweepStart.GetXY() + actor->m_position.GetXY()) * 0.5f;
+		m_collisionSweepBounds[actorIndex].m_radius = actor->GetSweepDisplacement().GetXY().GetLength() * 0.5f + actor->m_physicsRadius;
+		m_collisionSweepBounds[actorIndex].m_isAsleep = actor->m_activityTier == ActivityTier::SLEEPING;
+		maxSweepBoundRadius = std::max(maxSweepBoundRadius, m_collisionSweepBounds[actorIndex].m_radius);
+	}
+
+	// Sleepers do not search for partners, a pair with an awake actor is found from that actor and two sleepers are never tested
+	for (int actorIndex = 0; actorIndex < numActors; actorIndex++)
+	{
+		if (!IsActorAlive(m_actors[actorIndex]) || m_collisionSweepBounds[actorIndex].m_isAsleep)
+		{
+			continue;
+		}
 
-		for (int otherActorIndex = actorIndex + 1; otherActorIndex < (int)m_actors.size(); otherActorIndex++)
+		// The grid holds end positions, up to a bound radius from the bound center, and collision pushes may have moved them up to a cell since
+		SweepBound const& bound = m_collisionSweepBounds[actorIndex];
+		m_actorGridQueryResults.clear();
+		m_actorGrid.GetActorIndexesNearDisc(bound.m_center, bound.m_radius + 2.f * maxSweepBoundRadius + ACTOR_GRID_CELL_SIZE, m_actorGridQueryResults);
+		for (int otherActorIndex = m_actorGrid.GetNumIndexedActors(); otherActorIndex < numActors; otherActorIndex++)
 		{
-			if (IsActorAlive(m_actors[otherActorIndex]))
+			m_actorGridQueryResults.push_back(otherActorIndex);
+		}
+
+		for (int resultIndex = 0; resultIndex < (int)m_actorGridQueryResults.size(); resultIndex++)
+		{
+			int otherActorIndex = m_actorGridQueryResults[resultIndex];
+			if (otherActorIndex >= numActors || !IsActorAlive(m_actors[otherActorIndex]))
+			{
+				continue;
+			}
+			if (otherActorIndex <= actorIndex && !m_collisionSweepBounds[otherActorIndex].m_isAsleep)
+			{
+				continue;
+			}
+
+			SweepBound const& otherBound = m_collisionSweepBounds[otherActorIndex];
+			float combinedRadius = bound.m_radius + otherBound.m_radius;
+			if (GetDistanceSquared2D(bound.m_center, otherBound.m_center) > combinedRadius * combinedRadius)
 			{
-				CollideActors(m_actors[actorIndex], m_actors[otherActorIndex]);
+				continue;
 			}
+
+			CollideActors(m_actors[actorIndex], m_actors[otherActorIndex]);
 		}
 	}
 }
 
 void Map::CollideActors(Actor* actorA, Actor* actorB)
 {
-	if (DoZCylindersOverlap(actorA->m_position, actorA->m_position + Vec3::SKYWARD * actorA->m_physicsHeight, actorA->m_physicsRadius, actorB->m_position, actorB->m_position + Vec3::SKYWARD * actorB->m_physicsHeight, actorB->m_physicsRadius))
+	if (IsOwner(actorA, actorB) || IsOwner(actorB, actorA))
 	{
-		if (IsOwner(actorA, actorB) || IsOwner(actorB, actorA))
-		{
-			return;
-		}
+		return;
+	}
 
-		if (actorA->m_ownerUID == actorB->m_ownerUID && actorA->m_ownerUID != ActorUID::INVALID)
-		{
-			return;
-		}
+	if (actorA->m_ownerUID == actorB->m_ownerUID && actorA->m_ownerUID != ActorUID::INVALID)
+	{
+		return;
+	}
+
+	if (actorA->m_ownerUID != ActorUID::INVALID && actorB->m_ownerUID != ActorUID::INVALID)
+	{
+		return;
+	}
 
-		if (actorA->m_ownerUID != ActorUID::INVALID && actorB->m_ownerUID != ActorUID::INVALID)
+	if (!DoZCylindersOverlap(actorA->m_position, actorA->m_position + Vec3::SKYWARD * actorA->m_physicsHeight, actorA->m_physicsRadius, actorB->m_position, actorB->m_position + Vec3::SKYWARD * actorB->m_physicsHeight, actorB->m_physicsRadius))
+	{
+		// Fast actors can end the frame on the far side of another, in which case the faster one is moved back to where they first touched
+		if (!RewindFasterActorToFirstContact(actorA, actorB))
 		{
 			return;
 		}
+	}
+
+	actorA->OnCollide(actorB);
+	actorB->OnCollide(actorA);
+}
+
+bool Map::RewindFasterActorToFirstContact(Actor* actorA, Actor* actorB) const
+{
+	Vec3 displacementA = actorA->GetSweepDisplacement();
+	Vec3 displacementB = actorB->GetSweepDisplacement();
+	Vec3 relativeDisplacement = displacementA - displacementB;
+
+	// Relative moves shorter than the smaller radius cannot pass through either actor without overlapping at the end
+	float minRadius = actorA->m_physicsRadius < actorB->m_physicsRadius ? actorA->m_physicsRadius : actorB->m_physicsRadius;
+	if (relativeDisplacement.GetLengthSquared() < minRadius * minRadius)
+	{
+		return false;
+	}
 
-		actorA->OnCollide(actorB);
-		actorB->OnCollide(actorA);
+	Vec3 sweepStartA = actorA->GetSweepStartPosition();
+	Vec3 sweepStartB = actorB->GetSweepStartPosition();
+	SweepResult result = SweepZCylinderVsZCylinder(sweepStartA, relativeDisplacement, actorA->m_physicsRadius, actorA->m_physicsHeight, sweepStartB, actorB->m_physicsRadius, actorB->m_physicsHeight);
+	if (!result.m_didImpact)
+	{
+		return false;
 	}
+
+	// The slower actor keeps its move, the faster one stops at first contact and slides the rest of its move along the other
+	// The impact normal points from B to A, so it is flipped when B is the one rewound
+	bool isAFaster = displacementA.GetLengthSquared() >= displacementB.GetLengthSquared();
+	Actor* fasterActor = isAFaster ? actorA : actorB;
+	Vec3 fasterSweepStart = isAFaster ? sweepStartA : sweepStartB;
+	Vec3 fasterDisplacement = isAFaster ? displacementA : displacementB;
+	Vec3 contactNormal = isAFaster ? result.m_impactNormal : result.m_impactNormal * -1.f;
+
+	Vec3 remainingDisplacement = fasterDisplacement * (1.f - result.m_timeOfImpact);
+	float approachDistance = DotProduct3D(remainingDisplacement, contactNormal);
+	if (approachDistance < 0.f)
+	{
+		remainingDisplacement -= contactNormal * approachDistance;
+	}
+	fasterActor->m_position = fasterSweepStart + fasterDisplacement * result.m_timeOfImpact + contactNormal * 0.001f + remainingDisplacement;
+	return true;
 }
 
 void Map::CollideActorsWithMap()
 {
 	for (int actorIndex = 0; actorIndex < static_cast<int>(m_actors.size()); actorIndex++)
 	{
-		if (!IsActorAlive(m_actors[actorIndex]) || m_actors[actorIndex]->m_isStatic)
+		if (!IsActorAlive(m_actors[actorIndex]) || m_actors[actorIndex]->m_isStatic || m_actors[actorIndex]->m_activityTier == ActivityTier::SLEEPING)
 		{
 			continue;
 		}
@@ -403,39 +1150,119 @@ void Map::CollideActorsWithMap()
 
 void Map::CollideActorWithMap(Actor* actor)
 {
-	IntVec2 tileCoords = IntVec2(RoundDownToInt(actor->m_position.x), RoundDownToInt(actor->m_position.y));
+	SweepActorAgainstTiles(actor);
 
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::EAST);
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::WEST);
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::NORTH);
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::SOUTH);
+	IntVec2 tileCoords = IntVec2(RoundDownToInt(actor->m_position.x), RoundDownToInt(actor->m_position.y));
 
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::EAST + IntVec2::NORTH);
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::EAST + IntVec2::SOUTH);
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::WEST + IntVec2::NORTH);
-	CollideActorWithTileIfSolid(actor, tileCoords + IntVec2::WEST + IntVec2::SOUTH);
+	// Most actors are in open space, so one mask read skips all eight neighbour tests
+	// Offsets follow the neighbour bit order, cardinal tiles first so they push the actor before the corners do
+	static IntVec2 const neighborOffsets[8] =
+	{
+		IntVec2::EAST, IntVec2::WEST, IntVec2::NORTH, IntVec2::SOUTH,
+		IntVec2::EAST + IntVec2::NORTH, IntVec2::EAST + IntVec2::SOUTH, IntVec2::WEST + IntVec2::NORTH, IntVec2::WEST + IntVec2::SOUTH
+	};
+	unsigned int solidNeighbors = m_solidGrid.GetSolidNeighborMask(tileCoords);
+	for (int neighborIndex = 0; neighborIndex < 8 && solidNeighbors != 0; neighborIndex++)
+	{
+		if (solidNeighbors & (1 << neighborIndex))
+		{
+			CollideActorWithTileIfSolid(actor, tileCoords + neighborOffsets[neighborIndex]);
+		}
+	}
 
 	CollideActorWithFloorAndCeiling(actor);
 }
 
-void Map::CollideActorWithTileIfSolid(Actor* actor, IntVec2 const& tileCoords)
+void Map::SweepActorAgainstTiles(Actor* actor)
 {
-	if (tileCoords.x < 0 || tileCoords.x > GetDimensions().x - 1 || tileCoords.y < 0 || tileCoords.y > GetDimensions().y - 1)
+	// Moves shorter than the radius cannot skip past a tile edge, the neighbour push-out resolves them
+	Vec2 displacement = actor->GetSweepDisplacement().GetXY();
+	if (displacement.GetLengthSquared() < actor->m_physicsRadius * actor->m_physicsRadius)
 	{
 		return;
 	}
 
-	int tileIndex = tileCoords.x + tileCoords.y * m_definition.m_dimensions.x;
-	Tile& tile = m_tiles[tileIndex];
+	// The actor stops at the first wall it touches and slides the rest of the way along it, a few walls deep for corners
+	Vec2 position = actor->GetSweepStartPosition().GetXY();
+	bool didImpact = false;
+	for (int slideIndex = 0; slideIndex < 3; slideIndex++)
+	{
+		SweepResult result = SweepDiscVsSolidTiles(position, displacement, actor->m_physicsRadius);
+		if (!result.m_didImpact)
+		{
+			position += displacement;
+			break;
+		}
+
+		didImpact = true;
+		Vec2 impactNormal = result.m_impactNormal.GetXY();
+		Vec2 remainingDisplacement = displacement * (1.f - result.m_timeOfImpact);
+		position += displacement * result.m_timeOfImpact + impactNormal * 0.001f;
+		displacement = remainingDisplacement - impactNormal * DotProduct2D(remainingDisplacement, impactNormal);
+	}
+
+	if (didImpact)
+	{
+		actor->m_position = Vec3(position.x, position.y, actor->m_position.z);
+		actor->OnCollide(nullptr);
+	}
+}
+
+SweepResult Map::SweepDiscVsSolidTiles(Vec2 const& discStart, Vec2 const& displacement, float discRadius) const
+{
+	SweepResult result;
+
+	Vec2 discEnd = discStart + displacement;
+	IntVec2 gridDimensions = m_solidGrid.GetDimensions();
+	int minTileX = std::max(RoundDownToInt(std::min(discStart.x, discEnd.x) - discRadius), 0);
+	int minTileY = std::max(RoundDownToInt(std::min(discStart.y, discEnd.y) - discRadius), 0);
+	int maxTileX = std::min(RoundDownToInt(std::max(discStart.x, discEnd.x) + discRadius), gridDimensions.x - 1);
+	int maxTileY = std::min(RoundDownToInt(std::max(discStart.y, discEnd.y) + discRadius), gridDimensions.y - 1);
+	for (int tileY = minTileY; tileY <= maxTileY; tileY++)
+	{
+		for (int tileX = minTileX; tileX <= maxTileX; tileX++)
+		{
+			if (!m_solidGrid.IsTileSolid(tileX, tileY))
+			{
+				continue;
+			}
+
+			AABB2 tileBounds(Vec2((float)tileX, (float)tileY), Vec2((float)(tileX + 1), (float)(tileY + 1)));
+			SweepResult tileResult = SweepDiscVsAABB2(discStart, displacement, discRadius, tileBounds);
+			if (tileResult.m_didImpact && tileResult.m_timeOfImpact < result.m_timeOfImpact)
+			{
+				result = tileResult;
+			}
+		}
+	}
+
+	return result;
+}
+
+void Map::StoreActorSweepStartPositions()
+{
+	for (int actorIndex = 0; actorIndex < (int)m_actors.size(); actorIndex++)
+	{
+		Actor* actor = m_actors[actorIndex];
+		if (actor)
+		{
+			actor->m_sweepStartPosition = actor->m_position;
+			actor->m_hasSweepStartPosition = true;
+		}
+	}
+}
 
-	if (!tile.IsSolid())
+void Map::CollideActorWithTileIfSolid(Actor* actor, IntVec2 const& tileCoords)
+{
+	if (!m_solidGrid.IsTileSolid(tileCoords.x, tileCoords.y))
 	{
 		return;
 	}
 
 	Vec2 actorPositionXY = actor->m_position.GetXY();
+	AABB2 tileBounds(Vec2((float)tileCoords.x, (float)tileCoords.y), Vec2((float)(tileCoords.x + 1), (float)(tileCoords.y + 1)));
 
-	if (PushDiscOutOfFixedAABB2(actorPositionXY, actor->m_physicsRadius, tile.GetBounds()))
+	if (PushDiscOutOfFixedAABB2(actorPositionXY, actor->m_physicsRadius, tileBounds))
 	{
 		actor->OnCollide(nullptr);
 	}
@@ -449,9 +1276,9 @@ void Map::CollideActorWithFloorAndCeiling(Actor* actor)
 		actor->m_position.z = 0.f;
 		actor->OnCollide(nullptr);
 	}
-	else if (actor->m_position.z + actor->m_physicsHeight > 1.f)
+	else if (actor->m_position.z + actor->m_physicsHeight > GetCeilingHeight())
 	{
-		actor->m_position.z = 1.f - actor->m_physicsHeight;
+		actor->m_position.z = GetCeilingHeight() - actor->m_physicsHeight;
 		actor->OnCollide(nullptr);
 	}
 }
@@ -484,9 +1311,10 @@ void Map::DeleteDestroyedActors()
 	}
 }
 
-void Map::SpawnPlayer(int)
+void Map::SpawnPlayer(int playerIndex)
 {
-	int spawnPointIndex = g_RNG->RollRandomIntInRange(0, (int)m_spawnPoints.size() - 1);
+	CounterRNG spawnRNG = g_randomStreams->GetRNG(RandomStream::SPAWNING, GetRandomSubjectForName(m_definition.m_name.c_str()), m_frameIndex, (unsigned int)playerIndex);
+	int spawnPointIndex = spawnRNG.RollRandomIntInRange(0, (int)m_spawnPoints.size() - 1);
 	SpawnInfo spawnInfo;
 	spawnInfo.m_actor = "Soldier";
 	spawnInfo.m_position = m_spawnPoints[spawnPointIndex]->m_position;
@@ -523,6 +1351,33 @@ Actor* Map::CreateSpawnPoint(SpawnInfo spawnInfo)
 	return spawnPoint;
 }
 
+void Map::RebuildActorGrid()
+{
+	m_actorGrid.Rebuild(m_actors, GetWorldDimensions(), ACTOR_GRID_CELL_SIZE);
+}
+
+void Map::GetActorsInRadius(Vec3 const& center, float radius, std::vector<Actor*>& out_actors) const
+{
+	// Actors keep moving after the grid is rebuilt (collision pushes), so the query is padded by a cell before the exact test
+	m_actorGridQueryResults.clear();
+	m_actorGrid.GetActorIndexesNearDisc(center.GetXY(), radius + ACTOR_GRID_CELL_SIZE, m_actorGridQueryResults);
+
+	// Actors spawned since the last rebuild are appended to the list and not in the grid yet
+	for (int actorIndex = m_actorGrid.GetNumIndexedActors(); actorIndex < (int)m_actors.size(); actorIndex++)
+	{
+		m_actorGridQueryResults.push_back(actorIndex);
+	}
+
+	for (int resultIndex = 0; resultIndex < (int)m_actorGridQueryResults.size(); resultIndex++)
+	{
+		Actor* actor = m_actors[m_actorGridQueryResults[resultIndex]];
+		if (actor && IsPointInsideDisc2D(actor->m_position.GetXY(), center.GetXY(), radius))
+		{
+			out_actors.push_back(actor);
+		}
+	}
+}
+
 Actor* Map::GetActorByUID(ActorUID const& uid) const
 {
 	if (uid == ActorUID::INVALID)
@@ -599,3 +1454,20 @@ Particle* Map::SpawnParticle(Vec3 const& position, float radius, Rgba8 const& co
 	m_visualActors.push_back(newParticle);
 	return newParticle;
 }
+
+void Map::CreateParticleMesh()
+{
+	std::vector<Vertex_PCUTBN> vertexes;
+	std::vector<unsigned int> indexes;
+	AddVertsForAABB3(vertexes, indexes, AABB3(Vec3(-1.f, -1.f, -1.f), Vec3(1.f, 1.f, 1.f)), Rgba8::WHITE);
+
+	size_t vertexBytes = vertexes.size() * sizeof(Vertex_PCUTBN);
+	size_t indexBytes = indexes.size() * sizeof(unsigned int);
+	m_particleVertexBuffer = g_renderer->CreateVertexBuffer(vertexBytes, VertexType::VERTEX_PCUTBN);
+	m_particleIndexBuffer = g_renderer->CreateIndexBuffer(indexBytes);
+	TrackAllocation(AllocationCategory::GPU_BUFFERS, vertexBytes);
+	TrackAllocation(AllocationCategory::GPU_BUFFERS, indexBytes);
+	g_renderer->CopyCPUToGPU(vertexes.data(), vertexBytes, m_particleVertexBuffer);
+	g_renderer->CopyCPUToGPU(indexes.data(), indexBytes, m_particleIndexBuffer);
+	m_particleIndexCount = (int)indexes.size();
+}
@@ -1,13 +1,22 @@
 #pragma once
 
+#include "Game/ActorSpatialGrid.hpp"
 #include "Game/ActorUID.hpp"
 #include "Game/App.hpp"
+#include "Game/FlowField.hpp"
+#include "Game/HierarchicalNavGraph.hpp"
 #include "Game/MapDefinition.hpp"
+#include "Game/ProjectileSystem.hpp"
+#include "Game/RenderList.hpp"
+#include "Game/SnapshotExchange.hpp"
+#include "Game/SweptCollision.hpp"
 #include "Game/Tile.hpp"
+#include "Game/TileChunk.hpp"
+#include "Game/ViewFrustum.hpp"
+#include "Game/TileSolidityGrid.hpp"
 #include "Game/TileDefinition.hpp"
 #include "Game/GameCommon.hpp"
 
-#include "Engine/Core/HeatMaps/TileHeatMap.hpp"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 
 #include <vector>
@@ -20,6 +29,25 @@ class VertexBuffer;
 class IndexBuffer;
 class Controller;
 
+struct ActivityTierStats
+{
+	int m_numActive = 0;
+	int m_numReduced = 0;
+	int m_numSleeping = 0;
+	int m_numWoken = 0;
+	int m_numFellAsleep = 0;
+	int m_numUpdated = 0;
+};
+
+// Disc around everything an actor's cylinder passed through this frame, on the ground plane
+struct SweepBound
+{
+	Vec2 m_center = Vec2::ZERO;
+	float m_radius = 0.f;
+	// Taken before any pair is resolved, collisions can wake a sleeper partway through the pass
+	bool m_isAsleep = false;
+};
+
 class Map
 {
 public:
@@ -28,22 +56,44 @@ public:
 	Map(Game* game, MapDefinition mapDef);
 
 	virtual void			Update();
+	// Runs on the main thread before the simulation step starts, for anything that reads input or adds screen text and debug draws
+	virtual void			UpdateMainThread();
 	virtual void			UpdateActors();
+	// Sleeping actors skip updates and collision until something wakes them, distant AIs update every few frames
+	void					UpdateActivityTiers();
+	void					WakeActorsNearWaker(Actor const* waker, float queryRadius);
 
+	virtual void			BuildRenderList(std::vector<ViewFrustum> const& viewFrustums);
 	virtual void			Render() const;
-	virtual void			RenderCustomScreens() const = 0;
-	virtual void			RenderScreen() const = 0;
-	virtual void			RenderTiles() const;
-	virtual void			RenderActors() const;
+	// Offscreen passes drawn before the views, tile maps have none
+	virtual void			RenderCustomScreens() const;
+	virtual void			RenderScreen() const;
+	virtual void			AddTileDrawItems(RenderList& renderList, std::vector<ViewFrustum> const& viewFrustums) const;
+	virtual void			AddActorDrawItems(RenderList& renderList) const;
 
 	void					ConstructMapFromImage();
-	void					CreateTileHeatMaps();
+	virtual void			BuildNavigationGrid();
+	bool					IsTileBlockedForNavigation(IntVec2 const& tileCoords) const;
+	FlowField const*		GetFlowFieldToActor(Actor const* target);
+	bool					FindPath(Vec3 const& startPosition, Vec3 const& goalPosition, std::vector<Vec2>& out_waypoints) const;
+	bool					FindLocalPath(Vec2 const& startPosition, Vec2 const& goalPosition, std::vector<Vec2>& out_tileSteps) const;
+	void					DeleteUnusedFlowFields();
 	void					InitializeTiles();
+	void					MarkTileChunksDirty(IntVec2 const& tileCoords);
+	void					RebuildDirtyTileChunks();
+	void					AddVertsForTileChunk(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, TileChunk const& chunk) const;
+	void					RebuildTileChunk(TileChunk& chunk);
+	void					ReleaseTileChunkBuffers(TileChunk& chunk);
+	bool					IsTileChunkVisible(TileChunk const& chunk, std::vector<ViewFrustum> const& viewFrustums) const;
 	virtual IntVec2			GetDimensions() const { return m_definition.m_dimensions; }
+	// Extents of the playable area in tiles, which outdoor maps define without a tile grid
+	virtual IntVec2			GetWorldDimensions() const { return GetDimensions(); }
+	virtual float			GetCeilingHeight() const { return 1.f; }
 
 	void					SetTileType(IntVec2 const& tileCoords, std::string tileTypeName);
-	void					AddVertsForTile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, AABB2 const& floorUVs, AABB2 const& ceilingUVs) const;
-	void					AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, AABB2 const& wallUVs) const;
+	// Both emit one quad covering numTiles tiles of the same definition, starting at tileIndex
+	void					AddVertsForTile(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, IntVec2 const& numTiles) const;
+	void					AddVertsForWall(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes, int tileIndex, unsigned int wallFace, int numTiles) const;
 
 	bool					IsActorAlive(Actor* const& actor) const;
 	bool					IsOwner(Actor* actorA, Actor* actorB) const;
@@ -58,6 +108,10 @@ public:
 	virtual void					CollideActorWithMap(Actor* actor);
 	virtual void					CollideActorWithTileIfSolid(Actor* actor, IntVec2 const& tileCoords);
 	virtual void					CollideActorWithFloorAndCeiling(Actor* actor);
+	void							SweepActorAgainstTiles(Actor* actor);
+	bool							RewindFasterActorToFirstContact(Actor* actorA, Actor* actorB) const;
+	SweepResult						SweepDiscVsSolidTiles(Vec2 const& discStart, Vec2 const& displacement, float discRadius) const;
+	void							StoreActorSweepStartPositions();
 
 	virtual void					DeleteDestroyedActors();
 	virtual void					SpawnPlayer(int playerIndex);
@@ -65,12 +119,15 @@ public:
 	virtual Actor*					CreateSpawnPoint(SpawnInfo spawnInfo);
 	virtual Actor*					GetActorByUID(ActorUID const& uid) const;
 	virtual Actor*					GetClosestVisibleEnemy(Actor* seeker) const;
+	void							RebuildActorGrid();
+	void							GetActorsInRadius(Vec3 const& center, float radius, std::vector<Actor*>& out_actors) const;
 	bool							HasLineOfSight(Actor const* seeker, Actor const* target) const;
 	virtual void					DebugPossessNext();
 
 	virtual Player const*			GetCurrentRenderingPlayer() const;
 
 	Particle* SpawnParticle(Vec3 const& positiion, float radius, Rgba8 const& color, float lifetime);
+	void CreateParticleMesh();
 
 public:
 	Game* m_game;
@@ -79,10 +136,40 @@ public:
 	std::vector<Actor*> m_actors;
 	std::vector<Actor*> m_spawnPoints;
 	std::vector<Actor*> m_visualActors;
-	TileHeatMap* m_solidMap = nullptr;
-	VertexBuffer* m_tileVertexBuffer = nullptr;
-	IndexBuffer* m_tileIndexBuffer = nullptr;
+	TileSolidityGrid m_solidGrid;
+	std::vector<TileChunk> m_tileChunks;
+	IntVec2 m_tileChunkGridDimensions = IntVec2(0, 0);
+	int m_numTileChunkRebuilds = 0;
+	mutable int m_numTileChunksDrawn = 0;
+	mutable int m_numTileChunksCulled = 0;
+	// Tile mesh sizes as built, and as they would be with a quad for every tile face
+	int m_numTileVertexes = 0;
+	int m_numTileIndexes = 0;
+	int m_numUnculledTileVertexes = 0;
+	int m_numUnculledTileIndexes = 0;
 	unsigned int m_actorSalt = 0;
 	std::vector<Controller*> m_aiControllers;
 	Player* m_currentRenderingPlayer = nullptr;
+	// Built by the simulation and published each frame, rendering only reads the latest published list
+	SnapshotExchange<RenderList> m_renderSnapshots;
+	ActorSpatialGrid m_actorGrid;
+	mutable std::vector<int> m_actorGridQueryResults;
+	std::vector<SweepBound> m_collisionSweepBounds;
+	// Per-tile flag for tiles agents cannot walk through, bumping the version makes every flow field recompute
+	std::vector<unsigned char> m_navigationBlockedTiles;
+	int m_navigationVersion = 0;
+	std::vector<FlowField*> m_flowFields;
+	int m_flowFieldTileVisitsRemaining = FLOW_FIELD_TILE_VISITS_PER_FRAME;
+	HierarchicalNavGraph m_navGraph;
+	ProjectileSystem m_projectiles = ProjectileSystem(this);
+	ActivityTierStats m_activityStats;
+	// Simulation frames since the map started, staggers reduced ticks and keys random rolls
+	unsigned int m_frameIndex = 0;
+	std::vector<Actor*> m_activityWakers;
+	std::vector<Vec3> m_activityPlayerPositions;
+	std::vector<Actor*> m_activityNearbyActors;
+	// Unit cube every particle is drawn with, particles are spawned and deleted on the simulation thread so they own no GPU buffers
+	VertexBuffer* m_particleVertexBuffer = nullptr;
+	IndexBuffer* m_particleIndexBuffer = nullptr;
+	int m_particleIndexCount = 0;
 };
@@ -1,5 +1,6 @@
 #include "Game/MapDefinition.hpp"
 
+#include "Game/AllocationTracker.hpp"
 #include "Game/GameCommon.hpp"
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -34,13 +35,17 @@ MapDefinition::MapDefinition(XmlElement const* element)
 	std::string spriteSheetTexturePath = ParseXmlAttribute(*element, "spriteSheetTexture", "");
 	m_spriteSheetDimensions = ParseXmlAttribute(*element, "spriteSheetCellCount", IntVec2::ZERO);
 	Texture* spriteSheetTexture = g_renderer->CreateOrGetTextureFromFile(spriteSheetTexturePath.c_str());
+	// Maps copy their definition by value and share this sheet, so it lives as long as the definition table
 	m_terrainSpriteSheet = new SpriteSheet(spriteSheetTexture, m_spriteSheetDimensions);
+	TrackAllocation(AllocationCategory::DEFINITIONS, sizeof(SpriteSheet));
 	
 	std::string shaderPath = ParseXmlAttribute(*element, "shader", "");
 	if (!shaderPath.empty())
 	{
 		m_shader = g_renderer->CreateOrGetShader(shaderPath.c_str(), VertexType::VERTEX_PCUTBN);
 	}
+	std::string tileShaderPath = ParseXmlAttribute(*element, "tileShader", "Data/Shaders/DiffuseTiled");
+	m_tileShader = g_renderer->CreateOrGetShader(tileShaderPath.c_str(), VertexType::VERTEX_PCUTBN);
 
 	XmlElement const* spawnInfosXmlElement = element->FirstChildElement("SpawnInfos");
 	XmlElement const* spawnInfoXmlElement = spawnInfosXmlElement->FirstChildElement();
@@ -30,6 +30,8 @@ public:
 	IntVec2					m_spriteSheetDimensions = IntVec2::ZERO;
 	std::vector<SpawnInfo>	m_spawnInfos;
 	Shader*					m_shader = nullptr;
+	// Tile chunks are built for a shader that repeats each sprite across merged quads, so they never draw with the default shader
+	Shader*					m_tileShader = nullptr;
 
 public:
 	~MapDefinition() = default;
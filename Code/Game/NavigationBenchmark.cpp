@@ -0,0 +1,166 @@
+#include "Game/NavigationBenchmark.hpp"
+
+#include "Game/CounterRNG.hpp"
+#include "Game/FlowField.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/HierarchicalNavGraph.hpp"
+
+#include "Engine/Core/Time.hpp"
+
+
+void GenerateMazeTiles(std::vector<unsigned char>& out_blockedTiles, IntVec2 const& dimensions, float loopFraction)
+{
+	out_blockedTiles.assign(dimensions.x * dimensions.y, 1);
+	if (dimensions.x < 3 || dimensions.y < 3)
+	{
+		return;
+	}
+
+	CounterRNG mazeRNG = g_randomStreams->GetRNG(RandomStream::BENCHMARK, GetRandomSubjectForName("Maze"));
+	std::vector<int> carveStack;
+	out_blockedTiles[1 + 1 * dimensions.x] = 0;
+	carveStack.push_back(1 + 1 * dimensions.x);
+
+	int const stepX[4] = { 2, -2, 0, 0 };
+	int const stepY[4] = { 0, 0, 2, -2 };
+	while (!carveStack.empty())
+	{
+		int tileIndex = carveStack.back();
+		int tileX = tileIndex % dimensions.x;
+		int tileY = tileIndex / dimensions.x;
+
+		int candidateSteps[4];
+		int numCandidateSteps = 0;
+		for (int stepIndex = 0; stepIndex < 4; stepIndex++)
+		{
+			int nextX = tileX + stepX[stepIndex];
+			int nextY = tileY + stepY[stepIndex];
+			if (nextX > 0 && nextY > 0 && nextX < dimensions.x - 1 && nextY < dimensions.y - 1 && out_blockedTiles[nextX + nextY * dimensions.x])
+			{
+				candidateSteps[numCandidateSteps] = stepIndex;
+				numCandidateSteps++;
+			}
+		}
+
+		if (numCandidateSteps == 0)
+		{
+			carveStack.pop_back();
+			continue;
+		}
+
+		int stepIndex = candidateSteps[mazeRNG.RollRandomIntInRange(0, numCandidateSteps - 1)];
+		int nextX = tileX + stepX[stepIndex];
+		int nextY = tileY + stepY[stepIndex];
+		out_blockedTiles[(tileX + stepX[stepIndex] / 2) + (tileY + stepY[stepIndex] / 2) * dimensions.x] = 0;
+		out_blockedTiles[nextX + nextY * dimensions.x] = 0;
+		carveStack.push_back(nextX + nextY * dimensions.x);
+	}
+
+	int numWallsToOpen = (int)(loopFraction * (float)(dimensions.x * dimensions.y));
+	for (int wallIndex = 0; wallIndex < numWallsToOpen; wallIndex++)
+	{
+		int tileX = mazeRNG.RollRandomIntInRange(1, dimensions.x - 2);
+		int tileY = mazeRNG.RollRandomIntInRange(1, dimensions.y - 2);
+		out_blockedTiles[tileX + tileY * dimensions.x] = 0;
+	}
+}
+
+NavigationBenchmarkResults RunNavigationBenchmark(IntVec2 const& dimensions, int clusterSize, int numQueries, int numTileUpdates, int numFullGridSearches)
+{
+	NavigationBenchmarkResults results;
+	CounterRNG benchmarkRNG = g_randomStreams->GetRNG(RandomStream::BENCHMARK, GetRandomSubjectForName("NavigationBenchmark"));
+
+	std::vector<unsigned char> blockedTiles;
+	GenerateMazeTiles(blockedTiles, dimensions, 0.05f);
+
+	std::vector<int> walkableTileIndexes;
+	for (int tileIndex = 0; tileIndex < (int)blockedTiles.size(); tileIndex++)
+	{
+		if (!blockedTiles[tileIndex])
+		{
+			walkableTileIndexes.push_back(tileIndex);
+		}
+	}
+	if (walkableTileIndexes.empty())
+	{
+		return results;
+	}
+
+	HierarchicalNavGraph navGraph;
+	double buildStartTime = GetCurrentTimeSeconds();
+	navGraph.Build(blockedTiles, dimensions, clusterSize);
+	results.m_buildSeconds = GetCurrentTimeSeconds() - buildStartTime;
+	results.m_numClusters = navGraph.GetStats().m_numClusters;
+	results.m_numPortals = navGraph.GetStats().m_numPortals;
+
+	// Each update toggles a random tile twice so the maze is unchanged when queries run
+	double updateStartTime = GetCurrentTimeSeconds();
+	for (int updateIndex = 0; updateIndex < numTileUpdates; updateIndex++)
+	{
+		int tileIndex = walkableTileIndexes[benchmarkRNG.RollRandomIntInRange(0, (int)walkableTileIndexes.size() - 1)];
+		IntVec2 tileCoords(tileIndex % dimensions.x, tileIndex / dimensions.x);
+		blockedTiles[tileIndex] = 1;
+		navGraph.UpdateTile(blockedTiles, tileCoords);
+		blockedTiles[tileIndex] = 0;
+		navGraph.UpdateTile(blockedTiles, tileCoords);
+	}
+	results.m_numTileUpdates = numTileUpdates * 2;
+	if (numTileUpdates > 0)
+	{
+		results.m_averageTileUpdateSeconds = (GetCurrentTimeSeconds() - updateStartTime) / (double)results.m_numTileUpdates;
+	}
+
+	std::vector<IntVec2> queryStarts;
+	std::vector<IntVec2> queryGoals;
+	std::vector<float> queryCosts;
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		int startTileIndex = walkableTileIndexes[benchmarkRNG.RollRandomIntInRange(0, (int)walkableTileIndexes.size() - 1)];
+		int goalTileIndex = walkableTileIndexes[benchmarkRNG.RollRandomIntInRange(0, (int)walkableTileIndexes.size() - 1)];
+		queryStarts.push_back(IntVec2(startTileIndex % dimensions.x, startTileIndex / dimensions.x));
+		queryGoals.push_back(IntVec2(goalTileIndex % dimensions.x, goalTileIndex / dimensions.x));
+	}
+
+	std::vector<IntVec2> waypoints;
+	long long totalNodesExpanded = 0;
+	double queryStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		waypoints.clear();
+		float pathCost = -1.f;
+		if (navGraph.FindPath(blockedTiles, queryStarts[queryIndex], queryGoals[queryIndex], waypoints, &pathCost))
+		{
+			results.m_numPathsFound++;
+		}
+		queryCosts.push_back(pathCost);
+		totalNodesExpanded += navGraph.GetStats().m_numNodesExpanded;
+	}
+	results.m_numQueries = numQueries;
+	if (numQueries > 0)
+	{
+		results.m_averageQuerySeconds = (GetCurrentTimeSeconds() - queryStartTime) / (double)numQueries;
+		results.m_averageNodesExpanded = (double)totalNodesExpanded / (double)numQueries;
+	}
+
+	// Full-grid searches give the baseline cost and the optimal path length for the first few queries
+	FlowField fullGridSearch;
+	int numFullGridSearchesRun = numFullGridSearches < numQueries ? numFullGridSearches : numQueries;
+	double fullGridStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numFullGridSearchesRun; queryIndex++)
+	{
+		fullGridSearch.Compute(blockedTiles, dimensions, queryGoals[queryIndex]);
+		float optimalCost = fullGridSearch.GetDistanceAtTile(queryStarts[queryIndex]);
+		if (queryCosts[queryIndex] > 0.f && optimalCost > 0.f && optimalCost < FlowField::UNREACHABLE_DISTANCE)
+		{
+			float costRatio = queryCosts[queryIndex] / optimalCost;
+			results.m_worstPathCostRatio = costRatio > results.m_worstPathCostRatio ? costRatio : results.m_worstPathCostRatio;
+		}
+	}
+	results.m_numFullGridSearches = numFullGridSearchesRun;
+	if (numFullGridSearchesRun > 0)
+	{
+		results.m_averageFullGridSearchSeconds = (GetCurrentTimeSeconds() - fullGridStartTime) / (double)numFullGridSearchesRun;
+	}
+
+	return results;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+
+#include <vector>
+
+struct NavigationBenchmarkResults
+{
+public:
+	int		m_numClusters = 0;
+	int		m_numPortals = 0;
+	double	m_buildSeconds = 0.0;
+	int		m_numQueries = 0;
+	int		m_numPathsFound = 0;
+	double	m_averageQuerySeconds = 0.0;
+	double	m_averageNodesExpanded = 0.0;
+	int		m_numTileUpdates = 0;
+	double	m_averageTileUpdateSeconds = 0.0;
+	int		m_numFullGridSearches = 0;
+	double	m_averageFullGridSearchSeconds = 0.0;
+	float	m_worstPathCostRatio = 1.f;
+};
+
+// Carves a perfect maze with a depth-first walk over odd tiles, then opens a fraction of the remaining walls so there are loops to choose between
+void GenerateMazeTiles(std::vector<unsigned char>& out_blockedTiles, IntVec2 const& dimensions, float loopFraction);
+// Times the hierarchical graph against a full-grid Dijkstra search on a generated maze
+NavigationBenchmarkResults RunNavigationBenchmark(IntVec2 const& dimensions, int clusterSize, int numQueries, int numTileUpdates, int numFullGridSearches);
@@ -2,10 +2,14 @@
 
 #include "Game/App.hpp"
 #include "Game/Actor.hpp"
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/GeometryCache.hpp"
 #include "Game/Map.hpp"
+#include "Game/VoiceManager.hpp"
 #include "Game/Weapon.hpp"
+#include "Game/WeaponDefinition.hpp"
 
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/DevConsole.hpp"
@@ -102,6 +106,7 @@ void Player::Update()
 
 	g_app->m_worldCamera.SetTransform(m_position, m_orientation);
 	g_audio->UpdateListeners(m_playerIndex, m_position, GetForwardNormal(), GetUpNormal());
+	g_voiceManager->SetListenerPosition(m_playerIndex, m_position);
 }
 
 void Player::UpdateFreeFlyInput()
@@ -419,63 +424,115 @@ void Player::UpdateFirstPersonVRInput()
 	Mat44 playerModelMatrix = Mat44::CreateTranslation3D(m_position);
 	playerModelMatrix.Append(m_orientation.GetAsMatrix_iFwd_jLeft_kUp());
 
-	m_rightControllerWorldPosition = playerModelMatrix.TransformPosition3D(rightController.GetPosition_iFwd_jLeft_kUp());
-	m_rightControllerOrientation = m_orientation + rightController.GetOrientation_iFwd_jLeft_kUp();
-	m_leftControllerWorldPosition = playerModelMatrix.TransformPosition3D(leftController.GetPosition_iFwd_jLeft_kUp());
-	m_leftControllerOrientation = m_orientation + leftController.GetOrientation_iFwd_jLeft_kUp();
+	PoseSample const& pose = m_game->m_updatePose;
+	m_rightControllerWorldPosition = playerModelMatrix.TransformPosition3D(pose.m_rightController.m_position);
+	m_rightControllerOrientation = m_orientation + pose.m_rightController.m_orientation;
+	m_leftControllerWorldPosition = playerModelMatrix.TransformPosition3D(pose.m_leftController.m_position);
+	m_leftControllerOrientation = m_orientation + pose.m_leftController.m_orientation;
 }
 
-void Player::RenderScreen() const
+void Player::BuildHudState(PlayerHudState& out_hudState) const
 {
+	out_hudState = PlayerHudState();
 	if (!m_game->m_currentMap)
 	{
 		return;
 	}
 
-	//g_renderer->BeginCamera(g_app->m_screenCamera);
-
-	std::vector<Vertex_PCU> hudVerts;
-	std::vector<Vertex_PCU> weaponVerts;
-	std::vector<Vertex_PCU> reticleVerts;
-	std::vector<Vertex_PCU> screenTextVerts;
-
-
 	Actor* possessedActor = m_game->m_currentMap->GetActorByUID(m_actorUID);
 	if (!possessedActor)
 	{
 		return;
 	}
 
+	Weapon* const& weapon = possessedActor->m_weapons[possessedActor->m_equippedWeaponIndex];
+	out_hudState.m_hasActor = true;
+	out_hudState.m_is3DActor = possessedActor->m_definition.m_is3DActor;
+	out_hudState.m_healthFraction = possessedActor->m_health / possessedActor->m_definition.m_health;
+	out_hudState.m_health = RoundDownToInt(GetClamped(possessedActor->m_health, 0.f, possessedActor->m_definition.m_health));
+	out_hudState.m_kills = m_kills;
+	out_hudState.m_deaths = m_deaths;
+	out_hudState.m_weaponDefinition = &WeaponDefinition::s_weaponDefs[weapon->m_definition.m_name];
+
+	if (!possessedActor->m_definition.m_is3DActor)
+	{
+		// A finished attack shows the idle animation until the weapon fires again
+		SpriteAnimDefinition currentWeaponAnimation = weapon->m_currentAnimation;
+		if (currentWeaponAnimation.GetDuration() < weapon->m_animationClock->GetTotalSeconds())
+		{
+			currentWeaponAnimation = weapon->m_definition.m_idleAnimation;
+		}
+		SpriteDefinition sprite = currentWeaponAnimation.GetSpriteDefAtTime(weapon->m_animationClock->GetTotalSeconds());
+		out_hudState.m_weaponUVs = sprite.GetUVs();
+	}
+}
+
+void Player::RenderScreen(PlayerHudState const& hudState) const
+{
+	if (!hudState.m_hasActor)
+	{
+		return;
+	}
+
+	//g_renderer->BeginCamera(g_app->m_screenCamera);
+
+	WeaponDefinition const& weaponDefinition = *hudState.m_weaponDefinition;
 	AABB2 screenBox(GetNormalizedScreenCoordinates().m_mins * Vec2(g_screenSizeX, g_screenSizeY), GetNormalizedScreenCoordinates().m_maxs * Vec2(g_screenSizeX, g_screenSizeY));
+	uint64_t screenBoxKey = GeometryCache::HashValue(screenBox);
 
-	if (possessedActor->m_definition.m_is3DActor)
+	// HUD meshes are cached per player and only rebuilt when the values they display change
+	if (hudState.m_is3DActor)
 	{
-		std::vector<Vertex_PCU> healthBarVerts;
 		AABB2 healthBarOuterBounds = AABB2(Vec2(30.f, g_screenSizeY - 50.f), Vec2(230.f, g_screenSizeY - 30.f));
 		AABB2 healthBarInnerBounds(healthBarOuterBounds);
 		healthBarInnerBounds.AddPadding(-4.f, -2.f);
 
-		AddVertsForAABB2(healthBarVerts, healthBarOuterBounds, Rgba8::WHITE);
+		char const* healthBarFrameName = g_frameArena->Format("Player%d::HealthBarFrame", m_playerIndex);
+		uint64_t healthBarFrameKey = GeometryCache::HashValue(healthBarOuterBounds);
+		CachedMesh const* healthBarFrameMesh = g_geometryCache->FindMesh(healthBarFrameName, healthBarFrameKey);
+		if (!healthBarFrameMesh)
+		{
+			std::vector<Vertex_PCU> healthBarFrameVerts;
+			AddVertsForAABB2(healthBarFrameVerts, healthBarOuterBounds, Rgba8::WHITE);
+			AddVertsForAABB2(healthBarFrameVerts, healthBarInnerBounds, Rgba8::RED);
+			healthBarFrameMesh = g_geometryCache->UpdateMesh(healthBarFrameName, healthBarFrameKey, healthBarFrameVerts);
+		}
+		g_geometryCache->DrawMesh(healthBarFrameMesh);
 
-		float healthFraction = possessedActor->m_health / possessedActor->m_definition.m_health;
-		AddVertsForAABB2(healthBarVerts, healthBarInnerBounds, Rgba8::RED);
-		
 		AABB2 healthBarBounds(healthBarInnerBounds);
-		healthBarBounds.m_maxs.x *= healthFraction;
+		healthBarBounds.m_maxs.x *= hudState.m_healthFraction;
+		std::vector<Vertex_PCU>& healthBarVerts = g_frameArena->AcquireScratchVertexesPCU();
 		AddVertsForAABB2(healthBarVerts, healthBarBounds, Rgba8::GREEN);
-		g_renderer->DrawVertexArray(healthBarVerts);
+		g_geometryCache->DrawDynamicVertexArray(healthBarVerts);
 
 		Vec2 screenCenter = screenBox.GetCenter();
-		AddVertsForAABB2(reticleVerts, AABB2(screenCenter - possessedActor->m_weapons[possessedActor->m_equippedWeaponIndex]->m_definition.m_reticleSize.GetAsVec2() * 0.5f, screenCenter + possessedActor->m_weapons[possessedActor->m_equippedWeaponIndex]->m_definition.m_reticleSize.GetAsVec2() * 0.5f), Rgba8::WHITE);
-		g_renderer->BindTexture(possessedActor->m_weapons[possessedActor->m_equippedWeaponIndex]->m_definition.m_reticleTexture);
-		g_renderer->DrawVertexArray(reticleVerts);
+		Vec2 reticleSize = weaponDefinition.m_reticleSize.GetAsVec2();
+		AABB2 reticleBounds(screenCenter - reticleSize * 0.5f, screenCenter + reticleSize * 0.5f);
+		char const* reticleName = g_frameArena->Format("Player%d::Reticle", m_playerIndex);
+		uint64_t reticleKey = GeometryCache::HashValue(reticleBounds);
+		CachedMesh const* reticleMesh = g_geometryCache->FindMesh(reticleName, reticleKey);
+		if (!reticleMesh)
+		{
+			std::vector<Vertex_PCU> reticleVerts;
+			AddVertsForAABB2(reticleVerts, reticleBounds, Rgba8::WHITE);
+			reticleMesh = g_geometryCache->UpdateMesh(reticleName, reticleKey, reticleVerts);
+		}
+		g_renderer->BindTexture(weaponDefinition.m_reticleTexture);
+		g_geometryCache->DrawMesh(reticleMesh);
 
 		g_renderer->EndCamera(g_app->m_screenCamera);
 
 		return;
 	}
 
-	AddVertsForAABB2(hudVerts, screenBox.GetBoxAtUVs(Vec2::ZERO, Vec2(1.f, 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y)), Rgba8::WHITE);
+	char const* hudName = g_frameArena->Format("Player%d::Hud", m_playerIndex);
+	CachedMesh const* hudMesh = g_geometryCache->FindMesh(hudName, screenBoxKey);
+	if (!hudMesh)
+	{
+		std::vector<Vertex_PCU> hudVerts;
+		AddVertsForAABB2(hudVerts, screenBox.GetBoxAtUVs(Vec2::ZERO, Vec2(1.f, 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y)), Rgba8::WHITE);
+		hudMesh = g_geometryCache->UpdateMesh(hudName, screenBoxKey, hudVerts);
+	}
 
 	g_renderer->SetBlendMode(BlendMode::OPAQUE);
 	g_renderer->SetDepthMode(DepthMode::DISABLED);
@@ -483,42 +540,57 @@ void Player::RenderScreen() const
 	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
 	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->BindShader(possessedActor->m_weapons[possessedActor->m_equippedWeaponIndex]->m_definition.m_hudShader);
-	g_renderer->BindTexture(possessedActor->m_weapons[possessedActor->m_equippedWeaponIndex]->m_definition.m_hudTexture);
-	g_renderer->DrawVertexArray(hudVerts);
+	g_renderer->BindShader(weaponDefinition.m_hudShader);
+	g_renderer->BindTexture(weaponDefinition.m_hudTexture);
+	g_geometryCache->DrawMesh(hudMesh);
 
-	Weapon* const& weapon = possessedActor->m_weapons[possessedActor->m_equippedWeaponIndex];
+	float weaponScalingFactor = (GetNormalizedScreenCoordinates().GetDimensions().x * GetNormalizedScreenCoordinates().GetDimensions().y);
+	Vec2 weaponBottomCenter = screenBox.GetPointAtUV(Vec2(0.5f, 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y));
+	Vec2 weaponBottomLeft = weaponBottomCenter - Vec2((float)weaponDefinition.m_spriteSize.x * 0.5f * weaponScalingFactor, 0.f);
+	Vec2 weaponTopRight = weaponBottomCenter + Vec2((float)weaponDefinition.m_spriteSize.x * 0.5f * weaponScalingFactor, (float)weaponDefinition.m_spriteSize.y * weaponScalingFactor);
+	AABB2 weaponBounds(weaponBottomLeft, weaponTopRight);
+	AABB2 weaponUVs = hudState.m_weaponUVs;
 
-	if (weapon->m_currentAnimation.GetDuration() < weapon->m_animationClock->GetTotalSeconds())
+	// The weapon sprite only changes when the animation advances to a new frame
+	char const* weaponName = g_frameArena->Format("Player%d::Weapon", m_playerIndex);
+	uint64_t weaponKey = GeometryCache::HashValue(weaponUVs, GeometryCache::HashValue(weaponBounds));
+	CachedMesh const* weaponMesh = g_geometryCache->FindMesh(weaponName, weaponKey);
+	if (!weaponMesh)
 	{
-		weapon->m_currentAnimation = weapon->m_definition.m_idleAnimation;
+		std::vector<Vertex_PCU> weaponVerts;
+		AddVertsForAABB2(weaponVerts, weaponBounds, Rgba8::WHITE, weaponUVs.m_mins, weaponUVs.m_maxs);
+		weaponMesh = g_geometryCache->UpdateMesh(weaponName, weaponKey, weaponVerts);
 	}
 
-	float weaponScalingFactor = (GetNormalizedScreenCoordinates().GetDimensions().x * GetNormalizedScreenCoordinates().GetDimensions().y);
-	SpriteAnimDefinition currentWeaponAnimation = weapon->m_currentAnimation;
-	SpriteDefinition sprite = currentWeaponAnimation.GetSpriteDefAtTime(weapon->m_animationClock->GetTotalSeconds());
-	Vec2 weaponBottomCenter = screenBox.GetPointAtUV(Vec2(0.5f, 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y));
-	Vec2 weaponBottomLeft = weaponBottomCenter - Vec2((float)weapon->m_definition.m_spriteSize.x * 0.5f * weaponScalingFactor, 0.f);
-	Vec2 weaponTopRight = weaponBottomCenter + Vec2((float)weapon->m_definition.m_spriteSize.x * 0.5f * weaponScalingFactor, (float)weapon->m_definition.m_spriteSize.y * weaponScalingFactor);
-	AddVertsForAABB2(weaponVerts, AABB2(weaponBottomLeft, weaponTopRight), Rgba8::WHITE, sprite.GetUVs().m_mins, sprite.GetUVs().m_maxs);
-
-	g_renderer->BindShader(weapon->m_definition.m_idleAnimationShader);
-	g_renderer->BindTexture(weapon->m_definition.m_idleAnimation.GetTexture());
-	g_renderer->DrawVertexArray(weaponVerts);
+	g_renderer->BindShader(weaponDefinition.m_idleAnimationShader);
+	g_renderer->BindTexture(weaponDefinition.m_idleAnimation.GetTexture());
+	g_geometryCache->DrawMesh(weaponMesh);
 
 	Vec2 screenCenter = screenBox.GetCenter();
-	AddVertsForAABB2(reticleVerts, AABB2(screenCenter - weapon->m_definition.m_reticleSize.GetAsVec2() * 0.5f, screenCenter + weapon->m_definition.m_reticleSize.GetAsVec2() * 0.5f), Rgba8::WHITE);
-	g_renderer->BindTexture(weapon->m_definition.m_reticleTexture);
-	g_renderer->DrawVertexArray(reticleVerts);
+	AABB2 reticleBounds(screenCenter - weaponDefinition.m_reticleSize.GetAsVec2() * 0.5f, screenCenter + weaponDefinition.m_reticleSize.GetAsVec2() * 0.5f);
+	char const* reticleName = g_frameArena->Format("Player%d::Reticle", m_playerIndex);
+	uint64_t reticleKey = GeometryCache::HashValue(reticleBounds);
+	CachedMesh const* reticleMesh = g_geometryCache->FindMesh(reticleName, reticleKey);
+	if (!reticleMesh)
+	{
+		std::vector<Vertex_PCU> reticleVerts;
+		AddVertsForAABB2(reticleVerts, reticleBounds, Rgba8::WHITE);
+		reticleMesh = g_geometryCache->UpdateMesh(reticleName, reticleKey, reticleVerts);
+	}
+	g_renderer->BindTexture(weaponDefinition.m_reticleTexture);
+	g_geometryCache->DrawMesh(reticleMesh);
 
-	int renderedHealth = RoundDownToInt(GetClamped(possessedActor->m_health, 0.f, possessedActor->m_definition.m_health));
-	g_squirrelFont->AddVertsForTextInBox2D(screenTextVerts, screenBox.GetBoxAtUVs(Vec2(0.f, 0.f), Vec2(0.15f, 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y)), 40.f, Stringf("%d", m_kills).c_str(), Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.5f));
-	g_squirrelFont->AddVertsForTextInBox2D(screenTextVerts, screenBox.GetBoxAtUVs(Vec2(0.25f, 0.f), Vec2(0.36f, 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y)), 40.f, Stringf("%d", renderedHealth).c_str(), Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.5f));
-	g_squirrelFont->AddVertsForTextInBox2D(screenTextVerts, screenBox.GetBoxAtUVs(Vec2(0.85f, 0.f), Vec2(1.f, 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y)), 40.f, Stringf("%d", m_deaths).c_str(), Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.5f));
+	// Each number is its own text block, so a health change does not lay out the kill and death counts again
+	float hudHeightFraction = 0.128f / GetNormalizedScreenCoordinates().GetDimensions().y;
+	CachedMesh const* killsTextMesh = g_geometryCache->GetOrBuildTextMesh(g_frameArena->Format("Player%d::KillsText", m_playerIndex), g_squirrelFont, screenBox.GetBoxAtUVs(Vec2(0.f, 0.f), Vec2(0.15f, hudHeightFraction)), 40.f, g_frameArena->Format("%d", hudState.m_kills), Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.5f));
+	CachedMesh const* healthTextMesh = g_geometryCache->GetOrBuildTextMesh(g_frameArena->Format("Player%d::HealthText", m_playerIndex), g_squirrelFont, screenBox.GetBoxAtUVs(Vec2(0.25f, 0.f), Vec2(0.36f, hudHeightFraction)), 40.f, g_frameArena->Format("%d", hudState.m_health), Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.5f));
+	CachedMesh const* deathsTextMesh = g_geometryCache->GetOrBuildTextMesh(g_frameArena->Format("Player%d::DeathsText", m_playerIndex), g_squirrelFont, screenBox.GetBoxAtUVs(Vec2(0.85f, 0.f), Vec2(1.f, hudHeightFraction)), 40.f, g_frameArena->Format("%d", hudState.m_deaths), Rgba8::WHITE, 0.7f, Vec2(0.5f, 0.5f));
 
 	g_renderer->SetBlendMode(BlendMode::ALPHA);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(screenTextVerts);
+	g_geometryCache->DrawMesh(killsTextMesh);
+	g_geometryCache->DrawMesh(healthTextMesh);
+	g_geometryCache->DrawMesh(deathsTextMesh);
 
 	//g_renderer->EndCamera(g_app->m_screenCamera);
 }
@@ -5,6 +5,7 @@
 #include "Game/GameCommon.hpp"
 
 #include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
@@ -12,6 +13,22 @@
 
 class Actor;
 class Game;
+struct WeaponDefinition;
+
+// What the HUD shows, copied from the possessed actor once the simulation step has finished so the screen pass never reads live actors
+struct PlayerHudState
+{
+public:
+	bool						m_hasActor = false;
+	bool						m_is3DActor = false;
+	float						m_healthFraction = 0.f;
+	int							m_health = 0;
+	int							m_kills = 0;
+	int							m_deaths = 0;
+	// Points at the shared definition rather than the weapon, which a step can delete while the HUD is drawn
+	WeaponDefinition const*		m_weaponDefinition = nullptr;
+	AABB2						m_weaponUVs;
+};
 
 class Player : public Controller
 {
@@ -29,7 +46,8 @@ public:
 	void UpdateFreeFlyKeyboardAndMouseInput();
 	void UpdateFreeFlyControllerInput();
 
-	void RenderScreen() const;
+	void BuildHudState(PlayerHudState& out_hudState) const;
+	void RenderScreen(PlayerHudState const& hudState) const;
 
 	virtual bool IsPlayer() const override { return true; }
 	virtual void DamagedBy(Actor* actor) override;
@@ -0,0 +1,391 @@
+#include "Game/PoissonDiskPlacement.hpp"
+
+#include "Game/CounterRNG.hpp"
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+
+PoissonDiskPlacer::PoissonDiskPlacer(AABB2 const& bounds, std::vector<PlacementModel> const& models)
+	: m_bounds(bounds)
+	, m_models(models)
+{
+	m_minRadius = FLT_MAX;
+	for (int modelIndex = 0; modelIndex < (int)m_models.size(); modelIndex++)
+	{
+		m_totalWeight += m_models[modelIndex].m_weight;
+		m_minRadius = std::min(m_minRadius, m_models[modelIndex].m_exclusionRadius);
+		m_maxRadius = std::max(m_maxRadius, m_models[modelIndex].m_exclusionRadius);
+	}
+
+	// The closest two placements can be is twice the smallest radius, which is exactly the diagonal of a cell this size
+	m_cellSize = 2.f * m_minRadius / sqrtf(2.f);
+	Vec2 boundsDimensions = m_bounds.m_maxs - m_bounds.m_mins;
+	m_gridDimensions = IntVec2(std::max(1, (int)ceilf(boundsDimensions.x / m_cellSize)), std::max(1, (int)ceilf(boundsDimensions.y / m_cellSize)));
+}
+
+void PoissonDiskPlacer::AddObstacle(Vec2 const& center, float radius)
+{
+	m_obstacleCenters.push_back(center);
+	m_obstacleRadii.push_back(radius);
+}
+
+void PoissonDiskPlacer::SetDensityMap(std::vector<float> const& densities, IntVec2 const& dimensions)
+{
+	m_densities = densities;
+	m_densityDimensions = dimensions;
+}
+
+void PoissonDiskPlacer::Generate(std::vector<Placement>& out_placements, CounterRNG& rng, int candidatesPerPlacement)
+{
+	m_stats = PlacementStats();
+	m_placements.clear();
+	out_placements.clear();
+	if (m_models.empty() || m_totalWeight <= 0.f)
+	{
+		return;
+	}
+
+	int numCells = m_gridDimensions.x * m_gridDimensions.y;
+	m_cellPlacementIndexes.assign(numCells, -1);
+	BuildObstacleCells();
+
+	std::vector<int> activeIndexes;
+	int seedCellIndex = 0;
+	while (true)
+	{
+		if (activeIndexes.empty())
+		{
+			// Growth stalled (an obstacle or the bounds cut it off), reseed in the next cell it never reached
+			// The cursor only moves forward, so each cell costs at most one seed attempt over the whole run
+			while (seedCellIndex < numCells && activeIndexes.empty())
+			{
+				int cellIndex = seedCellIndex;
+				seedCellIndex++;
+				if (m_cellPlacementIndexes[cellIndex] >= 0)
+				{
+					continue;
+				}
+
+				Vec2 cellMins = m_bounds.m_mins + Vec2((float)(cellIndex % m_gridDimensions.x), (float)(cellIndex / m_gridDimensions.x)) * m_cellSize;
+				Vec2 seedPosition(rng.RollRandomFloatInRange(cellMins.x, cellMins.x + m_cellSize), rng.RollRandomFloatInRange(cellMins.y, cellMins.y + m_cellSize));
+				if (TryAddPlacement(seedPosition, RollModelIndex(rng)))
+				{
+					activeIndexes.push_back((int)m_placements.size() - 1);
+					m_stats.m_numSeeds++;
+				}
+			}
+
+			if (activeIndexes.empty())
+			{
+				break;
+			}
+		}
+
+		int activeSlot = rng.RollRandomIntInRange(0, (int)activeIndexes.size() - 1);
+		Placement const parent = m_placements[activeIndexes[activeSlot]];
+		float parentRadius = m_models[parent.m_modelIndex].m_exclusionRadius;
+
+		bool didAddChild = false;
+		for (int candidateIndex = 0; candidateIndex < candidatesPerPlacement; candidateIndex++)
+		{
+			// Candidates fall in the annulus between one and two spacings from the parent, so accepted ones pack tightly without overlapping
+			int modelIndex = RollModelIndex(rng);
+			float spacing = parentRadius + m_models[modelIndex].m_exclusionRadius;
+			float distance = rng.RollRandomFloatInRange(spacing, 2.f * spacing);
+			Vec2 candidatePosition = parent.m_position + Vec2::MakeFromPolarDegrees(rng.RollRandomFloatInRange(0.f, 360.f), distance);
+			if (TryAddPlacement(candidatePosition, modelIndex))
+			{
+				activeIndexes.push_back((int)m_placements.size() - 1);
+				didAddChild = true;
+				break;
+			}
+		}
+
+		if (!didAddChild)
+		{
+			activeIndexes[activeSlot] = activeIndexes.back();
+			activeIndexes.pop_back();
+		}
+	}
+
+	// Thinning only removes points, so the spacing guarantee survives and sparse areas stay sparse
+	out_placements.reserve(m_placements.size());
+	for (int placementIndex = 0; placementIndex < (int)m_placements.size(); placementIndex++)
+	{
+		Placement const& placement = m_placements[placementIndex];
+		if (m_densities.empty() || rng.RollRandomChance(GetDensityAt(placement.m_position)))
+		{
+			out_placements.push_back(placement);
+		}
+		else
+		{
+			m_stats.m_numThinned++;
+		}
+	}
+}
+
+bool PoissonDiskPlacer::IsLocationFree(Vec2 const& position, float radius) const
+{
+	if (position.x < m_bounds.m_mins.x || position.x >= m_bounds.m_maxs.x || position.y < m_bounds.m_mins.y || position.y >= m_bounds.m_maxs.y)
+	{
+		return false;
+	}
+
+	IntVec2 cellCoords = GetCellCoordsForPosition(position);
+	int cellIndex = cellCoords.x + cellCoords.y * m_gridDimensions.x;
+	if (m_cellPlacementIndexes[cellIndex] >= 0)
+	{
+		return false;
+	}
+
+	// Obstacles were stored in every cell within their radius plus the largest model radius, so the candidate's own cell has every one that can reach it
+	if (!m_obstacleCellStartIndexes.empty())
+	{
+		for (int cellObstacleIndex = m_obstacleCellStartIndexes[cellIndex]; cellObstacleIndex < m_obstacleCellStartIndexes[cellIndex + 1]; cellObstacleIndex++)
+		{
+			int obstacleIndex = m_obstacleCellIndexes[cellObstacleIndex];
+			float spacing = radius + m_obstacleRadii[obstacleIndex];
+			if (GetDistanceSquared2D(position, m_obstacleCenters[obstacleIndex]) < spacing * spacing)
+			{
+				return false;
+			}
+		}
+	}
+
+	int cellRange = (int)ceilf((radius + m_maxRadius) / m_cellSize);
+	int minCellX = std::max(cellCoords.x - cellRange, 0);
+	int maxCellX = std::min(cellCoords.x + cellRange, m_gridDimensions.x - 1);
+	int minCellY = std::max(cellCoords.y - cellRange, 0);
+	int maxCellY = std::min(cellCoords.y + cellRange, m_gridDimensions.y - 1);
+	for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+	{
+		for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+		{
+			int placementIndex = m_cellPlacementIndexes[cellX + cellY * m_gridDimensions.x];
+			if (placementIndex < 0)
+			{
+				continue;
+			}
+
+			Placement const& placement = m_placements[placementIndex];
+			float spacing = radius + m_models[placement.m_modelIndex].m_exclusionRadius;
+			if (GetDistanceSquared2D(position, placement.m_position) < spacing * spacing)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+float PoissonDiskPlacer::GetDensityAt(Vec2 const& position) const
+{
+	if (m_densities.empty())
+	{
+		return 1.f;
+	}
+
+	Vec2 boundsDimensions = m_bounds.m_maxs - m_bounds.m_mins;
+	int texelX = RoundDownToInt((position.x - m_bounds.m_mins.x) / boundsDimensions.x * (float)m_densityDimensions.x);
+	int texelY = RoundDownToInt((position.y - m_bounds.m_mins.y) / boundsDimensions.y * (float)m_densityDimensions.y);
+	texelX = std::min(std::max(texelX, 0), m_densityDimensions.x - 1);
+	texelY = std::min(std::max(texelY, 0), m_densityDimensions.y - 1);
+	return m_densities[texelX + texelY * m_densityDimensions.x];
+}
+
+int PoissonDiskPlacer::CountSpacingViolations() const
+{
+	int numViolations = 0;
+	for (int placementIndex = 0; placementIndex < (int)m_placements.size(); placementIndex++)
+	{
+		Placement const& placement = m_placements[placementIndex];
+		float radius = m_models[placement.m_modelIndex].m_exclusionRadius;
+		IntVec2 cellCoords = GetCellCoordsForPosition(placement.m_position);
+		int cellRange = (int)ceilf((radius + m_maxRadius) / m_cellSize);
+		for (int cellY = std::max(cellCoords.y - cellRange, 0); cellY <= std::min(cellCoords.y + cellRange, m_gridDimensions.y - 1); cellY++)
+		{
+			for (int cellX = std::max(cellCoords.x - cellRange, 0); cellX <= std::min(cellCoords.x + cellRange, m_gridDimensions.x - 1); cellX++)
+			{
+				// Each pair is counted once, from its lower index
+				int otherIndex = m_cellPlacementIndexes[cellX + cellY * m_gridDimensions.x];
+				if (otherIndex <= placementIndex)
+				{
+					continue;
+				}
+
+				Placement const& otherPlacement = m_placements[otherIndex];
+				float spacing = radius + m_models[otherPlacement.m_modelIndex].m_exclusionRadius;
+				if (GetDistanceSquared2D(placement.m_position, otherPlacement.m_position) < spacing * spacing)
+				{
+					numViolations++;
+				}
+			}
+		}
+	}
+	return numViolations;
+}
+
+void PoissonDiskPlacer::BuildObstacleCells()
+{
+	int numCells = m_gridDimensions.x * m_gridDimensions.y;
+	m_obstacleCellStartIndexes.assign(numCells + 1, 0);
+	m_obstacleCellIndexes.clear();
+	if (m_obstacleCenters.empty())
+	{
+		return;
+	}
+
+	// Count, prefix sum, then fill, the same layout the projectile system uses for static actors
+	for (int pass = 0; pass < 2; pass++)
+	{
+		std::vector<int> cellWriteIndexes;
+		if (pass == 1)
+		{
+			for (int cellIndex = 0; cellIndex < numCells; cellIndex++)
+			{
+				m_obstacleCellStartIndexes[cellIndex + 1] += m_obstacleCellStartIndexes[cellIndex];
+			}
+			m_obstacleCellIndexes.resize(m_obstacleCellStartIndexes[numCells]);
+			cellWriteIndexes.assign(m_obstacleCellStartIndexes.begin(), m_obstacleCellStartIndexes.end() - 1);
+		}
+
+		for (int obstacleIndex = 0; obstacleIndex < (int)m_obstacleCenters.size(); obstacleIndex++)
+		{
+			float reach = m_obstacleRadii[obstacleIndex] + m_maxRadius;
+			Vec2 const& center = m_obstacleCenters[obstacleIndex];
+			if (center.x + reach < m_bounds.m_mins.x || center.x - reach >= m_bounds.m_maxs.x || center.y + reach < m_bounds.m_mins.y || center.y - reach >= m_bounds.m_maxs.y)
+			{
+				continue;
+			}
+
+			IntVec2 minCellCoords = GetCellCoordsForPosition(center - Vec2(reach, reach));
+			IntVec2 maxCellCoords = GetCellCoordsForPosition(center + Vec2(reach, reach));
+			for (int cellY = minCellCoords.y; cellY <= maxCellCoords.y; cellY++)
+			{
+				for (int cellX = minCellCoords.x; cellX <= maxCellCoords.x; cellX++)
+				{
+					int cellIndex = cellX + cellY * m_gridDimensions.x;
+					if (pass == 0)
+					{
+						m_obstacleCellStartIndexes[cellIndex + 1]++;
+					}
+					else
+					{
+						m_obstacleCellIndexes[cellWriteIndexes[cellIndex]] = obstacleIndex;
+						cellWriteIndexes[cellIndex]++;
+					}
+				}
+			}
+		}
+	}
+}
+
+bool PoissonDiskPlacer::TryAddPlacement(Vec2 const& position, int modelIndex)
+{
+	m_stats.m_numCandidates++;
+	if (!IsLocationFree(position, m_models[modelIndex].m_exclusionRadius))
+	{
+		return false;
+	}
+
+	Placement placement;
+	placement.m_position = position;
+	placement.m_modelIndex = modelIndex;
+	IntVec2 cellCoords = GetCellCoordsForPosition(position);
+	m_cellPlacementIndexes[cellCoords.x + cellCoords.y * m_gridDimensions.x] = (int)m_placements.size();
+	m_placements.push_back(placement);
+	m_stats.m_numAccepted++;
+	return true;
+}
+
+int PoissonDiskPlacer::RollModelIndex(CounterRNG& rng) const
+{
+	float roll = rng.RollRandomFloatInRange(0.f, m_totalWeight);
+	for (int modelIndex = 0; modelIndex < (int)m_models.size() - 1; modelIndex++)
+	{
+		roll -= m_models[modelIndex].m_weight;
+		if (roll < 0.f)
+		{
+			return modelIndex;
+		}
+	}
+	return (int)m_models.size() - 1;
+}
+
+IntVec2 const PoissonDiskPlacer::GetCellCoordsForPosition(Vec2 const& position) const
+{
+	int cellX = std::min(std::max(RoundDownToInt((position.x - m_bounds.m_mins.x) / m_cellSize), 0), m_gridDimensions.x - 1);
+	int cellY = std::min(std::max(RoundDownToInt((position.y - m_bounds.m_mins.y) / m_cellSize), 0), m_gridDimensions.y - 1);
+	return IntVec2(cellX, cellY);
+}
+
+PlacementBenchmarkResults RunPlacementBenchmark(float worldSize, float naiveWorldSize)
+{
+	PlacementBenchmarkResults results;
+	results.m_worldSize = worldSize;
+	results.m_naiveWorldSize = naiveWorldSize;
+
+	std::vector<PlacementModel> models(2);
+	models[0].m_exclusionRadius = GOLD_TREE_EXCLUSION_RADIUS;
+	models[0].m_weight = GOLD_TREE_PLACEMENT_WEIGHT;
+	models[1].m_exclusionRadius = GOLD_ROCK_EXCLUSION_RADIUS;
+
+	RandomStreams streams(0);
+	CounterRNG poissonRNG = streams.GetRNG(RandomStream::BENCHMARK, 0);
+	PoissonDiskPlacer placer(AABB2(Vec2::ZERO, Vec2(worldSize, worldSize)), models);
+	std::vector<Placement> placements;
+	double startTime = GetCurrentTimeSeconds();
+	placer.Generate(placements, poissonRNG);
+	results.m_poissonSeconds = GetCurrentTimeSeconds() - startTime;
+	results.m_numPlacements = (int)placements.size();
+	results.m_numCandidates = placer.GetStats().m_numCandidates;
+	results.m_numSpacingViolations = placer.CountSpacingViolations();
+
+	// What GoldMap::PlaceTrees and PlaceRocks did: roll every tile, then test the tile against everything placed so far
+	CounterRNG naiveRNG = streams.GetRNG(RandomStream::BENCHMARK, 1);
+	std::vector<Placement> naivePlacements;
+	int naiveTiles = RoundDownToInt(naiveWorldSize);
+	startTime = GetCurrentTimeSeconds();
+	for (int modelIndex = 0; modelIndex < (int)models.size(); modelIndex++)
+	{
+		for (int y = 0; y < naiveTiles; y++)
+		{
+			for (int x = 0; x < naiveTiles; x++)
+			{
+				if (!naiveRNG.RollRandomChance(0.08f))
+				{
+					continue;
+				}
+
+				Vec2 tilePosition((float)x, (float)y);
+				bool isValid = true;
+				for (int placementIndex = 0; placementIndex < (int)naivePlacements.size(); placementIndex++)
+				{
+					if (IsPointInsideDisc2D(tilePosition, naivePlacements[placementIndex].m_position, models[naivePlacements[placementIndex].m_modelIndex].m_exclusionRadius))
+					{
+						isValid = false;
+						break;
+					}
+				}
+				if (isValid)
+				{
+					Placement placement;
+					placement.m_position = tilePosition;
+					placement.m_modelIndex = modelIndex;
+					naivePlacements.push_back(placement);
+				}
+			}
+		}
+	}
+	results.m_naiveSeconds = GetCurrentTimeSeconds() - startTime;
+	results.m_numNaivePlacements = (int)naivePlacements.size();
+
+	return results;
+}
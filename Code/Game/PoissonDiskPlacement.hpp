@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <vector>
+
+class CounterRNG;
+
+// One kind of thing being scattered, such as a tree or a rock
+struct PlacementModel
+{
+public:
+	// Two placements never come closer than the sum of their radii
+	float	m_exclusionRadius = 1.f;
+	// Relative chance of a new candidate being this model
+	float	m_weight = 1.f;
+};
+
+struct Placement
+{
+public:
+	Vec2	m_position = Vec2::ZERO;
+	int		m_modelIndex = 0;
+};
+
+struct PlacementStats
+{
+public:
+	int		m_numCandidates = 0;
+	int		m_numAccepted = 0;
+	int		m_numSeeds = 0;
+	int		m_numThinned = 0;
+};
+
+// Blue-noise scattering (Bridson's Poisson-disk sampling) with a separate exclusion radius per model
+// Background grid cells are small enough to hold at most one placement, so each candidate only tests a fixed neighborhood and generation is linear in the area
+// Fixed obstacles share the grid, and the density map thins the result afterwards so low densities leave clearings instead of packing points closer
+class PoissonDiskPlacer
+{
+public:
+	~PoissonDiskPlacer() = default;
+	PoissonDiskPlacer(AABB2 const& bounds, std::vector<PlacementModel> const& models);
+
+	void					AddObstacle(Vec2 const& center, float radius);
+	// Chances in [0, 1] of keeping a placement, stretched over the bounds row by row starting at the mins
+	void					SetDensityMap(std::vector<float> const& densities, IntVec2 const& dimensions);
+	void					Generate(std::vector<Placement>& out_placements, CounterRNG& rng, int candidatesPerPlacement = 30);
+
+	bool					IsLocationFree(Vec2 const& position, float radius) const;
+	float					GetDensityAt(Vec2 const& position) const;
+	// Pairs of generated placements closer than their radii allow, zero unless something is broken
+	int						CountSpacingViolations() const;
+	PlacementStats const&	GetStats() const { return m_stats; }
+
+private:
+	void					BuildObstacleCells();
+	bool					TryAddPlacement(Vec2 const& position, int modelIndex);
+	int						RollModelIndex(CounterRNG& rng) const;
+	IntVec2 const			GetCellCoordsForPosition(Vec2 const& position) const;
+
+private:
+	AABB2						m_bounds;
+	std::vector<PlacementModel>	m_models;
+	float						m_totalWeight = 0.f;
+	float						m_minRadius = 0.f;
+	float						m_maxRadius = 0.f;
+
+	float						m_cellSize = 1.f;
+	IntVec2						m_gridDimensions = IntVec2(0, 0);
+	std::vector<int>			m_cellPlacementIndexes;
+	std::vector<Placement>		m_placements;
+
+	std::vector<Vec2>			m_obstacleCenters;
+	std::vector<float>			m_obstacleRadii;
+	std::vector<int>			m_obstacleCellStartIndexes;
+	std::vector<int>			m_obstacleCellIndexes;
+
+	std::vector<float>			m_densities;
+	IntVec2						m_densityDimensions = IntVec2(0, 0);
+
+	PlacementStats				m_stats;
+};
+
+struct PlacementBenchmarkResults
+{
+public:
+	float	m_worldSize = 0.f;
+	int		m_numPlacements = 0;
+	int		m_numCandidates = 0;
+	double	m_poissonSeconds = 0.0;
+	int		m_numSpacingViolations = 0;
+	// The old per-tile roll with a linear validity test against every placed actor
+	float	m_naiveWorldSize = 0.f;
+	int		m_numNaivePlacements = 0;
+	double	m_naiveSeconds = 0.0;
+};
+
+// Scatters trees and rocks over a square world with the placer, verifies the spacing,
+// then times the per-tile roll GoldMap used to do on a smaller world for comparison
+PlacementBenchmarkResults RunPlacementBenchmark(float worldSize, float naiveWorldSize);
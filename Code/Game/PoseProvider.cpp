@@ -0,0 +1,70 @@
+#include "Game/PoseProvider.hpp"
+
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/VirtualReality/OpenXR.hpp"
+
+#include <math.h>
+
+
+bool OpenXRPoseProvider::IsActive() const
+{
+	return g_openXR && g_openXR->IsInitialized();
+}
+
+void OpenXRPoseProvider::SamplePose(PoseSample& out_sample)
+{
+	g_openXR->GetTransformForEye_iFwd_jLeft_kUp(XREye::LEFT, out_sample.m_leftEye.m_position, out_sample.m_leftEye.m_orientation);
+	g_openXR->GetTransformForEye_iFwd_jLeft_kUp(XREye::RIGHT, out_sample.m_rightEye.m_position, out_sample.m_rightEye.m_orientation);
+
+	VRController const& leftController = g_openXR->GetLeftController();
+	VRController const& rightController = g_openXR->GetRightController();
+	out_sample.m_leftController.m_position = leftController.GetPosition_iFwd_jLeft_kUp();
+	out_sample.m_leftController.m_orientation = leftController.GetOrientation_iFwd_jLeft_kUp();
+	out_sample.m_rightController.m_position = rightController.GetPosition_iFwd_jLeft_kUp();
+	out_sample.m_rightController.m_orientation = rightController.GetOrientation_iFwd_jLeft_kUp();
+
+	out_sample.m_sampleTimeSeconds = GetCurrentTimeSeconds();
+}
+
+MockPoseProvider::MockPoseProvider(float yawAmplitudeDegrees, float swayFrequency)
+	: m_yawAmplitudeDegrees(yawAmplitudeDegrees)
+	, m_swayFrequency(swayFrequency)
+{
+}
+
+void MockPoseProvider::SamplePose(PoseSample& out_sample)
+{
+	double timeSeconds = m_useManualTime ? m_manualTimeSeconds : GetCurrentTimeSeconds();
+	float headYaw = GetHeadYawAtTime(timeSeconds);
+
+	// Eyes sit 3cm either side of the head, hands ahead of it at waist height
+	EulerAngles headOrientation(headYaw, 0.f, 0.f);
+	Vec3 headLeft = headOrientation.GetAsMatrix_iFwd_jLeft_kUp().GetJBasis3D();
+	Vec3 headFwd = headOrientation.GetAsMatrix_iFwd_jLeft_kUp().GetIBasis3D();
+	out_sample.m_leftEye.m_position = headLeft * 0.03f;
+	out_sample.m_leftEye.m_orientation = headOrientation;
+	out_sample.m_rightEye.m_position = -headLeft * 0.03f;
+	out_sample.m_rightEye.m_orientation = headOrientation;
+	out_sample.m_leftController.m_position = headFwd * 0.3f + headLeft * 0.2f + Vec3::GROUNDWARD * 0.4f;
+	out_sample.m_leftController.m_orientation = headOrientation;
+	out_sample.m_rightController.m_position = headFwd * 0.3f - headLeft * 0.2f + Vec3::GROUNDWARD * 0.4f;
+	out_sample.m_rightController.m_orientation = headOrientation;
+
+	out_sample.m_sampleTimeSeconds = timeSeconds;
+}
+
+void MockPoseProvider::SetManualTime(double timeSeconds)
+{
+	m_useManualTime = true;
+	m_manualTimeSeconds = timeSeconds;
+}
+
+float MockPoseProvider::GetHeadYawAtTime(double timeSeconds) const
+{
+	// Phase is wrapped in double precision, system time is too large to multiply in float
+	double swayPhase = fmod(timeSeconds * (double)m_swayFrequency, 1.0);
+	return m_yawAmplitudeDegrees * SinDegrees(360.f * (float)swayPhase);
+}
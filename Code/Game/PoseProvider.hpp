@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+struct TrackedPose
+{
+public:
+	Vec3			m_position = Vec3::ZERO;
+	EulerAngles		m_orientation = EulerAngles::ZERO;
+};
+
+// Head and hand poses in the player's local space (iFwd, jLeft, kUp), with the time they were read
+struct PoseSample
+{
+public:
+	TrackedPose		m_leftEye;
+	TrackedPose		m_rightEye;
+	TrackedPose		m_leftController;
+	TrackedPose		m_rightController;
+	double			m_sampleTimeSeconds = 0.0;
+};
+
+struct LateLatchStats
+{
+public:
+	int				m_numLatches = 0;
+	// Age of the poses the frame would have rendered with, and of the late-latched ones, when the latch happened
+	double			m_lastUpdatePoseAgeSeconds = 0.0;
+	double			m_lastLatchedPoseAgeSeconds = 0.0;
+	float			m_lastHeadCorrectionDegrees = 0.f;
+};
+
+// Where tracked poses come from, so the game can sample them both when updating and again right before each eye renders
+class PoseProvider
+{
+public:
+	virtual ~PoseProvider() = default;
+
+	virtual bool				IsActive() const = 0;
+	virtual void				SamplePose(PoseSample& out_sample) = 0;
+};
+
+class OpenXRPoseProvider : public PoseProvider
+{
+public:
+	virtual bool				IsActive() const override;
+	virtual void				SamplePose(PoseSample& out_sample) override;
+};
+
+// Scripted head and hand motion for testing without a headset
+// The head sways in yaw and the hands follow it at a fixed offset, time is either the system time or set by hand for deterministic tests
+class MockPoseProvider : public PoseProvider
+{
+public:
+	MockPoseProvider(float yawAmplitudeDegrees, float swayFrequency);
+
+	virtual bool				IsActive() const override { return true; }
+	virtual void				SamplePose(PoseSample& out_sample) override;
+
+	void						SetManualTime(double timeSeconds);
+	float						GetHeadYawAtTime(double timeSeconds) const;
+
+private:
+	float						m_yawAmplitudeDegrees = 0.f;
+	float						m_swayFrequency = 0.f;
+	bool						m_useManualTime = false;
+	double						m_manualTimeSeconds = 0.0;
+};
@@ -0,0 +1,608 @@
+#include "Game/ProjectileSystem.hpp"
+
+#include "Game/Actor.hpp"
+#include "Game/ActorDefinition.hpp"
+#include "Game/App.hpp"
+#include "Game/Controller.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/VoiceManager.hpp"
+#include "Game/Gold/Particle.hpp"
+#include "Game/Gold/StaticActor.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <functional>
+
+
+// Projectiles this far outside the world can never hit anything again
+constexpr float PROJECTILE_WORLD_MARGIN = 100.f;
+
+
+ProjectileSystem::ProjectileSystem(Map* map)
+	: m_map(map)
+{
+}
+
+void ProjectileSystem::Spawn(std::string const& actorName, Vec3 const& position, EulerAngles const& orientation, Vec3 const& velocity, ActorUID const& ownerUID)
+{
+	int definitionIndex = GetOrAddDefinitionIndex(actorName);
+	if (definitionIndex < 0)
+	{
+		ERROR_RECOVERABLE(Stringf("Could not find projectile actor definition \"%s\"", actorName.c_str()));
+		return;
+	}
+
+	m_positions.push_back(position);
+	m_velocities.push_back(velocity);
+	m_orientations.push_back(orientation);
+	m_ownerUIDs.push_back(ownerUID);
+	m_definitionIndexes.push_back(definitionIndex);
+	m_ageSeconds.push_back(0.f);
+	m_deadSeconds.push_back(-1.f);
+	m_lastHitActorUIDs.push_back(ActorUID::INVALID);
+	m_randomSubjects.push_back(m_nextRandomSubject);
+	m_nextRandomSubject++;
+
+	m_currentStats.m_numSpawned++;
+}
+
+void ProjectileSystem::Update()
+{
+	double updateStartTime = GetCurrentTimeSeconds();
+	float deltaSeconds = m_map->m_game->m_gameClock.GetDeltaSeconds();
+	Vec2 worldMargin(PROJECTILE_WORLD_MARGIN, PROJECTILE_WORLD_MARGIN);
+	AABB2 worldBounds(-worldMargin, m_map->GetWorldDimensions().GetAsVec2() + worldMargin);
+
+	m_impacts.clear();
+	m_expiredIndexes.clear();
+
+	// Move and sweep every projectile first, impacts are only resolved once all of them have been found
+	for (int projectileIndex = 0; projectileIndex < (int)m_positions.size(); projectileIndex++)
+	{
+		ActorDefinition const& definition = *m_definitions[m_definitionIndexes[projectileIndex]].m_actorDefinition;
+		m_ageSeconds[projectileIndex] += deltaSeconds;
+
+		if (m_deadSeconds[projectileIndex] >= 0.f)
+		{
+			m_deadSeconds[projectileIndex] += deltaSeconds;
+			if (m_deadSeconds[projectileIndex] >= definition.m_corpseLifetime)
+			{
+				m_expiredIndexes.push_back(projectileIndex);
+			}
+			continue;
+		}
+
+		if (!IsPointInsideAABB2(m_positions[projectileIndex].GetXY(), worldBounds))
+		{
+			m_expiredIndexes.push_back(projectileIndex);
+			continue;
+		}
+
+		// Same integration as Actor::UpdatePhysics
+		Vec3& velocity = m_velocities[projectileIndex];
+		Vec3 acceleration = -velocity * definition.m_drag + Vec3::GROUNDWARD * GRAVITY * definition.m_gravityScale;
+		velocity += acceleration * deltaSeconds;
+
+		Vec3 startPosition = m_positions[projectileIndex];
+		Vec3 endPosition = startPosition + velocity * deltaSeconds;
+		m_positions[projectileIndex] = endPosition;
+		SweepProjectile(projectileIndex, startPosition, endPosition);
+		m_currentStats.m_numSimulated++;
+
+		if (definition.m_showVisualParticles)
+		{
+			Vec3 forward = m_orientations[projectileIndex].GetAsMatrix_iFwd_jLeft_kUp().GetIBasis3D();
+			CounterRNG particleRNG = GetProjectileRNG(projectileIndex, RandomStream::PARTICLES, 0);
+			for (int particleIndex = 0; particleIndex < definition.m_visualParticles; particleIndex++)
+			{
+				float particleSize = particleRNG.RollRandomFloatInRange(definition.m_visualParticleSize);
+				Particle* particle = m_map->SpawnParticle(m_positions[projectileIndex] - forward * definition.m_physicsRadius, particleSize, definition.m_visualParticleColor, definition.m_visualParticleLifetime);
+				Vec3 randomDirection = Vec3(particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f));
+				randomDirection = randomDirection.GetNormalized() * definition.m_visualParticleSpeed;
+				particle->AddImpulse(randomDirection);
+			}
+		}
+	}
+
+	ResolveImpacts();
+
+	// Highest index first, so swap-removal never moves a projectile that is still waiting to be removed
+	std::sort(m_expiredIndexes.begin(), m_expiredIndexes.end(), std::greater<int>());
+	for (int expiredIndex = 0; expiredIndex < (int)m_expiredIndexes.size(); expiredIndex++)
+	{
+		RemoveProjectile(m_expiredIndexes[expiredIndex]);
+	}
+
+	m_currentStats.m_updateSeconds = GetCurrentTimeSeconds() - updateStartTime;
+	m_lastUpdateStats = m_currentStats;
+	m_currentStats = ProjectileStats();
+}
+
+void ProjectileSystem::SweepProjectile(int projectileIndex, Vec3 const& startPosition, Vec3 const& endPosition)
+{
+	Vec3 displacement = endPosition - startPosition;
+	float sweepLength = displacement.GetLength();
+	if (sweepLength <= 0.f)
+	{
+		return;
+	}
+
+	ActorDefinition const& definition = *m_definitions[m_definitionIndexes[projectileIndex]].m_actorDefinition;
+	Vec3 sweepDirection = displacement.GetNormalized();
+	float radius = definition.m_physicsRadius;
+
+	ProjectileImpact impact;
+	impact.m_projectileIndex = projectileIndex;
+	float impactDistance = FLT_MAX;
+
+	// Floor and ceiling are planes, offset by the radius so the sphere's surface touches them
+	float floorHeight = radius;
+	float ceilingHeight = m_map->GetCeilingHeight() - radius;
+	if (endPosition.z < floorHeight && sweepDirection.z < 0.f)
+	{
+		impactDistance = GetClamped((floorHeight - startPosition.z) / sweepDirection.z, 0.f, sweepLength);
+		impact.m_normal = Vec3::SKYWARD;
+	}
+	else if (endPosition.z > ceilingHeight && sweepDirection.z > 0.f)
+	{
+		impactDistance = GetClamped((ceilingHeight - startPosition.z) / sweepDirection.z, 0.f, sweepLength);
+		impact.m_normal = Vec3::GROUNDWARD;
+	}
+
+	// Solid tiles are full height columns, so the sphere only has to be swept as a disc in XY
+	SweepResult tileResult = m_map->SweepDiscVsSolidTiles(startPosition.GetXY(), displacement.GetXY(), radius);
+	if (tileResult.m_didImpact && tileResult.m_timeOfImpact * sweepLength < impactDistance)
+	{
+		impactDistance = tileResult.m_timeOfImpact * sweepLength;
+		impact.m_normal = tileResult.m_impactNormal;
+	}
+
+	// Static actors and actor cylinders are inflated by the radius, which turns the sphere sweep into a ray cast
+	GetStaticActorIndexesNearSegment(startPosition, endPosition, radius);
+	for (int resultIndex = 0; resultIndex < (int)m_staticActorQueryResults.size(); resultIndex++)
+	{
+		StaticActor const* staticActor = m_staticActors[m_staticActorQueryResults[resultIndex]];
+		Vec3 cylinderBottom = staticActor->m_position + Vec3::GROUNDWARD * radius;
+		Vec3 cylinderTop = staticActor->m_position + Vec3::SKYWARD * (staticActor->m_physicsHeight + radius);
+		RaycastResult3D staticActorResult = RaycastVsCylinder3D(startPosition, sweepDirection, sweepLength, cylinderBottom, cylinderTop, staticActor->m_physicsRadius + radius);
+		m_currentStats.m_numStaticActorTests++;
+		if (staticActorResult.m_didImpact && staticActorResult.m_impactDistance < impactDistance)
+		{
+			impactDistance = staticActorResult.m_impactDistance;
+			impact.m_normal = staticActorResult.m_impactNormal;
+		}
+	}
+
+	// No actor is wider than a grid cell, so padding the query by one cell finds every cylinder the sweep can touch
+	ActorUID const& ownerUID = m_ownerUIDs[projectileIndex];
+	m_nearbyActors.clear();
+	m_map->GetActorsInRadius((startPosition + endPosition) * 0.5f, sweepLength * 0.5f + radius + ACTOR_GRID_CELL_SIZE, m_nearbyActors);
+	for (int actorIndex = 0; actorIndex < (int)m_nearbyActors.size(); actorIndex++)
+	{
+		Actor* actor = m_nearbyActors[actorIndex];
+		if (!m_map->IsActorAlive(actor) || actor->m_UID == ownerUID || actor->m_UID == m_lastHitActorUIDs[projectileIndex])
+		{
+			continue;
+		}
+		// Matches Map::CollideActors, where two owned actors never collide
+		if (ownerUID != ActorUID::INVALID && actor->m_ownerUID != ActorUID::INVALID)
+		{
+			continue;
+		}
+
+		Vec3 cylinderBottom = actor->m_position + Vec3::GROUNDWARD * radius;
+		Vec3 cylinderTop = actor->m_position + Vec3::SKYWARD * (actor->m_physicsHeight + radius);
+		RaycastResult3D actorResult = RaycastVsCylinder3D(startPosition, sweepDirection, sweepLength, cylinderBottom, cylinderTop, actor->m_physicsRadius + radius);
+		m_currentStats.m_numActorTests++;
+		if (actorResult.m_didImpact && actorResult.m_impactDistance <= impactDistance)
+		{
+			impactDistance = actorResult.m_impactDistance;
+			impact.m_normal = actorResult.m_impactNormal;
+			impact.m_actorUID = actor->m_UID;
+		}
+	}
+
+	if (impactDistance > sweepLength)
+	{
+		return;
+	}
+
+	impact.m_position = startPosition + sweepDirection * impactDistance;
+	m_positions[projectileIndex] = impact.m_position;
+	m_impacts.push_back(impact);
+}
+
+void ProjectileSystem::ResolveImpacts()
+{
+	for (int impactIndex = 0; impactIndex < (int)m_impacts.size(); impactIndex++)
+	{
+		ProjectileImpact const& impact = m_impacts[impactIndex];
+		int projectileIndex = impact.m_projectileIndex;
+		ActorDefinition const& definition = *m_definitions[m_definitionIndexes[projectileIndex]].m_actorDefinition;
+		m_currentStats.m_numImpacts++;
+
+		if (impact.m_actorUID != ActorUID::INVALID)
+		{
+			// An earlier impact or explosion in this batch may already have killed the actor
+			Actor* actor = m_map->GetActorByUID(impact.m_actorUID);
+			if (m_map->IsActorAlive(actor))
+			{
+				if (definition.m_damageOnCollide != FloatRange::ZERO)
+				{
+					CounterRNG combatRNG = GetProjectileRNG(projectileIndex, RandomStream::COMBAT, 0);
+					actor->TakeDamage(combatRNG.RollRandomFloatInRange(definition.m_damageOnCollide));
+					Actor* owner = m_map->GetActorByUID(m_ownerUIDs[projectileIndex]);
+					if (owner && actor->m_controller)
+					{
+						actor->m_controller->DamagedBy(owner);
+					}
+				}
+				Vec3 forward = m_orientations[projectileIndex].GetAsMatrix_iFwd_jLeft_kUp().GetIBasis3D();
+				actor->AddImpulse(forward.GetXY().ToVec3() * definition.m_impulseOnCollide);
+			}
+			m_lastHitActorUIDs[projectileIndex] = impact.m_actorUID;
+		}
+		else
+		{
+			// Projectiles that survive hitting a surface slide along it
+			Vec3& velocity = m_velocities[projectileIndex];
+			float speedIntoSurface = DotProduct3D(velocity, impact.m_normal);
+			if (speedIntoSurface < 0.f)
+			{
+				velocity -= impact.m_normal * speedIntoSurface;
+			}
+			m_lastHitActorUIDs[projectileIndex] = ActorUID::INVALID;
+		}
+
+		if (definition.m_dieOnCollide)
+		{
+			Detonate(projectileIndex, impact.m_position);
+		}
+	}
+}
+
+void ProjectileSystem::Detonate(int projectileIndex, Vec3 const& position)
+{
+	if (m_deadSeconds[projectileIndex] >= 0.f)
+	{
+		return;
+	}
+
+	ActorDefinition const& definition = *m_definitions[m_definitionIndexes[projectileIndex]].m_actorDefinition;
+	ActorUID const& ownerUID = m_ownerUIDs[projectileIndex];
+	m_deadSeconds[projectileIndex] = 0.f;
+	m_velocities[projectileIndex] = Vec3::ZERO;
+
+	if (definition.m_deathSound != MISSING_SOUND_ID)
+	{
+		g_voiceManager->PlaySoundAt(definition.m_deathSound, position, VoicePriority::HIGH);
+	}
+
+	// Same explosion as Actor::Die
+	if (definition.m_explodeOnDie)
+	{
+		m_currentStats.m_numExplosions++;
+
+		CounterRNG particleRNG = GetProjectileRNG(projectileIndex, RandomStream::PARTICLES, 1);
+		for (int particleIndex = 0; particleIndex < definition.m_explosionParticles; particleIndex++)
+		{
+			float particleSize = particleRNG.RollRandomFloatInRange(definition.m_explosionParticleSize);
+			Particle* particle = m_map->SpawnParticle(position, particleSize, definition.m_explosionParticleColor, definition.m_explosionParticleLifetime);
+			Vec3 randomDirection = Vec3(particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f));
+			randomDirection = randomDirection.GetNormalized() * definition.m_explosionParticleSpeed;
+			particle->AddImpulse(randomDirection);
+		}
+
+		m_nearbyActors.clear();
+		m_map->GetActorsInRadius(position, definition.m_explosionRadius, m_nearbyActors);
+		Actor* owner = m_map->GetActorByUID(ownerUID);
+		CounterRNG combatRNG = GetProjectileRNG(projectileIndex, RandomStream::COMBAT, 1);
+		for (int actorIndex = 0; actorIndex < (int)m_nearbyActors.size(); actorIndex++)
+		{
+			Actor* actor = m_nearbyActors[actorIndex];
+
+			if (actor->m_UID != ownerUID || actor->m_definition.m_faction == Faction::MARINE)
+			{
+				Vec3 directionToActor = (actor->m_position - position).GetNormalized();
+				actor->AddImpulse(definition.m_impulseOnExplode * directionToActor);
+			}
+
+			if (actor->m_UID != ownerUID)
+			{
+				float damage = combatRNG.RollRandomFloatInRange(definition.m_explosionDamage);
+				actor->TakeDamage(damage);
+				if (actor->m_controller)
+				{
+					actor->m_controller->DamagedBy(owner);
+				}
+			}
+		}
+	}
+
+	if (definition.m_corpseLifetime <= 0.f)
+	{
+		m_expiredIndexes.push_back(projectileIndex);
+	}
+}
+
+CounterRNG ProjectileSystem::GetProjectileRNG(int projectileIndex, RandomStream stream, unsigned int channel) const
+{
+	return g_randomStreams->GetRNG(stream, m_randomSubjects[projectileIndex], m_map->m_frameIndex, RANDOM_CHANNEL_PROJECTILE + channel);
+}
+
+void ProjectileSystem::RemoveProjectile(int projectileIndex)
+{
+	int lastIndex = (int)m_positions.size() - 1;
+	m_positions[projectileIndex] = m_positions[lastIndex];
+	m_velocities[projectileIndex] = m_velocities[lastIndex];
+	m_orientations[projectileIndex] = m_orientations[lastIndex];
+	m_ownerUIDs[projectileIndex] = m_ownerUIDs[lastIndex];
+	m_definitionIndexes[projectileIndex] = m_definitionIndexes[lastIndex];
+	m_ageSeconds[projectileIndex] = m_ageSeconds[lastIndex];
+	m_deadSeconds[projectileIndex] = m_deadSeconds[lastIndex];
+	m_lastHitActorUIDs[projectileIndex] = m_lastHitActorUIDs[lastIndex];
+	m_randomSubjects[projectileIndex] = m_randomSubjects[lastIndex];
+
+	m_positions.pop_back();
+	m_velocities.pop_back();
+	m_orientations.pop_back();
+	m_ownerUIDs.pop_back();
+	m_definitionIndexes.pop_back();
+	m_ageSeconds.pop_back();
+	m_deadSeconds.pop_back();
+	m_lastHitActorUIDs.pop_back();
+	m_randomSubjects.pop_back();
+}
+
+void ProjectileSystem::Clear()
+{
+	m_positions.clear();
+	m_velocities.clear();
+	m_orientations.clear();
+	m_ownerUIDs.clear();
+	m_definitionIndexes.clear();
+	m_ageSeconds.clear();
+	m_deadSeconds.clear();
+	m_lastHitActorUIDs.clear();
+	m_randomSubjects.clear();
+	m_impacts.clear();
+	m_expiredIndexes.clear();
+}
+
+void ProjectileSystem::AddDrawItems(RenderList& renderList) const
+{
+	if (m_positions.empty())
+	{
+		return;
+	}
+
+	Mat44 cameraModelMatrix = g_app->m_worldCamera.GetModelMatrix();
+	Vec3 cameraPosition = g_app->m_worldCamera.GetPosition();
+	m_modelInstances.resize(m_definitions.size());
+
+	// One draw per definition: models are instanced, billboards are expanded into a single world space vertex array
+	for (int definitionIndex = 0; definitionIndex < (int)m_definitions.size(); definitionIndex++)
+	{
+		ProjectileDefinition const& projectileDefinition = m_definitions[definitionIndex];
+		ActorDefinition const& definition = *projectileDefinition.m_actorDefinition;
+
+		if (definition.m_is3DActor)
+		{
+			std::vector<DrawInstance>& instances = m_modelInstances[definitionIndex];
+			instances.clear();
+			for (int projectileIndex = 0; projectileIndex < (int)m_positions.size(); projectileIndex++)
+			{
+				if (m_definitionIndexes[projectileIndex] != definitionIndex)
+				{
+					continue;
+				}
+
+				DrawInstance instance;
+				instance.m_modelMatrix = Mat44::CreateTranslation3D(m_positions[projectileIndex]);
+				instance.m_modelMatrix.Append(m_orientations[projectileIndex].GetAsMatrix_iFwd_jLeft_kUp());
+				instances.push_back(instance);
+			}
+
+			if (definition.m_blendMode == BlendMode::OPAQUE)
+			{
+				renderList.AddInstancedDraw(definition.m_model->GetVertexBuffer(), definition.m_model->GetIndexBuffer(), definition.m_model->GetIndexCount(), instances, definition.m_texture);
+				continue;
+			}
+			for (int instanceIndex = 0; instanceIndex < (int)instances.size(); instanceIndex++)
+			{
+				renderList.AddIndexedDraw(definition.m_model->GetVertexBuffer(), definition.m_model->GetIndexBuffer(), definition.m_model->GetIndexCount(), instances[instanceIndex].m_modelMatrix, Rgba8::WHITE, definition.m_texture, definition.m_blendMode, RenderList::GetLayerForBlendMode(definition.m_blendMode));
+			}
+			continue;
+		}
+
+		// The render list copies the vertexes, so frame scratch arrays are enough
+		std::vector<Vertex_PCU>& unlitVertexes = g_frameArena->AcquireScratchVertexesPCU();
+		std::vector<Vertex_PCUTBN>& litVertexes = g_frameArena->AcquireScratchVertexesPCUTBN();
+		std::vector<Vertex_PCU>& unlitQuadVertexes = g_frameArena->AcquireScratchVertexesPCU();
+		std::vector<Vertex_PCUTBN>& litQuadVertexes = g_frameArena->AcquireScratchVertexesPCUTBN();
+		Mat44 pivotTransform = Mat44::CreateTranslation3D(-Vec3(0.f, definition.m_size.x, definition.m_size.y) * Vec3(0.f, definition.m_pivot.x, definition.m_pivot.y));
+
+		for (int projectileIndex = 0; projectileIndex < (int)m_positions.size(); projectileIndex++)
+		{
+			if (m_definitionIndexes[projectileIndex] != definitionIndex)
+			{
+				continue;
+			}
+
+			bool isDead = m_deadSeconds[projectileIndex] >= 0.f;
+			DirectionalSpriteTable const* spriteTable = (isDead && projectileDefinition.m_deathSpriteTable) ? projectileDefinition.m_deathSpriteTable : projectileDefinition.m_flySpriteTable;
+			if (!spriteTable || spriteTable->IsEmpty())
+			{
+				continue;
+			}
+
+			Vec3 const& position = m_positions[projectileIndex];
+			float localViewingDegrees = (position - cameraPosition).GetXY().GetOrientationDegrees() - m_orientations[projectileIndex].m_yawDegrees;
+			AABB2 const& spriteUVs = spriteTable->GetUVs(localViewingDegrees, isDead ? m_deadSeconds[projectileIndex] : m_ageSeconds[projectileIndex]);
+
+			Mat44 quadTransform = GetBillboardMatrix(definition.m_billboardType, cameraModelMatrix, position);
+			quadTransform.Append(pivotTransform);
+
+			if (definition.m_isLit)
+			{
+				litQuadVertexes.clear();
+				AddVertsForRoundedQuad3D(litQuadVertexes, Vec3::ZERO, Vec3::NORTH * definition.m_size.x, Vec3::NORTH * definition.m_size.x + Vec3::SKYWARD * definition.m_size.y, Vec3::SKYWARD * definition.m_size.y, Rgba8::WHITE, spriteUVs);
+				TransformVertexArray3D(litQuadVertexes, quadTransform);
+				litVertexes.insert(litVertexes.end(), litQuadVertexes.begin(), litQuadVertexes.end());
+			}
+			else
+			{
+				unlitQuadVertexes.clear();
+				AddVertsForQuad3D(unlitQuadVertexes, Vec3::ZERO, Vec3::NORTH * definition.m_size.x, Vec3::NORTH * definition.m_size.x + Vec3::SKYWARD * definition.m_size.y, Vec3::SKYWARD * definition.m_size.y, Rgba8::WHITE, spriteUVs);
+				TransformVertexArray3D(unlitQuadVertexes, quadTransform);
+				unlitVertexes.insert(unlitVertexes.end(), unlitQuadVertexes.begin(), unlitQuadVertexes.end());
+			}
+		}
+
+		DrawItem billboardItem;
+		billboardItem.m_tint = definition.m_texture ? Rgba8::WHITE : Rgba8::MAGENTA;
+		billboardItem.m_texture = definition.m_texture;
+		billboardItem.m_shader = definition.m_shader;
+		if (!litVertexes.empty())
+		{
+			renderList.AddVertexArray(litVertexes, billboardItem);
+		}
+		if (!unlitVertexes.empty())
+		{
+			renderList.AddVertexArray(unlitVertexes, billboardItem);
+		}
+	}
+}
+
+void ProjectileSystem::SetStaticActors(std::vector<StaticActor*> const& staticActors)
+{
+	m_staticActors = staticActors;
+	IntVec2 worldDimensions = m_map->GetWorldDimensions();
+	m_staticActorGridDimensions = IntVec2(std::max(1, worldDimensions.x), std::max(1, worldDimensions.y));
+
+	int numCells = m_staticActorGridDimensions.x * m_staticActorGridDimensions.y;
+	m_staticActorCellStartIndexes.assign(numCells + 1, 0);
+	m_staticActorQueryStamps.assign(m_staticActors.size(), 0);
+	m_staticActorQueryStamp = 0;
+
+	// Static actors are added to every tile cell their footprint overlaps, counted first and then written
+	for (int pass = 0; pass < 2; pass++)
+	{
+		std::vector<int> cellWriteIndexes(m_staticActorCellStartIndexes.begin(), m_staticActorCellStartIndexes.end() - 1);
+		for (int staticActorIndex = 0; staticActorIndex < (int)m_staticActors.size(); staticActorIndex++)
+		{
+			StaticActor const* staticActor = m_staticActors[staticActorIndex];
+			if (!staticActor)
+			{
+				continue;
+			}
+
+			Vec2 center = staticActor->m_position.GetXY();
+			float radius = staticActor->m_physicsRadius;
+			int minCellX = std::min(std::max(RoundDownToInt(center.x - radius), 0), m_staticActorGridDimensions.x - 1);
+			int minCellY = std::min(std::max(RoundDownToInt(center.y - radius), 0), m_staticActorGridDimensions.y - 1);
+			int maxCellX = std::min(std::max(RoundDownToInt(center.x + radius), 0), m_staticActorGridDimensions.x - 1);
+			int maxCellY = std::min(std::max(RoundDownToInt(center.y + radius), 0), m_staticActorGridDimensions.y - 1);
+			for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+			{
+				for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+				{
+					int cellIndex = cellX + cellY * m_staticActorGridDimensions.x;
+					if (pass == 0)
+					{
+						m_staticActorCellStartIndexes[cellIndex + 1]++;
+					}
+					else
+					{
+						m_staticActorCellIndexes[cellWriteIndexes[cellIndex]] = staticActorIndex;
+						cellWriteIndexes[cellIndex]++;
+					}
+				}
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (int cellIndex = 0; cellIndex < numCells; cellIndex++)
+			{
+				m_staticActorCellStartIndexes[cellIndex + 1] += m_staticActorCellStartIndexes[cellIndex];
+			}
+			m_staticActorCellIndexes.resize(m_staticActorCellStartIndexes[numCells]);
+		}
+	}
+}
+
+void ProjectileSystem::GetStaticActorIndexesNearSegment(Vec3 const& startPosition, Vec3 const& endPosition, float radius)
+{
+	m_staticActorQueryResults.clear();
+	if (m_staticActors.empty())
+	{
+		return;
+	}
+
+	// Stamps keep actors that span several cells from being tested more than once
+	m_staticActorQueryStamp++;
+
+	int minCellX = std::min(std::max(RoundDownToInt(std::min(startPosition.x, endPosition.x) - radius), 0), m_staticActorGridDimensions.x - 1);
+	int minCellY = std::min(std::max(RoundDownToInt(std::min(startPosition.y, endPosition.y) - radius), 0), m_staticActorGridDimensions.y - 1);
+	int maxCellX = std::min(std::max(RoundDownToInt(std::max(startPosition.x, endPosition.x) + radius), 0), m_staticActorGridDimensions.x - 1);
+	int maxCellY = std::min(std::max(RoundDownToInt(std::max(startPosition.y, endPosition.y) + radius), 0), m_staticActorGridDimensions.y - 1);
+	for (int cellY = minCellY; cellY <= maxCellY; cellY++)
+	{
+		for (int cellX = minCellX; cellX <= maxCellX; cellX++)
+		{
+			int cellIndex = cellX + cellY * m_staticActorGridDimensions.x;
+			for (int cellActorIndex = m_staticActorCellStartIndexes[cellIndex]; cellActorIndex < m_staticActorCellStartIndexes[cellIndex + 1]; cellActorIndex++)
+			{
+				int staticActorIndex = m_staticActorCellIndexes[cellActorIndex];
+				if (m_staticActorQueryStamps[staticActorIndex] != m_staticActorQueryStamp)
+				{
+					m_staticActorQueryStamps[staticActorIndex] = m_staticActorQueryStamp;
+					m_staticActorQueryResults.push_back(staticActorIndex);
+				}
+			}
+		}
+	}
+}
+
+int ProjectileSystem::GetOrAddDefinitionIndex(std::string const& actorName)
+{
+	for (int definitionIndex = 0; definitionIndex < (int)m_definitions.size(); definitionIndex++)
+	{
+		if (m_definitions[definitionIndex].m_actorDefinition->m_name == actorName)
+		{
+			return definitionIndex;
+		}
+	}
+
+	auto actorDefIter = ActorDefinition::s_actorDefs.find(actorName);
+	if (actorDefIter == ActorDefinition::s_actorDefs.end())
+	{
+		return -1;
+	}
+
+	ProjectileDefinition projectileDefinition;
+	projectileDefinition.m_actorDefinition = &actorDefIter->second;
+	std::vector<DirectionalSpriteTable*> const& spriteTables = actorDefIter->second.m_spriteTables;
+	for (int tableIndex = 0; tableIndex < (int)spriteTables.size(); tableIndex++)
+	{
+		if (tableIndex == 0)
+		{
+			projectileDefinition.m_flySpriteTable = spriteTables[tableIndex];
+		}
+		if (spriteTables[tableIndex]->m_name == "Death")
+		{
+			projectileDefinition.m_deathSpriteTable = spriteTables[tableIndex];
+		}
+	}
+
+	m_definitions.push_back(projectileDefinition);
+	return (int)m_definitions.size() - 1;
+}
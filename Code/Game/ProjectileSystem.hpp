@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Game/ActorUID.hpp"
+#include "Game/CounterRNG.hpp"
+#include "Game/RenderList.hpp"
+
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <string>
+#include <vector>
+
+class Actor;
+class DirectionalSpriteTable;
+class Map;
+class StaticActor;
+struct ActorDefinition;
+
+struct ProjectileStats
+{
+	int m_numSpawned = 0;
+	int m_numSimulated = 0;
+	int m_numActorTests = 0;
+	int m_numStaticActorTests = 0;
+	int m_numImpacts = 0;
+	int m_numExplosions = 0;
+	double m_updateSeconds = 0.0;
+};
+
+// Everything a projectile hit during the sweep phase, resolved together once every projectile has moved
+struct ProjectileImpact
+{
+	int m_projectileIndex = -1;
+	Vec3 m_position = Vec3::ZERO;
+	Vec3 m_normal = Vec3::ZERO;
+	ActorUID m_actorUID = ActorUID::INVALID;
+};
+
+// Per-definition data looked up once instead of per projectile
+struct ProjectileDefinition
+{
+	ActorDefinition const* m_actorDefinition = nullptr;
+	DirectionalSpriteTable const* m_flySpriteTable = nullptr;
+	DirectionalSpriteTable const* m_deathSpriteTable = nullptr;
+};
+
+// Projectile actors (plasma, grenades, rockets) stored as parallel arrays instead of full Actors
+// Each frame every projectile sweeps its sphere along its motion against the tiles, static actors and actor cylinders,
+// then all impacts and explosions are resolved in one batch and dead projectiles are swap-removed
+class ProjectileSystem
+{
+public:
+	~ProjectileSystem() = default;
+	explicit ProjectileSystem(Map* map);
+
+	void						Spawn(std::string const& actorName, Vec3 const& position, EulerAngles const& orientation, Vec3 const& velocity, ActorUID const& ownerUID);
+	void						Update();
+	void						AddDrawItems(RenderList& renderList) const;
+	void						Clear();
+
+	// Static actors never move, so they are bucketed by tile once when the map is built
+	void						SetStaticActors(std::vector<StaticActor*> const& staticActors);
+
+	int							GetNumProjectiles() const { return (int)m_positions.size(); }
+	ProjectileStats const&		GetLastUpdateStats() const { return m_lastUpdateStats; }
+
+private:
+	int							GetOrAddDefinitionIndex(std::string const& actorName);
+	void						SweepProjectile(int projectileIndex, Vec3 const& startPosition, Vec3 const& endPosition);
+	void						ResolveImpacts();
+	void						Detonate(int projectileIndex, Vec3 const& position);
+	void						RemoveProjectile(int projectileIndex);
+	// Flight rolls use channel 0 and detonation rolls channel 1, a projectile can do both in one frame
+	CounterRNG					GetProjectileRNG(int projectileIndex, RandomStream stream, unsigned int channel) const;
+	void						GetStaticActorIndexesNearSegment(Vec3 const& startPosition, Vec3 const& endPosition, float radius);
+
+private:
+	Map*						m_map = nullptr;
+	std::vector<ProjectileDefinition> m_definitions;
+
+	std::vector<Vec3>			m_positions;
+	std::vector<Vec3>			m_velocities;
+	std::vector<EulerAngles>	m_orientations;
+	std::vector<ActorUID>		m_ownerUIDs;
+	std::vector<int>			m_definitionIndexes;
+	std::vector<float>			m_ageSeconds;
+	// Negative while flying, afterwards the time spent playing the death animation
+	std::vector<float>			m_deadSeconds;
+	// Projectiles that survive a hit skip the same actor until they hit something else
+	std::vector<ActorUID>		m_lastHitActorUIDs;
+	// Spawn order keys each projectile's random rolls, so they do not depend on where swap-removal moved it
+	std::vector<unsigned int>	m_randomSubjects;
+	unsigned int				m_nextRandomSubject = 0;
+
+	// Model instances are rebuilt every frame, kept here so their capacity is reused
+	mutable std::vector<std::vector<DrawInstance>> m_modelInstances;
+
+	std::vector<ProjectileImpact> m_impacts;
+	std::vector<int>			m_expiredIndexes;
+	std::vector<Actor*>			m_nearbyActors;
+
+	std::vector<StaticActor*>	m_staticActors;
+	IntVec2						m_staticActorGridDimensions = IntVec2(0, 0);
+	std::vector<int>			m_staticActorCellStartIndexes;
+	std::vector<int>			m_staticActorCellIndexes;
+	std::vector<int>			m_staticActorQueryResults;
+	std::vector<int>			m_staticActorQueryStamps;
+	int							m_staticActorQueryStamp = 0;
+
+	ProjectileStats				m_currentStats;
+	ProjectileStats				m_lastUpdateStats;
+};
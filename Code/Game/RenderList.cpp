@@ -0,0 +1,310 @@
+#include "Game/RenderList.hpp"
+
+#include "Game/DrawBackend.hpp"
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Core/Time.hpp"
+
+#include <algorithm>
+
+
+void RenderList::BeginBuild()
+{
+	Clear();
+	m_buildStartTime = GetCurrentTimeSeconds();
+}
+
+void RenderList::EndBuild()
+{
+	m_stats.m_buildSeconds = GetCurrentTimeSeconds() - m_buildStartTime;
+
+	double sortStartTime = GetCurrentTimeSeconds();
+	Sort();
+	m_stats.m_sortSeconds = GetCurrentTimeSeconds() - sortStartTime;
+
+	m_stats.m_numDrawItems = (int)m_drawItems.size();
+	m_stats.m_numVertexArrays = m_numVertexArraysPCU + m_numVertexArraysPCUTBN;
+}
+
+void RenderList::Clear()
+{
+	m_drawItems.clear();
+	for (int vertexArrayIndex = 0; vertexArrayIndex < m_numVertexArraysPCU; vertexArrayIndex++)
+	{
+		m_vertexArraysPCU[vertexArrayIndex].clear();
+	}
+	for (int vertexArrayIndex = 0; vertexArrayIndex < m_numVertexArraysPCUTBN; vertexArrayIndex++)
+	{
+		m_vertexArraysPCUTBN[vertexArrayIndex].clear();
+	}
+	m_numVertexArraysPCU = 0;
+	m_numVertexArraysPCUTBN = 0;
+	m_instances.clear();
+	m_defaultShader = nullptr;
+	m_stats = RenderListStats();
+	for (int slotIndex = 0; slotIndex < (int)LateLatchSlot::COUNT; slotIndex++)
+	{
+		m_lateLatchCorrections[slotIndex] = Mat44::IDENTITY;
+	}
+}
+
+void RenderList::SetDefaultShader(Shader* shader)
+{
+	m_defaultShader = shader;
+}
+
+void RenderList::AddDrawItem(DrawItem const& drawItem)
+{
+	m_drawItems.push_back(drawItem);
+	DrawItem& addedItem = m_drawItems.back();
+	if (!addedItem.m_shader)
+	{
+		addedItem.m_shader = m_defaultShader;
+	}
+	addedItem.m_submissionIndex = (int)m_drawItems.size() - 1;
+}
+
+void RenderList::AddIndexedDraw(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount, Mat44 const& modelMatrix, Rgba8 const& tint, Texture* texture, BlendMode blendMode, RenderLayer layer)
+{
+	DrawItem drawItem;
+	drawItem.m_geometryType = DrawGeometryType::INDEXED;
+	drawItem.m_vertexBuffer = vertexBuffer;
+	drawItem.m_indexBuffer = indexBuffer;
+	drawItem.m_indexCount = indexCount;
+	drawItem.m_modelMatrix = modelMatrix;
+	drawItem.m_tint = tint;
+	drawItem.m_texture = texture;
+	drawItem.m_blendMode = blendMode;
+	drawItem.m_layer = layer;
+	AddDrawItem(drawItem);
+}
+
+void RenderList::AddInstancedDraw(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount, std::vector<DrawInstance> const& instances, Texture* texture)
+{
+	if (instances.empty())
+	{
+		return;
+	}
+
+	DrawItem drawItem;
+	drawItem.m_geometryType = DrawGeometryType::INDEXED_INSTANCES;
+	drawItem.m_vertexBuffer = vertexBuffer;
+	drawItem.m_indexBuffer = indexBuffer;
+	drawItem.m_indexCount = indexCount;
+	drawItem.m_firstInstanceIndex = (int)m_instances.size();
+	m_instances.insert(m_instances.end(), instances.begin(), instances.end());
+	drawItem.m_numInstances = (int)instances.size();
+	drawItem.m_texture = texture;
+	AddDrawItem(drawItem);
+}
+
+void RenderList::AddVertexArray(std::vector<Vertex_PCU> const& vertexes, DrawItem const& drawItem)
+{
+	if (m_numVertexArraysPCU == (int)m_vertexArraysPCU.size())
+	{
+		m_vertexArraysPCU.emplace_back();
+	}
+	std::vector<Vertex_PCU>& pooledVertexes = m_vertexArraysPCU[m_numVertexArraysPCU];
+	pooledVertexes.assign(vertexes.begin(), vertexes.end());
+
+	DrawItem vertexArrayItem = drawItem;
+	vertexArrayItem.m_geometryType = DrawGeometryType::VERTEX_ARRAY_PCU;
+	vertexArrayItem.m_vertexArrayIndex = m_numVertexArraysPCU;
+	m_numVertexArraysPCU++;
+	AddDrawItem(vertexArrayItem);
+}
+
+void RenderList::AddVertexArray(std::vector<Vertex_PCUTBN> const& vertexes, DrawItem const& drawItem)
+{
+	if (m_numVertexArraysPCUTBN == (int)m_vertexArraysPCUTBN.size())
+	{
+		m_vertexArraysPCUTBN.emplace_back();
+	}
+	std::vector<Vertex_PCUTBN>& pooledVertexes = m_vertexArraysPCUTBN[m_numVertexArraysPCUTBN];
+	pooledVertexes.assign(vertexes.begin(), vertexes.end());
+
+	DrawItem vertexArrayItem = drawItem;
+	vertexArrayItem.m_geometryType = DrawGeometryType::VERTEX_ARRAY_PCUTBN;
+	vertexArrayItem.m_vertexArrayIndex = m_numVertexArraysPCUTBN;
+	m_numVertexArraysPCUTBN++;
+	AddDrawItem(vertexArrayItem);
+}
+
+void RenderList::Sort()
+{
+	// Opaque items are grouped by state, blended layers keep their submission order within the layer
+	std::stable_sort(m_drawItems.begin(), m_drawItems.end(), [](DrawItem const& a, DrawItem const& b)
+	{
+		if (a.m_layer != b.m_layer)
+		{
+			return a.m_layer < b.m_layer;
+		}
+		if (a.m_layer != RenderLayer::OPAQUE)
+		{
+			return a.m_submissionIndex < b.m_submissionIndex;
+		}
+		if (a.m_shader != b.m_shader)
+		{
+			return a.m_shader < b.m_shader;
+		}
+		if (a.m_texture != b.m_texture)
+		{
+			return a.m_texture < b.m_texture;
+		}
+		if (a.m_blendMode != b.m_blendMode)
+		{
+			return a.m_blendMode < b.m_blendMode;
+		}
+		if (a.m_cullMode != b.m_cullMode)
+		{
+			return a.m_cullMode < b.m_cullMode;
+		}
+		if (a.m_depthMode != b.m_depthMode)
+		{
+			return a.m_depthMode < b.m_depthMode;
+		}
+		if (a.m_samplerMode != b.m_samplerMode)
+		{
+			return a.m_samplerMode < b.m_samplerMode;
+		}
+		return a.m_vertexBuffer < b.m_vertexBuffer;
+	});
+}
+
+void RenderList::SetLateLatchCorrection(LateLatchSlot slot, Mat44 const& correction) const
+{
+	m_lateLatchCorrections[(int)slot] = correction;
+}
+
+void RenderList::Submit() const
+{
+	Submit(RendererDrawBackend::s_instance);
+}
+
+void RenderList::Submit(DrawBackend& backend) const
+{
+	SubmitToBackend(backend, m_stats, true);
+}
+
+void RenderList::Replay(DrawBackend& backend, RenderListStats& out_replayStats, bool filterRedundantState) const
+{
+	SubmitToBackend(backend, out_replayStats, filterRedundantState);
+}
+
+void RenderList::SubmitToBackend(DrawBackend& backend, RenderListStats& stats, bool filterRedundantState) const
+{
+	if (m_drawItems.empty())
+	{
+		return;
+	}
+
+	// Render state left behind by whatever drew before this list is unknown, so the first item sets everything
+	backend.SetRasterizerFillMode(RasterizerFillMode::SOLID);
+	stats.m_numStateChanges++;
+
+	DrawItem const* previousItem = nullptr;
+	for (int drawItemIndex = 0; drawItemIndex < (int)m_drawItems.size(); drawItemIndex++)
+	{
+		DrawItem const& drawItem = m_drawItems[drawItemIndex];
+		SubmitDrawItem(backend, drawItem, previousItem, stats);
+		if (filterRedundantState)
+		{
+			previousItem = &drawItem;
+		}
+	}
+
+	stats.m_numSubmits++;
+}
+
+void RenderList::SubmitDrawItem(DrawBackend& backend, DrawItem const& drawItem, DrawItem const* previousItem, RenderListStats& stats) const
+{
+	if (!previousItem || previousItem->m_blendMode != drawItem.m_blendMode)
+	{
+		backend.SetBlendMode(drawItem.m_blendMode);
+		stats.m_numStateChanges++;
+	}
+	if (!previousItem || previousItem->m_depthMode != drawItem.m_depthMode)
+	{
+		backend.SetDepthMode(drawItem.m_depthMode);
+		stats.m_numStateChanges++;
+	}
+	if (!previousItem || previousItem->m_cullMode != drawItem.m_cullMode)
+	{
+		backend.SetRasterizerCullMode(drawItem.m_cullMode);
+		stats.m_numStateChanges++;
+	}
+	if (!previousItem || previousItem->m_samplerMode != drawItem.m_samplerMode)
+	{
+		backend.SetSamplerMode(drawItem.m_samplerMode);
+		stats.m_numStateChanges++;
+	}
+	if (!previousItem || previousItem->m_shader != drawItem.m_shader)
+	{
+		backend.BindShader(drawItem.m_shader);
+		stats.m_numStateChanges++;
+	}
+	if (!previousItem || previousItem->m_texture != drawItem.m_texture)
+	{
+		backend.BindTexture(drawItem.m_texture);
+		stats.m_numStateChanges++;
+	}
+
+	if (drawItem.m_geometryType == DrawGeometryType::INDEXED_INSTANCES)
+	{
+		// The renderer has no instanced draw, so the batch is replayed with only the model constants changing between draws
+		// Only moving geometry (projectiles) goes through here, static geometry is merged into one buffer by StaticBatchBuilder instead
+		for (int instanceIndex = 0; instanceIndex < drawItem.m_numInstances; instanceIndex++)
+		{
+			DrawInstance const& instance = m_instances[drawItem.m_firstInstanceIndex + instanceIndex];
+			backend.SetModelConstants(instance.m_modelMatrix, instance.m_tint);
+			backend.DrawIndexBuffer(drawItem.m_vertexBuffer, drawItem.m_indexBuffer, drawItem.m_indexCount);
+		}
+		stats.m_numDrawCalls += drawItem.m_numInstances;
+		return;
+	}
+
+	if (drawItem.m_lateLatchSlot != LateLatchSlot::NONE)
+	{
+		Mat44 latchedModelMatrix = m_lateLatchCorrections[(int)drawItem.m_lateLatchSlot];
+		latchedModelMatrix.Append(drawItem.m_modelMatrix);
+		backend.SetModelConstants(latchedModelMatrix, drawItem.m_tint);
+	}
+	else
+	{
+		backend.SetModelConstants(drawItem.m_modelMatrix, drawItem.m_tint);
+	}
+
+	switch (drawItem.m_geometryType)
+	{
+		case DrawGeometryType::INDEXED:
+		{
+			backend.DrawIndexBuffer(drawItem.m_vertexBuffer, drawItem.m_indexBuffer, drawItem.m_indexCount);
+			break;
+		}
+		case DrawGeometryType::VERTEX_ARRAY_PCU:
+		{
+			backend.DrawVertexArray(m_vertexArraysPCU[drawItem.m_vertexArrayIndex]);
+			break;
+		}
+		case DrawGeometryType::VERTEX_ARRAY_PCUTBN:
+		{
+			backend.DrawVertexArray(m_vertexArraysPCUTBN[drawItem.m_vertexArrayIndex]);
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+	stats.m_numDrawCalls++;
+}
+
+RenderLayer RenderList::GetLayerForBlendMode(BlendMode blendMode)
+{
+	switch (blendMode)
+	{
+		case BlendMode::OPAQUE:		return RenderLayer::OPAQUE;
+		case BlendMode::ADDITIVE:	return RenderLayer::ADDITIVE;
+		default:					return RenderLayer::TRANSLUCENT;
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <vector>
+
+class DrawBackend;
+class IndexBuffer;
+class Shader;
+class Texture;
+class VertexBuffer;
+
+// Layers are drawn in order, so blended geometry always lands on top of the opaque scene
+enum class RenderLayer
+{
+	OPAQUE,
+	TRANSLUCENT,
+	ADDITIVE,
+	COUNT
+};
+
+// Items whose transform follows a tracked pose, corrected at render time with a pose sampled after the list was built
+enum class LateLatchSlot
+{
+	NONE = -1,
+	LEFT_HAND,
+	RIGHT_HAND,
+	COUNT
+};
+
+enum class DrawGeometryType
+{
+	INDEXED,
+	INDEXED_INSTANCES,
+	VERTEX_ARRAY_PCU,
+	VERTEX_ARRAY_PCUTBN
+};
+
+struct DrawInstance
+{
+public:
+	Mat44					m_modelMatrix = Mat44::IDENTITY;
+	Rgba8					m_tint = Rgba8::WHITE;
+};
+
+struct DrawItem
+{
+public:
+	DrawGeometryType		m_geometryType = DrawGeometryType::INDEXED;
+	VertexBuffer*			m_vertexBuffer = nullptr;
+	IndexBuffer*			m_indexBuffer = nullptr;
+	int						m_indexCount = 0;
+	int						m_vertexArrayIndex = -1;
+	int						m_firstInstanceIndex = -1;
+	int						m_numInstances = 0;
+
+	Mat44					m_modelMatrix = Mat44::IDENTITY;
+	Rgba8					m_tint = Rgba8::WHITE;
+	Texture*				m_texture = nullptr;
+	Shader*					m_shader = nullptr;
+
+	RenderLayer				m_layer = RenderLayer::OPAQUE;
+	BlendMode				m_blendMode = BlendMode::OPAQUE;
+	DepthMode				m_depthMode = DepthMode::ENABLED;
+	RasterizerCullMode		m_cullMode = RasterizerCullMode::CULL_BACK;
+	SamplerMode				m_samplerMode = SamplerMode::POINT_CLAMP;
+
+	int						m_submissionIndex = 0;
+	LateLatchSlot			m_lateLatchSlot = LateLatchSlot::NONE;
+};
+
+struct RenderListStats
+{
+public:
+	int		m_numDrawItems = 0;
+	int		m_numVertexArrays = 0;
+	int		m_numSubmits = 0;
+	int		m_numDrawCalls = 0;
+	int		m_numStateChanges = 0;
+	double	m_buildSeconds = 0.0;
+	double	m_sortSeconds = 0.0;
+};
+
+// A flat list of draw items built once per frame by traversing the scene, then sorted by render state and replayed for every view (desktop, left eye, right eye)
+// Submit only emits state that differs from the previous item, and goes through a DrawBackend so the command stream can be recorded without a device
+// Vertex arrays and instances are copied into the list, so a built list is a self-contained snapshot of the scene (GPU buffers are referenced, not copied)
+class RenderList
+{
+public:
+	~RenderList() = default;
+	RenderList() = default;
+
+	void						BeginBuild();
+	void						EndBuild();
+	void						Clear();
+
+	// Items added without a shader use the default shader active at the time they were added (nullptr is the renderer's default shader)
+	void						SetDefaultShader(Shader* shader);
+	Shader*						GetDefaultShader() const { return m_defaultShader; }
+
+	void						AddDrawItem(DrawItem const& drawItem);
+	void						AddIndexedDraw(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount, Mat44 const& modelMatrix, Rgba8 const& tint = Rgba8::WHITE, Texture* texture = nullptr, BlendMode blendMode = BlendMode::OPAQUE, RenderLayer layer = RenderLayer::OPAQUE);
+	void						AddInstancedDraw(VertexBuffer* vertexBuffer, IndexBuffer* indexBuffer, int indexCount, std::vector<DrawInstance> const& instances, Texture* texture = nullptr);
+	void						AddVertexArray(std::vector<Vertex_PCU> const& vertexes, DrawItem const& drawItem);
+	void						AddVertexArray(std::vector<Vertex_PCUTBN> const& vertexes, DrawItem const& drawItem);
+
+	void						Sort();
+	// Render-side state: premultiplied onto the model matrix of every item in the slot, reset to identity when the list is rebuilt
+	void						SetLateLatchCorrection(LateLatchSlot slot, Mat44 const& correction) const;
+	void						Submit() const;
+	void						Submit(DrawBackend& backend) const;
+	// Replays the list without counting toward its own stats, for inspecting the command stream
+	// Without filtering every state is set before every draw, which is what Submit would cost without redundant state filtering
+	void						Replay(DrawBackend& backend, RenderListStats& out_replayStats, bool filterRedundantState = true) const;
+
+	int							GetNumDrawItems() const { return (int)m_drawItems.size(); }
+	std::vector<DrawItem> const&	GetDrawItems() const { return m_drawItems; }
+	std::vector<Vertex_PCU> const&		GetVertexArrayPCU(int vertexArrayIndex) const { return m_vertexArraysPCU[vertexArrayIndex]; }
+	std::vector<Vertex_PCUTBN> const&	GetVertexArrayPCUTBN(int vertexArrayIndex) const { return m_vertexArraysPCUTBN[vertexArrayIndex]; }
+	RenderListStats const&		GetStats() const { return m_stats; }
+
+	static RenderLayer			GetLayerForBlendMode(BlendMode blendMode);
+
+private:
+	void						SubmitToBackend(DrawBackend& backend, RenderListStats& stats, bool filterRedundantState) const;
+	void						SubmitDrawItem(DrawBackend& backend, DrawItem const& drawItem, DrawItem const* previousItem, RenderListStats& stats) const;
+
+private:
+	std::vector<DrawItem>					m_drawItems;
+	// Vertex arrays are pooled across frames so billboards don't reallocate every frame
+	std::vector<std::vector<Vertex_PCU>>	m_vertexArraysPCU;
+	std::vector<std::vector<Vertex_PCUTBN>>	m_vertexArraysPCUTBN;
+	int										m_numVertexArraysPCU = 0;
+	int										m_numVertexArraysPCUTBN = 0;
+	std::vector<DrawInstance>				m_instances;
+
+	Shader*									m_defaultShader = nullptr;
+	double									m_buildStartTime = 0.0;
+	mutable RenderListStats					m_stats;
+	mutable Mat44							m_lateLatchCorrections[(int)LateLatchSlot::COUNT];
+};
@@ -0,0 +1,177 @@
+#include "Game/RenderListBenchmark.hpp"
+
+#include "Game/CounterRNG.hpp"
+#include "Game/DrawBackend.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/RenderList.hpp"
+
+#include <cstdint>
+
+
+// State in effect when a draw command is issued
+struct DrawState
+{
+public:
+	int			m_blendMode = -1;
+	int			m_depthMode = -1;
+	int			m_cullMode = -1;
+	int			m_fillMode = -1;
+	int			m_samplerMode = -1;
+	void const*	m_shader = nullptr;
+	void const*	m_texture = nullptr;
+
+	bool operator==(DrawState const& other) const
+	{
+		return m_blendMode == other.m_blendMode && m_depthMode == other.m_depthMode && m_cullMode == other.m_cullMode && m_fillMode == other.m_fillMode && m_samplerMode == other.m_samplerMode && m_shader == other.m_shader && m_texture == other.m_texture;
+	}
+};
+
+static void GetStatesAtDraws(RecordingDrawBackend const& recorder, std::vector<DrawState>& out_statesAtDraws)
+{
+	out_statesAtDraws.clear();
+	DrawState state;
+	for (int commandIndex = 0; commandIndex < (int)recorder.m_commands.size(); commandIndex++)
+	{
+		DrawCommand const& command = recorder.m_commands[commandIndex];
+		switch (command.m_type)
+		{
+			case DrawCommandType::SET_BLEND_MODE:		state.m_blendMode = command.m_value;		break;
+			case DrawCommandType::SET_DEPTH_MODE:		state.m_depthMode = command.m_value;		break;
+			case DrawCommandType::SET_CULL_MODE:		state.m_cullMode = command.m_value;			break;
+			case DrawCommandType::SET_FILL_MODE:		state.m_fillMode = command.m_value;			break;
+			case DrawCommandType::SET_SAMPLER_MODE:		state.m_samplerMode = command.m_value;		break;
+			case DrawCommandType::BIND_SHADER:			state.m_shader = command.m_pointer;			break;
+			case DrawCommandType::BIND_TEXTURE:			state.m_texture = command.m_pointer;		break;
+			case DrawCommandType::DRAW_INDEXED:
+			case DrawCommandType::DRAW_VERTEX_ARRAY:	out_statesAtDraws.push_back(state);		break;
+			default:																		break;
+		}
+	}
+}
+
+// Opaque items are ordered by state, blended layers by submission, matching RenderList::Sort
+static bool IsDrawItemOrdered(DrawItem const& a, DrawItem const& b)
+{
+	if (a.m_layer != b.m_layer)
+	{
+		return a.m_layer < b.m_layer;
+	}
+	if (a.m_layer != RenderLayer::OPAQUE)
+	{
+		return a.m_submissionIndex < b.m_submissionIndex;
+	}
+	if (a.m_shader != b.m_shader)
+	{
+		return a.m_shader < b.m_shader;
+	}
+	if (a.m_texture != b.m_texture)
+	{
+		return a.m_texture < b.m_texture;
+	}
+	if (a.m_blendMode != b.m_blendMode)
+	{
+		return a.m_blendMode < b.m_blendMode;
+	}
+	if (a.m_cullMode != b.m_cullMode)
+	{
+		return a.m_cullMode < b.m_cullMode;
+	}
+	if (a.m_depthMode != b.m_depthMode)
+	{
+		return a.m_depthMode < b.m_depthMode;
+	}
+	if (a.m_samplerMode != b.m_samplerMode)
+	{
+		return a.m_samplerMode < b.m_samplerMode;
+	}
+	return a.m_vertexBuffer <= b.m_vertexBuffer;
+}
+
+RenderListBenchmarkResults RunRenderListBenchmark(int numDrawItems, int numIterations)
+{
+	RenderListBenchmarkResults results;
+	results.m_numDrawItems = numDrawItems;
+	results.m_numIterations = numIterations;
+
+	// Resources are only compared and recorded, never dereferenced, so distinct fake addresses stand in for them
+	int const numShaders = 4;
+	int const numTextures = 16;
+	int const numVertexBuffers = 64;
+	BlendMode const blendModes[3] = { BlendMode::OPAQUE, BlendMode::ALPHA, BlendMode::ADDITIVE };
+	RasterizerCullMode const cullModes[2] = { RasterizerCullMode::CULL_BACK, RasterizerCullMode::CULL_NONE };
+	std::vector<Vertex_PCU> billboardVertexes(6);
+
+	RenderList renderList;
+	for (int iterationIndex = 0; iterationIndex < numIterations; iterationIndex++)
+	{
+		// Every iteration builds the same items, like a steady scene rebuilt every frame
+		CounterRNG itemRNG = g_randomStreams->GetRNG(RandomStream::BENCHMARK, GetRandomSubjectForName("RenderList"));
+		renderList.BeginBuild();
+		for (int itemIndex = 0; itemIndex < numDrawItems; itemIndex++)
+		{
+			DrawItem drawItem;
+			drawItem.m_shader = reinterpret_cast<Shader*>((uintptr_t)(itemRNG.RollRandomIntInRange(1, numShaders) * 16));
+			drawItem.m_texture = reinterpret_cast<Texture*>((uintptr_t)(itemRNG.RollRandomIntInRange(1, numTextures) * 16));
+			drawItem.m_blendMode = blendModes[itemRNG.RollRandomChance(0.8f) ? 0 : itemRNG.RollRandomIntInRange(1, 2)];
+			drawItem.m_layer = RenderList::GetLayerForBlendMode(drawItem.m_blendMode);
+			drawItem.m_cullMode = cullModes[itemRNG.RollRandomIntInRange(0, 1)];
+			if (drawItem.m_blendMode == BlendMode::OPAQUE)
+			{
+				drawItem.m_vertexBuffer = reinterpret_cast<VertexBuffer*>((uintptr_t)(itemRNG.RollRandomIntInRange(1, numVertexBuffers) * 16));
+				drawItem.m_indexCount = 36;
+				renderList.AddDrawItem(drawItem);
+			}
+			else
+			{
+				renderList.AddVertexArray(billboardVertexes, drawItem);
+			}
+		}
+		renderList.EndBuild();
+
+		results.m_averageBuildSeconds += renderList.GetStats().m_buildSeconds;
+		results.m_averageSortSeconds += renderList.GetStats().m_sortSeconds;
+	}
+	if (numIterations > 0)
+	{
+		results.m_averageBuildSeconds /= (double)numIterations;
+		results.m_averageSortSeconds /= (double)numIterations;
+	}
+
+	std::vector<DrawItem> const& drawItems = renderList.GetDrawItems();
+	for (int itemIndex = 1; itemIndex < (int)drawItems.size(); itemIndex++)
+	{
+		if (!IsDrawItemOrdered(drawItems[itemIndex - 1], drawItems[itemIndex]))
+		{
+			results.m_numSortOrderErrors++;
+		}
+	}
+
+	RecordingDrawBackend filteredRecorder;
+	RecordingDrawBackend unfilteredRecorder;
+	RenderListStats filteredStats;
+	RenderListStats unfilteredStats;
+	renderList.Replay(filteredRecorder, filteredStats);
+	renderList.Replay(unfilteredRecorder, unfilteredStats, false);
+	results.m_numDrawCommands = filteredRecorder.GetNumDrawCommands();
+	results.m_numStateCommands = filteredRecorder.GetNumStateCommands();
+	results.m_numUnfilteredStateCommands = unfilteredRecorder.GetNumStateCommands();
+
+	std::vector<DrawState> filteredStates;
+	std::vector<DrawState> unfilteredStates;
+	GetStatesAtDraws(filteredRecorder, filteredStates);
+	GetStatesAtDraws(unfilteredRecorder, unfilteredStates);
+	if (filteredStates.size() != unfilteredStates.size())
+	{
+		results.m_numStateMismatches = numDrawItems;
+		return results;
+	}
+	for (int drawIndex = 0; drawIndex < (int)filteredStates.size(); drawIndex++)
+	{
+		if (!(filteredStates[drawIndex] == unfilteredStates[drawIndex]))
+		{
+			results.m_numStateMismatches++;
+		}
+	}
+
+	return results;
+}
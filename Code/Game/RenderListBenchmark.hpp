@@ -0,0 +1,19 @@
+#pragma once
+
+struct RenderListBenchmarkResults
+{
+public:
+	int		m_numDrawItems = 0;
+	int		m_numIterations = 0;
+	double	m_averageBuildSeconds = 0.0;
+	double	m_averageSortSeconds = 0.0;
+	int		m_numDrawCommands = 0;
+	int		m_numStateCommands = 0;
+	int		m_numUnfilteredStateCommands = 0;
+	int		m_numSortOrderErrors = 0;
+	int		m_numStateMismatches = 0;
+};
+
+// Builds a synthetic render list spread over a few shaders, textures and blend modes and times building and sorting it, without a map or a device
+// The sorted order is checked against the layer and state ordering rules, and the filtered command stream is replayed against an unfiltered one to check every draw still sees the same state
+RenderListBenchmarkResults RunRenderListBenchmark(int numDrawItems, int numIterations);
@@ -0,0 +1,61 @@
+#include "Game/SimulationThread.hpp"
+
+#include "Engine/Core/Time.hpp"
+
+
+SimulationThread::~SimulationThread()
+{
+	WaitForStep();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isQuitting = true;
+	}
+	m_stepCondition.notify_all();
+	m_thread.join();
+}
+
+SimulationThread::SimulationThread(std::function<void()> const& step)
+	: m_step(step)
+{
+	// Started last, once every member the thread reads is constructed
+	m_thread = std::thread(&SimulationThread::ThreadMain, this);
+}
+
+void SimulationThread::StartStep()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStepPending = true;
+	}
+	m_stepCondition.notify_all();
+}
+
+void SimulationThread::WaitForStep()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_stepCondition.wait(lock, [this]() { return !m_isStepPending; });
+}
+
+void SimulationThread::ThreadMain()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_stepCondition.wait(lock, [this]() { return m_isStepPending || m_isQuitting; });
+		if (m_isQuitting)
+		{
+			return;
+		}
+
+		// The lock is only held to hand the step over, the step itself runs unlocked
+		lock.unlock();
+		double startTime = GetCurrentTimeSeconds();
+		m_step();
+		double stepSeconds = GetCurrentTimeSeconds() - startTime;
+		lock.lock();
+
+		m_lastStepSeconds = stepSeconds;
+		m_isStepPending = false;
+		m_stepCondition.notify_all();
+	}
+}
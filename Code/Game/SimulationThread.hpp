@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+// Runs one simulation step at a time on a dedicated thread, so the main thread can render the last published snapshot meanwhile
+// The main thread starts a step and waits for it before touching simulation state again, snapshots themselves are handed over through a SnapshotExchange
+class SimulationThread
+{
+public:
+	~SimulationThread();
+	explicit SimulationThread(std::function<void()> const& step);
+	SimulationThread(SimulationThread const& copyFrom) = delete;
+	SimulationThread& operator=(SimulationThread const& copyFrom) = delete;
+
+	void						StartStep();
+	// Blocks until the step started last has finished, returns right away when none is running
+	void						WaitForStep();
+	// Only meaningful after WaitForStep
+	double						GetLastStepSeconds() const { return m_lastStepSeconds; }
+
+private:
+	void						ThreadMain();
+
+private:
+	std::function<void()>		m_step;
+	std::mutex					m_mutex;
+	std::condition_variable		m_stepCondition;
+	bool						m_isStepPending = false;
+	bool						m_isQuitting = false;
+	double						m_lastStepSeconds = 0.0;
+	std::thread					m_thread;
+};
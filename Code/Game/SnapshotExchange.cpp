@@ -0,0 +1,84 @@
+#include "Game/SnapshotExchange.hpp"
+
+#include "Engine/Core/Time.hpp"
+
+#include <thread>
+#include <vector>
+
+
+struct StressSnapshot
+{
+public:
+	int							m_sequence = -1;
+	std::vector<unsigned int>	m_payload;
+};
+
+static unsigned int GetStressPayloadValue(int sequence, int payloadIndex)
+{
+	return (unsigned int)sequence * 2654435761u + (unsigned int)payloadIndex;
+}
+
+SnapshotStressResults RunSnapshotExchangeStress(int numSnapshots, int payloadSize)
+{
+	SnapshotStressResults results;
+	SnapshotExchange<StressSnapshot> exchange;
+	std::atomic<bool> isProducerDone = false;
+
+	double startTime = GetCurrentTimeSeconds();
+
+	std::thread producer([&]()
+	{
+		for (int sequence = 0; sequence < numSnapshots; sequence++)
+		{
+			StressSnapshot& snapshot = exchange.GetWriteBuffer();
+			snapshot.m_payload.resize(payloadSize);
+			for (int payloadIndex = 0; payloadIndex < payloadSize; payloadIndex++)
+			{
+				snapshot.m_payload[payloadIndex] = GetStressPayloadValue(sequence, payloadIndex);
+			}
+			snapshot.m_sequence = sequence;
+			exchange.Publish();
+			results.m_numPublished++;
+		}
+		isProducerDone.store(true, std::memory_order_release);
+	});
+
+	std::thread consumer([&]()
+	{
+		int lastSequence = -1;
+		while (true)
+		{
+			// Checked before acquiring, so the final snapshot is still picked up after the producer finishes
+			bool wasProducerDone = isProducerDone.load(std::memory_order_acquire);
+			if (exchange.AcquireLatest())
+			{
+				StressSnapshot const& snapshot = exchange.GetReadBuffer();
+				if (snapshot.m_sequence <= lastSequence)
+				{
+					results.m_numOutOfOrderReads++;
+				}
+				for (int payloadIndex = 0; payloadIndex < (int)snapshot.m_payload.size(); payloadIndex++)
+				{
+					if (snapshot.m_payload[payloadIndex] != GetStressPayloadValue(snapshot.m_sequence, payloadIndex))
+					{
+						results.m_numTornReads++;
+						break;
+					}
+				}
+				results.m_numSkipped += snapshot.m_sequence - lastSequence - 1;
+				lastSequence = snapshot.m_sequence;
+				results.m_numAcquired++;
+			}
+			else if (wasProducerDone)
+			{
+				break;
+			}
+		}
+	});
+
+	producer.join();
+	consumer.join();
+
+	results.m_elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+	return results;
+}
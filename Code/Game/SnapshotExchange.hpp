@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+
+
+// Lock-free handoff of whole snapshots from one producer thread to one consumer thread (triple buffering)
+// The producer fills the write buffer and publishes it, the consumer picks up the newest published buffer and reads it until it acquires again
+// Neither side ever waits: each owns one buffer outright and the third is swapped through a single atomic, so a slow consumer just skips snapshots
+// Published buffers are not cleared, so T should reuse its own storage when refilled
+template <typename T>
+class SnapshotExchange
+{
+public:
+	~SnapshotExchange() = default;
+	SnapshotExchange() = default;
+	SnapshotExchange(SnapshotExchange const& copyFrom) = delete;
+	SnapshotExchange& operator=(SnapshotExchange const& copyFrom) = delete;
+
+	// Producer side
+	T&				GetWriteBuffer() { return m_buffers[m_writeIndex]; }
+	void			Publish();
+
+	// Consumer side, returns false and keeps the current read buffer when nothing was published since the last acquire
+	bool			AcquireLatest();
+	T const&		GetReadBuffer() const { return m_buffers[m_readIndex]; }
+
+private:
+	static constexpr unsigned int INDEX_MASK = 0x3;
+	static constexpr unsigned int FRESH_BIT = 0x4;
+
+	T							m_buffers[3];
+	unsigned int				m_writeIndex = 0;
+	unsigned int				m_readIndex = 1;
+	// Index of the buffer between the two sides, with FRESH_BIT set while the consumer has not taken it
+	std::atomic<unsigned int>	m_pendingIndex = 2;
+};
+
+template <typename T>
+void SnapshotExchange<T>::Publish()
+{
+	// Release makes the writes to the buffer visible to whoever acquires it, and the buffer handed back becomes the next write buffer
+	unsigned int previousPending = m_pendingIndex.exchange(m_writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+	m_writeIndex = previousPending & INDEX_MASK;
+}
+
+template <typename T>
+bool SnapshotExchange<T>::AcquireLatest()
+{
+	if ((m_pendingIndex.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+	{
+		return false;
+	}
+
+	unsigned int previousPending = m_pendingIndex.exchange(m_readIndex, std::memory_order_acq_rel);
+	m_readIndex = previousPending & INDEX_MASK;
+	return true;
+}
+
+
+struct SnapshotStressResults
+{
+public:
+	int		m_numPublished = 0;
+	int		m_numAcquired = 0;
+	int		m_numSkipped = 0;
+	int		m_numTornReads = 0;
+	int		m_numOutOfOrderReads = 0;
+	double	m_elapsedSeconds = 0.0;
+};
+
+// Headless check of the handoff: a producer thread publishes numbered snapshots with a payload derived from the number,
+// while a consumer thread acquires as fast as it can and verifies every payload it reads is whole and newer than the last
+SnapshotStressResults RunSnapshotExchangeStress(int numSnapshots, int payloadSize);
@@ -0,0 +1,159 @@
+#include "Game/SweptCollision.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+
+// Entry and exit fractions of a point moving along the displacement through the box, false if it never enters within the sweep
+static bool GetPointSweepIntervalVsAABB2(Vec2 const& start, Vec2 const& displacement, AABB2 const& box, float& out_entry, float& out_exit, Vec2& out_entryNormal)
+{
+	out_entry = -FLT_MAX;
+	out_exit = FLT_MAX;
+
+	float starts[2] = { start.x, start.y };
+	float deltas[2] = { displacement.x, displacement.y };
+	float mins[2] = { box.m_mins.x, box.m_mins.y };
+	float maxs[2] = { box.m_maxs.x, box.m_maxs.y };
+	for (int axisIndex = 0; axisIndex < 2; axisIndex++)
+	{
+		if (deltas[axisIndex] == 0.f)
+		{
+			if (starts[axisIndex] < mins[axisIndex] || starts[axisIndex] > maxs[axisIndex])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float entry = ((deltas[axisIndex] > 0.f ? mins[axisIndex] : maxs[axisIndex]) - starts[axisIndex]) / deltas[axisIndex];
+		float exit = ((deltas[axisIndex] > 0.f ? maxs[axisIndex] : mins[axisIndex]) - starts[axisIndex]) / deltas[axisIndex];
+		if (entry > out_entry)
+		{
+			out_entry = entry;
+			out_entryNormal = axisIndex == 0 ? Vec2(deltas[axisIndex] > 0.f ? -1.f : 1.f, 0.f) : Vec2(0.f, deltas[axisIndex] > 0.f ? -1.f : 1.f);
+		}
+		out_exit = std::min(out_exit, exit);
+	}
+
+	return out_entry <= out_exit && out_exit >= 0.f && out_entry <= 1.f;
+}
+
+// Entry and exit fractions of a point moving along the displacement through the disc
+static bool GetPointSweepIntervalVsDisc2D(Vec2 const& start, Vec2 const& displacement, Vec2 const& discCenter, float discRadius, float& out_entry, float& out_exit)
+{
+	Vec2 centerToStart = start - discCenter;
+	float a = displacement.GetLengthSquared();
+	float c = centerToStart.GetLengthSquared() - discRadius * discRadius;
+	if (a == 0.f)
+	{
+		out_entry = -FLT_MAX;
+		out_exit = FLT_MAX;
+		return c <= 0.f;
+	}
+
+	float b = 2.f * DotProduct2D(centerToStart, displacement);
+	float discriminant = b * b - 4.f * a * c;
+	if (discriminant < 0.f)
+	{
+		return false;
+	}
+
+	float sqrtDiscriminant = sqrtf(discriminant);
+	out_entry = (-b - sqrtDiscriminant) / (2.f * a);
+	out_exit = (-b + sqrtDiscriminant) / (2.f * a);
+	return out_exit >= 0.f && out_entry <= 1.f;
+}
+
+SweepResult SweepDiscVsAABB2(Vec2 const& discStart, Vec2 const& displacement, float discRadius, AABB2 const& box)
+{
+	SweepResult result;
+
+	Vec2 nearestPoint = box.GetNearestPoint(discStart);
+	if (GetDistanceSquared2D(nearestPoint, discStart) <= discRadius * discRadius)
+	{
+		return result;
+	}
+
+	// The disc touches the box when its center enters the box grown by the radius (two slabs and four rounded corners)
+	float entry = 0.f;
+	float exit = 0.f;
+	Vec2 entryNormal;
+	AABB2 wideSlab(box.m_mins - Vec2(discRadius, 0.f), box.m_maxs + Vec2(discRadius, 0.f));
+	AABB2 tallSlab(box.m_mins - Vec2(0.f, discRadius), box.m_maxs + Vec2(0.f, discRadius));
+	AABB2 slabs[2] = { wideSlab, tallSlab };
+	for (int slabIndex = 0; slabIndex < 2; slabIndex++)
+	{
+		if (GetPointSweepIntervalVsAABB2(discStart, displacement, slabs[slabIndex], entry, exit, entryNormal) && entry < result.m_timeOfImpact)
+		{
+			result.m_didImpact = true;
+			result.m_timeOfImpact = std::max(entry, 0.f);
+			result.m_impactNormal = entryNormal.ToVec3();
+		}
+	}
+
+	Vec2 corners[4] = { box.m_mins, Vec2(box.m_maxs.x, box.m_mins.y), box.m_maxs, Vec2(box.m_mins.x, box.m_maxs.y) };
+	for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+	{
+		if (GetPointSweepIntervalVsDisc2D(discStart, displacement, corners[cornerIndex], discRadius, entry, exit) && entry < result.m_timeOfImpact)
+		{
+			result.m_didImpact = true;
+			result.m_timeOfImpact = std::max(entry, 0.f);
+			result.m_impactNormal = (discStart + displacement * result.m_timeOfImpact - corners[cornerIndex]).GetNormalized().ToVec3();
+		}
+	}
+
+	return result;
+}
+
+SweepResult SweepZCylinderVsZCylinder(Vec3 const& movingBase, Vec3 const& displacement, float movingRadius, float movingHeight, Vec3 const& fixedBase, float fixedRadius, float fixedHeight)
+{
+	SweepResult result;
+
+	// In XY the moving center has to enter a disc of both radii around the fixed center
+	float discEntry = 0.f;
+	float discExit = 0.f;
+	if (!GetPointSweepIntervalVsDisc2D(movingBase.GetXY(), displacement.GetXY(), fixedBase.GetXY(), movingRadius + fixedRadius, discEntry, discExit))
+	{
+		return result;
+	}
+
+	// In Z the moving base has to be within the fixed cylinder's span, extended down by the moving height
+	float spanMin = fixedBase.z - movingHeight;
+	float spanMax = fixedBase.z + fixedHeight;
+	float spanEntry = -FLT_MAX;
+	float spanExit = FLT_MAX;
+	if (displacement.z == 0.f)
+	{
+		if (movingBase.z < spanMin || movingBase.z > spanMax)
+		{
+			return result;
+		}
+	}
+	else
+	{
+		spanEntry = ((displacement.z > 0.f ? spanMin : spanMax) - movingBase.z) / displacement.z;
+		spanExit = ((displacement.z > 0.f ? spanMax : spanMin) - movingBase.z) / displacement.z;
+	}
+
+	float entry = std::max(discEntry, spanEntry);
+	float exit = std::min(discExit, spanExit);
+	if (entry > exit || entry < 0.f || entry > 1.f)
+	{
+		return result;
+	}
+
+	result.m_didImpact = true;
+	result.m_timeOfImpact = entry;
+	if (discEntry >= spanEntry)
+	{
+		Vec2 impactCenter = movingBase.GetXY() + displacement.GetXY() * entry;
+		result.m_impactNormal = (impactCenter - fixedBase.GetXY()).GetNormalized().ToVec3();
+	}
+	else
+	{
+		result.m_impactNormal = displacement.z > 0.f ? Vec3::GROUNDWARD : Vec3::SKYWARD;
+	}
+	return result;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+
+// Continuous collision tests: a shape moving along a displacement against a fixed shape
+// Time of impact is the fraction of the displacement travelled before first contact
+// Shapes that already overlap at the start report no impact, the discrete push-out tests resolve those
+struct SweepResult
+{
+public:
+	bool	m_didImpact = false;
+	float	m_timeOfImpact = 1.f;
+	// Points away from the fixed shape
+	Vec3	m_impactNormal = Vec3::ZERO;
+};
+
+SweepResult		SweepDiscVsAABB2(Vec2 const& discStart, Vec2 const& displacement, float discRadius, AABB2 const& box);
+// Cylinders stand upright on their base position, as actors do
+SweepResult		SweepZCylinderVsZCylinder(Vec3 const& movingBase, Vec3 const& displacement, float movingRadius, float movingHeight, Vec3 const& fixedBase, float fixedRadius, float fixedHeight);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+class IndexBuffer;
+class VertexBuffer;
+
+// A square block of the tile mesh with its own buffers, rebuilt only when a tile in it (or a wall beside it) changes
+// Chunks are also the unit tile geometry is culled by
+struct TileChunk
+{
+public:
+	IntVec2			m_minTileCoords = IntVec2(0, 0);
+	// Exclusive, so chunks on the map edge may be smaller than TILE_CHUNK_SIZE
+	IntVec2			m_maxTileCoords = IntVec2(0, 0);
+	Vec3			m_boundsCenter = Vec3::ZERO;
+	float			m_boundsRadius = 0.f;
+
+	VertexBuffer*	m_vertexBuffer = nullptr;
+	IndexBuffer*	m_indexBuffer = nullptr;
+	int				m_vertexCapacity = 0;
+	int				m_indexCapacity = 0;
+	int				m_numVertexes = 0;
+	int				m_numIndexes = 0;
+	// What the chunk's tiles would cost drawn one quad per face, kept so the map totals only change by the chunks rebuilt
+	int				m_numUnculledVertexes = 0;
+	int				m_numUnculledIndexes = 0;
+	bool			m_isDirty = true;
+};
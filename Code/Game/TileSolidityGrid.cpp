@@ -0,0 +1,132 @@
+#include "Game/TileSolidityGrid.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+
+void TileSolidityGrid::Initialize(IntVec2 const& dimensions)
+{
+	m_dimensions = dimensions;
+	m_numBlocksX = (dimensions.x + BLOCK_SIZE_MASK) >> BLOCK_SIZE_SHIFT;
+	int numBlocksY = (dimensions.y + BLOCK_SIZE_MASK) >> BLOCK_SIZE_SHIFT;
+	m_blocks.assign(m_numBlocksX * numBlocksY, 0);
+}
+
+void TileSolidityGrid::SetTileSolid(IntVec2 const& tileCoords, bool isSolid)
+{
+	if ((unsigned int)tileCoords.x >= (unsigned int)m_dimensions.x || (unsigned int)tileCoords.y >= (unsigned int)m_dimensions.y)
+	{
+		return;
+	}
+
+	uint64_t& block = m_blocks[(tileCoords.x >> BLOCK_SIZE_SHIFT) + (tileCoords.y >> BLOCK_SIZE_SHIFT) * m_numBlocksX];
+	uint64_t tileBit = (uint64_t)1 << ((tileCoords.x & BLOCK_SIZE_MASK) + ((tileCoords.y & BLOCK_SIZE_MASK) << BLOCK_SIZE_SHIFT));
+	if (isSolid)
+	{
+		block |= tileBit;
+	}
+	else
+	{
+		block &= ~tileBit;
+	}
+}
+
+bool TileSolidityGrid::IsTileSolid(int tileX, int tileY) const
+{
+	if ((unsigned int)tileX >= (unsigned int)m_dimensions.x || (unsigned int)tileY >= (unsigned int)m_dimensions.y)
+	{
+		return false;
+	}
+
+	uint64_t block = m_blocks[(tileX >> BLOCK_SIZE_SHIFT) + (tileY >> BLOCK_SIZE_SHIFT) * m_numBlocksX];
+	return ((block >> ((tileX & BLOCK_SIZE_MASK) + ((tileY & BLOCK_SIZE_MASK) << BLOCK_SIZE_SHIFT))) & 1) != 0;
+}
+
+unsigned int TileSolidityGrid::GetSolidNeighborMask(IntVec2 const& tileCoords) const
+{
+	unsigned int mask = 0;
+	mask |= IsTileSolid(tileCoords.x + 1, tileCoords.y) ? NEIGHBOR_EAST : 0;
+	mask |= IsTileSolid(tileCoords.x - 1, tileCoords.y) ? NEIGHBOR_WEST : 0;
+	mask |= IsTileSolid(tileCoords.x, tileCoords.y + 1) ? NEIGHBOR_NORTH : 0;
+	mask |= IsTileSolid(tileCoords.x, tileCoords.y - 1) ? NEIGHBOR_SOUTH : 0;
+	mask |= IsTileSolid(tileCoords.x + 1, tileCoords.y + 1) ? NEIGHBOR_NORTHEAST : 0;
+	mask |= IsTileSolid(tileCoords.x + 1, tileCoords.y - 1) ? NEIGHBOR_SOUTHEAST : 0;
+	mask |= IsTileSolid(tileCoords.x - 1, tileCoords.y + 1) ? NEIGHBOR_NORTHWEST : 0;
+	mask |= IsTileSolid(tileCoords.x - 1, tileCoords.y - 1) ? NEIGHBOR_SOUTHWEST : 0;
+	return mask;
+}
+
+RaycastResult3D TileSolidityGrid::Raycast(Vec3 const& startPos, Vec3 const& fwdNormal, float maxDistance) const
+{
+	RaycastResult3D result;
+	result.m_didImpact = false;
+	result.m_impactDistance = maxDistance;
+	result.m_rayStartPosition = startPos;
+	result.m_rayForwardNormal = fwdNormal;
+	result.m_rayMaxLength = maxDistance;
+
+	int tileX = RoundDownToInt(startPos.x);
+	int tileY = RoundDownToInt(startPos.y);
+	if (IsTileSolid(tileX, tileY))
+	{
+		result.m_didImpact = true;
+		result.m_impactDistance = 0.f;
+		result.m_impactPosition = startPos;
+		result.m_impactNormal = fwdNormal * -1.f;
+		return result;
+	}
+
+	if (fwdNormal.x == 0.f && fwdNormal.y == 0.f)
+	{
+		result.m_impactPosition = startPos + fwdNormal * maxDistance;
+		return result;
+	}
+
+	// Distance along the ray between successive crossings of vertical and horizontal tile edges
+	float fwdDistPerXCrossing = fwdNormal.x != 0.f ? 1.f / fabsf(fwdNormal.x) : FLT_MAX;
+	float fwdDistPerYCrossing = fwdNormal.y != 0.f ? 1.f / fabsf(fwdNormal.y) : FLT_MAX;
+	int tileStepX = fwdNormal.x < 0.f ? -1 : 1;
+	int tileStepY = fwdNormal.y < 0.f ? -1 : 1;
+	float fwdDistAtNextXCrossing = fwdNormal.x != 0.f ? fabsf((float)(tileX + (tileStepX + 1) / 2) - startPos.x) * fwdDistPerXCrossing : FLT_MAX;
+	float fwdDistAtNextYCrossing = fwdNormal.y != 0.f ? fabsf((float)(tileY + (tileStepY + 1) / 2) - startPos.y) * fwdDistPerYCrossing : FLT_MAX;
+
+	while (true)
+	{
+		bool isCrossingX = fwdDistAtNextXCrossing < fwdDistAtNextYCrossing;
+		float fwdDistAtCrossing = isCrossingX ? fwdDistAtNextXCrossing : fwdDistAtNextYCrossing;
+		if (fwdDistAtCrossing > maxDistance)
+		{
+			break;
+		}
+
+		if (isCrossingX)
+		{
+			tileX += tileStepX;
+			fwdDistAtNextXCrossing += fwdDistPerXCrossing;
+		}
+		else
+		{
+			tileY += tileStepY;
+			fwdDistAtNextYCrossing += fwdDistPerYCrossing;
+		}
+
+		if (IsTileSolid(tileX, tileY))
+		{
+			result.m_didImpact = true;
+			result.m_impactDistance = fwdDistAtCrossing;
+			result.m_impactNormal = isCrossingX ? Vec3((float)-tileStepX, 0.f, 0.f) : Vec3(0.f, (float)-tileStepY, 0.f);
+			break;
+		}
+
+		// Once the ray has left the grid and is heading further out, no solid tile can follow
+		if ((tileX < 0 && tileStepX < 0) || (tileX >= m_dimensions.x && tileStepX > 0) || (tileY < 0 && tileStepY < 0) || (tileY >= m_dimensions.y && tileStepY > 0))
+		{
+			break;
+		}
+	}
+
+	result.m_impactPosition = startPos + fwdNormal * result.m_impactDistance;
+	return result;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/RaycastUtils.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// One bit per tile marking solid tiles, packed into 8x8 blocks so a tile and its neighbours usually share a single 64-bit word
+// Collision and raycasts read only this grid, never the tile definitions
+class TileSolidityGrid
+{
+public:
+	~TileSolidityGrid() = default;
+	TileSolidityGrid() = default;
+
+	void				Initialize(IntVec2 const& dimensions);
+	void				SetTileSolid(IntVec2 const& tileCoords, bool isSolid);
+
+	// Tiles outside the grid are never solid
+	bool				IsTileSolid(int tileX, int tileY) const;
+	// Bits follow NEIGHBOR_EAST..NEIGHBOR_SOUTHWEST, set for each solid tile around the given tile
+	unsigned int		GetSolidNeighborMask(IntVec2 const& tileCoords) const;
+	// Walks the tiles under the ray's XY projection, distances are measured along the full 3D ray
+	RaycastResult3D		Raycast(Vec3 const& startPos, Vec3 const& fwdNormal, float maxDistance) const;
+
+	IntVec2 const		GetDimensions() const { return m_dimensions; }
+
+public:
+	static constexpr unsigned int NEIGHBOR_EAST			= 1 << 0;
+	static constexpr unsigned int NEIGHBOR_WEST			= 1 << 1;
+	static constexpr unsigned int NEIGHBOR_NORTH		= 1 << 2;
+	static constexpr unsigned int NEIGHBOR_SOUTH		= 1 << 3;
+	static constexpr unsigned int NEIGHBOR_NORTHEAST	= 1 << 4;
+	static constexpr unsigned int NEIGHBOR_SOUTHEAST	= 1 << 5;
+	static constexpr unsigned int NEIGHBOR_NORTHWEST	= 1 << 6;
+	static constexpr unsigned int NEIGHBOR_SOUTHWEST	= 1 << 7;
+
+private:
+	static constexpr int BLOCK_SIZE_SHIFT = 3;
+	static constexpr int BLOCK_SIZE_MASK = (1 << BLOCK_SIZE_SHIFT) - 1;
+
+	IntVec2					m_dimensions = IntVec2(0, 0);
+	int						m_numBlocksX = 0;
+	std::vector<uint64_t>	m_blocks;
+};
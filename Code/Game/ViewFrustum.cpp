@@ -0,0 +1,48 @@
+#include "Game/ViewFrustum.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+
+ViewFrustum ViewFrustum::CreatePerspective(Mat44 const& cameraTransform, float fovLeftDegrees, float fovRightDegrees, float fovUpDegrees, float fovDownDegrees, float nearDistance, float farDistance)
+{
+	// Cameras look along i with j to their left and k up, so an angle to the right turns away from j
+	Vec3 position = cameraTransform.GetTranslation3D();
+	Vec3 forward = cameraTransform.GetIBasis3D();
+	Vec3 left = cameraTransform.GetJBasis3D();
+	Vec3 up = cameraTransform.GetKBasis3D();
+
+	ViewFrustum frustum;
+	frustum.m_planeNormals[0] = forward * -SinDegrees(fovLeftDegrees) - left * CosDegrees(fovLeftDegrees);
+	frustum.m_planeNormals[1] = forward * SinDegrees(fovRightDegrees) + left * CosDegrees(fovRightDegrees);
+	frustum.m_planeNormals[2] = forward * SinDegrees(fovUpDegrees) - up * CosDegrees(fovUpDegrees);
+	frustum.m_planeNormals[3] = forward * -SinDegrees(fovDownDegrees) + up * CosDegrees(fovDownDegrees);
+	for (int planeIndex = 0; planeIndex < 4; planeIndex++)
+	{
+		frustum.m_planeDistances[planeIndex] = DotProduct3D(frustum.m_planeNormals[planeIndex], position);
+	}
+
+	frustum.m_planeNormals[4] = forward;
+	frustum.m_planeDistances[4] = DotProduct3D(forward, position) + nearDistance;
+	frustum.m_planeNormals[5] = forward * -1.f;
+	frustum.m_planeDistances[5] = -(DotProduct3D(forward, position) + farDistance);
+	return frustum;
+}
+
+ViewFrustum ViewFrustum::CreatePerspective(Mat44 const& cameraTransform, float aspect, float fovDegrees, float nearDistance, float farDistance)
+{
+	float halfFovDegrees = fovDegrees * 0.5f;
+	float halfHorizontalFovDegrees = Atan2Degrees(aspect * SinDegrees(halfFovDegrees), CosDegrees(halfFovDegrees));
+	return CreatePerspective(cameraTransform, -halfHorizontalFovDegrees, halfHorizontalFovDegrees, halfFovDegrees, -halfFovDegrees, nearDistance, farDistance);
+}
+
+bool ViewFrustum::IsSphereInside(Vec3 const& center, float radius) const
+{
+	for (int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++)
+	{
+		if (DotProduct3D(m_planeNormals[planeIndex], center) - m_planeDistances[planeIndex] < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+
+// Six inward facing planes of a perspective view, for culling bounding spheres on the CPU
+// Field of view angles follow OpenXR, measured from the view forward with left and down negative, so asymmetric eye views fit too
+struct ViewFrustum
+{
+public:
+	static ViewFrustum	CreatePerspective(Mat44 const& cameraTransform, float fovLeftDegrees, float fovRightDegrees, float fovUpDegrees, float fovDownDegrees, float nearDistance, float farDistance);
+	// Symmetric view matching Camera::SetPerspectiveView
+	static ViewFrustum	CreatePerspective(Mat44 const& cameraTransform, float aspect, float fovDegrees, float nearDistance, float farDistance);
+
+	bool				IsSphereInside(Vec3 const& center, float radius) const;
+
+public:
+	static constexpr int NUM_PLANES = 6;
+	Vec3				m_planeNormals[NUM_PLANES];
+	float				m_planeDistances[NUM_PLANES] = {};
+};
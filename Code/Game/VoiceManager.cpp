@@ -0,0 +1,195 @@
+#include "Game/VoiceManager.hpp"
+
+#include "Game/Actor.hpp"
+#include "Game/AudioBackend.hpp"
+#include "Game/Map.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cmath>
+
+
+VoiceManager::~VoiceManager()
+{
+	// Voices still playing are left to the audio system, which may already be shut down by now
+	delete m_backend;
+	m_backend = nullptr;
+}
+
+VoiceManager::VoiceManager(AudioBackend* backend, int maxVoices, int maxInstancesPerSound, float maxAudibleDistance)
+	: m_backend(backend)
+	, m_maxVoices(maxVoices)
+	, m_maxInstancesPerSound(maxInstancesPerSound)
+	, m_maxAudibleDistance(maxAudibleDistance)
+{
+	m_voices.reserve(maxVoices);
+}
+
+SoundPlaybackID VoiceManager::PlaySoundAt(SoundID soundID, Vec3 const& position, VoicePriority priority, ActorUID followActorUID)
+{
+	m_stats.m_numRequests++;
+	if (soundID == MISSING_SOUND_ID)
+	{
+		return MISSING_SOUND_ID;
+	}
+
+	if (GetDistanceToNearestListener(position) > m_maxAudibleDistance)
+	{
+		m_stats.m_numCulledByDistance++;
+		return MISSING_SOUND_ID;
+	}
+
+	// Identical sounds stacking up are heard as one louder sound, so the oldest instance gives way to the new one
+	int numInstances = 0;
+	int oldestInstanceIndex = -1;
+	for (int voiceIndex = 0; voiceIndex < (int)m_voices.size(); voiceIndex++)
+	{
+		ManagedVoice const& voice = m_voices[voiceIndex];
+		if (voice.m_soundID != soundID)
+		{
+			continue;
+		}
+
+		numInstances++;
+		if (voice.m_priority <= priority && (oldestInstanceIndex == -1 || voice.m_startSequence < m_voices[oldestInstanceIndex].m_startSequence))
+		{
+			oldestInstanceIndex = voiceIndex;
+		}
+	}
+
+	if (numInstances >= m_maxInstancesPerSound)
+	{
+		if (oldestInstanceIndex == -1)
+		{
+			m_stats.m_numRejectedBySoundCap++;
+			return MISSING_SOUND_ID;
+		}
+		StopVoice(oldestInstanceIndex);
+		m_stats.m_numStolenBySoundCap++;
+	}
+	else if ((int)m_voices.size() >= m_maxVoices)
+	{
+		float importance = GetVoiceImportance(priority, position);
+		int leastImportantVoiceIndex = -1;
+		float leastImportance = 0.f;
+		for (int voiceIndex = 0; voiceIndex < (int)m_voices.size(); voiceIndex++)
+		{
+			float voiceImportance = GetVoiceImportance(m_voices[voiceIndex].m_priority, m_voices[voiceIndex].m_position);
+			if (leastImportantVoiceIndex == -1 || voiceImportance < leastImportance)
+			{
+				leastImportantVoiceIndex = voiceIndex;
+				leastImportance = voiceImportance;
+			}
+		}
+
+		if (leastImportantVoiceIndex == -1 || leastImportance >= importance)
+		{
+			m_stats.m_numRejectedByBudget++;
+			return MISSING_SOUND_ID;
+		}
+		StopVoice(leastImportantVoiceIndex);
+		m_stats.m_numStolenByBudget++;
+	}
+
+	ManagedVoice voice;
+	voice.m_playbackID = m_backend->StartSoundAt(soundID, position);
+	voice.m_soundID = soundID;
+	voice.m_position = position;
+	voice.m_priority = priority;
+	voice.m_followActorUID = followActorUID;
+	voice.m_startSequence = m_nextStartSequence;
+	m_nextStartSequence++;
+	m_voices.push_back(voice);
+
+	m_stats.m_numStarted++;
+	m_stats.m_numPeakActiveVoices = (int)m_voices.size() > m_stats.m_numPeakActiveVoices ? (int)m_voices.size() : m_stats.m_numPeakActiveVoices;
+	return voice.m_playbackID;
+}
+
+void VoiceManager::Update(Map const* map)
+{
+	for (int voiceIndex = 0; voiceIndex < (int)m_voices.size(); voiceIndex++)
+	{
+		ManagedVoice& voice = m_voices[voiceIndex];
+		if (!m_backend->IsPlaying(voice.m_playbackID))
+		{
+			m_voices[voiceIndex] = m_voices.back();
+			m_voices.pop_back();
+			voiceIndex--;
+			m_stats.m_numFinished++;
+			continue;
+		}
+
+		if (!map || voice.m_followActorUID == ActorUID::INVALID)
+		{
+			continue;
+		}
+
+		Actor const* actor = map->GetActorByUID(voice.m_followActorUID);
+		if (!actor)
+		{
+			// The actor is gone, so the rest of the sound plays where it was last heard
+			voice.m_followActorUID = ActorUID::INVALID;
+			continue;
+		}
+
+		if (actor->m_position.x != voice.m_position.x || actor->m_position.y != voice.m_position.y || actor->m_position.z != voice.m_position.z)
+		{
+			voice.m_position = actor->m_position;
+			m_backend->SetSoundPosition(voice.m_playbackID, voice.m_position);
+			m_stats.m_numPositionUpdates++;
+		}
+	}
+}
+
+void VoiceManager::StopAll()
+{
+	for (int voiceIndex = 0; voiceIndex < (int)m_voices.size(); voiceIndex++)
+	{
+		m_backend->StopSound(m_voices[voiceIndex].m_playbackID);
+	}
+	m_voices.clear();
+}
+
+void VoiceManager::SetListenerPosition(int listenerIndex, Vec3 const& position)
+{
+	if (listenerIndex >= (int)m_listenerPositions.size())
+	{
+		m_listenerPositions.resize(listenerIndex + 1, position);
+	}
+	m_listenerPositions[listenerIndex] = position;
+}
+
+void VoiceManager::ClearListeners()
+{
+	m_listenerPositions.clear();
+}
+
+float VoiceManager::GetDistanceToNearestListener(Vec3 const& position) const
+{
+	// Without a listener there is nothing to measure from, so every sound counts as close
+	if (m_listenerPositions.empty())
+	{
+		return 0.f;
+	}
+
+	float nearestDistanceSquared = GetDistanceSquared3D(position, m_listenerPositions[0]);
+	for (int listenerIndex = 1; listenerIndex < (int)m_listenerPositions.size(); listenerIndex++)
+	{
+		float distanceSquared = GetDistanceSquared3D(position, m_listenerPositions[listenerIndex]);
+		nearestDistanceSquared = distanceSquared < nearestDistanceSquared ? distanceSquared : nearestDistanceSquared;
+	}
+	return sqrtf(nearestDistanceSquared);
+}
+
+float VoiceManager::GetVoiceImportance(VoicePriority priority, Vec3 const& position) const
+{
+	return (float)priority * (m_maxAudibleDistance + 1.f) - GetDistanceToNearestListener(position);
+}
+
+void VoiceManager::StopVoice(int voiceIndex)
+{
+	m_backend->StopSound(m_voices[voiceIndex].m_playbackID);
+	m_voices[voiceIndex] = m_voices.back();
+	m_voices.pop_back();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Game/ActorUID.hpp"
+
+#include "Engine/Audio/AudioSystem.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <vector>
+
+class AudioBackend;
+class Map;
+
+enum class VoicePriority
+{
+	LOW,
+	NORMAL,
+	HIGH,
+	CRITICAL
+};
+
+struct ManagedVoice
+{
+public:
+	SoundPlaybackID		m_playbackID = MISSING_SOUND_ID;
+	SoundID				m_soundID = MISSING_SOUND_ID;
+	Vec3				m_position = Vec3::ZERO;
+	VoicePriority		m_priority = VoicePriority::NORMAL;
+	// Voices attached to an actor follow it until they finish
+	ActorUID			m_followActorUID = ActorUID::INVALID;
+	unsigned int		m_startSequence = 0;
+};
+
+struct VoiceManagerStats
+{
+public:
+	int		m_numRequests = 0;
+	int		m_numStarted = 0;
+	int		m_numCulledByDistance = 0;
+	int		m_numRejectedBySoundCap = 0;
+	int		m_numRejectedByBudget = 0;
+	int		m_numStolenBySoundCap = 0;
+	int		m_numStolenByBudget = 0;
+	int		m_numFinished = 0;
+	int		m_numPositionUpdates = 0;
+	int		m_numPeakActiveVoices = 0;
+};
+
+// Every game sound goes through here instead of straight to the audio system
+// Requests beyond earshot are dropped, each sound can only have a few instances at once, and a global budget caps the voice count
+// When a cap is hit, the new sound takes over the least important playing voice if it outranks it, otherwise it is dropped
+// Followed voices have their positions pushed to the backend once per frame in Update, rather than by each actor
+class VoiceManager
+{
+public:
+	~VoiceManager();
+	// The manager takes ownership of the backend
+	VoiceManager(AudioBackend* backend, int maxVoices, int maxInstancesPerSound, float maxAudibleDistance);
+
+	SoundPlaybackID				PlaySoundAt(SoundID soundID, Vec3 const& position, VoicePriority priority = VoicePriority::NORMAL, ActorUID followActorUID = ActorUID::INVALID);
+	void						Update(Map const* map);
+	void						StopAll();
+
+	void						SetListenerPosition(int listenerIndex, Vec3 const& position);
+	void						ClearListeners();
+	int							GetNumActiveVoices() const { return (int)m_voices.size(); }
+	int							GetMaxVoices() const { return m_maxVoices; }
+	VoiceManagerStats const&	GetStats() const { return m_stats; }
+	AudioBackend*				GetBackend() const { return m_backend; }
+
+private:
+	float						GetDistanceToNearestListener(Vec3 const& position) const;
+	// Higher is more important, priority dominates and distance breaks ties within a priority
+	float						GetVoiceImportance(VoicePriority priority, Vec3 const& position) const;
+	void						StopVoice(int voiceIndex);
+
+private:
+	AudioBackend*				m_backend = nullptr;
+	int							m_maxVoices = 32;
+	int							m_maxInstancesPerSound = 4;
+	float						m_maxAudibleDistance = 40.f;
+	std::vector<Vec3>			m_listenerPositions;
+	std::vector<ManagedVoice>	m_voices;
+	unsigned int				m_nextStartSequence = 0;
+	VoiceManagerStats			m_stats;
+};
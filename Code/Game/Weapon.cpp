@@ -1,17 +1,31 @@
 #include "Game/Weapon.hpp"
 
 #include "Game/Actor.hpp"
+#include "Game/AllocationTracker.hpp"
 #include "Game/Controller.hpp"
+#include "Game/CounterRNG.hpp"
 #include "Game/Map.hpp"
 #include "Game/Game.hpp"
 #include "Game/Gold/Particle.hpp"
 #include "Game/Player.hpp"
+#include "Game/RenderList.hpp"
 
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/DebugRenderSystem.hpp"
 #include "Engine/VirtualReality/OpenXR.hpp"
 
 
+Weapon::~Weapon()
+{
+	if (m_animationClock)
+	{
+		m_map->m_game->m_gameClock.RemoveChild(m_animationClock);
+		TrackFree(AllocationCategory::WEAPONS, sizeof(Clock));
+	}
+	delete m_animationClock;
+	m_animationClock = nullptr;
+}
+
 Weapon::Weapon(WeaponDefinition const& definition, XRHand equipHand)
 	: m_definition(definition)
 	, m_equipHand(equipHand)
@@ -20,11 +34,23 @@ Weapon::Weapon(WeaponDefinition const& definition, XRHand equipHand)
 	m_currentShader = m_definition.m_idleAnimationShader;
 }
 
+void* Weapon::operator new(size_t numBytes)
+{
+	TrackAllocation(AllocationCategory::WEAPONS, numBytes);
+	return ::operator new(numBytes);
+}
+
+void Weapon::operator delete(void* pointer, size_t numBytes)
+{
+	TrackFree(AllocationCategory::WEAPONS, numBytes);
+	::operator delete(pointer);
+}
+
 void Weapon::Update()
 {
 }
 
-void Weapon::Render() const
+void Weapon::AddDrawItems(RenderList& renderList) const
 {
 	if (!m_definition.m_is3DWeapon)
 	{
@@ -46,15 +72,7 @@ void Weapon::Render() const
 	transform.Append(owner->m_orientation.GetAsMatrix_iFwd_jLeft_kUp());
 	transform.AppendScaleUniform3D(m_definition.m_modelScale);
 
-	g_renderer->SetBlendMode(BlendMode::OPAQUE);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->SetModelConstants(transform);
-	g_renderer->BindTexture(m_definition.m_texture);
-	//g_theRenderer->BindShader(m_definition.m_shader);
-	g_renderer->DrawIndexBuffer(m_definition.m_model->GetVertexBuffer(), m_definition.m_model->GetIndexBuffer(), m_definition.m_model->GetIndexCount());
+	renderList.AddIndexedDraw(m_definition.m_model->GetVertexBuffer(), m_definition.m_model->GetIndexBuffer(), m_definition.m_model->GetIndexCount(), transform, Rgba8::WHITE, m_definition.m_texture);
 }
 
 void Weapon::OnEquipped(Actor* owner)
@@ -63,7 +81,12 @@ void Weapon::OnEquipped(Actor* owner)
 	m_ownerUID = owner->m_UID;
 	m_refireTimer = Stopwatch(&m_map->m_game->m_gameClock, m_definition.m_refireTime);
 	m_refireTimer.Start();
-	m_animationClock = new Clock(owner->m_map->m_game->m_gameClock);
+	// Weapons are equipped every time the player switches to them, so the clock is only created the first time
+	if (!m_animationClock)
+	{
+		m_animationClock = new Clock(owner->m_map->m_game->m_gameClock);
+		TrackAllocation(AllocationCategory::WEAPONS, sizeof(Clock));
+	}
 	m_animationClock->Reset();
 }
 
@@ -80,7 +103,7 @@ void Weapon::Fire()
 		return;
 	}
 
-	g_audio->StartSoundAt(m_definition.m_fireSound, owner->m_position);
+	m_fireSoundPlayback = g_voiceManager->PlaySoundAt(m_definition.m_fireSound, owner->m_position, owner->GetSoundPriority(), owner->m_UID);
 
 	if (!g_openXR || !g_openXR->IsInitialized())
 	{
@@ -112,11 +135,16 @@ void Weapon::Fire()
 		}
 	}
 
+	// Both hands may fire in the same frame, so each rolls on its own channel
+	unsigned int handChannel = RANDOM_CHANNEL_WEAPON + (m_equipHand == XRHand::LEFT ? 1 : (m_equipHand == XRHand::RIGHT ? 2 : 0));
+	CounterRNG combatRNG = g_randomStreams->GetRNG(RandomStream::COMBAT, m_ownerUID.GetData(), m_map->m_frameIndex, handChannel);
+	CounterRNG particleRNG = g_randomStreams->GetRNG(RandomStream::PARTICLES, m_ownerUID.GetData(), m_map->m_frameIndex, handChannel);
+
 	for (int rayIndex = 0; rayIndex < m_definition.m_rayCount; rayIndex++)
 	{
 		for (int particleIndex = 0; particleIndex < m_definition.m_particlesOnHit; particleIndex++)
 		{
-			float particleRadius = g_RNG->RollRandomFloatInRange(0.003f, 0.005f);
+			float particleRadius = particleRNG.RollRandomFloatInRange(0.003f, 0.005f);
 			if (g_openXR && g_openXR->IsInitialized() && owner->m_controller && owner->m_controller->IsPlayer())
 			{
 				Player* player = (Player*)owner->m_controller;
@@ -132,19 +160,19 @@ void Weapon::Fire()
 				}
 
 				Particle* particle = m_map->SpawnParticle(firePosition + weaponFwd * 0.25f - weaponLeft * 0.04f + weaponUp * 0.05f, particleRadius, m_definition.m_fireParticleColor, 0.1f);
-				Vec3 randomDirection = g_RNG->RollRandomVec3InRadius(Vec3::ZERO, 1.f);
+				Vec3 randomDirection = particleRNG.RollRandomVec3InRadius(Vec3::ZERO, 1.f);
 				particle->AddImpulse(randomDirection);
 			}
 			else
 			{
 				Particle* particle = m_map->SpawnParticle(owner->GetWeaponPosition() + owner->GetForwardNormal() * 0.08f + - owner->GetLeftNormal() * 0.04f + owner->GetUpNormal() * 0.05f, particleRadius, m_definition.m_fireParticleColor, 0.1f);
-				Vec3 randomDirection = GetRandomFireDirection(owner, 15.f);
+				Vec3 randomDirection = GetRandomFireDirection(owner, 15.f, particleRNG);
 
 				particle->AddImpulse(randomDirection);
 			}
 		}
 
-		Vec3 fireDirection = GetRandomFireDirection(owner, m_definition.m_rayCone);
+		Vec3 fireDirection = GetRandomFireDirection(owner, m_definition.m_rayCone, combatRNG);
 		if (g_openXR && g_openXR->IsInitialized() && owner->m_controller && owner->m_controller->IsPlayer())
 		{
 			fireDirection = actorFwd;
@@ -165,23 +193,23 @@ void Weapon::Fire()
 				{
 					for (int particleIndex = 0; particleIndex < m_definition.m_particlesOnHit; particleIndex++)
 					{
-						float particleRadius = g_RNG->RollRandomFloatInRange(0.003f, 0.005f);
+						float particleRadius = particleRNG.RollRandomFloatInRange(0.003f, 0.005f);
 						Particle* particle = m_map->SpawnParticle(result.m_impactPosition, particleRadius, m_definition.m_hitParticleColor, 0.1f);
-						Vec3 randomDirection = Vec3(g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f));
-						randomDirection = randomDirection.GetNormalized() * g_RNG->RollRandomFloatInRange(1.f, 2.f);
+						Vec3 randomDirection = Vec3(particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f));
+						randomDirection = randomDirection.GetNormalized() * particleRNG.RollRandomFloatInRange(1.f, 2.f);
 						particle->AddImpulse(randomDirection);
 					}
 					continue;
 				}
 				for (int particleIndex = 0; particleIndex < m_definition.m_particlesOnHit; particleIndex++)
 				{
-					float particleRadius = g_RNG->RollRandomFloatInRange(0.003f, 0.005f);
+					float particleRadius = particleRNG.RollRandomFloatInRange(0.003f, 0.005f);
 					Particle* particle = m_map->SpawnParticle(result.m_impactPosition, particleRadius, Rgba8::RED, 0.1f);
-					Vec3 randomDirection = Vec3(g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f));
-					randomDirection = randomDirection.GetNormalized() * g_RNG->RollRandomFloatInRange(1.f, 2.f);
+					Vec3 randomDirection = Vec3(particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f));
+					randomDirection = randomDirection.GetNormalized() * particleRNG.RollRandomFloatInRange(1.f, 2.f);
 					particle->AddImpulse(randomDirection);
 				}
-				float damage = g_RNG->RollRandomFloatInRange(m_definition.m_rayDamage);
+				float damage = combatRNG.RollRandomFloatInRange(m_definition.m_rayDamage);
 				impactActor->TakeDamage(damage);
 				if (impactActor->m_controller)
 				{
@@ -192,10 +220,10 @@ void Weapon::Fire()
 			{
 				for (int particleIndex = 0; particleIndex < m_definition.m_particlesOnHit; particleIndex++)
 				{
-					float particleRadius = g_RNG->RollRandomFloatInRange(0.003f, 0.005f);
+					float particleRadius = particleRNG.RollRandomFloatInRange(0.003f, 0.005f);
 					Particle* particle = m_map->SpawnParticle(result.m_impactPosition, particleRadius, m_definition.m_hitParticleColor, 0.1f);
-					Vec3 randomDirection = Vec3(g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f));
-					randomDirection = randomDirection.GetNormalized() * g_RNG->RollRandomFloatInRange(1.f, 2.f);
+					Vec3 randomDirection = Vec3(particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f), particleRNG.RollRandomFloatInRange(-1.f, 1.f));
+					randomDirection = randomDirection.GetNormalized() * particleRNG.RollRandomFloatInRange(1.f, 2.f);
 					particle->AddImpulse(randomDirection);
 				}
 			}
@@ -204,19 +232,14 @@ void Weapon::Fire()
 
 	for (int projectileIndex = 0; projectileIndex < m_definition.m_projectileCount; projectileIndex++)
 	{
-		Vec3 fireDirection = GetRandomFireDirection(owner, m_definition.m_projectileCone);
+		Vec3 fireDirection = GetRandomFireDirection(owner, m_definition.m_projectileCone, combatRNG);
 		if (g_openXR && g_openXR->IsInitialized() && owner->m_controller && owner->m_controller->IsPlayer())
 		{
 			fireDirection = actorFwd;
 		}
-		SpawnInfo spawnInfo;
-		spawnInfo.m_actor = m_definition.m_projectileActor;
-		spawnInfo.m_position = firePosition;
-		spawnInfo.m_orientation = owner->m_orientation;
-		spawnInfo.m_orientation.m_pitchDegrees -= 10.f;
-		Actor* projectileActor = m_map->SpawnActor(spawnInfo);
-		projectileActor->m_ownerUID = m_ownerUID;
-		projectileActor->AddImpulse(fireDirection * m_definition.m_projectileSpeed);
+		EulerAngles projectileOrientation = owner->m_orientation;
+		projectileOrientation.m_pitchDegrees -= 10.f;
+		m_map->m_projectiles.Spawn(m_definition.m_projectileActor, firePosition, projectileOrientation, fireDirection * m_definition.m_projectileSpeed, m_ownerUID);
 	}
 
 	for (int meleeIndex = 0; meleeIndex < m_definition.m_meleeCount; meleeIndex++)
@@ -237,7 +260,7 @@ void Weapon::Fire()
 
 			if (IsPointInsideDirectedSector2D(actor->m_position.GetXY(), owner->m_position.GetXY(), owner->GetForwardNormal().GetXY().GetNormalized(), m_definition.m_meleeArc, m_definition.m_meleeRange))
 			{
-				float damage = g_RNG->RollRandomFloatInRange(m_definition.m_meleeDamage);
+				float damage = combatRNG.RollRandomFloatInRange(m_definition.m_meleeDamage);
 				actor->TakeDamage(damage);
 				Vec3 directionToTarget = (actor->m_position - owner->m_position).GetNormalized();
 				actor->AddImpulse(directionToTarget * m_definition.m_meleeImpulse);
@@ -260,6 +283,7 @@ void Weapon::Fire()
 	m_currentAnimation = m_definition.m_attackAnimation;
 	m_animationClock->Reset();
 	owner->m_currentAnimation = owner->m_definition.GetAnimationGroupByName("Attack");
+	owner->m_currentSpriteTable = owner->m_definition.GetSpriteTableByName("Attack");
 	if (owner->m_currentAnimation.m_scaleBySpeed)
 	{
 		owner->m_animationClock.SetTimeScale(owner->m_velocity.GetLength() / owner->m_definition.m_runSpeed);
@@ -271,9 +295,9 @@ void Weapon::Fire()
 	owner->m_animationClock.Reset();
 }
 
-Vec3 const Weapon::GetRandomFireDirection(Actor const* actor, float deviationAngle) const
+Vec3 const Weapon::GetRandomFireDirection(Actor const* actor, float deviationAngle, CounterRNG& rng) const
 {
-	Vec2 randomDeviation2 = g_RNG->RollRandomVec2InRadius(Vec2::ZERO, TanDegrees(deviationAngle));
+	Vec2 randomDeviation2 = rng.RollRandomVec2InRadius(Vec2::ZERO, TanDegrees(deviationAngle));
 	Vec3 randomDeviation3 = Vec3(0.f, randomDeviation2.x, randomDeviation2.y);
 	Vec3 finalDirectionInActorLocalSpace = Vec3::EAST + randomDeviation3;
 	return actor->GetRenderModelMatrix().TransformVectorQuantity3D(finalDirectionInActorLocalSpace);
@@ -6,22 +6,28 @@
 #include "Game/ActorUID.hpp"
 
 class Actor;
+class CounterRNG;
 class Map;
+class RenderList;
 
 class Weapon
 {
 public:
-	~Weapon() = default;
+	~Weapon();
 	Weapon() = default;
-	Weapon(Weapon const& copyFrom) = default;
+	// The animation clock is owned, so weapons are not copied
+	Weapon(Weapon const& copyFrom) = delete;
 	explicit Weapon(WeaponDefinition const& definition, XRHand equipHand = XRHand::NONE);
+
+	static void* operator new(size_t numBytes);
+	static void operator delete(void* pointer, size_t numBytes);
 	
 	void Update();
-	void Render() const;
+	void AddDrawItems(RenderList& renderList) const;
 
 	void OnEquipped(Actor* owner);
 	void Fire();
-	Vec3 const GetRandomFireDirection(Actor const* actor, float deviationAngle) const;
+	Vec3 const GetRandomFireDirection(Actor const* actor, float deviationAngle, CounterRNG& rng) const;
 	float GetRange() const;
 
 public:
@@ -35,7 +41,7 @@ public:
 	Shader* m_currentShader = nullptr;
 
 	std::vector<Vertex_PCU> m_reticleVertexes;
-	SoundID m_fireSoundPlayback = MISSING_SOUND_ID;
+	SoundPlaybackID m_fireSoundPlayback = MISSING_SOUND_ID;
 
 	Mat44 m_transform;
 
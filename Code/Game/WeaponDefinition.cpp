@@ -3,6 +3,7 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
 #include "Game/ActorDefinition.hpp"
+#include "Game/AllocationTracker.hpp"
 #include "Game/GameCommon.hpp"
 
 std::map<std::string, WeaponDefinition> WeaponDefinition::s_weaponDefs;
@@ -119,6 +120,7 @@ WeaponDefinition::WeaponDefinition(XmlElement const* element)
 				IntVec2 idleAnimationSpriteSheetCellCount = ParseXmlAttribute(*animationElement, "cellCount", IntVec2::ZERO);
 				float idleAnimationSecondsPerFrame = ParseXmlAttribute(*animationElement, "secondsPerFrame", 0.f);
 				SpriteSheet* idleAnimationSpriteSheet = new SpriteSheet(idleAnimationTexture, idleAnimationSpriteSheetCellCount);
+				TrackAllocation(AllocationCategory::DEFINITIONS, sizeof(SpriteSheet));
 				m_idleAnimation = SpriteAnimDefinition(idleAnimationSpriteSheet, -1, -1, idleAnimationSecondsPerFrame, SpriteAnimPlaybackType::ONCE);
 				m_idleAnimation.LoadFromXml(animationElement);
 			}
@@ -138,6 +140,7 @@ WeaponDefinition::WeaponDefinition(XmlElement const* element)
 				IntVec2 attackAnimationSpriteSheetCellCount = ParseXmlAttribute(*animationElement, "cellCount", IntVec2::ZERO);
 				float attackAnimationSecondsPerFrame = ParseXmlAttribute(*animationElement, "secondsPerFrame", 0.f);
 				SpriteSheet* attackAnimationSpriteSheet = new SpriteSheet(attackAnimationTexture, attackAnimationSpriteSheetCellCount);
+				TrackAllocation(AllocationCategory::DEFINITIONS, sizeof(SpriteSheet));
 				m_attackAnimation = SpriteAnimDefinition(attackAnimationSpriteSheet, -1, -1, attackAnimationSecondsPerFrame, SpriteAnimPlaybackType::ONCE);
 				m_attackAnimation.LoadFromXml(animationElement);
 			}
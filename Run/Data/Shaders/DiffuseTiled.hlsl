@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------------------------
+struct vs_input_t
+{
+	float3 localPosition : POSITION;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+	float3 localTangent : TANGENT;
+	float3 localBitangent : BITANGENT;
+	float3 localNormal : NORMAL;
+};
+
+//------------------------------------------------------------------------------------------------
+struct v2p_t
+{
+	float4 position : SV_Position;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+	float4 tangent : TANGENT;
+	float4 bitangent : BITANGENT;
+	float4 normal : NORMAL;
+	float4 lightSpacePos : LIGHTSPACEPOS;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer LightConstants : register(b1)
+{
+	float3 SunDirection;
+	float SunIntensity;
+	float AmbientIntensity;
+	float3 padding;
+	float4x4 LightViewMatrix;
+	float4x4 LightProjectionMatrix;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer CameraConstants : register(b2)
+{
+	float4x4 ViewMatrix;
+	float4x4 ProjectionMatrix;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer ModelConstants : register(b3)
+{
+	float4x4 ModelMatrix;
+	float4 ModelColor;
+};
+
+//------------------------------------------------------------------------------------------------
+Texture2D diffuseTexture : register(t0);
+
+Texture2D shadowMap : register(t1);
+
+//------------------------------------------------------------------------------------------------
+SamplerState diffuseSampler : register(s0);
+
+SamplerComparisonState ShadowSampler : register(s1)
+{
+   // sampler state
+   Filter = COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+   AddressU = MIRROR;
+   AddressV = MIRROR;
+
+   // sampler comparison state
+   ComparisonFunc = LESS;  
+};
+
+//------------------------------------------------------------------------------------------------
+v2p_t VertexMain(vs_input_t input)
+{
+	float4 localPosition = float4(input.localPosition, 1);
+	float4 worldPosition = mul(ModelMatrix, localPosition);
+	float4 viewPosition = mul(ViewMatrix, worldPosition);
+	float4 clipPosition = mul(ProjectionMatrix, viewPosition);
+	float4 localNormal = float4(input.localNormal, 0);
+	float4 worldNormal = mul(ModelMatrix, localNormal);
+	float4 lightViewPosition = mul(LightViewMatrix, worldPosition);
+	float4 lightSpacePosition = mul(LightProjectionMatrix, lightViewPosition);
+
+	v2p_t v2p;
+	v2p.position = clipPosition;
+	v2p.color = input.color;
+	v2p.uv = input.uv;
+	// Tile vertexes carry their sprite's rectangle on the atlas here instead of a tangent frame
+	v2p.tangent = float4(input.localTangent, 0);
+	v2p.bitangent = float4(input.localBitangent, 0);
+	v2p.normal = worldNormal;
+	v2p.lightSpacePos = lightSpacePosition;
+	return v2p;
+}
+
+//------------------------------------------------------------------------------------------------
+float4 PixelMain(v2p_t input) : SV_Target0
+{
+	float directional = 0.0;
+		float2 shadowTexCoords;
+		shadowTexCoords.x = 0.5f + (input.lightSpacePos.x / input.lightSpacePos.w * 0.5f);
+		shadowTexCoords.y = 0.5f - (input.lightSpacePos.y / input.lightSpacePos.w * 0.5f);
+		float pixelDepth = input.lightSpacePos.z / input.lightSpacePos.w;
+		
+	if ((saturate(shadowTexCoords.x) == shadowTexCoords.x) && (saturate(shadowTexCoords.y) == shadowTexCoords.y) && (pixelDepth > 0))
+	{
+		float lighting = shadowMap.SampleCmpLevelZero(ShadowSampler, shadowTexCoords, pixelDepth);
+		
+		if (lighting > 0)
+		{
+			directional = SunIntensity * saturate(dot(normalize(input.normal.xyz), -SunDirection));
+		}
+	}
+	
+	float ambient = AmbientIntensity;
+	float4 lightColor = float4((ambient + directional).xxx, 1);
+	// Merged tile quads count tiles in their uv, so the sprite repeats once per tile inside its rectangle on the atlas
+	// Gradients come from the unwrapped uv, the jump where frac wraps would otherwise pick the wrong mip along every tile edge
+	float2 spriteMins = input.tangent.xy;
+	float2 spriteSize = input.bitangent.xy;
+	float2 atlasUV = spriteMins + frac(input.uv) * spriteSize;
+	float4 textureColor = diffuseTexture.SampleGrad(diffuseSampler, atlasUV, ddx(input.uv) * spriteSize, ddy(input.uv) * spriteSize);
+	float4 vertexColor = input.color;
+	float4 modelColor = ModelColor;
+	float4 color = lightColor * textureColor * vertexColor * modelColor;
+	clip(color.a - 0.01f);
+	return color;
+}